@@ -35,6 +35,8 @@ void (Coords::spherical::*setPhi)(const Coords::angle&) = &Coords::spherical::ph
 
 void (Coords::DateTime::*setTimezone)(const double&) = &Coords::DateTime::setTimezone;
 
+Coords::Cartesian (Coords::rotator::*rotate)(const Coords::Cartesian&, const Coords::angle&) = &Coords::rotator::rotate;
+
 
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(fromJulianDate_overloads, Coords::DateTime::fromJulianDate, 1, 2)
 
@@ -199,7 +201,7 @@ BOOST_PYTHON_MODULE(coords) {
 
     // other methods
 
-    .def("rotate", &Coords::rotator::rotate)
+    .def("rotate", rotate)
 
     ; // end of rotator class_
 
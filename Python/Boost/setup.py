@@ -10,18 +10,21 @@ ASSUMES: ../../libCoords exists and has boost installed (in
 import platform
 import sys
 
-from distutils.core import setup, Extension
+from setuptools import setup, Extension
 
 name = 'coords'
 version = '1.0'
 description = 'coords package'
 
+# Boost names the Python 3 library after the version, e.g. boost_python311
+boost_python = 'boost_python%d%d' % sys.version_info[:2]
+
 if platform.system() == 'Darwin':
 
     BOOST_ROOT = '/usr/local'
     include_dirs = ['../../libCoords', BOOST_ROOT + '/include']
     library_dirs = ['../../libCoords', BOOST_ROOT + '/lib']
-    libraries = ['boost_python', 'Coords']
+    libraries = [boost_python, 'Coords']
     sources = ['coords.cpp']
 
 elif platform.system() == 'Linux':
@@ -29,11 +32,11 @@ elif platform.system() == 'Linux':
 
     include_dirs = ['../../libCoords']
     library_dirs = ['../../libCoords', '/usr/lib64']
-    libraries = ['boost_python', 'boost_regex', 'Coords']
+    libraries = [boost_python, 'boost_regex', 'Coords']
     sources = ['coords.cpp']
 
 else:
-    print 'unsupported platform:', platform.system()
+    print('unsupported platform:', platform.system())
     sys.exit(1)
 
 coords_module = Extension(name,
@@ -0,0 +1,43 @@
+"""Allocation benchmark for coords objects.
+
+Times the scalar operators that create a new coords object for every
+result, i.e. the calls that go through the object freelists.
+
+usage: python benchmark_allocation.py [number]
+"""
+
+import sys
+import timeit
+
+setup = """
+import coords
+a = coords.Cartesian(1, 2, 3)
+b = coords.Cartesian(4, 5, 6)
+an_angle = coords.angle(30)
+another_angle = coords.angle(45)
+a_rotator = coords.rotator(coords.Cartesian(1, 1, 1))
+a_spherical = coords.spherical(1, coords.angle(30), coords.angle(45))
+a_datetime = coords.datetime('1962-07-10T07:30:00+05:00')
+"""
+
+statements = [
+    ('Cartesian + Cartesian', 'a + b'),
+    ('Cartesian * float', 'a * 2.0'),
+    ('Cartesian.normalized()', 'a.normalized()'),
+    ('Cartesian()', 'coords.Cartesian(1, 2, 3)'),
+    ('angle + angle', 'an_angle + another_angle'),
+    ('angle()', 'coords.angle(30)'),
+    ('rotator.rotate()', 'a_rotator.rotate(a, an_angle)'),
+    ('spherical * float', 'a_spherical * 2.0'),
+    ('datetime + float', 'a_datetime + 1.5'),
+]
+
+
+def main(number):
+    for name, statement in statements:
+        seconds = min(timeit.repeat(statement, setup, repeat=3, number=number))
+        print('%-24s %8.1f ns' % (name, 1e9*seconds/number))
+
+
+if __name__ == '__main__':
+    main(int(sys.argv[1]) if len(sys.argv) > 1 else 1000000)
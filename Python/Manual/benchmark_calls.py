@@ -0,0 +1,68 @@
+"""Call overhead benchmark for coords objects.
+
+Times the scalar constructors, methods and accessors used in control
+scripts, i.e. the argument parsing fast paths.
+
+usage: python benchmark_calls.py [number]
+
+ns per call on Python 3.11, x86_64. Before is the METH_VARARGS methods
+and tp_init constructors, after the METH_FASTCALL methods and, except
+with the limited API (COORDS_LIMITED_API=1), vectorcall constructors.
+
+                           before  after  limited
+Cartesian(x, y, z)             70     34       82
+Cartesian(x=, y=, z=)         221    205      228
+angle(deg)                     65     28       69
+angle(deg, min, sec)           74     38       83
+Cartesian.magnitude()          12     12       12
+rotator.rotate()               57     29       34
+coords.dot()                   57     18       19
+coords.cross()                 54     22       26
+Cartesian.normalized()         28     28       35
+angle.normalize()              82     42       44
+angle.deg2rad()                56     15       14
+CartesianRecorder.push()       42     15       18
+CartesianRecorder.get()        58     28       35
+Cartesian.x                    18     18       18
+angle.value                    18     18       18
+"""
+
+import sys
+import timeit
+
+setup = """
+import coords
+a = coords.Cartesian(1, 2, 3)
+b = coords.Cartesian(4, 5, 6)
+an_angle = coords.angle(30)
+a_rotator = coords.rotator(coords.Cartesian(1, 1, 1))
+a_recorder = coords.CartesianRecorder(64)
+"""
+
+statements = [
+    ('Cartesian(x, y, z)', 'coords.Cartesian(1.0, 2.0, 3.0)'),
+    ('Cartesian(x=, y=, z=)', 'coords.Cartesian(x=1.0, y=2.0, z=3.0)'),
+    ('angle(deg)', 'coords.angle(30.0)'),
+    ('angle(deg, min, sec)', 'coords.angle(30, 15, 10.5)'),
+    ('Cartesian.magnitude()', 'a.magnitude()'),
+    ('rotator.rotate()', 'a_rotator.rotate(a, an_angle)'),
+    ('coords.dot()', 'coords.dot(a, b)'),
+    ('coords.cross()', 'coords.cross(a, b)'),
+    ('Cartesian.normalized()', 'a.normalized()'),
+    ('angle.normalize()', 'an_angle.normalize(0, 360)'),
+    ('angle.deg2rad()', 'an_angle.deg2rad(30.0)'),
+    ('CartesianRecorder.push()', 'a_recorder.push(a)'),
+    ('CartesianRecorder.get()', 'a_recorder.get(0)'),
+    ('Cartesian.x', 'a.x'),
+    ('angle.value', 'an_angle.value'),
+]
+
+
+def main(number):
+    for name, statement in statements:
+        seconds = min(timeit.repeat(statement, setup, repeat=3, number=number))
+        print('%-24s %8.1f ns' % (name, 1e9*seconds/number))
+
+
+if __name__ == '__main__':
+    main(int(sys.argv[1]) if len(sys.argv) > 1 else 1000000)
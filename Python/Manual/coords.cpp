@@ -4,33 +4,112 @@
 // Description: Contains the python wrappers for the Coordinates
 //              objects.
 //
-// See also:    http://docs.python.org/extending/newtypes.html
-//              http://docs.python.org/c-api/complex.html
-//              https://docs.python.org/2/reference/datamodel.html
+// See also:    https://docs.python.org/3/extending/newtypes.html
+//              https://docs.python.org/3/c-api/type.html
+//              https://docs.python.org/3/reference/datamodel.html
+//              https://peps.python.org/pep-0489/
 //
 // Author:      L.R. McFarland
 // Created:     2014 Nov 21
 // ==========================================================
 
 #include <Python.h> // must be first
-#include <structmember.h> // part of python
 
+#include <climits>
+#include <cstring>
+#include <new> // placement new
 #include <sstream>
+#include <vector>
 
 #include <angle.h>
 #include <Cartesian.h>
 #include <datetime.h>
+#include <expression.h>
 #include <spherical.h>
 
 // ===================
 // ===== statics =====
 // ===================
 
-static PyObject* sCoordsException; // exception holder
-
 // TODO: make precision configuralble on build, not hardcoded.
 static const unsigned int sPrintPrecision(12); // matches defaut %s precision for unit test
 
+// ------------------------
+// ----- module state -----
+// ------------------------
+
+// The types, exception and freelists live in the module state, not
+// in statics, so each (sub)interpreter importing coords gets its own
+// copy. See PEP 489 and PEP 630.
+
+static const size_t sFreeListLimit(256);
+
+struct FreeList {
+  PyObject* m_objects[sFreeListLimit];
+  size_t    m_size;
+};
+
+typedef struct {
+  PyObject*     Error; // exception holder
+
+  PyTypeObject* AngleType;
+  PyTypeObject* LatitudeType;
+  PyTypeObject* DeclinationType;
+  PyTypeObject* CartesianType;
+  PyTypeObject* rotatorType;
+  PyTypeObject* CartesianRecorderType;
+  PyTypeObject* sphericalType;
+  PyTypeObject* datetimeType;
+  PyTypeObject* expressionType;
+
+  PyObject*     numpy_empty; // numpy.empty, imported on first use
+  PyObject*     datetime_module; // Python datetime, imported on first use
+  PyObject*     datetime_names[12]; // interned datetime attribute names
+
+  FreeList      AngleFreeList;
+  FreeList      LatitudeFreeList;
+  FreeList      DeclinationFreeList;
+  FreeList      CartesianFreeList;
+  FreeList      SphericalFreeList;
+  FreeList      DatetimeFreeList;
+} coords_state;
+
+extern PyModuleDef coords_module;
+
+static coords_state* get_type_state(PyTypeObject* a_type) {
+  // Returns the state of the coords module that defined a_type or its
+  // coords base type, NULL if there is none.
+#if !defined(Py_LIMITED_API) && PY_VERSION_HEX >= 0x030B0000
+  PyObject* a_module(PyType_GetModuleByDef(a_type, &coords_module));
+  if (a_module == NULL) {
+    PyErr_Clear();
+    return NULL;
+  }
+  return (coords_state*)PyModule_GetState(a_module);
+#else
+  while (a_type) {
+    if (PyType_GetFlags(a_type) & Py_TPFLAGS_HEAPTYPE) {
+      PyObject* a_module(PyType_GetModule(a_type));
+      if (a_module && PyModule_GetDef(a_module) == &coords_module)
+	return (coords_state*)PyModule_GetState(a_module);
+      PyErr_Clear();
+    }
+    a_type = (PyTypeObject*)PyType_GetSlot(a_type, Py_tp_base);
+  }
+  return NULL;
+#endif
+}
+
+static coords_state* get_state(PyObject* self) {
+  return get_type_state(Py_TYPE(self));
+}
+
+static coords_state* get_state2(PyObject* o1, PyObject* o2) {
+  // binary operators, only one of o1 and o2 may be a coords object.
+  coords_state* st(get_state(o1));
+  return st ? st : get_state(o2);
+}
+
 // -----------------
 // ----- Angle -----
 // -----------------
@@ -48,8 +127,8 @@ typedef struct {
 } Angle;
 
 // Forward declarations for as_number methods. Wraps Type definition.
-static void new_AngleType(Angle** an_angle);
-static int is_AngleType(PyObject* an_angle);
+static void new_AngleType(coords_state* st, Angle** an_angle);
+static int is_AngleType(coords_state* st, PyObject* an_angle);
 
 // --------------------
 // ----- Latitude -----
@@ -60,8 +139,8 @@ typedef struct {
   Coords::Latitude m_angle;
 } Latitude;
 
-static void new_LatitudeType(Latitude** an_angle);
-static int is_LatitudeType(PyObject* an_angle);
+static void new_LatitudeType(coords_state* st, Latitude** an_angle);
+static int is_LatitudeType(coords_state* st, PyObject* an_angle);
 
 // -----------------------
 // ----- Declination -----
@@ -74,8 +153,8 @@ typedef struct {
   Coords::Declination m_angle;
 } Declination;
 
-static void new_DeclinationType(Declination** an_angle);
-static int is_DeclinationType(PyObject* an_angle);
+static void new_DeclinationType(coords_state* st, Declination** an_angle);
+static int is_DeclinationType(coords_state* st, PyObject* an_angle);
 
 // ---------------------
 // ----- Cartesian -----
@@ -91,8 +170,8 @@ typedef struct {
 } Cartesian;
 
 // Forward declarations for as_number methods. Wraps CartesianType definition.
-static void new_CartesianType(Cartesian** a_Cartesian);
-static int is_CartesianType(PyObject* a_Cartesian);
+static void new_CartesianType(coords_state* st, Cartesian** a_Cartesian);
+static int is_CartesianType(coords_state* st, PyObject* a_Cartesian);
 
 static PyObject* Cartesian_normalized(PyObject* self, PyObject *args);
 
@@ -108,8 +187,22 @@ typedef struct {
 } rotator;
 
 // Forward declarations for as_number methods. Wraps RotatorType definition.
-static void new_rotatorType(rotator** a_Rotator);
-static int is_rotatorType(PyObject* a_Rotator);
+static void new_rotatorType(coords_state* st, rotator** a_Rotator);
+static int is_rotatorType(coords_state* st, PyObject* a_Rotator);
+
+// -----------------------------
+// ----- CartesianRecorder -----
+// -----------------------------
+
+static char sSizeLimitStr[] = "sizeLimit";
+
+typedef struct {
+  PyObject_HEAD
+  Coords::CartesianRecorder m_recorder;
+  Py_ssize_t                m_exports;    // buffer views handed out
+  Py_ssize_t                m_shape[2];   // (size, 3) for the views
+  Py_ssize_t                m_strides[2];
+} CartesianRecorder;
 
 // ---------------------
 // ----- spherical -----
@@ -125,8 +218,8 @@ typedef struct {
 } spherical;
 
 // Forward declarations for as_number methods. Wraps sphericalType definition.
-static void new_sphericalType(spherical** a_spherical);
-static int is_sphericalType(PyObject* a_spherical);
+static void new_sphericalType(coords_state* st, spherical** a_spherical);
+static int is_sphericalType(coords_state* st, PyObject* a_spherical);
 
 
 // --------------------
@@ -155,8 +248,20 @@ typedef struct {
 } datetime;
 
 // Forward declarations for as_number methods. Wraps datetimeType definition.
-static void new_datetimeType(datetime** a_datetime);
-static int is_datetimeType(PyObject* a_datetime);
+static void new_datetimeType(coords_state* st, datetime** a_datetime);
+static int is_datetimeType(coords_state* st, PyObject* a_datetime);
+
+
+// ----------------------
+// ----- expression -----
+// ----------------------
+
+static char sFormulaStr[] = "formula";
+
+typedef struct {
+  PyObject_HEAD
+  Coords::expression m_expression;
+} expression;
 
 
 // ---------------------
@@ -166,20 +271,20 @@ static int is_datetimeType(PyObject* a_datetime);
 // helper functions for parsing numeric arguments. Allows arg to be
 // double or int.
 
-int parse_int_arg(PyObject* arg, int& val) {
+int parse_int_arg(coords_state* st, PyObject* arg, int& val) {
 
   if (arg) {
 
-    if (PyFloat_Check(arg) || PyInt_Check(arg)) {
+    if (PyFloat_Check(arg) || PyLong_Check(arg)) {
       val = PyFloat_AsDouble(arg);
       return 0;
 
-    } else if (PyString_Check(arg)) {
-      PyErr_SetString(sCoordsException, "Direct conversion from string is not supported. Use float(arg).");
+    } else if (PyUnicode_Check(arg)) {
+      PyErr_SetString(st->Error, "Direct conversion from string is not supported. Use float(arg).");
       return -1;
 
     } else {
-      PyErr_SetString(sCoordsException, "arg must be an int or float");
+      PyErr_SetString(st->Error, "arg must be an int or float");
       return -1;
     }
 
@@ -188,20 +293,20 @@ int parse_int_arg(PyObject* arg, int& val) {
   return 0; // fall through to leave default val unchanged
 }
 
-int parse_double_arg(PyObject* arg, double& val) {
+int parse_double_arg(coords_state* st, PyObject* arg, double& val) {
 
   if (arg) {
 
-    if (PyFloat_Check(arg) || PyInt_Check(arg)) {
+    if (PyFloat_Check(arg) || PyLong_Check(arg)) {
       val = PyFloat_AsDouble(arg);
       return 0;
 
-    } else if (PyString_Check(arg)) {
-      PyErr_SetString(sCoordsException, "Direct conversion from string is not supported. Use float(arg).");
+    } else if (PyUnicode_Check(arg)) {
+      PyErr_SetString(st->Error, "Direct conversion from string is not supported. Use float(arg).");
       return -1;
 
     } else {
-      PyErr_SetString(sCoordsException, "arg must be an int or float");
+      PyErr_SetString(st->Error, "arg must be an int or float");
       return -1;
     }
 
@@ -210,6 +315,325 @@ int parse_double_arg(PyObject* arg, double& val) {
   return 0; // fall through to leave default val unchanged
 }
 
+// The hot constructors skip PyArg_ParseTupleAndKeywords when all the
+// arguments are positional floats or ints, the common case in
+// scripts. Without the limited API they are called by vectorcall,
+// with it through tp_init. Both return the number of values read into
+// a_values, or -1 to use the general path.
+
+static bool fast_double(PyObject* arg, double& a_value) {
+  if (PyFloat_CheckExact(arg)) {
+    a_value = PyFloat_AsDouble(arg);
+    return true;
+  }
+  if (PyLong_CheckExact(arg)) {
+    a_value = PyLong_AsDouble(arg);
+    if (a_value == -1.0 && PyErr_Occurred()) {
+      PyErr_Clear(); // overflow, the general path reports it
+      return false;
+    }
+    return true;
+  }
+  return false;
+}
+
+static Py_ssize_t parse_fast_doubles(PyObject* args, PyObject* kwds,
+				     double* a_values, const Py_ssize_t& a_max) {
+
+  if (kwds && PyDict_Size(kwds) != 0)
+    return -1;
+
+#ifdef Py_LIMITED_API
+  const Py_ssize_t n(PyTuple_Size(args));
+#else
+  const Py_ssize_t n(PyTuple_GET_SIZE(args));
+#endif
+  if (n > a_max)
+    return -1;
+
+  for (Py_ssize_t i = 0; i < n; ++i) {
+#ifdef Py_LIMITED_API
+    PyObject* arg(PyTuple_GetItem(args, i));
+#else
+    PyObject* arg(PyTuple_GET_ITEM(args, i));
+#endif
+    if (!fast_double(arg, a_values[i]))
+      return -1;
+  }
+
+  return n;
+}
+
+#ifndef Py_LIMITED_API
+static Py_ssize_t parse_fast_doubles(PyObject* const* args, const Py_ssize_t& nargs, PyObject* kwnames,
+				     double* a_values, const Py_ssize_t& a_max) {
+
+  if ((kwnames && PyTuple_GET_SIZE(kwnames) != 0) || nargs > a_max)
+    return -1;
+
+  for (Py_ssize_t i = 0; i < nargs; ++i)
+    if (!fast_double(args[i], a_values[i]))
+      return -1;
+
+  return nargs;
+}
+
+// the general path of a vectorcall constructor, tp_new then tp_init
+// as type.__call__ would
+static PyObject* vectorcall_new(PyTypeObject* type, newfunc a_new, initproc an_init,
+				PyObject* const* args, const Py_ssize_t& nargs, PyObject* kwnames) {
+
+  PyObject* a_tuple(PyTuple_New(nargs));
+  if (a_tuple == NULL)
+    return NULL;
+  for (Py_ssize_t i = 0; i < nargs; ++i)
+    PyTuple_SET_ITEM(a_tuple, i, Py_NewRef(args[i]));
+
+  PyObject* a_dict(NULL);
+  if (kwnames && PyTuple_GET_SIZE(kwnames) != 0) {
+    a_dict = PyDict_New();
+    for (Py_ssize_t i = 0; a_dict && i < PyTuple_GET_SIZE(kwnames); ++i)
+      if (PyDict_SetItem(a_dict, PyTuple_GET_ITEM(kwnames, i), args[nargs + i]) < 0)
+	Py_CLEAR(a_dict);
+    if (a_dict == NULL) {
+      Py_DECREF(a_tuple);
+      return NULL;
+    }
+  }
+
+  PyObject* self(a_new(type, a_tuple, a_dict));
+  if (self && an_init(self, a_tuple, a_dict) < 0)
+    Py_CLEAR(self);
+
+  Py_DECREF(a_tuple);
+  Py_XDECREF(a_dict);
+  return self;
+}
+#endif
+
+// METH_FASTCALL methods check their positional count like
+// PyArg_UnpackTuple.
+
+static int check_nargs(const char* a_name, const Py_ssize_t& nargs, const Py_ssize_t& an_expected) {
+  if (nargs != an_expected) {
+    PyErr_Format(PyExc_TypeError, "%s expected %zd argument%s, got %zd",
+		 a_name, an_expected, an_expected == 1 ? "" : "s", nargs);
+    return -1;
+  }
+  return 0;
+}
+
+// ----- buffers for the batch functions -----
+
+// The batch functions take any C contiguous buffer of float64, e.g. a
+// numpy array or an array of ctypes.c_double, with out copying it.
+// Vectors are packed x, y, z, i.e. (n, 3) arrays.
+
+static char sValuesStr[] = "values";
+static char sOutStr[] = "out";
+static char sAStr[] = "a";
+static char sBStr[] = "b";
+static char sAngleStr[] = "angle";
+static char sBeginStr[] = "begin";
+static char sEndStr[] = "end";
+
+template <typename T>
+class TypedBuffer {
+  // Py_buffer of float64 (or int64) released when it goes out of scope.
+public:
+  TypedBuffer() : m_is_valid(false) {}
+  ~TypedBuffer() {if (m_is_valid) PyBuffer_Release(&m_view);}
+
+  int get(coords_state* st, PyObject* an_object, const int& a_flags);
+
+  T*         data() const {return static_cast<T*>(m_view.buf);}
+  Py_ssize_t size() const {return m_view.len/sizeof(T);}
+
+  // C contiguous views always have a shape.
+  int        ndim() const {return m_view.ndim;}
+  Py_ssize_t shape(const int& i) const {return m_view.shape[i];}
+
+private:
+  TypedBuffer(const TypedBuffer&);
+  TypedBuffer& operator=(const TypedBuffer&);
+
+  static bool isFormat(const char* a_format);
+  static const char* typeName();
+
+  Py_buffer m_view;
+  bool      m_is_valid;
+};
+
+typedef TypedBuffer<double>  DoubleBuffer;
+typedef TypedBuffer<int64_t> Int64Buffer;
+
+template <> bool TypedBuffer<double>::isFormat(const char* a_format) {return strcmp(a_format, "d") == 0;}
+template <> const char* TypedBuffer<double>::typeName() {return "float64";}
+
+// numpy int64 is "l" on LP64 and "q" on Windows, ctypes.c_int64 either.
+template <> bool TypedBuffer<int64_t>::isFormat(const char* a_format) {
+  return strcmp(a_format, "q") == 0 || strcmp(a_format, "l") == 0;
+}
+template <> const char* TypedBuffer<int64_t>::typeName() {return "int64";}
+
+template <typename T>
+int TypedBuffer<T>::get(coords_state* st, PyObject* an_object, const int& a_flags) {
+
+  if (PyObject_GetBuffer(an_object, &m_view, a_flags | PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) < 0) {
+    PyErr_Clear();
+    std::string emsg(std::string("arg must be a C contiguous buffer of ") + typeName());
+    PyErr_SetString(st->Error, emsg.c_str());
+    return -1;
+  }
+  m_is_valid = true;
+
+  // struct module format, ctypes uses explicit byte order.
+  const char* a_format(m_view.format ? m_view.format : "B");
+#ifdef WORDS_BIGENDIAN
+  if (*a_format == '@' || *a_format == '=' || *a_format == '>' || *a_format == '!')
+    ++a_format;
+#else
+  if (*a_format == '@' || *a_format == '=' || *a_format == '<')
+    ++a_format;
+#endif
+
+  if (m_view.itemsize != sizeof(T) || !isFormat(a_format)) {
+    std::string emsg(std::string("arg must be a buffer of ") + typeName());
+    PyErr_SetString(st->Error, emsg.c_str());
+    return -1;
+  }
+
+  return 0;
+}
+
+static PyObject* new_double_array(coords_state* st, const Py_ssize_t& a_rows, const Py_ssize_t& a_columns,
+				  const char* a_dtype="float64") {
+  // numpy.empty((a_rows, a_columns)) or numpy.empty(a_rows) for one column.
+  // numpy is only imported when the caller does not pass out.
+
+  if (st->numpy_empty == NULL) {
+    PyObject* numpy(PyImport_ImportModule("numpy"));
+    if (numpy == NULL) {
+      PyErr_Clear();
+      PyErr_SetString(st->Error, "numpy is not available, use the out argument");
+      return NULL;
+    }
+    st->numpy_empty = PyObject_GetAttrString(numpy, "empty");
+    Py_DECREF(numpy);
+    if (st->numpy_empty == NULL)
+      return NULL;
+  }
+
+  PyObject* shape(a_columns == 1 ?
+		  Py_BuildValue("(n)", a_rows) :
+		  Py_BuildValue("(nn)", a_rows, a_columns));
+  if (shape == NULL)
+    return NULL;
+
+  PyObject* result(PyObject_CallFunction(st->numpy_empty, "Os", shape, a_dtype));
+  Py_DECREF(shape);
+  return result;
+}
+
+static PyObject* get_batch_output(coords_state* st, PyObject* out,
+				  const Py_ssize_t& a_rows,
+				  const Py_ssize_t& a_columns,
+				  DoubleBuffer& a_buffer) {
+  // Returns a new reference to out, or a new array if out is NULL,
+  // with a_buffer holding its data.
+
+  PyObject* result(out);
+  if (result)
+    Py_INCREF(result);
+  else
+    result = new_double_array(st, a_rows, a_columns);
+
+  if (result == NULL)
+    return NULL;
+
+  if (a_buffer.get(st, result, PyBUF_WRITABLE) < 0) {
+    Py_DECREF(result);
+    return NULL;
+  }
+
+  if (a_buffer.size() != a_rows*a_columns) {
+    PyErr_SetString(st->Error, "out is the wrong size");
+    Py_DECREF(result);
+    return NULL;
+  }
+
+  return result;
+}
+
+static int get_batch_rows(coords_state* st, const DoubleBuffer& a_buffer, const Py_ssize_t& a_columns, Py_ssize_t& a_rows) {
+  if (a_buffer.size() % a_columns != 0) {
+    PyErr_SetString(st->Error, "buffer size must be a multiple of 3");
+    return -1;
+  }
+  a_rows = a_buffer.size()/a_columns;
+  return 0;
+}
+
+// ----- freelists -----
+
+// Like the CPython float freelist, deallocated objects of the exact
+// coords types are kept for reuse instead of going back to
+// PyObject_Free, so the arithmetic operators do not hit the allocator
+// for every result. Subclass instances are not pooled. Only touched
+// with the GIL held.
+
+static PyObject* freelist_new(FreeList& a_list, PyTypeObject* a_type) {
+  // Returns a new a_type object with its C++ member not constructed,
+  // the caller does that with placement new.
+  if (a_list.m_size == 0)
+    return PyObject_New(PyObject, a_type);
+  PyObject* self(a_list.m_objects[--a_list.m_size]);
+  return PyObject_Init(self, a_type);
+}
+
+static void freelist_free(FreeList& a_list, PyTypeObject* a_type, PyObject* self) {
+  // The caller has already destroyed the C++ member. Instances of heap
+  // types own a reference to their type, released pooled or not.
+  // PyObject_Init takes it again on reuse.
+  PyTypeObject* its_type(Py_TYPE(self));
+  if (its_type == a_type && a_list.m_size < sFreeListLimit)
+    a_list.m_objects[a_list.m_size++] = self;
+  else
+    ((freefunc)PyType_GetSlot(its_type, Py_tp_free))(self);
+  Py_DECREF(its_type);
+}
+
+static void freelist_clear(FreeList& a_list) {
+  // The types were released in freelist_free.
+  while (a_list.m_size > 0)
+    PyObject_Free(a_list.m_objects[--a_list.m_size]);
+}
+
+// ----- pickle -----
+
+// The coords values pickle as (type(self), (), record), where record
+// is their fixed layout binary record from libCoords, e.g.
+// Coords::angle2binary(), and __setstate__() reads it back. Smaller
+// and faster than a str() round trip for multiprocessing.
+
+PyDoc_STRVAR(coords_reduce__doc__, "Returns (type, (), binary record) for pickle and copy");
+PyDoc_STRVAR(coords_setstate__doc__, "Restores the object from the binary record made by __reduce__");
+
+static PyObject* reduce_binary(PyObject* self, const char* a_record, const size_t& a_size) {
+  PyObject* state(PyBytes_FromStringAndSize(a_record, a_size));
+  if (state == NULL)
+    return NULL;
+  return Py_BuildValue("(O()N)", (PyObject*)Py_TYPE(self), state);
+}
+
+static const char* get_binary_state(coords_state* st, PyObject* state, const size_t& a_size) {
+  if (!PyBytes_Check(state) || (size_t)PyBytes_Size(state) != a_size) {
+    PyErr_Format(st->Error, "__setstate__ arg must be %zu bytes", a_size);
+    return NULL;
+  }
+  return PyBytes_AsString(state);
+}
+
 
 // =================
 // ===== Angle =====
@@ -220,12 +644,25 @@ int parse_double_arg(PyObject* arg, double& val) {
 // ------------------------
 
 static PyObject* Angle_new(PyTypeObject* type, PyObject* args, PyObject* kwds) {
+  coords_state* st(get_type_state(type));
   Angle* self(NULL);
-  self = (Angle*)type->tp_alloc(type, 0);
+  if (type == st->AngleType)
+    self = (Angle*)freelist_new(st->AngleFreeList, type);
+  else
+    self = (Angle*)((allocfunc)PyType_GetSlot(type, Py_tp_alloc))(type, 0);
+  if (self)
+    new (&self->m_angle) Coords::angle();
   return (PyObject*)self;
 }
 
 static int Angle_init(Angle* self, PyObject* args, PyObject* kwds) {
+  coords_state* st(get_state((PyObject*)self));
+
+  double dms[3] = {0, 0, 0};
+  if (parse_fast_doubles(args, kwds, dms, 3) >= 0) {
+    self->m_angle.value(Coords::degrees2seconds(dms[0], dms[1], dms[2])/3600);
+    return 0;
+  }
 
   static char* kwlist[] = {sDegreeStr, sMinuteStr, sSecondStr, NULL};
 
@@ -243,28 +680,28 @@ static int Angle_init(Angle* self, PyObject* args, PyObject* kwds) {
   if (arg0) {
 
     // copy constructor
-    if (is_AngleType(arg0)) {
+    if (is_AngleType(st, arg0)) {
       self->m_angle.value(((Angle*)arg0)->m_angle.value());
       return 0;
 
-    } else if (PyFloat_Check(arg0) || PyInt_Check(arg0)) {
+    } else if (PyFloat_Check(arg0) || PyLong_Check(arg0)) {
       degrees = PyFloat_AsDouble(arg0);
 
-    } else if (PyString_Check(arg0)) {
-      PyErr_SetString(sCoordsException, "Direct conversion from string is not supported. Use float(arg).");
+    } else if (PyUnicode_Check(arg0)) {
+      PyErr_SetString(st->Error, "Direct conversion from string is not supported. Use float(arg).");
       return -1;
 
     } else {
-      PyErr_SetString(sCoordsException, "arg0 must be an angle, int or float");
+      PyErr_SetString(st->Error, "arg0 must be an angle, int or float");
       return -1;
     }
 
   }
 
-  if (parse_double_arg(arg1, minutes))
+  if (parse_double_arg(st, arg1, minutes))
       return -1;
 
-  if (parse_double_arg(arg2, seconds))
+  if (parse_double_arg(st, arg2, seconds))
       return -1;
 
   self->m_angle.value(Coords::degrees2seconds(degrees, minutes, seconds)/3600);
@@ -273,9 +710,27 @@ static int Angle_init(Angle* self, PyObject* args, PyObject* kwds) {
 
 }
 
+#ifndef Py_LIMITED_API
+static PyObject* Angle_vectorcall(PyObject* type, PyObject* const* args, size_t nargsf, PyObject* kwnames) {
+  const Py_ssize_t nargs(PyVectorcall_NARGS(nargsf));
+
+  double dms[3] = {0, 0, 0};
+  if (parse_fast_doubles(args, nargs, kwnames, dms, 3) >= 0) {
+    Angle* self((Angle*)Angle_new((PyTypeObject*)type, NULL, NULL));
+    if (self)
+      self->m_angle.value(Coords::degrees2seconds(dms[0], dms[1], dms[2])/3600);
+    return (PyObject*)self;
+  }
+
+  return vectorcall_new((PyTypeObject*)type, Angle_new, (initproc)Angle_init, args, nargs, kwnames);
+}
+#endif
+
 
 static void Angle_dealloc(Angle* self) {
-  self->ob_type->tp_free((PyObject*)self);
+  coords_state* st(get_state((PyObject*)self));
+  self->m_angle.~angle();
+  freelist_free(st->AngleFreeList, st->AngleType, (PyObject*)self);
 }
 
 // -----------------
@@ -286,7 +741,7 @@ PyObject* Angle_str(PyObject* self) {
   std::stringstream result;
   result.precision(sPrintPrecision);
   result << ((Angle*)self)->m_angle;
-  return PyString_FromString(result.str().c_str());
+  return PyUnicode_FromString(result.str().c_str());
 }
 
 // TODO a different repr? for constructor?
@@ -294,7 +749,7 @@ PyObject* Angle_repr(PyObject* self) {
   std::stringstream result;
   result.precision(sPrintPrecision);
   result << ((Angle*)self)->m_angle;
-  return PyString_FromString(result.str().c_str());
+  return PyUnicode_FromString(result.str().c_str());
 }
 
 // -------------------------------
@@ -308,14 +763,15 @@ static PyObject* Angle_getValue(Angle* self, void* closure) {
 }
 
 static int Angle_setValue(Angle* self, PyObject* value, void* closure) {
+  coords_state* st(get_state((PyObject*)self));
 
   if (value == NULL) {
-    PyErr_SetString(sCoordsException, "can not delete value");
+    PyErr_SetString(st->Error, "can not delete value");
     return -1;
   }
 
-  if (!PyFloat_Check(value) && !PyInt_Check(value)) {
-    PyErr_SetString(sCoordsException, "value must be a float or int");
+  if (!PyFloat_Check(value) && !PyLong_Check(value)) {
+    PyErr_SetString(st->Error, "value must be a float or int");
     return -1;
   }
 
@@ -331,14 +787,15 @@ static PyObject* Angle_getRadians(Angle* self, void* closure) {
 }
 
 static int Angle_setRadians(Angle* self, PyObject* radians, void* closure) {
+  coords_state* st(get_state((PyObject*)self));
 
   if (radians == NULL) {
-    PyErr_SetString(sCoordsException, "can not delete radians");
+    PyErr_SetString(st->Error, "can not delete radians");
     return -1;
   }
 
-  if (!PyFloat_Check(radians) && !PyInt_Check(radians)) {
-    PyErr_SetString(sCoordsException, "radians must be a float or int");
+  if (!PyFloat_Check(radians) && !PyLong_Check(radians)) {
+    PyErr_SetString(st->Error, "radians must be a float or int");
     return -1;
   }
 
@@ -351,9 +808,10 @@ static int Angle_setRadians(Angle* self, PyObject* radians, void* closure) {
 // ----- methods -----
 // -------------------
 
-static PyObject* normalize(PyObject* o1, PyObject* o2) {
+static PyObject* normalize(PyObject* o1, PyObject* const* args, Py_ssize_t nargs) {
+  coords_state* st(get_state(o1));
 
-  if (!is_AngleType(o1)) {
+  if (!is_AngleType(st, o1)) {
     // TODO coords.Error?
     Py_INCREF(Py_NotImplemented);
     return Py_NotImplemented;
@@ -361,10 +819,14 @@ static PyObject* normalize(PyObject* o1, PyObject* o2) {
 
   // TODO kwlist?
 
-  double begin(0);
-  double end(0);
+  if (check_nargs("normalize", nargs, 2))
+    return NULL;
 
-  if (!PyArg_ParseTuple(o2, "dd", &begin, &end))
+  double begin(PyFloat_AsDouble(args[0]));
+  if (begin == -1.0 && PyErr_Occurred())
+    return NULL;
+  double end(PyFloat_AsDouble(args[1]));
+  if (end == -1.0 && PyErr_Occurred())
     return NULL;
 
   ((Angle*)o1)->m_angle.normalize(begin, end);
@@ -375,8 +837,9 @@ static PyObject* normalize(PyObject* o1, PyObject* o2) {
 }
 
 static PyObject* complement(PyObject* o1) {
+  coords_state* st(get_state(o1));
 
-  if (!is_AngleType(o1)) {
+  if (!is_AngleType(st, o1)) {
     // TODO coords.Error?
     Py_INCREF(Py_NotImplemented);
     return Py_NotImplemented;
@@ -384,10 +847,10 @@ static PyObject* complement(PyObject* o1) {
 
   Angle* result_angle(NULL);
 
-  new_AngleType(&result_angle);
+  new_AngleType(st, &result_angle);
 
   if (result_angle == NULL) {
-    PyErr_SetString(sCoordsException, "add failed to create coord.angle");
+    PyErr_SetString(st->Error, "add failed to create coord.angle");
     return NULL;
   }
 
@@ -402,8 +865,9 @@ static PyObject* complement(PyObject* o1) {
 
 
 static PyObject* Angle_nb_add(PyObject* o1, PyObject* o2) {
+  coords_state* st(get_state2(o1, o2));
 
-  if (!is_AngleType(o1) || !is_AngleType(o2)) {
+  if (!is_AngleType(st, o1) || !is_AngleType(st, o2)) {
     // TODO coords.Error?
     Py_INCREF(Py_NotImplemented);
     return Py_NotImplemented;
@@ -411,10 +875,10 @@ static PyObject* Angle_nb_add(PyObject* o1, PyObject* o2) {
 
   Angle* result_angle(NULL);
 
-  new_AngleType(&result_angle);
+  new_AngleType(st, &result_angle);
 
   if (result_angle == NULL) {
-    PyErr_SetString(sCoordsException, "add failed to create coord.angle");
+    PyErr_SetString(st->Error, "add failed to create coord.angle");
     return NULL;
   }
 
@@ -427,18 +891,19 @@ static PyObject* Angle_nb_add(PyObject* o1, PyObject* o2) {
 
 
 static PyObject* Angle_nb_subtract(PyObject* o1, PyObject* o2) {
+  coords_state* st(get_state2(o1, o2));
 
-  if (!is_AngleType(o1) || !is_AngleType(o2)) {
+  if (!is_AngleType(st, o1) || !is_AngleType(st, o2)) {
     Py_INCREF(Py_NotImplemented);
     return Py_NotImplemented;
   }
 
   Angle* result_angle(NULL);
 
-  new_AngleType(&result_angle);
+  new_AngleType(st, &result_angle);
 
   if (result_angle == NULL) {
-    PyErr_SetString(sCoordsException, "subtract failed to create coord.angle");
+    PyErr_SetString(st->Error, "subtract failed to create coord.angle");
     return NULL;
   }
 
@@ -451,19 +916,20 @@ static PyObject* Angle_nb_subtract(PyObject* o1, PyObject* o2) {
 
 
 static PyObject* Angle_nb_negative(PyObject* o1) {
+  coords_state* st(get_state(o1));
   // Unitary minus
 
-  if (!is_AngleType(o1)) {
+  if (!is_AngleType(st, o1)) {
     Py_INCREF(Py_NotImplemented);
     return Py_NotImplemented;
   }
 
   Angle* result_angle(NULL);
 
-  new_AngleType(&result_angle);
+  new_AngleType(st, &result_angle);
 
   if (result_angle == NULL) {
-    PyErr_SetString(sCoordsException, "negative failed to create coord.angle");
+    PyErr_SetString(st->Error, "negative failed to create coord.angle");
     return NULL;
   }
 
@@ -476,19 +942,20 @@ static PyObject* Angle_nb_negative(PyObject* o1) {
 
 
 static PyObject* Angle_nb_multiply(PyObject* o1, PyObject* o2) {
+  coords_state* st(get_state2(o1, o2));
 
   // TODO support o2 as double?
 
-  if (!is_AngleType(o1) || !is_AngleType(o2)) {
+  if (!is_AngleType(st, o1) || !is_AngleType(st, o2)) {
     Py_INCREF(Py_NotImplemented);
     return Py_NotImplemented;
   }
 
   Angle* result_angle(NULL);
-  new_AngleType(&result_angle);
+  new_AngleType(st, &result_angle);
 
   if (result_angle == NULL) {
-    PyErr_SetString(sCoordsException, "multiply failed to create coord.angle");
+    PyErr_SetString(st->Error, "multiply failed to create coord.angle");
     return NULL;
   }
 
@@ -498,27 +965,29 @@ static PyObject* Angle_nb_multiply(PyObject* o1, PyObject* o2) {
 }
 
 
-static PyObject* Angle_nb_divide(PyObject* o1, PyObject* o2) {
+static PyObject* Angle_nb_true_divide(PyObject* o1, PyObject* o2) {
+  coords_state* st(get_state2(o1, o2));
 
   // TODO support o2 as double?
 
-  if (!is_AngleType(o1) || !is_AngleType(o2)) {
+  if (!is_AngleType(st, o1) || !is_AngleType(st, o2)) {
     Py_INCREF(Py_NotImplemented);
     return Py_NotImplemented;
   }
 
   Angle* result_angle(NULL);
-  new_AngleType(&result_angle);
+  new_AngleType(st, &result_angle);
 
   if (result_angle == NULL) {
-    PyErr_SetString(sCoordsException, "divide failed to create coord.angle");
+    PyErr_SetString(st->Error, "divide failed to create coord.angle");
     return NULL;
   }
 
   try {
     result_angle->m_angle = ((Angle*)o1)->m_angle / ((Angle*)o2)->m_angle;
   } catch (Coords::Error err) {
-    PyErr_SetString(sCoordsException, err.what());
+    PyErr_SetString(st->Error, err.what());
+    Py_DECREF(result_angle);
     return NULL;
   }
 
@@ -527,8 +996,9 @@ static PyObject* Angle_nb_divide(PyObject* o1, PyObject* o2) {
 
 
 static PyObject* Angle_tp_richcompare(PyObject* o1, PyObject* o2, int op) {
+  coords_state* st(get_state2(o1, o2));
 
-  if (!is_AngleType(o1) || !is_AngleType(o2)) {
+  if (!is_AngleType(st, o1) || !is_AngleType(st, o2)) {
     Py_INCREF(Py_NotImplemented);
     return Py_NotImplemented;
   }
@@ -536,44 +1006,44 @@ static PyObject* Angle_tp_richcompare(PyObject* o1, PyObject* o2, int op) {
   if (op == Py_LT) {
 
     if (((Angle*)o1)->m_angle < ((Angle*)o2)->m_angle)
-      return Py_True;
+      Py_RETURN_TRUE;
     else
-      return Py_False;
+      Py_RETURN_FALSE;
 
   } else if (op == Py_LE) {
 
     if (((Angle*)o1)->m_angle <= ((Angle*)o2)->m_angle)
-      return Py_True;
+      Py_RETURN_TRUE;
     else
-      return Py_False;
+      Py_RETURN_FALSE;
 
   } else if (op == Py_EQ) {
 
     if (((Angle*)o1)->m_angle == ((Angle*)o2)->m_angle)
-      return Py_True;
+      Py_RETURN_TRUE;
     else
-      return Py_False;
+      Py_RETURN_FALSE;
 
   } else if (op == Py_NE) {
 
     if (((Angle*)o1)->m_angle != ((Angle*)o2)->m_angle)
-      return Py_True;
+      Py_RETURN_TRUE;
     else
-      return Py_False;
+      Py_RETURN_FALSE;
 
   } else if (op == Py_GT) {
 
     if (((Angle*)o1)->m_angle > ((Angle*)o2)->m_angle)
-      return Py_True;
+      Py_RETURN_TRUE;
     else
-      return Py_False;
+      Py_RETURN_FALSE;
 
   } else if (op == Py_GE) {
 
     if (((Angle*)o1)->m_angle >= ((Angle*)o2)->m_angle)
-      return Py_True;
+      Py_RETURN_TRUE;
     else
-      return Py_False;
+      Py_RETURN_FALSE;
 
   } else {
 
@@ -589,50 +1059,54 @@ static PyObject* Angle_tp_richcompare(PyObject* o1, PyObject* o2, int op) {
 // ---------------------------
 
 static PyObject* Angle_nb_inplace_add(PyObject* o1, PyObject* o2) {
+  coords_state* st(get_state(o1));
   // TODO o1 is implicitly always angleType?
   // TODO support o2 as double?
-  if (is_AngleType(o1) && is_AngleType(o2)) {
+  if (is_AngleType(st, o1) && is_AngleType(st, o2)) {
     ((Angle*)o1)->m_angle.operator+=(((Angle*)o2)->m_angle);
     Py_INCREF(o1);
     return o1;
   }
-  PyErr_SetString(sCoordsException, "angle::operator+=() only supports angle types");
+  PyErr_SetString(st->Error, "angle::operator+=() only supports angle types");
   return NULL;
 }
 
 static PyObject* Angle_nb_inplace_subtract(PyObject* o1, PyObject* o2) {
+  coords_state* st(get_state(o1));
   // TODO o1 is implicitly always angleType?
   // TODO support o2 as double?
-  if (is_AngleType(o1) && is_AngleType(o2)) {
+  if (is_AngleType(st, o1) && is_AngleType(st, o2)) {
     ((Angle*)o1)->m_angle.operator-=(((Angle*)o2)->m_angle);
     Py_INCREF(o1);
     return o1;
   }
-  PyErr_SetString(sCoordsException, "angle::operator-=() only supports angle types");
+  PyErr_SetString(st->Error, "angle::operator-=() only supports angle types");
   return NULL;
 }
 
 static PyObject* Angle_nb_inplace_multiply(PyObject* o1, PyObject* o2) {
+  coords_state* st(get_state(o1));
   // TODO o1 is implicitly always angleType?
   // TODO support o2 as double?
-  if (is_AngleType(o1) && is_AngleType(o2)) {
+  if (is_AngleType(st, o1) && is_AngleType(st, o2)) {
     ((Angle*)o1)->m_angle.operator*=(((Angle*)o2)->m_angle);
     Py_INCREF(o1);
     return o1;
   }
-  PyErr_SetString(sCoordsException, "angle::operator*=() only supports angle types");
+  PyErr_SetString(st->Error, "angle::operator*=() only supports angle types");
   return NULL;
 }
 
-static PyObject* Angle_nb_inplace_divide(PyObject* o1, PyObject* o2) {
+static PyObject* Angle_nb_inplace_true_divide(PyObject* o1, PyObject* o2) {
+  coords_state* st(get_state(o1));
   // TODO o1 is implicitly always angleType?
   // TODO support o2 as double?
-  if (is_AngleType(o1) && is_AngleType(o2)) {
+  if (is_AngleType(st, o1) && is_AngleType(st, o2)) {
     ((Angle*)o1)->m_angle.operator/=(((Angle*)o2)->m_angle);
     Py_INCREF(o1);
     return o1;
   }
-  PyErr_SetString(sCoordsException, "angle::operator/=() only supports angle types");
+  PyErr_SetString(st->Error, "angle::operator/=() only supports angle types");
   return NULL;
 }
 
@@ -645,22 +1119,43 @@ static PyObject* Angle_nb_inplace_divide(PyObject* o1, PyObject* o2) {
 
 // ----- deg2rad -----
 
-static PyObject* deg2rad(PyObject* self, PyObject *args) {
-  double radians(0);
-  if (!PyArg_ParseTuple(args, "d", &radians))
+static PyObject* deg2rad(PyObject* self, PyObject* const* args, Py_ssize_t nargs) {
+  if (check_nargs("deg2rad", nargs, 1))
+    return NULL;
+  double radians(PyFloat_AsDouble(args[0]));
+  if (radians == -1.0 && PyErr_Occurred())
     return NULL;
   double degrees = Coords::angle::deg2rad(radians);
-  return (PyObject*)  Py_BuildValue("d", degrees);
+  return (PyObject*)  PyFloat_FromDouble(degrees);
 }
 
 // ----- rad2deg -----
 
-static PyObject* rad2deg(PyObject* self, PyObject *args) {
-  double radians(0);
-  if (!PyArg_ParseTuple(args, "d", &radians))
+static PyObject* rad2deg(PyObject* self, PyObject* const* args, Py_ssize_t nargs) {
+  if (check_nargs("rad2deg", nargs, 1))
+    return NULL;
+  double radians(PyFloat_AsDouble(args[0]));
+  if (radians == -1.0 && PyErr_Occurred())
     return NULL;
   double degrees = Coords::angle::rad2deg(radians);
-  return (PyObject*)  Py_BuildValue("d", degrees);
+  return (PyObject*)  PyFloat_FromDouble(degrees);
+}
+
+// ----- pickle -----
+
+static PyObject* Angle_reduce(PyObject* self, PyObject* args) {
+  char a_record[Coords::angle_binary_size];
+  Coords::angle2binary(&((Angle*)self)->m_angle, a_record, 1);
+  return reduce_binary(self, a_record, sizeof(a_record));
+}
+
+static PyObject* Angle_setstate(PyObject* self, PyObject* state) {
+  coords_state* st(get_state(self));
+  const char* a_record(get_binary_state(st, state, Coords::angle_binary_size));
+  if (a_record == NULL)
+    return NULL;
+  Coords::binary2angle(a_record, &((Angle*)self)->m_angle, 1);
+  Py_RETURN_NONE;
 }
 
 // --------------------------
@@ -673,18 +1168,16 @@ PyDoc_STRVAR(coords_normalize__doc__, "normalizes the value to given range");
 PyDoc_STRVAR(coords_complement__doc__, "returns the complement of the angle");
 
 static PyMethodDef Angle_methods[] = {
-  {"deg2rad", (PyCFunction) deg2rad, METH_VARARGS, coords_deg2rad__doc__},
-  {"rad2deg", (PyCFunction) rad2deg, METH_VARARGS, coords_rad2deg__doc__},
-  {"normalize", (PyCFunction) normalize, METH_VARARGS, coords_normalize__doc__},
-  {"complement", (PyCFunction) complement, METH_VARARGS, coords_complement__doc__},
+  {"deg2rad", (PyCFunction)(void(*)(void)) deg2rad, METH_FASTCALL, coords_deg2rad__doc__},
+  {"rad2deg", (PyCFunction)(void(*)(void)) rad2deg, METH_FASTCALL, coords_rad2deg__doc__},
+  {"normalize", (PyCFunction)(void(*)(void)) normalize, METH_FASTCALL, coords_normalize__doc__},
+  {"complement", (PyCFunction) complement, METH_NOARGS, coords_complement__doc__},
+  {"__reduce__", (PyCFunction) Angle_reduce, METH_NOARGS, coords_reduce__doc__},
+  {"__setstate__", (PyCFunction) Angle_setstate, METH_O, coords_setstate__doc__},
   {NULL}  /* Sentinel */
 };
 
 
-static PyMemberDef Angle_members[] = {
-  {NULL}  /* Sentinel */
-};
-
 static PyGetSetDef Angle_getseters[] = {
   {sValueStr, (getter)Angle_getValue, (setter)Angle_setValue, sValueStr, NULL},
   {sRadiansStr, (getter)Angle_getRadians, (setter)Angle_setRadians, sRadiansStr, NULL},
@@ -692,108 +1185,49 @@ static PyGetSetDef Angle_getseters[] = {
 };
 
 
-// see http://docs.python.org/c-api/typeobj.html
-static PyNumberMethods Angle_as_number = {
-  (binaryfunc) Angle_nb_add,
-  (binaryfunc) Angle_nb_subtract,
-  (binaryfunc) Angle_nb_multiply,
-  (binaryfunc) Angle_nb_divide,
-  (binaryfunc) 0,  // nb_remainder
-  (binaryfunc) 0,  // nb_divmod
-  (ternaryfunc) 0, // nb_power
-  (unaryfunc) Angle_nb_negative,
-  (unaryfunc) 0,   // nb_positive
-  (unaryfunc) 0,   // nb_absolute
-  (inquiry) 0,     // nb_nonzero. Used by PyObject_IsTrue.
-  (unaryfunc) 0,   // nb_invert
-  (binaryfunc) 0,  // nb_lshift
-  (binaryfunc) 0,  // nb_rshift
-  (binaryfunc) 0,  // nb_and
-  (binaryfunc) 0,  // nb_xor
-  (binaryfunc) 0,  // nb_or
-  (coercion) 0,    // Used by the coerce() function
-  (unaryfunc) 0,   // nb_int
-  (unaryfunc) 0,   // nb_long
-  (unaryfunc) 0,   // nb_float
-  (unaryfunc) 0,   // nb_oct
-  (unaryfunc) 0,   // nb_hex
-
-  // added in release 2.0
-
-  (binaryfunc) Angle_nb_inplace_add,
-  (binaryfunc) Angle_nb_inplace_subtract,
-  (binaryfunc) Angle_nb_inplace_multiply,
-  (binaryfunc) Angle_nb_inplace_divide,
-  (binaryfunc) 0,  // nb_inplace_remainder
-  (ternaryfunc) 0, // nb_inplace_power
-  (binaryfunc) 0,  // nb_inplace_lshift
-  (binaryfunc) 0,  // nb_inplace_rshift
-  (binaryfunc) 0,  // nb_inplace_and
-  (binaryfunc) 0,  // nb_inplace_xor
-  (binaryfunc) 0,  // nb_inplace_or
-
-  // added in release 2.2
-  (binaryfunc) 0,  // nb_floor_divide
-  (binaryfunc) 0,  // nb_true_divide
-  (binaryfunc) 0,  // nb_inplace_floor_divide
-  (binaryfunc) 0,  // nb_inplace_true_divide
-
+static PyType_Slot Angle_slots[] = {
+  {Py_tp_dealloc,             (void*) Angle_dealloc},
+  {Py_tp_repr,                (void*) Angle_repr},
+  {Py_tp_str,                 (void*) Angle_str},
+  {Py_tp_doc,                 (void*) "angle objects"},
+  {Py_tp_richcompare,         (void*) Angle_tp_richcompare},
+  {Py_tp_methods,             (void*) Angle_methods},
+  {Py_tp_getset,              (void*) Angle_getseters},
+  {Py_tp_init,                (void*) Angle_init},
+  {Py_tp_new,                 (void*) Angle_new},
+  {Py_nb_add,                 (void*) Angle_nb_add},
+  {Py_nb_subtract,            (void*) Angle_nb_subtract},
+  {Py_nb_multiply,            (void*) Angle_nb_multiply},
+  {Py_nb_true_divide,         (void*) Angle_nb_true_divide},
+  {Py_nb_negative,            (void*) Angle_nb_negative},
+  {Py_nb_inplace_add,         (void*) Angle_nb_inplace_add},
+  {Py_nb_inplace_subtract,    (void*) Angle_nb_inplace_subtract},
+  {Py_nb_inplace_multiply,    (void*) Angle_nb_inplace_multiply},
+  {Py_nb_inplace_true_divide, (void*) Angle_nb_inplace_true_divide},
+  {0, NULL}  /* Sentinel */
 };
 
-
-PyTypeObject AngleType = {
-  PyObject_HEAD_INIT(NULL)
-  0,                                 /* ob_size */
-  "angle",                           /* tp_name */
-  sizeof(Angle),                     /* tp_basicsize */
-  0,                                 /* tp_itemsize */
-  (destructor) Angle_dealloc,        /* tp_dealloc */
-  0,                                 /* tp_print */
-  0,                                 /* tp_getattr */
-  0,                                 /* tp_setattr */
-  0,                                 /* tp_compare */
-  Angle_repr,                        /* tp_repr */
-  &Angle_as_number,                  /* tp_as_number */
-  0,                                 /* tp_as_sequence */
-  0,                                 /* tp_as_mapping */
-  0,                                 /* tp_hash */
-  0,                                 /* tp_call */
-  Angle_str,                         /* tp_str */
-  0,                                 /* tp_getattro */
-  0,                                 /* tp_setattro */
-  0,                                 /* tp_as_buffer */
-  Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE | Py_TPFLAGS_CHECKTYPES, /* tp_flags */
-  "angle objects",                   /* tp_doc */
-  0,                                 /* tp_traverse */
-  0,                                 /* tp_clear */
-  Angle_tp_richcompare,              /* tp_richcompare */
-  0,                                 /* tp_weaklistoffset */
-  0,                                 /* tp_iter */
-  0,                                 /* tp_iternext */
-  Angle_methods,                     /* tp_methods */
-  Angle_members,                     /* tp_members */
-  Angle_getseters,                   /* tp_getset */
-  0,                                 /* tp_base */
-  0,                                 /* tp_dict */
-  0,                                 /* tp_descr_get */
-  0,                                 /* tp_descr_set */
-  0,                                 /* tp_dictoffset */
-  (initproc)Angle_init,              /* tp_init */
-  0,                                 /* tp_alloc */
-  Angle_new,                         /* tp_new */
+static PyType_Spec Angle_spec = {
+  "coords.angle",                   /* name */
+  sizeof(Angle),                    /* basicsize */
+  0,                                /* itemsize */
+  Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE | Py_TPFLAGS_IMMUTABLETYPE, /* flags */
+  Angle_slots                       /* slots */
 };
 
 // ------------------------------------------
 // ----- implement forward declarations -----
 // ------------------------------------------
 
-static void new_AngleType(Angle** an_angle) {
-  *an_angle = PyObject_New(Angle, &AngleType);
+static void new_AngleType(coords_state* st, Angle** an_angle) {
+  *an_angle = (Angle*)freelist_new(st->AngleFreeList, st->AngleType);
+  if (*an_angle)
+    new (&(*an_angle)->m_angle) Coords::angle();
 }
 
-static int is_AngleType(PyObject* an_angle) {
+static int is_AngleType(coords_state* st, PyObject* an_angle) {
   //wrapper for type check
-  return PyObject_TypeCheck(an_angle, &AngleType);
+  return PyObject_TypeCheck(an_angle, st->AngleType);
 }
 
 
@@ -806,12 +1240,19 @@ static int is_AngleType(PyObject* an_angle) {
 // ------------------------
 
 static PyObject* Latitude_new(PyTypeObject* type, PyObject* args, PyObject* kwds) {
+  coords_state* st(get_type_state(type));
   Latitude* self(NULL);
-  self = (Latitude*)type->tp_alloc(type, 0);
+  if (type == st->LatitudeType)
+    self = (Latitude*)freelist_new(st->LatitudeFreeList, type);
+  else
+    self = (Latitude*)((allocfunc)PyType_GetSlot(type, Py_tp_alloc))(type, 0);
+  if (self)
+    new (&self->m_angle) Coords::Latitude();
   return (PyObject*)self;
 }
 
 static int Latitude_init(Latitude* self, PyObject* args, PyObject* kwds) {
+  coords_state* st(get_state((PyObject*)self));
 
   static char* kwlist[] = {sDegreeStr, sMinuteStr, sSecondStr, NULL};
 
@@ -829,31 +1270,37 @@ static int Latitude_init(Latitude* self, PyObject* args, PyObject* kwds) {
   if (arg0) {
 
     // copy constructor
-    if (is_LatitudeType(arg0)) {
+    if (is_LatitudeType(st, arg0)) {
       self->m_angle.value(((Latitude*)arg0)->m_angle.value());
       return 0;
 
-    } else if (PyFloat_Check(arg0) || PyInt_Check(arg0)) {
+    } else if (PyFloat_Check(arg0) || PyLong_Check(arg0)) {
       degrees = PyFloat_AsDouble(arg0);
 
-    } else if (PyString_Check(arg0)) {
-      PyErr_SetString(sCoordsException, "Direct conversion from string is not supported. Use float(arg).");
+    } else if (PyUnicode_Check(arg0)) {
+      PyErr_SetString(st->Error, "Direct conversion from string is not supported. Use float(arg).");
       return -1;
 
     } else {
-      PyErr_SetString(sCoordsException, "arg0 must be an int or float");
+      PyErr_SetString(st->Error, "arg0 must be an int or float");
       return -1;
     }
 
   }
 
-  if (parse_double_arg(arg1, minutes))
+  if (parse_double_arg(st, arg1, minutes))
       return -1;
 
-  if (parse_double_arg(arg2, seconds))
+  if (parse_double_arg(st, arg2, seconds))
       return -1;
 
-  self->m_angle.value(Coords::degrees2seconds(degrees, minutes, seconds)/3600);
+  // the range checked constructor
+  try {
+    self->m_angle = Coords::Latitude(degrees, minutes, seconds);
+  } catch (const Coords::Error& err) {
+    PyErr_SetString(st->Error, err.what());
+    return -1;
+  }
 
   return 0;
 
@@ -861,7 +1308,9 @@ static int Latitude_init(Latitude* self, PyObject* args, PyObject* kwds) {
 
 
 static void Latitude_dealloc(Latitude* self) {
-  self->ob_type->tp_free((PyObject*)self);
+  coords_state* st(get_state((PyObject*)self));
+  self->m_angle.~Latitude();
+  freelist_free(st->LatitudeFreeList, st->LatitudeType, (PyObject*)self);
 }
 
 // -----------------
@@ -872,7 +1321,7 @@ PyObject* Latitude_str(PyObject* self) {
   std::stringstream result;
   result.precision(sPrintPrecision);
   result << ((Latitude*)self)->m_angle;
-  return PyString_FromString(result.str().c_str());
+  return PyUnicode_FromString(result.str().c_str());
 }
 
 // TODO a different repr? for constructor?
@@ -880,7 +1329,7 @@ PyObject* Latitude_repr(PyObject* self) {
   std::stringstream result;
   result.precision(sPrintPrecision);
   result << ((Latitude*)self)->m_angle;
-  return PyString_FromString(result.str().c_str());
+  return PyUnicode_FromString(result.str().c_str());
 }
 
 // -------------------------------
@@ -894,14 +1343,15 @@ static PyObject* Latitude_getValue(Latitude* self, void* closure) {
 }
 
 static int Latitude_setValue(Latitude* self, PyObject* value, void* closure) {
+  coords_state* st(get_state((PyObject*)self));
 
   if (value == NULL) {
-    PyErr_SetString(sCoordsException, "can not delete value");
+    PyErr_SetString(st->Error, "can not delete value");
     return -1;
   }
 
-  if (!PyFloat_Check(value) && !PyInt_Check(value)) {
-    PyErr_SetString(sCoordsException, "value must be a float or int");
+  if (!PyFloat_Check(value) && !PyLong_Check(value)) {
+    PyErr_SetString(st->Error, "value must be a float or int");
     return -1;
   }
 
@@ -917,14 +1367,15 @@ static PyObject* Latitude_getRadians(Latitude* self, void* closure) {
 }
 
 static int Latitude_setRadians(Latitude* self, PyObject* radians, void* closure) {
+  coords_state* st(get_state((PyObject*)self));
 
   if (radians == NULL) {
-    PyErr_SetString(sCoordsException, "can not delete radians");
+    PyErr_SetString(st->Error, "can not delete radians");
     return -1;
   }
 
-  if (!PyFloat_Check(radians) && !PyInt_Check(radians)) {
-    PyErr_SetString(sCoordsException, "radians must be a float or int");
+  if (!PyFloat_Check(radians) && !PyLong_Check(radians)) {
+    PyErr_SetString(st->Error, "radians must be a float or int");
     return -1;
   }
 
@@ -939,19 +1390,20 @@ static int Latitude_setRadians(Latitude* self, PyObject* radians, void* closure)
 
 
 static PyObject* Latitude_nb_add(PyObject* o1, PyObject* o2) {
+  coords_state* st(get_state2(o1, o2));
   // TODO support o2 as angle? double?
 
-  if (!is_LatitudeType(o1) || !is_LatitudeType(o2)) {
+  if (!is_LatitudeType(st, o1) || !is_LatitudeType(st, o2)) {
     Py_INCREF(Py_NotImplemented);
     return Py_NotImplemented;
   }
 
   Angle* result_angle(NULL); // switches to Angle
 
-  new_AngleType(&result_angle);
+  new_AngleType(st, &result_angle);
 
   if (result_angle == NULL) {
-    PyErr_SetString(sCoordsException, "add failed to create coord.angle");
+    PyErr_SetString(st->Error, "add failed to create coord.angle");
     return NULL;
   }
 
@@ -964,19 +1416,20 @@ static PyObject* Latitude_nb_add(PyObject* o1, PyObject* o2) {
 
 
 static PyObject* Latitude_nb_subtract(PyObject* o1, PyObject* o2) {
+  coords_state* st(get_state2(o1, o2));
   // TODO support o2 as angle? double?
 
-  if (!is_LatitudeType(o1) || !is_LatitudeType(o2)) {
+  if (!is_LatitudeType(st, o1) || !is_LatitudeType(st, o2)) {
     Py_INCREF(Py_NotImplemented);
     return Py_NotImplemented;
   }
 
   Angle* result_angle(NULL); // switches to Angle
 
-  new_AngleType(&result_angle);
+  new_AngleType(st, &result_angle);
 
   if (result_angle == NULL) {
-    PyErr_SetString(sCoordsException, "subtract failed to create coord.angle");
+    PyErr_SetString(st->Error, "subtract failed to create coord.angle");
     return NULL;
   }
 
@@ -989,19 +1442,20 @@ static PyObject* Latitude_nb_subtract(PyObject* o1, PyObject* o2) {
 
 
 static PyObject* Latitude_nb_negative(PyObject* o1) {
+  coords_state* st(get_state(o1));
   // Unitary minus
 
-  if (!is_LatitudeType(o1)) {
+  if (!is_LatitudeType(st, o1)) {
     Py_INCREF(Py_NotImplemented);
     return Py_NotImplemented;
   }
 
   Angle* result_angle(NULL); // switches to Angle
 
-  new_AngleType(&result_angle);
+  new_AngleType(st, &result_angle);
 
   if (result_angle == NULL) {
-    PyErr_SetString(sCoordsException, "negative failed to create coord.angle");
+    PyErr_SetString(st->Error, "negative failed to create coord.angle");
     return NULL;
   }
 
@@ -1014,18 +1468,19 @@ static PyObject* Latitude_nb_negative(PyObject* o1) {
 
 
 static PyObject* Latitude_nb_multiply(PyObject* o1, PyObject* o2) {
+  coords_state* st(get_state2(o1, o2));
   // TODO support o2 as angle? double?
 
-  if (!is_LatitudeType(o1) || !is_LatitudeType(o2)) {
+  if (!is_LatitudeType(st, o1) || !is_LatitudeType(st, o2)) {
     Py_INCREF(Py_NotImplemented);
     return Py_NotImplemented;
   }
 
   Angle* result_angle(NULL); // switches to Angle
-  new_AngleType(&result_angle);
+  new_AngleType(st, &result_angle);
 
   if (result_angle == NULL) {
-    PyErr_SetString(sCoordsException, "multiply failed to create coord.angle");
+    PyErr_SetString(st->Error, "multiply failed to create coord.angle");
     return NULL;
   }
 
@@ -1035,26 +1490,28 @@ static PyObject* Latitude_nb_multiply(PyObject* o1, PyObject* o2) {
 }
 
 
-static PyObject* Latitude_nb_divide(PyObject* o1, PyObject* o2) {
+static PyObject* Latitude_nb_true_divide(PyObject* o1, PyObject* o2) {
+  coords_state* st(get_state2(o1, o2));
   // TODO support o2 as angle? double?
 
-  if (!is_LatitudeType(o1) || !is_LatitudeType(o2)) {
+  if (!is_LatitudeType(st, o1) || !is_LatitudeType(st, o2)) {
     Py_INCREF(Py_NotImplemented);
     return Py_NotImplemented;
   }
 
   Angle* result_angle(NULL); // switches to Angle
-  new_AngleType(&result_angle);
+  new_AngleType(st, &result_angle);
 
   if (result_angle == NULL) {
-    PyErr_SetString(sCoordsException, "divide failed to create coord.angle");
+    PyErr_SetString(st->Error, "divide failed to create coord.angle");
     return NULL;
   }
 
   try {
     result_angle->m_angle = ((Latitude*)o1)->m_angle / ((Latitude*)o2)->m_angle;
-  } catch (Coords::Error err) {
-    PyErr_SetString(sCoordsException, err.what());
+  } catch (const Coords::Error& err) {
+    PyErr_SetString(st->Error, err.what());
+    Py_DECREF(result_angle);
     return NULL;
   }
 
@@ -1063,8 +1520,9 @@ static PyObject* Latitude_nb_divide(PyObject* o1, PyObject* o2) {
 
 
 static PyObject* Latitude_tp_richcompare(PyObject* o1, PyObject* o2, int op) {
+  coords_state* st(get_state2(o1, o2));
 
-  if (!is_LatitudeType(o1) || !is_LatitudeType(o2)) {
+  if (!is_LatitudeType(st, o1) || !is_LatitudeType(st, o2)) {
     Py_INCREF(Py_NotImplemented);
     return Py_NotImplemented;
   }
@@ -1072,44 +1530,44 @@ static PyObject* Latitude_tp_richcompare(PyObject* o1, PyObject* o2, int op) {
   if (op == Py_LT) {
 
     if (((Latitude*)o1)->m_angle < ((Latitude*)o2)->m_angle)
-      return Py_True;
+      Py_RETURN_TRUE;
     else
-      return Py_False;
+      Py_RETURN_FALSE;
 
   } else if (op == Py_LE) {
 
     if (((Latitude*)o1)->m_angle <= ((Latitude*)o2)->m_angle)
-      return Py_True;
+      Py_RETURN_TRUE;
     else
-      return Py_False;
+      Py_RETURN_FALSE;
 
   } else if (op == Py_EQ) {
 
     if (((Latitude*)o1)->m_angle == ((Latitude*)o2)->m_angle)
-      return Py_True;
+      Py_RETURN_TRUE;
     else
-      return Py_False;
+      Py_RETURN_FALSE;
 
   } else if (op == Py_NE) {
 
     if (((Latitude*)o1)->m_angle != ((Latitude*)o2)->m_angle)
-      return Py_True;
+      Py_RETURN_TRUE;
     else
-      return Py_False;
+      Py_RETURN_FALSE;
 
   } else if (op == Py_GT) {
 
     if (((Latitude*)o1)->m_angle > ((Latitude*)o2)->m_angle)
-      return Py_True;
+      Py_RETURN_TRUE;
     else
-      return Py_False;
+      Py_RETURN_FALSE;
 
   } else if (op == Py_GE) {
 
     if (((Latitude*)o1)->m_angle >= ((Latitude*)o2)->m_angle)
-      return Py_True;
+      Py_RETURN_TRUE;
     else
-      return Py_False;
+      Py_RETURN_FALSE;
 
   } else {
 
@@ -1125,62 +1583,81 @@ static PyObject* Latitude_tp_richcompare(PyObject* o1, PyObject* o2, int op) {
 // ---------------------------
 
 static PyObject* Latitude_nb_inplace_add(PyObject* o1, PyObject* o2) {
+  coords_state* st(get_state(o1));
   // TODO support o2 as angle? double?
-  if (is_LatitudeType(o1) && is_LatitudeType(o2)) {
+  if (is_LatitudeType(st, o1) && is_LatitudeType(st, o2)) {
     ((Latitude*)o1)->m_angle.operator+=(((Latitude*)o2)->m_angle);
     Py_INCREF(o1);
     return o1;
   }
-  PyErr_SetString(sCoordsException, "Latitude::operator+=() only supports Latitude types");
+  PyErr_SetString(st->Error, "Latitude::operator+=() only supports Latitude types");
   return NULL;
 }
 
 static PyObject* Latitude_nb_inplace_subtract(PyObject* o1, PyObject* o2) {
+  coords_state* st(get_state(o1));
   // TODO support o2 as angle? double?
-  if (is_LatitudeType(o1) && is_LatitudeType(o2)) {
+  if (is_LatitudeType(st, o1) && is_LatitudeType(st, o2)) {
     ((Latitude*)o1)->m_angle.operator-=(((Latitude*)o2)->m_angle);
     Py_INCREF(o1);
     return o1;
   }
-  PyErr_SetString(sCoordsException, "Latitude::operator-=() only supports Latitude types");
+  PyErr_SetString(st->Error, "Latitude::operator-=() only supports Latitude types");
   return NULL;
 }
 
 static PyObject* Latitude_nb_inplace_multiply(PyObject* o1, PyObject* o2) {
+  coords_state* st(get_state(o1));
   // TODO support o2 as angle? double?
-  if (is_LatitudeType(o1) && is_LatitudeType(o2)) {
+  if (is_LatitudeType(st, o1) && is_LatitudeType(st, o2)) {
     ((Latitude*)o1)->m_angle.operator*=(((Latitude*)o2)->m_angle);
     Py_INCREF(o1);
     return o1;
   }
-  PyErr_SetString(sCoordsException, "Latitude::operator*=() only supports Latitude types");
+  PyErr_SetString(st->Error, "Latitude::operator*=() only supports Latitude types");
   return NULL;
 }
 
-static PyObject* Latitude_nb_inplace_divide(PyObject* o1, PyObject* o2) {
+static PyObject* Latitude_nb_inplace_true_divide(PyObject* o1, PyObject* o2) {
+  coords_state* st(get_state(o1));
   // TODO support o2 as angle? double?
-  if (is_LatitudeType(o1) && is_LatitudeType(o2)) {
+  if (is_LatitudeType(st, o1) && is_LatitudeType(st, o2)) {
     ((Latitude*)o1)->m_angle.operator/=(((Latitude*)o2)->m_angle);
     Py_INCREF(o1);
     return o1;
   }
-  PyErr_SetString(sCoordsException, "Latitude::operator/=() only supports Latitude types");
+  PyErr_SetString(st->Error, "Latitude::operator/=() only supports Latitude types");
   return NULL;
 }
 
+// ----- pickle -----
+
+static PyObject* Latitude_reduce(PyObject* self, PyObject* args) {
+  char a_record[Coords::angle_binary_size];
+  Coords::angle2binary(&((Latitude*)self)->m_angle, a_record, 1);
+  return reduce_binary(self, a_record, sizeof(a_record));
+}
+
+static PyObject* Latitude_setstate(PyObject* self, PyObject* state) {
+  coords_state* st(get_state(self));
+  const char* a_record(get_binary_state(st, state, Coords::angle_binary_size));
+  if (a_record == NULL)
+    return NULL;
+  Coords::binary2angle(a_record, &((Latitude*)self)->m_angle, 1);
+  Py_RETURN_NONE;
+}
+
 // --------------------------
 // ----- Python structs -----
 // --------------------------
 
 static PyMethodDef Latitude_methods[] = {
+  {"__reduce__", (PyCFunction) Latitude_reduce, METH_NOARGS, coords_reduce__doc__},
+  {"__setstate__", (PyCFunction) Latitude_setstate, METH_O, coords_setstate__doc__},
   {NULL}  /* Sentinel */
 };
 
 
-static PyMemberDef Latitude_members[] = {
-  {NULL}  /* Sentinel */
-};
-
 static PyGetSetDef Latitude_getseters[] = {
   {sValueStr, (getter)Latitude_getValue, (setter)Latitude_setValue, sValueStr, NULL},
   {sRadiansStr, (getter)Latitude_getRadians, (setter)Latitude_setRadians, sRadiansStr, NULL},
@@ -1188,108 +1665,49 @@ static PyGetSetDef Latitude_getseters[] = {
 };
 
 
-// see http://docs.python.org/c-api/typeobj.html
-static PyNumberMethods Latitude_as_number = {
-  (binaryfunc) Latitude_nb_add,
-  (binaryfunc) Latitude_nb_subtract,
-  (binaryfunc) Latitude_nb_multiply,
-  (binaryfunc) Latitude_nb_divide,
-  (binaryfunc) 0,  // nb_remainder
-  (binaryfunc) 0,  // nb_divmod
-  (ternaryfunc) 0, // nb_power
-  (unaryfunc) Latitude_nb_negative,
-  (unaryfunc) 0,   // nb_positive
-  (unaryfunc) 0,   // nb_absolute
-  (inquiry) 0,     // nb_nonzero. Used by PyObject_IsTrue.
-  (unaryfunc) 0,   // nb_invert
-  (binaryfunc) 0,  // nb_lshift
-  (binaryfunc) 0,  // nb_rshift
-  (binaryfunc) 0,  // nb_and
-  (binaryfunc) 0,  // nb_xor
-  (binaryfunc) 0,  // nb_or
-  (coercion) 0,    // Used by the coerce() function
-  (unaryfunc) 0,   // nb_int
-  (unaryfunc) 0,   // nb_long
-  (unaryfunc) 0,   // nb_float
-  (unaryfunc) 0,   // nb_oct
-  (unaryfunc) 0,   // nb_hex
-
-  // added in release 2.0
-
-  (binaryfunc) Latitude_nb_inplace_add,
-  (binaryfunc) Latitude_nb_inplace_subtract,
-  (binaryfunc) Latitude_nb_inplace_multiply,
-  (binaryfunc) Latitude_nb_inplace_divide,
-  (binaryfunc) 0,  // nb_inplace_remainder
-  (ternaryfunc) 0, // nb_inplace_power
-  (binaryfunc) 0,  // nb_inplace_lshift
-  (binaryfunc) 0,  // nb_inplace_rshift
-  (binaryfunc) 0,  // nb_inplace_and
-  (binaryfunc) 0,  // nb_inplace_xor
-  (binaryfunc) 0,  // nb_inplace_or
-
-  // added in release 2.2
-  (binaryfunc) 0,  // nb_floor_divide
-  (binaryfunc) 0,  // nb_true_divide
-  (binaryfunc) 0,  // nb_inplace_floor_divide
-  (binaryfunc) 0,  // nb_inplace_true_divide
-
+static PyType_Slot Latitude_slots[] = {
+  {Py_tp_dealloc,             (void*) Latitude_dealloc},
+  {Py_tp_repr,                (void*) Latitude_repr},
+  {Py_tp_str,                 (void*) Latitude_str},
+  {Py_tp_doc,                 (void*) "Latitude objects"},
+  {Py_tp_richcompare,         (void*) Latitude_tp_richcompare},
+  {Py_tp_methods,             (void*) Latitude_methods},
+  {Py_tp_getset,              (void*) Latitude_getseters},
+  {Py_tp_init,                (void*) Latitude_init},
+  {Py_tp_new,                 (void*) Latitude_new},
+  {Py_nb_add,                 (void*) Latitude_nb_add},
+  {Py_nb_subtract,            (void*) Latitude_nb_subtract},
+  {Py_nb_multiply,            (void*) Latitude_nb_multiply},
+  {Py_nb_true_divide,         (void*) Latitude_nb_true_divide},
+  {Py_nb_negative,            (void*) Latitude_nb_negative},
+  {Py_nb_inplace_add,         (void*) Latitude_nb_inplace_add},
+  {Py_nb_inplace_subtract,    (void*) Latitude_nb_inplace_subtract},
+  {Py_nb_inplace_multiply,    (void*) Latitude_nb_inplace_multiply},
+  {Py_nb_inplace_true_divide, (void*) Latitude_nb_inplace_true_divide},
+  {0, NULL}  /* Sentinel */
 };
 
-
-PyTypeObject LatitudeType = {
-  PyObject_HEAD_INIT(NULL)
-  0,                                 /* ob_size */
-  "Latitude",                           /* tp_name */
-  sizeof(Latitude),                     /* tp_basicsize */
-  0,                                 /* tp_itemsize */
-  (destructor) Latitude_dealloc,        /* tp_dealloc */
-  0,                                 /* tp_print */
-  0,                                 /* tp_getattr */
-  0,                                 /* tp_setattr */
-  0,                                 /* tp_compare */
-  Latitude_repr,                        /* tp_repr */
-  &Latitude_as_number,                  /* tp_as_number */
-  0,                                 /* tp_as_sequence */
-  0,                                 /* tp_as_mapping */
-  0,                                 /* tp_hash */
-  0,                                 /* tp_call */
-  Latitude_str,                         /* tp_str */
-  0,                                 /* tp_getattro */
-  0,                                 /* tp_setattro */
-  0,                                 /* tp_as_buffer */
-  Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE | Py_TPFLAGS_CHECKTYPES, /* tp_flags */
-  "Latitude objects",                   /* tp_doc */
-  0,                                 /* tp_traverse */
-  0,                                 /* tp_clear */
-  Latitude_tp_richcompare,              /* tp_richcompare */
-  0,                                 /* tp_weaklistoffset */
-  0,                                 /* tp_iter */
-  0,                                 /* tp_iternext */
-  Latitude_methods,                     /* tp_methods */
-  Latitude_members,                     /* tp_members */
-  Latitude_getseters,                   /* tp_getset */
-  0,                                 /* tp_base */
-  0,                                 /* tp_dict */
-  0,                                 /* tp_descr_get */
-  0,                                 /* tp_descr_set */
-  0,                                 /* tp_dictoffset */
-  (initproc)Latitude_init,              /* tp_init */
-  0,                                 /* tp_alloc */
-  Latitude_new,                         /* tp_new */
+static PyType_Spec Latitude_spec = {
+  "coords.latitude",                /* name */
+  sizeof(Latitude),                 /* basicsize */
+  0,                                /* itemsize */
+  Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE | Py_TPFLAGS_IMMUTABLETYPE, /* flags */
+  Latitude_slots                    /* slots */
 };
 
 // ------------------------------------------
 // ----- implement forward declarations -----
 // ------------------------------------------
 
-static void new_LatitudeType(Latitude** an_angle) {
-  *an_angle = PyObject_New(Latitude, &LatitudeType);
+static void new_LatitudeType(coords_state* st, Latitude** an_angle) {
+  *an_angle = (Latitude*)freelist_new(st->LatitudeFreeList, st->LatitudeType);
+  if (*an_angle)
+    new (&(*an_angle)->m_angle) Coords::Latitude();
 }
 
-static int is_LatitudeType(PyObject* an_angle) {
+static int is_LatitudeType(coords_state* st, PyObject* an_angle) {
   //wrapper for type check
-  return PyObject_TypeCheck(an_angle, &LatitudeType);
+  return PyObject_TypeCheck(an_angle, st->LatitudeType);
 }
 
 
@@ -1304,12 +1722,19 @@ static int is_LatitudeType(PyObject* an_angle) {
 // ------------------------
 
 static PyObject* Declination_new(PyTypeObject* type, PyObject* args, PyObject* kwds) {
+  coords_state* st(get_type_state(type));
   Declination* self(NULL);
-  self = (Declination*)type->tp_alloc(type, 0);
+  if (type == st->DeclinationType)
+    self = (Declination*)freelist_new(st->DeclinationFreeList, type);
+  else
+    self = (Declination*)((allocfunc)PyType_GetSlot(type, Py_tp_alloc))(type, 0);
+  if (self)
+    new (&self->m_angle) Coords::Declination();
   return (PyObject*)self;
 }
 
 static int Declination_init(Declination* self, PyObject* args, PyObject* kwds) {
+  coords_state* st(get_state((PyObject*)self));
 
   static char* kwlist[] = {sDegreeStr, sMinuteStr, sSecondStr, NULL};
 
@@ -1327,31 +1752,37 @@ static int Declination_init(Declination* self, PyObject* args, PyObject* kwds) {
   if (arg0) {
 
     // copy constructor
-    if (is_DeclinationType(arg0)) {
+    if (is_DeclinationType(st, arg0)) {
       self->m_angle.value(((Declination*)arg0)->m_angle.value());
       return 0;
 
-    } else if (PyFloat_Check(arg0) || PyInt_Check(arg0)) {
+    } else if (PyFloat_Check(arg0) || PyLong_Check(arg0)) {
       degrees = PyFloat_AsDouble(arg0);
 
-    } else if (PyString_Check(arg0)) {
-      PyErr_SetString(sCoordsException, "Direct conversion from string is not supported. Use float(arg).");
+    } else if (PyUnicode_Check(arg0)) {
+      PyErr_SetString(st->Error, "Direct conversion from string is not supported. Use float(arg).");
       return -1;
 
     } else {
-      PyErr_SetString(sCoordsException, "arg0 must be an int or float");
+      PyErr_SetString(st->Error, "arg0 must be an int or float");
       return -1;
     }
 
   }
 
-  if (parse_double_arg(arg1, minutes))
+  if (parse_double_arg(st, arg1, minutes))
       return -1;
 
-  if (parse_double_arg(arg2, seconds))
+  if (parse_double_arg(st, arg2, seconds))
       return -1;
 
-  self->m_angle.value(Coords::degrees2seconds(degrees, minutes, seconds)/3600);
+  // the range checked constructor
+  try {
+    self->m_angle = Coords::Declination(degrees, minutes, seconds);
+  } catch (Coords::Error err) {
+    PyErr_SetString(st->Error, err.what());
+    return -1;
+  }
 
   return 0;
 
@@ -1359,7 +1790,9 @@ static int Declination_init(Declination* self, PyObject* args, PyObject* kwds) {
 
 
 static void Declination_dealloc(Declination* self) {
-  self->ob_type->tp_free((PyObject*)self);
+  coords_state* st(get_state((PyObject*)self));
+  self->m_angle.~Declination();
+  freelist_free(st->DeclinationFreeList, st->DeclinationType, (PyObject*)self);
 }
 
 // -----------------
@@ -1370,7 +1803,7 @@ PyObject* Declination_str(PyObject* self) {
   std::stringstream result;
   result.precision(sPrintPrecision);
   result << ((Declination*)self)->m_angle;
-  return PyString_FromString(result.str().c_str());
+  return PyUnicode_FromString(result.str().c_str());
 }
 
 // TODO a different repr? for constructor?
@@ -1378,7 +1811,7 @@ PyObject* Declination_repr(PyObject* self) {
   std::stringstream result;
   result.precision(sPrintPrecision);
   result << ((Declination*)self)->m_angle;
-  return PyString_FromString(result.str().c_str());
+  return PyUnicode_FromString(result.str().c_str());
 }
 
 // -------------------------------
@@ -1392,14 +1825,15 @@ static PyObject* Declination_getValue(Declination* self, void* closure) {
 }
 
 static int Declination_setValue(Declination* self, PyObject* value, void* closure) {
+  coords_state* st(get_state((PyObject*)self));
 
   if (value == NULL) {
-    PyErr_SetString(sCoordsException, "can not delete value");
+    PyErr_SetString(st->Error, "can not delete value");
     return -1;
   }
 
-  if (!PyFloat_Check(value) && !PyInt_Check(value)) {
-    PyErr_SetString(sCoordsException, "value must be a float or int");
+  if (!PyFloat_Check(value) && !PyLong_Check(value)) {
+    PyErr_SetString(st->Error, "value must be a float or int");
     return -1;
   }
 
@@ -1415,14 +1849,15 @@ static PyObject* Declination_getRadians(Declination* self, void* closure) {
 }
 
 static int Declination_setRadians(Declination* self, PyObject* radians, void* closure) {
+  coords_state* st(get_state((PyObject*)self));
 
   if (radians == NULL) {
-    PyErr_SetString(sCoordsException, "can not delete radians");
+    PyErr_SetString(st->Error, "can not delete radians");
     return -1;
   }
 
-  if (!PyFloat_Check(radians) && !PyInt_Check(radians)) {
-    PyErr_SetString(sCoordsException, "radians must be a float or int");
+  if (!PyFloat_Check(radians) && !PyLong_Check(radians)) {
+    PyErr_SetString(st->Error, "radians must be a float or int");
     return -1;
   }
 
@@ -1437,19 +1872,20 @@ static int Declination_setRadians(Declination* self, PyObject* radians, void* cl
 
 
 static PyObject* Declination_nb_add(PyObject* o1, PyObject* o2) {
+  coords_state* st(get_state2(o1, o2));
   // TODO support o2 as angle? double?
 
-  if (!is_DeclinationType(o1) || !is_DeclinationType(o2)) {
+  if (!is_DeclinationType(st, o1) || !is_DeclinationType(st, o2)) {
     Py_INCREF(Py_NotImplemented);
     return Py_NotImplemented;
   }
 
   Angle* result_angle(NULL); // switches to Angle
 
-  new_AngleType(&result_angle);
+  new_AngleType(st, &result_angle);
 
   if (result_angle == NULL) {
-    PyErr_SetString(sCoordsException, "add failed to create coord.angle");
+    PyErr_SetString(st->Error, "add failed to create coord.angle");
     return NULL;
   }
 
@@ -1462,19 +1898,20 @@ static PyObject* Declination_nb_add(PyObject* o1, PyObject* o2) {
 
 
 static PyObject* Declination_nb_subtract(PyObject* o1, PyObject* o2) {
+  coords_state* st(get_state2(o1, o2));
   // TODO support o2 as angle? double?
 
-  if (!is_DeclinationType(o1) || !is_DeclinationType(o2)) {
+  if (!is_DeclinationType(st, o1) || !is_DeclinationType(st, o2)) {
     Py_INCREF(Py_NotImplemented);
     return Py_NotImplemented;
   }
 
   Angle* result_angle(NULL); // switches to Angle
 
-  new_AngleType(&result_angle);
+  new_AngleType(st, &result_angle);
 
   if (result_angle == NULL) {
-    PyErr_SetString(sCoordsException, "subtract failed to create coord.angle");
+    PyErr_SetString(st->Error, "subtract failed to create coord.angle");
     return NULL;
   }
 
@@ -1487,19 +1924,20 @@ static PyObject* Declination_nb_subtract(PyObject* o1, PyObject* o2) {
 
 
 static PyObject* Declination_nb_negative(PyObject* o1) {
+  coords_state* st(get_state(o1));
   // Unitary minus
 
-  if (!is_DeclinationType(o1)) {
+  if (!is_DeclinationType(st, o1)) {
     Py_INCREF(Py_NotImplemented);
     return Py_NotImplemented;
   }
 
   Angle* result_angle(NULL); // switches to Angle
 
-  new_AngleType(&result_angle);
+  new_AngleType(st, &result_angle);
 
   if (result_angle == NULL) {
-    PyErr_SetString(sCoordsException, "negative failed to create coord.angle");
+    PyErr_SetString(st->Error, "negative failed to create coord.angle");
     return NULL;
   }
 
@@ -1512,18 +1950,19 @@ static PyObject* Declination_nb_negative(PyObject* o1) {
 
 
 static PyObject* Declination_nb_multiply(PyObject* o1, PyObject* o2) {
+  coords_state* st(get_state2(o1, o2));
   // TODO support o2 as angle? double?
 
-  if (!is_DeclinationType(o1) || !is_DeclinationType(o2)) {
+  if (!is_DeclinationType(st, o1) || !is_DeclinationType(st, o2)) {
     Py_INCREF(Py_NotImplemented);
     return Py_NotImplemented;
   }
 
   Angle* result_angle(NULL); // switches to Angle
-  new_AngleType(&result_angle);
+  new_AngleType(st, &result_angle);
 
   if (result_angle == NULL) {
-    PyErr_SetString(sCoordsException, "multiply failed to create coord.angle");
+    PyErr_SetString(st->Error, "multiply failed to create coord.angle");
     return NULL;
   }
 
@@ -1533,26 +1972,28 @@ static PyObject* Declination_nb_multiply(PyObject* o1, PyObject* o2) {
 }
 
 
-static PyObject* Declination_nb_divide(PyObject* o1, PyObject* o2) {
+static PyObject* Declination_nb_true_divide(PyObject* o1, PyObject* o2) {
+  coords_state* st(get_state2(o1, o2));
   // TODO support o2 as angle? double?
 
-  if (!is_DeclinationType(o1) || !is_DeclinationType(o2)) {
+  if (!is_DeclinationType(st, o1) || !is_DeclinationType(st, o2)) {
     Py_INCREF(Py_NotImplemented);
     return Py_NotImplemented;
   }
 
   Angle* result_angle(NULL); // switches to Angle
-  new_AngleType(&result_angle);
+  new_AngleType(st, &result_angle);
 
   if (result_angle == NULL) {
-    PyErr_SetString(sCoordsException, "divide failed to create coord.angle");
+    PyErr_SetString(st->Error, "divide failed to create coord.angle");
     return NULL;
   }
 
   try {
     result_angle->m_angle = ((Declination*)o1)->m_angle / ((Declination*)o2)->m_angle;
   } catch (Coords::Error err) {
-    PyErr_SetString(sCoordsException, err.what());
+    PyErr_SetString(st->Error, err.what());
+    Py_DECREF(result_angle);
     return NULL;
   }
 
@@ -1561,8 +2002,9 @@ static PyObject* Declination_nb_divide(PyObject* o1, PyObject* o2) {
 
 
 static PyObject* Declination_tp_richcompare(PyObject* o1, PyObject* o2, int op) {
+  coords_state* st(get_state2(o1, o2));
 
-  if (!is_DeclinationType(o1) || !is_DeclinationType(o2)) {
+  if (!is_DeclinationType(st, o1) || !is_DeclinationType(st, o2)) {
     Py_INCREF(Py_NotImplemented);
     return Py_NotImplemented;
   }
@@ -1570,44 +2012,44 @@ static PyObject* Declination_tp_richcompare(PyObject* o1, PyObject* o2, int op)
   if (op == Py_LT) {
 
     if (((Declination*)o1)->m_angle < ((Declination*)o2)->m_angle)
-      return Py_True;
+      Py_RETURN_TRUE;
     else
-      return Py_False;
+      Py_RETURN_FALSE;
 
   } else if (op == Py_LE) {
 
     if (((Declination*)o1)->m_angle <= ((Declination*)o2)->m_angle)
-      return Py_True;
+      Py_RETURN_TRUE;
     else
-      return Py_False;
+      Py_RETURN_FALSE;
 
   } else if (op == Py_EQ) {
 
     if (((Declination*)o1)->m_angle == ((Declination*)o2)->m_angle)
-      return Py_True;
+      Py_RETURN_TRUE;
     else
-      return Py_False;
+      Py_RETURN_FALSE;
 
   } else if (op == Py_NE) {
 
     if (((Declination*)o1)->m_angle != ((Declination*)o2)->m_angle)
-      return Py_True;
+      Py_RETURN_TRUE;
     else
-      return Py_False;
+      Py_RETURN_FALSE;
 
   } else if (op == Py_GT) {
 
     if (((Declination*)o1)->m_angle > ((Declination*)o2)->m_angle)
-      return Py_True;
+      Py_RETURN_TRUE;
     else
-      return Py_False;
+      Py_RETURN_FALSE;
 
   } else if (op == Py_GE) {
 
     if (((Declination*)o1)->m_angle >= ((Declination*)o2)->m_angle)
-      return Py_True;
+      Py_RETURN_TRUE;
     else
-      return Py_False;
+      Py_RETURN_FALSE;
 
   } else {
 
@@ -1623,62 +2065,81 @@ static PyObject* Declination_tp_richcompare(PyObject* o1, PyObject* o2, int op)
 // ---------------------------
 
 static PyObject* Declination_nb_inplace_add(PyObject* o1, PyObject* o2) {
+  coords_state* st(get_state(o1));
   // TODO support o2 as angle? double?
-  if (is_DeclinationType(o1) && is_DeclinationType(o2)) {
+  if (is_DeclinationType(st, o1) && is_DeclinationType(st, o2)) {
     ((Declination*)o1)->m_angle.operator+=(((Declination*)o2)->m_angle);
     Py_INCREF(o1);
     return o1;
   }
-  PyErr_SetString(sCoordsException, "Declination::operator+=() only supports Declination types");
+  PyErr_SetString(st->Error, "Declination::operator+=() only supports Declination types");
   return NULL;
 }
 
 static PyObject* Declination_nb_inplace_subtract(PyObject* o1, PyObject* o2) {
+  coords_state* st(get_state(o1));
   // TODO support o2 as angle? double?
-  if (is_DeclinationType(o1) && is_DeclinationType(o2)) {
+  if (is_DeclinationType(st, o1) && is_DeclinationType(st, o2)) {
     ((Declination*)o1)->m_angle.operator-=(((Declination*)o2)->m_angle);
     Py_INCREF(o1);
     return o1;
   }
-  PyErr_SetString(sCoordsException, "Declination::operator-=() only supports Declination types");
+  PyErr_SetString(st->Error, "Declination::operator-=() only supports Declination types");
   return NULL;
 }
 
 static PyObject* Declination_nb_inplace_multiply(PyObject* o1, PyObject* o2) {
+  coords_state* st(get_state(o1));
   // TODO support o2 as angle? double?
-  if (is_DeclinationType(o1) && is_DeclinationType(o2)) {
+  if (is_DeclinationType(st, o1) && is_DeclinationType(st, o2)) {
     ((Declination*)o1)->m_angle.operator*=(((Declination*)o2)->m_angle);
     Py_INCREF(o1);
     return o1;
   }
-  PyErr_SetString(sCoordsException, "Declination::operator*=() only supports Declination types");
+  PyErr_SetString(st->Error, "Declination::operator*=() only supports Declination types");
   return NULL;
 }
 
-static PyObject* Declination_nb_inplace_divide(PyObject* o1, PyObject* o2) {
+static PyObject* Declination_nb_inplace_true_divide(PyObject* o1, PyObject* o2) {
+  coords_state* st(get_state(o1));
   // TODO support o2 as angle? double?
-  if (is_DeclinationType(o1) && is_DeclinationType(o2)) {
+  if (is_DeclinationType(st, o1) && is_DeclinationType(st, o2)) {
     ((Declination*)o1)->m_angle.operator/=(((Declination*)o2)->m_angle);
     Py_INCREF(o1);
     return o1;
   }
-  PyErr_SetString(sCoordsException, "Declination::operator/=() only supports Declination types");
+  PyErr_SetString(st->Error, "Declination::operator/=() only supports Declination types");
   return NULL;
 }
 
+// ----- pickle -----
+
+static PyObject* Declination_reduce(PyObject* self, PyObject* args) {
+  char a_record[Coords::angle_binary_size];
+  Coords::angle2binary(&((Declination*)self)->m_angle, a_record, 1);
+  return reduce_binary(self, a_record, sizeof(a_record));
+}
+
+static PyObject* Declination_setstate(PyObject* self, PyObject* state) {
+  coords_state* st(get_state(self));
+  const char* a_record(get_binary_state(st, state, Coords::angle_binary_size));
+  if (a_record == NULL)
+    return NULL;
+  Coords::binary2angle(a_record, &((Declination*)self)->m_angle, 1);
+  Py_RETURN_NONE;
+}
+
 // --------------------------
 // ----- Python structs -----
 // --------------------------
 
 static PyMethodDef Declination_methods[] = {
+  {"__reduce__", (PyCFunction) Declination_reduce, METH_NOARGS, coords_reduce__doc__},
+  {"__setstate__", (PyCFunction) Declination_setstate, METH_O, coords_setstate__doc__},
   {NULL}  /* Sentinel */
 };
 
 
-static PyMemberDef Declination_members[] = {
-  {NULL}  /* Sentinel */
-};
-
 static PyGetSetDef Declination_getseters[] = {
   {sValueStr, (getter)Declination_getValue, (setter)Declination_setValue, sValueStr, NULL},
   {sRadiansStr, (getter)Declination_getRadians, (setter)Declination_setRadians, sRadiansStr, NULL},
@@ -1686,108 +2147,49 @@ static PyGetSetDef Declination_getseters[] = {
 };
 
 
-// see http://docs.python.org/c-api/typeobj.html
-static PyNumberMethods Declination_as_number = {
-  (binaryfunc) Declination_nb_add,
-  (binaryfunc) Declination_nb_subtract,
-  (binaryfunc) Declination_nb_multiply,
-  (binaryfunc) Declination_nb_divide,
-  (binaryfunc) 0,  // nb_remainder
-  (binaryfunc) 0,  // nb_divmod
-  (ternaryfunc) 0, // nb_power
-  (unaryfunc) Declination_nb_negative,
-  (unaryfunc) 0,   // nb_positive
-  (unaryfunc) 0,   // nb_absolute
-  (inquiry) 0,     // nb_nonzero. Used by PyObject_IsTrue.
-  (unaryfunc) 0,   // nb_invert
-  (binaryfunc) 0,  // nb_lshift
-  (binaryfunc) 0,  // nb_rshift
-  (binaryfunc) 0,  // nb_and
-  (binaryfunc) 0,  // nb_xor
-  (binaryfunc) 0,  // nb_or
-  (coercion) 0,    // Used by the coerce() function
-  (unaryfunc) 0,   // nb_int
-  (unaryfunc) 0,   // nb_long
-  (unaryfunc) 0,   // nb_float
-  (unaryfunc) 0,   // nb_oct
-  (unaryfunc) 0,   // nb_hex
-
-  // added in release 2.0
-
-  (binaryfunc) Declination_nb_inplace_add,
-  (binaryfunc) Declination_nb_inplace_subtract,
-  (binaryfunc) Declination_nb_inplace_multiply,
-  (binaryfunc) Declination_nb_inplace_divide,
-  (binaryfunc) 0,  // nb_inplace_remainder
-  (ternaryfunc) 0, // nb_inplace_power
-  (binaryfunc) 0,  // nb_inplace_lshift
-  (binaryfunc) 0,  // nb_inplace_rshift
-  (binaryfunc) 0,  // nb_inplace_and
-  (binaryfunc) 0,  // nb_inplace_xor
-  (binaryfunc) 0,  // nb_inplace_or
-
-  // added in release 2.2
-  (binaryfunc) 0,  // nb_floor_divide
-  (binaryfunc) 0,  // nb_true_divide
-  (binaryfunc) 0,  // nb_inplace_floor_divide
-  (binaryfunc) 0,  // nb_inplace_true_divide
-
+static PyType_Slot Declination_slots[] = {
+  {Py_tp_dealloc,             (void*) Declination_dealloc},
+  {Py_tp_repr,                (void*) Declination_repr},
+  {Py_tp_str,                 (void*) Declination_str},
+  {Py_tp_doc,                 (void*) "Declination objects"},
+  {Py_tp_richcompare,         (void*) Declination_tp_richcompare},
+  {Py_tp_methods,             (void*) Declination_methods},
+  {Py_tp_getset,              (void*) Declination_getseters},
+  {Py_tp_init,                (void*) Declination_init},
+  {Py_tp_new,                 (void*) Declination_new},
+  {Py_nb_add,                 (void*) Declination_nb_add},
+  {Py_nb_subtract,            (void*) Declination_nb_subtract},
+  {Py_nb_multiply,            (void*) Declination_nb_multiply},
+  {Py_nb_true_divide,         (void*) Declination_nb_true_divide},
+  {Py_nb_negative,            (void*) Declination_nb_negative},
+  {Py_nb_inplace_add,         (void*) Declination_nb_inplace_add},
+  {Py_nb_inplace_subtract,    (void*) Declination_nb_inplace_subtract},
+  {Py_nb_inplace_multiply,    (void*) Declination_nb_inplace_multiply},
+  {Py_nb_inplace_true_divide, (void*) Declination_nb_inplace_true_divide},
+  {0, NULL}  /* Sentinel */
 };
 
-
-PyTypeObject DeclinationType = {
-  PyObject_HEAD_INIT(NULL)
-  0,                                 /* ob_size */
-  "Declination",                           /* tp_name */
-  sizeof(Declination),                     /* tp_basicsize */
-  0,                                 /* tp_itemsize */
-  (destructor) Declination_dealloc,        /* tp_dealloc */
-  0,                                 /* tp_print */
-  0,                                 /* tp_getattr */
-  0,                                 /* tp_setattr */
-  0,                                 /* tp_compare */
-  Declination_repr,                        /* tp_repr */
-  &Declination_as_number,                  /* tp_as_number */
-  0,                                 /* tp_as_sequence */
-  0,                                 /* tp_as_mapping */
-  0,                                 /* tp_hash */
-  0,                                 /* tp_call */
-  Declination_str,                         /* tp_str */
-  0,                                 /* tp_getattro */
-  0,                                 /* tp_setattro */
-  0,                                 /* tp_as_buffer */
-  Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE | Py_TPFLAGS_CHECKTYPES, /* tp_flags */
-  "Declination objects",                   /* tp_doc */
-  0,                                 /* tp_traverse */
-  0,                                 /* tp_clear */
-  Declination_tp_richcompare,              /* tp_richcompare */
-  0,                                 /* tp_weaklistoffset */
-  0,                                 /* tp_iter */
-  0,                                 /* tp_iternext */
-  Declination_methods,                     /* tp_methods */
-  Declination_members,                     /* tp_members */
-  Declination_getseters,                   /* tp_getset */
-  0,                                 /* tp_base */
-  0,                                 /* tp_dict */
-  0,                                 /* tp_descr_get */
-  0,                                 /* tp_descr_set */
-  0,                                 /* tp_dictoffset */
-  (initproc)Declination_init,              /* tp_init */
-  0,                                 /* tp_alloc */
-  Declination_new,                         /* tp_new */
+static PyType_Spec Declination_spec = {
+  "coords.declination",             /* name */
+  sizeof(Declination),              /* basicsize */
+  0,                                /* itemsize */
+  Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE | Py_TPFLAGS_IMMUTABLETYPE, /* flags */
+  Declination_slots                 /* slots */
 };
 
 // ------------------------------------------
 // ----- implement forward declarations -----
 // ------------------------------------------
 
-static void new_DeclinationType(Declination** an_angle) {
-  *an_angle = PyObject_New(Declination, &DeclinationType);
+static void new_DeclinationType(coords_state* st, Declination** an_angle) {
+  *an_angle = (Declination*)freelist_new(st->DeclinationFreeList, st->DeclinationType);
+  if (*an_angle)
+    new (&(*an_angle)->m_angle) Coords::Declination();
 }
 
-static int is_DeclinationType(PyObject* an_angle) {
+static int is_DeclinationType(coords_state* st, PyObject* an_angle) {
   //wrapper for type check
-  return PyObject_TypeCheck(an_angle, &DeclinationType);
+  return PyObject_TypeCheck(an_angle, st->DeclinationType);
 }
 
 
@@ -1800,12 +2202,25 @@ static int is_DeclinationType(PyObject* an_angle) {
 // ------------------------
 
 static PyObject* Cartesian_new(PyTypeObject* type, PyObject* args, PyObject* kwds) {
+  coords_state* st(get_type_state(type));
   Cartesian* self(NULL);
-  self = (Cartesian*)type->tp_alloc(type, 0);
+  if (type == st->CartesianType)
+    self = (Cartesian*)freelist_new(st->CartesianFreeList, type);
+  else
+    self = (Cartesian*)((allocfunc)PyType_GetSlot(type, Py_tp_alloc))(type, 0);
+  if (self)
+    new (&self->m_Cartesian) Coords::Cartesian();
   return (PyObject*)self;
 }
 
 static int Cartesian_init(Cartesian* self, PyObject* args, PyObject* kwds) {
+  coords_state* st(get_state((PyObject*)self));
+
+  double xyz[3] = {0, 0, 0};
+  if (parse_fast_doubles(args, kwds, xyz, 3) >= 0) {
+    self->m_Cartesian = Coords::Cartesian(xyz[0], xyz[1], xyz[2]);
+    return 0;
+  }
 
   static char* kwlist[] = {sXstr, sYstr, sZstr, NULL};
 
@@ -1823,14 +2238,14 @@ static int Cartesian_init(Cartesian* self, PyObject* args, PyObject* kwds) {
 
   if (arg0) {
 
-    if (is_CartesianType(arg0)) {
+    if (is_CartesianType(st, arg0)) {
       // copy constructor
       self->m_Cartesian.x(((Cartesian*)arg0)->m_Cartesian.x());
       self->m_Cartesian.y(((Cartesian*)arg0)->m_Cartesian.y());
       self->m_Cartesian.z(((Cartesian*)arg0)->m_Cartesian.z());
       return 0;
 
-    } else if (is_sphericalType(arg0)) {
+    } else if (is_sphericalType(st, arg0)) {
       // spherical conversion constructor
       Coords::Cartesian from_spherical(((spherical*)arg0)->m_spherical);
       self->m_Cartesian.x(from_spherical.x());
@@ -1838,24 +2253,24 @@ static int Cartesian_init(Cartesian* self, PyObject* args, PyObject* kwds) {
       self->m_Cartesian.z(from_spherical.z());
       return 0;
 
-    } else if (PyFloat_Check(arg0) || PyInt_Check(arg0)) {
+    } else if (PyFloat_Check(arg0) || PyLong_Check(arg0)) {
       x = PyFloat_AsDouble(arg0);
 
-    } else if (PyString_Check(arg0)) {
-      PyErr_SetString(sCoordsException, "Direct conversion from string is not supported. Use float(arg).");
+    } else if (PyUnicode_Check(arg0)) {
+      PyErr_SetString(st->Error, "Direct conversion from string is not supported. Use float(arg).");
       return -1;
 
     } else {
-      PyErr_SetString(sCoordsException, "arg0 must be a coords.Cartesian, coords.spherical, int or float");
+      PyErr_SetString(st->Error, "arg0 must be a coords.Cartesian, coords.spherical, int or float");
       return -1;
     }
 
   }
 
-  if (parse_double_arg(arg1, y))
+  if (parse_double_arg(st, arg1, y))
       return -1;
 
-  if (parse_double_arg(arg2, z))
+  if (parse_double_arg(st, arg2, z))
       return -1;
 
   self->m_Cartesian.x(x);
@@ -1866,8 +2281,26 @@ static int Cartesian_init(Cartesian* self, PyObject* args, PyObject* kwds) {
 
 }
 
+#ifndef Py_LIMITED_API
+static PyObject* Cartesian_vectorcall(PyObject* type, PyObject* const* args, size_t nargsf, PyObject* kwnames) {
+  const Py_ssize_t nargs(PyVectorcall_NARGS(nargsf));
+
+  double xyz[3] = {0, 0, 0};
+  if (parse_fast_doubles(args, nargs, kwnames, xyz, 3) >= 0) {
+    Cartesian* self((Cartesian*)Cartesian_new((PyTypeObject*)type, NULL, NULL));
+    if (self)
+      self->m_Cartesian = Coords::Cartesian(xyz[0], xyz[1], xyz[2]);
+    return (PyObject*)self;
+  }
+
+  return vectorcall_new((PyTypeObject*)type, Cartesian_new, (initproc)Cartesian_init, args, nargs, kwnames);
+}
+#endif
+
 static void Cartesian_dealloc(Cartesian* self) {
-  self->ob_type->tp_free((PyObject*)self);
+  coords_state* st(get_state((PyObject*)self));
+  self->m_Cartesian.~Cartesian();
+  freelist_free(st->CartesianFreeList, st->CartesianType, (PyObject*)self);
 }
 
 // -----------------
@@ -1880,7 +2313,7 @@ PyObject* Cartesian_str(PyObject* self) {
   std::stringstream result;
   result.precision(sPrintPrecision);
   result << ((Cartesian*)self)->m_Cartesian;
-  return PyString_FromString(result.str().c_str());
+  return PyUnicode_FromString(result.str().c_str());
 }
 
 PyObject* Cartesian_repr(PyObject* self) {
@@ -1891,7 +2324,7 @@ PyObject* Cartesian_repr(PyObject* self) {
 	 << a_Cartesian.x() << ", "
 	 << a_Cartesian.y() << ", "
 	 << a_Cartesian.z() << ")";
-  return PyString_FromString(result.str().c_str());
+  return PyUnicode_FromString(result.str().c_str());
 }
 
 // -------------------------------
@@ -1905,14 +2338,15 @@ static PyObject* Cartesian_getx(Cartesian* self, void* closure) {
 }
 
 static int Cartesian_setx(Cartesian* self, PyObject* value, void* closure) {
+  coords_state* st(get_state((PyObject*)self));
 
   if (value == NULL) {
-    PyErr_SetString(sCoordsException, "can not delete x");
+    PyErr_SetString(st->Error, "can not delete x");
     return -1;
   }
 
-  if (!PyFloat_Check(value) && !PyInt_Check(value)) {
-    PyErr_SetString(sCoordsException, "x must be a float or int");
+  if (!PyFloat_Check(value) && !PyLong_Check(value)) {
+    PyErr_SetString(st->Error, "x must be a float or int");
     return -1;
   }
 
@@ -1928,14 +2362,15 @@ static PyObject* Cartesian_gety(Cartesian* self, void* closure) {
 }
 
 static int Cartesian_sety(Cartesian* self, PyObject* value, void* closure) {
+  coords_state* st(get_state((PyObject*)self));
 
   if (value == NULL) {
-    PyErr_SetString(sCoordsException, "can not delete y");
+    PyErr_SetString(st->Error, "can not delete y");
     return -1;
   }
 
-  if (!PyFloat_Check(value) && !PyInt_Check(value)) {
-    PyErr_SetString(sCoordsException, "y must be a float or int");
+  if (!PyFloat_Check(value) && !PyLong_Check(value)) {
+    PyErr_SetString(st->Error, "y must be a float or int");
     return -1;
   }
 
@@ -1951,14 +2386,15 @@ static PyObject* Cartesian_getz(Cartesian* self, void* closure) {
 }
 
 static int Cartesian_setz(Cartesian* self, PyObject* value, void* closure) {
+  coords_state* st(get_state((PyObject*)self));
 
   if (value == NULL) {
-    PyErr_SetString(sCoordsException, "can not delete z");
+    PyErr_SetString(st->Error, "can not delete z");
     return -1;
   }
 
-  if (!PyFloat_Check(value) && !PyInt_Check(value)) {
-    PyErr_SetString(sCoordsException, "z must be a float or int");
+  if (!PyFloat_Check(value) && !PyLong_Check(value)) {
+    PyErr_SetString(st->Error, "z must be a float or int");
     return -1;
   }
 
@@ -1973,18 +2409,19 @@ static int Cartesian_setz(Cartesian* self, PyObject* value, void* closure) {
 
 
 static PyObject* Cartesian_nb_add(PyObject* o1, PyObject* o2) {
+  coords_state* st(get_state2(o1, o2));
 
-  if (!is_CartesianType(o1) || !is_CartesianType(o2)) {
+  if (!is_CartesianType(st, o1) || !is_CartesianType(st, o2)) {
     Py_INCREF(Py_NotImplemented);
     return Py_NotImplemented;
   }
 
   Cartesian* result_Cartesian(NULL);
 
-  new_CartesianType(&result_Cartesian);
+  new_CartesianType(st, &result_Cartesian);
 
   if (result_Cartesian == NULL) {
-    PyErr_SetString(sCoordsException, "add failed to create coord.Cartesian");
+    PyErr_SetString(st->Error, "add failed to create coord.Cartesian");
     return NULL;
   }
 
@@ -1998,18 +2435,19 @@ static PyObject* Cartesian_nb_add(PyObject* o1, PyObject* o2) {
 
 
 static PyObject* Cartesian_nb_subtract(PyObject* o1, PyObject* o2) {
+  coords_state* st(get_state2(o1, o2));
 
-  if (!is_CartesianType(o1) || !is_CartesianType(o2)) {
+  if (!is_CartesianType(st, o1) || !is_CartesianType(st, o2)) {
     Py_INCREF(Py_NotImplemented);
     return Py_NotImplemented;
   }
 
   Cartesian* result_Cartesian(NULL);
 
-  new_CartesianType(&result_Cartesian);
+  new_CartesianType(st, &result_Cartesian);
 
   if (result_Cartesian == NULL) {
-    PyErr_SetString(sCoordsException, "subtract failed to create coord.Cartesian");
+    PyErr_SetString(st->Error, "subtract failed to create coord.Cartesian");
     return NULL;
   }
 
@@ -2023,19 +2461,20 @@ static PyObject* Cartesian_nb_subtract(PyObject* o1, PyObject* o2) {
 
 
 static PyObject* Cartesian_nb_negative(PyObject* o1) {
+  coords_state* st(get_state(o1));
   // Unitary minus
 
-  if (!is_CartesianType(o1)) {
+  if (!is_CartesianType(st, o1)) {
     Py_INCREF(Py_NotImplemented);
     return Py_NotImplemented;
   }
 
   Cartesian* result_Cartesian(NULL);
 
-  new_CartesianType(&result_Cartesian);
+  new_CartesianType(st, &result_Cartesian);
 
   if (result_Cartesian == NULL) {
-    PyErr_SetString(sCoordsException, "unitary minus failed to create coord.Cartesian");
+    PyErr_SetString(st->Error, "unitary minus failed to create coord.Cartesian");
     return NULL;
   }
 
@@ -2048,62 +2487,65 @@ static PyObject* Cartesian_nb_negative(PyObject* o1) {
 
 
 static PyObject* Cartesian_nb_multiply(PyObject* o1, PyObject* o2) {
+  coords_state* st(get_state2(o1, o2));
 
   // This returns the dot product of the Cartesian vectors as a double
   // if o1 and o2 are both Cartesian. Returns a scaled version of o1
   // or o2 if one is Cartesian and the other double or int. Returns
   // not implemented otherwise.
 
-  if (is_CartesianType(o1) && is_CartesianType(o2)) {
+  if (is_CartesianType(st, o1) && is_CartesianType(st, o2)) {
     double a_dot_product(((Cartesian*)o1)->m_Cartesian * ((Cartesian*)o2)->m_Cartesian);
     return Py_BuildValue("d", a_dot_product);
   }
 
   Cartesian* result_Cartesian(NULL);
-  new_CartesianType(&result_Cartesian);
+  new_CartesianType(st, &result_Cartesian);
 
   if (result_Cartesian == NULL) {
-    PyErr_SetString(sCoordsException, "multiply failed to create coord.Cartesian");
+    PyErr_SetString(st->Error, "multiply failed to create coord.Cartesian");
     return NULL;
   }
 
-  if (is_CartesianType(o1) && (PyFloat_Check(o2) || PyInt_Check(o2))) {
+  if (is_CartesianType(st, o1) && (PyFloat_Check(o2) || PyLong_Check(o2))) {
     result_Cartesian->m_Cartesian = ((Cartesian*)o1)->m_Cartesian * PyFloat_AsDouble(o2);
     return (PyObject*) result_Cartesian;
   }
 
-  if ((PyFloat_Check(o1) || PyInt_Check(o1)) && is_CartesianType(o2)) {
+  if ((PyFloat_Check(o1) || PyLong_Check(o1)) && is_CartesianType(st, o2)) {
     result_Cartesian->m_Cartesian = PyFloat_AsDouble(o1) * ((Cartesian*)o2)->m_Cartesian;
     return (PyObject*) result_Cartesian;
 
   }
 
+  Py_DECREF(result_Cartesian);
   Py_INCREF(Py_NotImplemented);
   return Py_NotImplemented;
 
 }
 
 
-static PyObject* Cartesian_nb_divide(PyObject* o1, PyObject* o2) {
+static PyObject* Cartesian_nb_true_divide(PyObject* o1, PyObject* o2) {
+  coords_state* st(get_state2(o1, o2));
   // This returns a Cartesian object scaled by the divisor.  o1 must be
   // CartesianType, o2 a float or int otherwise this will raise a
   // NotImplemented error.
 
   Cartesian* result_Cartesian(NULL);
-  new_CartesianType(&result_Cartesian);
+  new_CartesianType(st, &result_Cartesian);
 
   if (result_Cartesian == NULL) {
-    PyErr_SetString(sCoordsException, "divide failed to create coord.Cartesian");
+    PyErr_SetString(st->Error, "divide failed to create coord.Cartesian");
     return NULL;
   }
 
-  if (is_CartesianType(o1) && (PyFloat_Check(o2) || PyInt_Check(o2))) {
+  if (is_CartesianType(st, o1) && (PyFloat_Check(o2) || PyLong_Check(o2))) {
 
     try {
       result_Cartesian->m_Cartesian = ((Cartesian*)o1)->m_Cartesian / PyFloat_AsDouble(o2);
     } catch (Coords::DivideByZeroError& err) {
       Py_DECREF(result_Cartesian);
-      PyErr_SetString(sCoordsException, err.what());
+      PyErr_SetString(st->Error, err.what());
       return NULL;
     }
 
@@ -2118,8 +2560,9 @@ static PyObject* Cartesian_nb_divide(PyObject* o1, PyObject* o2) {
 
 
 static PyObject* Cartesian_tp_richcompare(PyObject* o1, PyObject* o2, int op) {
+  coords_state* st(get_state2(o1, o2));
 
-  if (!is_CartesianType(o1) || !is_CartesianType(o2)) {
+  if (!is_CartesianType(st, o1) || !is_CartesianType(st, o2)) {
     Py_INCREF(Py_NotImplemented);
     return Py_NotImplemented;
   }
@@ -2127,16 +2570,16 @@ static PyObject* Cartesian_tp_richcompare(PyObject* o1, PyObject* o2, int op) {
   if (op == Py_EQ) {
 
     if (((Cartesian*)o1)->m_Cartesian == ((Cartesian*)o2)->m_Cartesian)
-      return Py_True;
+      Py_RETURN_TRUE;
     else
-      return Py_False;
+      Py_RETURN_FALSE;
 
   } else if (op == Py_NE) {
 
     if (((Cartesian*)o1)->m_Cartesian != ((Cartesian*)o2)->m_Cartesian)
-      return Py_True;
+      Py_RETURN_TRUE;
     else
-      return Py_False;
+      Py_RETURN_FALSE;
 
   } else {
 
@@ -2152,51 +2595,55 @@ static PyObject* Cartesian_tp_richcompare(PyObject* o1, PyObject* o2, int op) {
 // ---------------------------
 
 static PyObject* Cartesian_nb_inplace_add(PyObject* o1, PyObject* o2) {
-  if (is_CartesianType(o1) && is_CartesianType(o2)) {
+  coords_state* st(get_state(o1));
+  if (is_CartesianType(st, o1) && is_CartesianType(st, o2)) {
     ((Cartesian*)o1)->m_Cartesian.operator+=(((Cartesian*)o2)->m_Cartesian);
     Py_INCREF(o1);
     return o1;
   }
-  PyErr_SetString(sCoordsException, "Cartesian::operator+=() only supports Cartesian types");
+  PyErr_SetString(st->Error, "Cartesian::operator+=() only supports Cartesian types");
   return NULL;
 }
 
 static PyObject* Cartesian_nb_inplace_subtract(PyObject* o1, PyObject* o2) {
-  if (is_CartesianType(o1) && is_CartesianType(o2)) {
+  coords_state* st(get_state(o1));
+  if (is_CartesianType(st, o1) && is_CartesianType(st, o2)) {
     ((Cartesian*)o1)->m_Cartesian.operator-=(((Cartesian*)o2)->m_Cartesian);
     Py_INCREF(o1);
     return o1;
   }
-  PyErr_SetString(sCoordsException, "Cartesian::operator-=() only supports Cartesian types");
+  PyErr_SetString(st->Error, "Cartesian::operator-=() only supports Cartesian types");
   return NULL;
 }
 
 static PyObject* Cartesian_nb_inplace_multiply(PyObject* o1, PyObject* o2) {
+  coords_state* st(get_state(o1));
 
   // This only scales the vector. If it returned the dot product, it
   // would switch the object to type double.
 
-  if (is_CartesianType(o1) && (PyFloat_Check(o2) || PyInt_Check(o2))) {
+  if (is_CartesianType(st, o1) && (PyFloat_Check(o2) || PyLong_Check(o2))) {
     ((Cartesian*)o1)->m_Cartesian.operator*=(PyFloat_AsDouble(o2));
     Py_INCREF(o1);
     return o1;
   }
 
-  PyErr_SetString(sCoordsException, "Cartesian::operator*=() only supports Cartesian types");
+  PyErr_SetString(st->Error, "Cartesian::operator*=() only supports Cartesian types");
   return NULL;
 
 }
 
-static PyObject* Cartesian_nb_inplace_divide(PyObject* o1, PyObject* o2) {
+static PyObject* Cartesian_nb_inplace_true_divide(PyObject* o1, PyObject* o2) {
+  coords_state* st(get_state(o1));
   // This only scales the vector.
 
-  if (is_CartesianType(o1) && (PyFloat_Check(o2) || PyInt_Check(o2))) {
+  if (is_CartesianType(st, o1) && (PyFloat_Check(o2) || PyLong_Check(o2))) {
     ((Cartesian*)o1)->m_Cartesian.operator/=(PyFloat_AsDouble(o2));
     Py_INCREF(o1);
     return o1;
   }
 
-  PyErr_SetString(sCoordsException, "Cartesian::operator/=() only supports Cartesian types");
+  PyErr_SetString(st->Error, "Cartesian::operator/=() only supports Cartesian types");
   return NULL;
 
 }
@@ -2207,8 +2654,24 @@ static PyObject* Cartesian_nb_inplace_divide(PyObject* o1, PyObject* o2) {
 
 // ----- Cartesian_magnitude -----
 static PyObject* Cartesian_magnitude(PyObject* self, PyObject *args) {
-  double a_magnitude(((Cartesian*)self)->m_Cartesian.magnitude());
-  return (PyObject*)  Py_BuildValue("d", a_magnitude);
+  return PyFloat_FromDouble(((Cartesian*)self)->m_Cartesian.magnitude());
+}
+
+// ----- pickle -----
+
+static PyObject* Cartesian_reduce(PyObject* self, PyObject* args) {
+  char a_record[Coords::Cartesian_binary_size];
+  Coords::Cartesian2binary(&((Cartesian*)self)->m_Cartesian, a_record, 1);
+  return reduce_binary(self, a_record, sizeof(a_record));
+}
+
+static PyObject* Cartesian_setstate(PyObject* self, PyObject* state) {
+  coords_state* st(get_state(self));
+  const char* a_record(get_binary_state(st, state, Coords::Cartesian_binary_size));
+  if (a_record == NULL)
+    return NULL;
+  Coords::binary2Cartesian(a_record, &((Cartesian*)self)->m_Cartesian, 1);
+  Py_RETURN_NONE;
 }
 
 // --------------------------
@@ -2219,16 +2682,14 @@ PyDoc_STRVAR(Cartesian_magnitude__doc__, "Returns the magnitude of the Cartesian
 PyDoc_STRVAR(Cartesian_normalized__doc__, "Returns the normalized version of the Cartesian object");
 
 static PyMethodDef Cartesian_methods[] = {
-  {"magnitude", (PyCFunction) Cartesian_magnitude, METH_VARARGS, Cartesian_magnitude__doc__},
+  {"magnitude", (PyCFunction) Cartesian_magnitude, METH_NOARGS, Cartesian_magnitude__doc__},
   {"normalized", (PyCFunction) Cartesian_normalized, METH_VARARGS, Cartesian_normalized__doc__},
+  {"__reduce__", (PyCFunction) Cartesian_reduce, METH_NOARGS, coords_reduce__doc__},
+  {"__setstate__", (PyCFunction) Cartesian_setstate, METH_O, coords_setstate__doc__},
   {NULL}  /* Sentinel */
 };
 
 
-static PyMemberDef Cartesian_members[] = {
-  {NULL}  /* Sentinel */
-};
-
 
 static PyGetSetDef Cartesian_getseters[] = {
   {sXstr, (getter)Cartesian_getx, (setter)Cartesian_setx, sXstr, NULL},
@@ -2237,122 +2698,68 @@ static PyGetSetDef Cartesian_getseters[] = {
   {NULL}  /* Sentinel */
 };
 
-// see http://docs.python.org/c-api/typeobj.html
-static PyNumberMethods Cartesian_as_number = {
-  (binaryfunc) Cartesian_nb_add,
-  (binaryfunc) Cartesian_nb_subtract,
-  (binaryfunc) Cartesian_nb_multiply,
-  (binaryfunc) Cartesian_nb_divide,
-  (binaryfunc) 0,  // nb_remainder
-  (binaryfunc) 0,  // nb_divmod
-  (ternaryfunc) 0, // nb_power
-  (unaryfunc) Cartesian_nb_negative,
-  (unaryfunc) 0,   // nb_positive
-  (unaryfunc) 0,   // nb_absolute
-  (inquiry) 0,     // nb_nonzero. Used by PyObject_IsTrue.
-  (unaryfunc) 0,   // nb_invert
-  (binaryfunc) 0,  // nb_lshift
-  (binaryfunc) 0,  // nb_rshift
-  (binaryfunc) 0,  // nb_and
-  (binaryfunc) 0,  // nb_xor
-  (binaryfunc) 0,  // nb_or
-  (coercion) 0,    // Used by the coerce() function
-  (unaryfunc) 0,   // nb_int
-  (unaryfunc) 0,   // nb_long
-  (unaryfunc) 0,   // nb_float
-  (unaryfunc) 0,   // nb_oct
-  (unaryfunc) 0,   // nb_hex
-
-  // added in release 2.0
-
-  (binaryfunc) Cartesian_nb_inplace_add,
-  (binaryfunc) Cartesian_nb_inplace_subtract,
-  (binaryfunc) Cartesian_nb_inplace_multiply,
-  (binaryfunc) Cartesian_nb_inplace_divide,
-  (binaryfunc) 0,  // nb_inplace_remainder
-  (ternaryfunc) 0, // nb_inplace_power
-  (binaryfunc) 0,  // nb_inplace_lshift
-  (binaryfunc) 0,  // nb_inplace_rshift
-  (binaryfunc) 0,  // nb_inplace_and
-  (binaryfunc) 0,  // nb_inplace_xor
-  (binaryfunc) 0,  // nb_inplace_or
-
-  // added in release 2.2
-  (binaryfunc) 0,  // nb_floor_divide
-  (binaryfunc) 0,  // nb_true_divide
-  (binaryfunc) 0,  // nb_inplace_floor_divide
-  (binaryfunc) 0,  // nb_inplace_true_divide
-
+static PyType_Slot Cartesian_slots[] = {
+  {Py_tp_dealloc,             (void*) Cartesian_dealloc},
+  {Py_tp_repr,                (void*) Cartesian_repr},
+  {Py_tp_str,                 (void*) Cartesian_str},
+  {Py_tp_doc,                 (void*) "Cartesian objects"},
+  {Py_tp_richcompare,         (void*) Cartesian_tp_richcompare},
+  {Py_tp_methods,             (void*) Cartesian_methods},
+  {Py_tp_getset,              (void*) Cartesian_getseters},
+  {Py_tp_init,                (void*) Cartesian_init},
+  {Py_tp_new,                 (void*) Cartesian_new},
+  {Py_nb_add,                 (void*) Cartesian_nb_add},
+  {Py_nb_subtract,            (void*) Cartesian_nb_subtract},
+  {Py_nb_multiply,            (void*) Cartesian_nb_multiply},
+  {Py_nb_true_divide,         (void*) Cartesian_nb_true_divide},
+  {Py_nb_negative,            (void*) Cartesian_nb_negative},
+  {Py_nb_inplace_add,         (void*) Cartesian_nb_inplace_add},
+  {Py_nb_inplace_subtract,    (void*) Cartesian_nb_inplace_subtract},
+  {Py_nb_inplace_multiply,    (void*) Cartesian_nb_inplace_multiply},
+  {Py_nb_inplace_true_divide, (void*) Cartesian_nb_inplace_true_divide},
+  {0, NULL}  /* Sentinel */
 };
 
-
-PyTypeObject CartesianType = {
-  PyObject_HEAD_INIT(NULL)
-  0,                                        /* ob_size */
-  "Cartesian",                              /* tp_name */
-  sizeof(Cartesian),                        /* tp_basicsize */
-  0,                                        /* tp_itemsize */
-  (destructor) Cartesian_dealloc,           /* tp_dealloc */
-  0,                                        /* tp_print */
-  0,                                        /* tp_getattr */
-  0,                                        /* tp_setattr */
-  0,                                        /* tp_compare */
-  Cartesian_repr,                           /* tp_repr */
-  &Cartesian_as_number,                     /* tp_as_number */
-  0,                                        /* tp_as_sequence */
-  0,                                        /* tp_as_mapping */
-  0,                                        /* tp_hash */
-  0,                                        /* tp_call */
-  Cartesian_str,                            /* tp_str */
-  0,                                        /* tp_getattro */
-  0,                                        /* tp_setattro */
-  0,                                        /* tp_as_buffer */
-  Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE | Py_TPFLAGS_CHECKTYPES, /* tp_flags */
-  "Cartesian objects",                      /* tp_doc */
-  0,                                        /* tp_traverse */
-  0,                                        /* tp_clear */
-  Cartesian_tp_richcompare,                 /* tp_richcompare */
-  0,                                        /* tp_weaklistoffset */
-  0,                                        /* tp_iter */
-  0,                                        /* tp_iternext */
-  Cartesian_methods,                        /* tp_methods */
-  Cartesian_members,                        /* tp_members */
-  Cartesian_getseters,                      /* tp_getset */
-  0,                                        /* tp_base */
-  0,                                        /* tp_dict */
-  0,                                        /* tp_descr_get */
-  0,                                        /* tp_descr_set */
-  0,                                        /* tp_dictoffset */
-  (initproc)Cartesian_init,                 /* tp_init */
-  0,                                        /* tp_alloc */
-  Cartesian_new,                            /* tp_new */
+static PyType_Spec Cartesian_spec = {
+  "coords.Cartesian",               /* name */
+  sizeof(Cartesian),                /* basicsize */
+  0,                                /* itemsize */
+  Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE | Py_TPFLAGS_IMMUTABLETYPE, /* flags */
+  Cartesian_slots                   /* slots */
 };
 
 // ------------------------------------------
 // ----- implement forward declarations -----
 // ------------------------------------------
 
-static void new_CartesianType(Cartesian** a_Cartesian) {
-  *a_Cartesian = PyObject_New(Cartesian, &CartesianType);
+static void new_CartesianType(coords_state* st, Cartesian** a_Cartesian) {
+  *a_Cartesian = (Cartesian*)freelist_new(st->CartesianFreeList, st->CartesianType);
+  if (*a_Cartesian)
+    new (&(*a_Cartesian)->m_Cartesian) Coords::Cartesian();
 }
 
-static int is_CartesianType(PyObject* a_Cartesian) {
-  return PyObject_TypeCheck(a_Cartesian, &CartesianType);
+static int is_CartesianType(coords_state* st, PyObject* a_Cartesian) {
+  return PyObject_TypeCheck(a_Cartesian, st->CartesianType);
 }
 
 // ----- Cartesian_normalized -----
 static PyObject* Cartesian_normalized(PyObject* self, PyObject *args) {
+  coords_state* st(get_state(self));
 
   Cartesian* result_Cartesian(NULL);
-  result_Cartesian = PyObject_New(Cartesian, &CartesianType); // alloc and inits
+  new_CartesianType(st, &result_Cartesian);
   if (result_Cartesian == NULL) {
-    PyErr_SetString(sCoordsException, "normalized failed to create Cartesian type");
+    PyErr_SetString(st->Error, "normalized failed to create Cartesian type");
     return NULL;
   }
 
-  Coords::Cartesian a_normalized(((Cartesian*)self)->m_Cartesian.normalized());
-
-  result_Cartesian->m_Cartesian = a_normalized;
+  try {
+    result_Cartesian->m_Cartesian = ((Cartesian*)self)->m_Cartesian.normalized();
+  } catch (Coords::DivideByZeroError& err) {
+    Py_DECREF(result_Cartesian);
+    PyErr_SetString(st->Error, err.what());
+    return NULL;
+  }
 
   return (PyObject*) result_Cartesian;
 
@@ -2368,11 +2775,14 @@ static PyObject* Cartesian_normalized(PyObject* self, PyObject *args) {
 
 static PyObject* rotator_new(PyTypeObject* type, PyObject* args, PyObject* kwds) {
   rotator* self(NULL);
-  self = (rotator*)type->tp_alloc(type, 0);
+  self = (rotator*)((allocfunc)PyType_GetSlot(type, Py_tp_alloc))(type, 0);
+  if (self)
+    new (&self->m_rotator) Coords::rotator(Coords::Cartesian::Uo); // python default axis
   return (PyObject*)self;
 }
 
 static int rotator_init(rotator* self, PyObject* args, PyObject* kwds) {
+  coords_state* st(get_state((PyObject*)self));
 
   static char* kwlist[] = {sAxisStr, NULL};
 
@@ -2384,16 +2794,16 @@ static int rotator_init(rotator* self, PyObject* args, PyObject* kwds) {
   if (arg0) {
 
     // copy constructor
-    if (is_rotatorType(arg0)) {
+    if (is_rotatorType(st, arg0)) {
       self->m_rotator.axis(((rotator*)arg0)->m_rotator.axis());
       return 0;
 
-    } else if (is_CartesianType(arg0)) {
+    } else if (is_CartesianType(st, arg0)) {
       self->m_rotator.axis(((Cartesian*)arg0)->m_Cartesian);
       return 0;
 
     } else {
-      PyErr_SetString(sCoordsException, "arg0 must be a coords.rotator or coords.Cartesian");
+      PyErr_SetString(st->Error, "arg0 must be a coords.rotator or coords.Cartesian");
       return -1;
     }
 
@@ -2405,7 +2815,10 @@ static int rotator_init(rotator* self, PyObject* args, PyObject* kwds) {
 
 
 static void rotator_dealloc(rotator* self) {
-  self->ob_type->tp_free((PyObject*)self);
+  PyTypeObject* its_type(Py_TYPE((PyObject*)self));
+  self->m_rotator.~rotator();
+  ((freefunc)PyType_GetSlot(its_type, Py_tp_free))((PyObject*)self);
+  Py_DECREF(its_type);
 }
 
 // -----------------
@@ -2416,7 +2829,7 @@ PyObject* rotator_str(PyObject* self) {
   std::stringstream result;
   result.precision(sPrintPrecision);
   result << ((rotator*)self)->m_rotator.axis();
-  return PyString_FromString(result.str().c_str());
+  return PyUnicode_FromString(result.str().c_str());
 }
 
 // TODO a different repr? for constructor?
@@ -2424,55 +2837,101 @@ PyObject* rotator_repr(PyObject* self) {
   std::stringstream result;
   result.precision(sPrintPrecision);
   result << ((rotator*)self)->m_rotator.axis();
-  return PyString_FromString(result.str().c_str());
+  return PyUnicode_FromString(result.str().c_str());
 }
 
 // -------------------
 // ----- methods -----
 // -------------------
 
-static PyObject* rotator_rotate(PyObject* o1, PyObject* o2) {
+static PyObject* rotator_rotate(PyObject* o1, PyObject* const* args, Py_ssize_t nargs) {
+  coords_state* st(get_state(o1));
 
   // TODO kwlist?
 
-  PyObject* arg0(NULL);
-  PyObject* arg1(NULL);
+  if (check_nargs("rotate", nargs, 2))
+    return NULL;
 
-  if (!PyArg_ParseTuple(o2, "OO", &arg0, &arg1))
+  PyObject* arg0(args[0]);
+  PyObject* arg1(args[1]);
+
+  if (!is_rotatorType(st, o1)) {
+    PyErr_SetString(st->Error, "not rotator method"); // TODO
     return NULL;
+  }
 
-  if (!is_rotatorType(o1)) {
-    PyErr_SetString(sCoordsException, "not rotator method"); // TODO
+  if (!is_CartesianType(st, arg0)) {
+    PyErr_SetString(st->Error, "rotator::rotate() arg0 must be a Cartesian vector");
     return NULL;
   }
 
-  if (!is_CartesianType(arg0)) {
-    PyErr_SetString(sCoordsException, "rotator::rotate() arg0 must be a Cartesian vector");
+  if (!is_AngleType(st, arg1)) {
+    PyErr_SetString(st->Error, "rotator::rotate() arg1 must be an angle");
     return NULL;
   }
 
-  if (!is_AngleType(arg1)) {
-    PyErr_SetString(sCoordsException, "rotator::rotate() arg1 must be an angle");
+  if (((rotator*)o1)->m_rotator.axis() == Coords::Cartesian::Uo) {
+    PyErr_SetString(st->Error, "rotator has Uo rotation axis");
     return NULL;
   }
 
   Cartesian* result_Cartesian(NULL);
-  result_Cartesian = PyObject_New(Cartesian, &CartesianType); // alloc and inits
+  new_CartesianType(st, &result_Cartesian);
   if (result_Cartesian == NULL) {
-    PyErr_SetString(sCoordsException, "rotate failed to create coord.Cartesian");
+    PyErr_SetString(st->Error, "rotate failed to create coord.Cartesian");
     return NULL;
   }
 
+  result_Cartesian->m_Cartesian = ((rotator*)o1)->m_rotator.rotate(((Cartesian*)arg0)->m_Cartesian,
+								   ((Angle*)arg1)->m_angle);
+
+  return (PyObject*) result_Cartesian;
 
-  if (((rotator*)o1)->m_rotator.axis() == Coords::Cartesian::Uo) {
-    PyErr_SetString(sCoordsException, "rotator has Uo rotation axis");
+}
+
+
+static PyObject* rotator_rotateArray(PyObject* self, PyObject* args, PyObject* kwds) {
+  coords_state* st(get_state(self));
+
+  static char* kwlist[] = {sValuesStr, sAngleStr, sOutStr, NULL};
+
+  PyObject* arg0(NULL);
+  PyObject* arg1(NULL);
+  PyObject* out(NULL);
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "OO|O", kwlist, &arg0, &arg1, &out))
+    return NULL;
+
+  if (!is_AngleType(st, arg1)) {
+    PyErr_SetString(st->Error, "rotator::rotateArray() arg1 must be an angle");
     return NULL;
   }
 
-  result_Cartesian->m_Cartesian = ((rotator*)o1)->m_rotator.rotate(((Cartesian*)arg0)->m_Cartesian,
-								   ((Angle*)arg1)->m_angle);
+  if (((rotator*)self)->m_rotator.axis() == Coords::Cartesian::Uo) {
+    PyErr_SetString(st->Error, "rotator has Uo rotation axis");
+    return NULL;
+  }
 
-  return (PyObject*) result_Cartesian;
+  DoubleBuffer values;
+  Py_ssize_t rows(0);
+  if (values.get(st, arg0, PyBUF_SIMPLE) < 0 || get_batch_rows(st, values, 3, rows) < 0)
+    return NULL;
+
+  DoubleBuffer result_values;
+  PyObject* result(get_batch_output(st, out, rows, 3, result_values));
+  if (result == NULL)
+    return NULL;
+
+  // copies so other threads may change the rotator and angle objects
+  // while this one runs without the GIL.
+  const Coords::rotator a_rotator(((rotator*)self)->m_rotator);
+  const Coords::angle an_angle(((Angle*)arg1)->m_angle);
+
+  Py_BEGIN_ALLOW_THREADS
+  a_rotator.rotate(values.data(), result_values.data(), rows, an_angle);
+  Py_END_ALLOW_THREADS
+
+  return result;
 
 }
 
@@ -2482,93 +2941,336 @@ static PyObject* rotator_rotate(PyObject* o1, PyObject* o2) {
 // --------------------------
 
 PyDoc_STRVAR(rotator_rotate__doc__, "Returns the vector rotate by the angle about the axis");
+PyDoc_STRVAR(rotator_rotateArray__doc__, "rotateArray(values, angle, out=None) rotates an (n, 3) float64 buffer of vectors by the angle about the axis");
 
 static PyMethodDef rotator_methods[] = {
-  {"rotate", (PyCFunction) rotator_rotate, METH_VARARGS, rotator_rotate__doc__},
+  {"rotate", (PyCFunction)(void(*)(void)) rotator_rotate, METH_FASTCALL, rotator_rotate__doc__},
+  {"rotateArray", (PyCFunction) rotator_rotateArray, METH_VARARGS | METH_KEYWORDS, rotator_rotateArray__doc__},
   {NULL}  /* Sentinel */
 };
 
 
-static PyMemberDef rotator_members[] = {
-  {NULL}  /* Sentinel */
-};
 
-static PyGetSetDef rotator_getseters[] = {
-  {NULL}  /* Sentinel */
+static PyType_Slot rotator_slots[] = {
+  {Py_tp_dealloc, (void*) rotator_dealloc},
+  {Py_tp_repr,    (void*) rotator_repr},
+  {Py_tp_str,     (void*) rotator_str},
+  {Py_tp_doc,     (void*) "rotator objects"},
+  {Py_tp_methods, (void*) rotator_methods},
+  {Py_tp_init,    (void*) rotator_init},
+  {Py_tp_new,     (void*) rotator_new},
+  {0, NULL}  /* Sentinel */
 };
 
-
-PyTypeObject rotatorType = {
-  PyObject_HEAD_INIT(NULL)
-  0,                                 /* ob_size */
-  "rotator",                         /* tp_name */
-  sizeof(rotator),                   /* tp_basicsize */
-  0,                                 /* tp_itemsize */
-  (destructor) rotator_dealloc,      /* tp_dealloc */
-  0,                                 /* tp_print */
-  0,                                 /* tp_getattr */
-  0,                                 /* tp_setattr */
-  0,                                 /* tp_compare */
-  rotator_repr,                      /* tp_repr */
-  0,                                 /* tp_as_number */
-  0,                                 /* tp_as_sequence */
-  0,                                 /* tp_as_mapping */
-  0,                                 /* tp_hash */
-  0,                                 /* tp_call */
-  rotator_str,                       /* tp_str */
-  0,                                 /* tp_getattro */
-  0,                                 /* tp_setattro */
-  0,                                 /* tp_as_buffer */
-  Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE | Py_TPFLAGS_CHECKTYPES, /* tp_flags */
-  "rotator objects",                   /* tp_doc */
-  0,                                 /* tp_traverse */
-  0,                                 /* tp_clear */
-  0,                                 /* tp_richcompare */
-  0,                                 /* tp_weaklistoffset */
-  0,                                 /* tp_iter */
-  0,                                 /* tp_iternext */
-  rotator_methods,                  /* tp_methods */
-  rotator_members,                  /* tp_members */
-  rotator_getseters,                /* tp_getset */
-  0,                                 /* tp_base */
-  0,                                 /* tp_dict */
-  0,                                 /* tp_descr_get */
-  0,                                 /* tp_descr_set */
-  0,                                 /* tp_dictoffset */
-  (initproc)rotator_init,           /* tp_init */
-  0,                                 /* tp_alloc */
-  rotator_new,                      /* tp_new */
+static PyType_Spec rotator_spec = {
+  "coords.rotator",                 /* name */
+  sizeof(rotator),                  /* basicsize */
+  0,                                /* itemsize */
+  Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE | Py_TPFLAGS_IMMUTABLETYPE, /* flags */
+  rotator_slots                     /* slots */
 };
 
 // ------------------------------------------
 // ----- implement forward declarations -----
 // ------------------------------------------
 
-static void new_rotatorType(rotator** a_rotator) {
-  *a_rotator = PyObject_New(rotator, &rotatorType);
+static void new_rotatorType(coords_state* st, rotator** a_rotator) {
+  *a_rotator = PyObject_New(rotator, st->rotatorType);
+  if (*a_rotator)
+    new (&(*a_rotator)->m_rotator) Coords::rotator(Coords::Cartesian::Uo);
 }
 
-static int is_rotatorType(PyObject* a_rotator) {
+static int is_rotatorType(coords_state* st, PyObject* a_rotator) {
   //wrapper for type check
-  return PyObject_TypeCheck(a_rotator, &rotatorType);
+  return PyObject_TypeCheck(a_rotator, st->rotatorType);
 }
 
 
-// =====================
-// ===== spherical =====
-// =====================
+// =============================
+// ===== CartesianRecorder =====
+// =============================
+
+// The recorder exports its samples with the buffer protocol as a read
+// only (n, 3) float64 array, oldest first, e.g. numpy.asarray(recorder)
+// or coords.magnitude(recorder) with out copying. Like bytearray, it
+// can not change while a view is alive.
+
+static int CartesianRecorder_check_exports(CartesianRecorder* self) {
+  if (self->m_exports > 0) {
+    PyErr_SetString(PyExc_BufferError, "CartesianRecorder can not change while a view of it exists");
+    return -1;
+  }
+  return 0;
+}
+
+// ------------------------
+// ----- constructors -----
+// ------------------------
+
+static PyObject* CartesianRecorder_new(PyTypeObject* type, PyObject* args, PyObject* kwds) {
+  CartesianRecorder* self(NULL);
+  self = (CartesianRecorder*)((allocfunc)PyType_GetSlot(type, Py_tp_alloc))(type, 0);
+  if (self) {
+    new (&self->m_recorder) Coords::CartesianRecorder();
+    self->m_exports = 0;
+  }
+  return (PyObject*)self;
+}
+
+static int CartesianRecorder_init(CartesianRecorder* self, PyObject* args, PyObject* kwds) {
+  coords_state* st(get_state((PyObject*)self));
+
+  static char* kwlist[] = {sSizeLimitStr, NULL};
+
+  Py_ssize_t size_limit(Coords::CartesianRecorder::default_size);
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "|n", kwlist, &size_limit))
+    return -1;
+
+  if (size_limit < 0 || size_limit > UINT_MAX) {
+    PyErr_SetString(st->Error, "sizeLimit is out of range");
+    return -1;
+  }
+
+  if (CartesianRecorder_check_exports(self) < 0)
+    return -1;
+
+  self->m_recorder = Coords::CartesianRecorder(size_limit);
+
+  return 0;
+
+}
+
+static void CartesianRecorder_dealloc(CartesianRecorder* self) {
+  PyTypeObject* its_type(Py_TYPE((PyObject*)self));
+  self->m_recorder.~CartesianRecorder();
+  ((freefunc)PyType_GetSlot(its_type, Py_tp_free))((PyObject*)self);
+  Py_DECREF(its_type);
+}
+
+// -------------------------------
+// ----- getters and setters -----
+// -------------------------------
+
+static PyObject* CartesianRecorder_getSizeLimit(CartesianRecorder* self, void* closure) {
+  return PyLong_FromUnsignedLong(self->m_recorder.sizeLimit());
+}
+
+static int CartesianRecorder_setSizeLimit(CartesianRecorder* self, PyObject* value, void* closure) {
+  coords_state* st(get_state((PyObject*)self));
+
+  if (value == NULL) {
+    PyErr_SetString(st->Error, "can not delete sizeLimit");
+    return -1;
+  }
+
+  if (!PyLong_Check(value)) {
+    PyErr_SetString(st->Error, "sizeLimit must be an int");
+    return -1;
+  }
+
+  long size_limit(PyLong_AsLong(value));
+  if (size_limit < 0 || size_limit > UINT_MAX) {
+    PyErr_Clear();
+    PyErr_SetString(st->Error, "sizeLimit is out of range");
+    return -1;
+  }
+
+  if (CartesianRecorder_check_exports(self) < 0)
+    return -1;
+
+  self->m_recorder.sizeLimit(size_limit);
+
+  return 0;
+}
+
+// -------------------
+// ----- methods -----
+// -------------------
+
+static PyObject* CartesianRecorder_push(PyObject* self, PyObject* const* args, Py_ssize_t nargs) {
+  coords_state* st(get_state(self));
+
+  if (check_nargs("push", nargs, 1))
+    return NULL;
+
+  PyObject* arg0(args[0]);
+
+  if (!is_CartesianType(st, arg0)) {
+    PyErr_SetString(st->Error, "CartesianRecorder::push() arg must be a Cartesian vector");
+    return NULL;
+  }
+
+  if (CartesianRecorder_check_exports((CartesianRecorder*)self) < 0)
+    return NULL;
+
+  ((CartesianRecorder*)self)->m_recorder.push(((Cartesian*)arg0)->m_Cartesian);
+
+  Py_RETURN_NONE;
+}
+
+static PyObject* CartesianRecorder_get(PyObject* self, PyObject* const* args, Py_ssize_t nargs) {
+  coords_state* st(get_state(self));
+
+  if (check_nargs("get", nargs, 1))
+    return NULL;
+
+  const Py_ssize_t idx(PyNumber_AsSsize_t(args[0], PyExc_OverflowError));
+  if (idx == -1 && PyErr_Occurred())
+    return NULL;
+
+  const Coords::CartesianRecorder& a_recorder(((CartesianRecorder*)self)->m_recorder);
+  if (idx < 0 || (unsigned long)idx >= a_recorder.size()) {
+    PyErr_SetString(PyExc_IndexError, "CartesianRecorder index out of range");
+    return NULL;
+  }
+
+  Cartesian* result_Cartesian(NULL);
+  new_CartesianType(st, &result_Cartesian);
+  if (result_Cartesian == NULL) {
+    PyErr_SetString(st->Error, "get failed to create coord.Cartesian");
+    return NULL;
+  }
+
+  result_Cartesian->m_Cartesian = a_recorder.get(idx);
+
+  return (PyObject*) result_Cartesian;
+}
+
+static PyObject* CartesianRecorder_clear(PyObject* self, PyObject* args) {
+  if (CartesianRecorder_check_exports((CartesianRecorder*)self) < 0)
+    return NULL;
+  ((CartesianRecorder*)self)->m_recorder.clear();
+  Py_RETURN_NONE;
+}
+
+static PyObject* CartesianRecorder_linearize(PyObject* self, PyObject* args) {
+  // a view already has it linear.
+  Coords::CartesianRecorder& a_recorder(((CartesianRecorder*)self)->m_recorder);
+  if (!a_recorder.isLinear())
+    a_recorder.linearize();
+  Py_RETURN_NONE;
+}
+
+static Py_ssize_t CartesianRecorder_length(PyObject* self) {
+  return ((CartesianRecorder*)self)->m_recorder.size();
+}
+
+// ---------------------------
+// ----- buffer protocol -----
+// ---------------------------
+
+static int CartesianRecorder_getbuffer(PyObject* self, Py_buffer* view, int flags) {
+
+  if ((flags & PyBUF_WRITABLE) == PyBUF_WRITABLE) {
+    PyErr_SetString(PyExc_BufferError, "CartesianRecorder views are read only");
+    view->obj = NULL;
+    return -1;
+  }
+
+  // rotates the ring in place, once, if it has wrapped.
+  CartesianRecorder* a_recorder((CartesianRecorder*)self);
+  if (!a_recorder->m_recorder.isLinear())
+    a_recorder->m_recorder.linearize();
+
+  static double s_empty[3] = {0, 0, 0}; // non NULL buf for no samples
+
+  size_t a_size(0);
+  const double* xyz(a_recorder->m_recorder.firstSegment(a_size));
+
+  a_recorder->m_shape[0] = a_size;
+  a_recorder->m_shape[1] = 3;
+  a_recorder->m_strides[0] = 3*sizeof(double);
+  a_recorder->m_strides[1] = sizeof(double);
+
+  view->obj = self;
+  Py_INCREF(self);
+  view->buf = a_size ? const_cast<double*>(xyz) : s_empty;
+  view->len = 3*a_size*sizeof(double);
+  view->readonly = 1;
+  view->itemsize = sizeof(double);
+  view->format = (flags & PyBUF_FORMAT) == PyBUF_FORMAT ? (char*)"d" : NULL;
+  view->ndim = (flags & PyBUF_ND) == PyBUF_ND ? 2 : 1;
+  view->shape = (flags & PyBUF_ND) == PyBUF_ND ? a_recorder->m_shape : NULL;
+  view->strides = (flags & PyBUF_STRIDES) == PyBUF_STRIDES ? a_recorder->m_strides : NULL;
+  view->suboffsets = NULL;
+  view->internal = NULL;
+
+  ++a_recorder->m_exports;
+
+  return 0;
+}
+
+static void CartesianRecorder_releasebuffer(PyObject* self, Py_buffer* view) {
+  --((CartesianRecorder*)self)->m_exports;
+}
+
+// --------------------------
+// ----- Python structs -----
+// --------------------------
+
+PyDoc_STRVAR(CartesianRecorder_push__doc__, "Appends a Cartesian, overwriting the oldest once sizeLimit is reached");
+PyDoc_STRVAR(CartesianRecorder_get__doc__, "Returns the Cartesian at index, oldest first");
+PyDoc_STRVAR(CartesianRecorder_clear__doc__, "Removes all the samples");
+PyDoc_STRVAR(CartesianRecorder_linearize__doc__, "Rotates the samples in place so they are contiguous, oldest first. Buffer views do this too.");
+
+static PyMethodDef CartesianRecorder_methods[] = {
+  {"push", (PyCFunction)(void(*)(void)) CartesianRecorder_push, METH_FASTCALL, CartesianRecorder_push__doc__},
+  {"get", (PyCFunction)(void(*)(void)) CartesianRecorder_get, METH_FASTCALL, CartesianRecorder_get__doc__},
+  {"clear", (PyCFunction) CartesianRecorder_clear, METH_NOARGS, CartesianRecorder_clear__doc__},
+  {"linearize", (PyCFunction) CartesianRecorder_linearize, METH_NOARGS, CartesianRecorder_linearize__doc__},
+  {NULL}  /* Sentinel */
+};
+
+static PyGetSetDef CartesianRecorder_getseters[] = {
+  {sSizeLimitStr, (getter)CartesianRecorder_getSizeLimit, (setter)CartesianRecorder_setSizeLimit, sSizeLimitStr, NULL},
+  {NULL}  /* Sentinel */
+};
+
+static PyType_Slot CartesianRecorder_slots[] = {
+  {Py_tp_dealloc,       (void*) CartesianRecorder_dealloc},
+  {Py_tp_doc,           (void*) "CartesianRecorder objects"},
+  {Py_tp_methods,       (void*) CartesianRecorder_methods},
+  {Py_tp_getset,        (void*) CartesianRecorder_getseters},
+  {Py_tp_init,          (void*) CartesianRecorder_init},
+  {Py_tp_new,           (void*) CartesianRecorder_new},
+  {Py_sq_length,        (void*) CartesianRecorder_length},
+  {Py_bf_getbuffer,     (void*) CartesianRecorder_getbuffer},
+  {Py_bf_releasebuffer, (void*) CartesianRecorder_releasebuffer},
+  {0, NULL}  /* Sentinel */
+};
+
+static PyType_Spec CartesianRecorder_spec = {
+  "coords.CartesianRecorder",       /* name */
+  sizeof(CartesianRecorder),        /* basicsize */
+  0,                                /* itemsize */
+  Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE | Py_TPFLAGS_IMMUTABLETYPE, /* flags */
+  CartesianRecorder_slots           /* slots */
+};
+
+
+// =====================
+// ===== spherical =====
+// =====================
 
 // ------------------------
 // ----- constructors -----
 // ------------------------
 
 static PyObject* spherical_new(PyTypeObject* type, PyObject* args, PyObject* kwds) {
+  coords_state* st(get_type_state(type));
   spherical* self(NULL);
-  self = (spherical*)type->tp_alloc(type, 0);
+  if (type == st->sphericalType)
+    self = (spherical*)freelist_new(st->SphericalFreeList, type);
+  else
+    self = (spherical*)((allocfunc)PyType_GetSlot(type, Py_tp_alloc))(type, 0);
+  if (self)
+    new (&self->m_spherical) Coords::spherical();
   return (PyObject*)self;
 }
 
 static int spherical_init(spherical* self, PyObject* args, PyObject* kwds) {
+  coords_state* st(get_state((PyObject*)self));
 
   static char* kwlist[] = {sRstr, sThetaStr, sPhiStr, NULL};
 
@@ -2586,14 +3288,14 @@ static int spherical_init(spherical* self, PyObject* args, PyObject* kwds) {
 
   if (arg0) {
 
-    if (is_sphericalType(arg0)) {
+    if (is_sphericalType(st, arg0)) {
       // copy constructor
       self->m_spherical.r(((spherical*)arg0)->m_spherical.r());
       self->m_spherical.theta(((spherical*)arg0)->m_spherical.theta());
       self->m_spherical.phi(((spherical*)arg0)->m_spherical.phi());
       return 0;
 
-    } else if (is_CartesianType(arg0)) {
+    } else if (is_CartesianType(st, arg0)) {
       // Cartesian conversion constructor
       Coords::spherical from_cartesian(((Cartesian*)arg0)->m_Cartesian);
       self->m_spherical.r(from_cartesian.r());
@@ -2601,15 +3303,15 @@ static int spherical_init(spherical* self, PyObject* args, PyObject* kwds) {
       self->m_spherical.phi(from_cartesian.phi());
       return 0;
 
-    } else if ((PyFloat_Check(arg0) || PyInt_Check(arg0))) {
+    } else if ((PyFloat_Check(arg0) || PyLong_Check(arg0))) {
       r = PyFloat_AsDouble(arg0);
 
-    } else if (PyString_Check(arg0)) {
-      PyErr_SetString(sCoordsException, "Direct conversion from string is not supported. Use float(arg).");
+    } else if (PyUnicode_Check(arg0)) {
+      PyErr_SetString(st->Error, "Direct conversion from string is not supported. Use float(arg).");
       return -1;
 
     } else {
-      PyErr_SetString(sCoordsException, "arg0 must be a coords.spherical, coords.Cartesian, int or float");
+      PyErr_SetString(st->Error, "arg0 must be a coords.spherical, coords.Cartesian, int or float");
       return -1;
     }
 
@@ -2617,21 +3319,21 @@ static int spherical_init(spherical* self, PyObject* args, PyObject* kwds) {
 
   if (arg1) {
 
-    if (is_AngleType(arg1)) {
+    if (is_AngleType(st, arg1)) {
       theta = ((Angle*)arg1)->m_angle;
 
-    } else if (is_LatitudeType(arg1)) {
+    } else if (is_LatitudeType(st, arg1)) {
       theta = Coords::angle(90.0) - ((Latitude*)arg1)->m_angle;
 
-    } else if (is_DeclinationType(arg1)) {
+    } else if (is_DeclinationType(st, arg1)) {
       theta = Coords::angle(90.0) - ((Declination*)arg1)->m_angle;
 
-    } else if (PyString_Check(arg1)) {
-      PyErr_SetString(sCoordsException, "Direct conversion from string is not supported. Use float(arg).");
+    } else if (PyUnicode_Check(arg1)) {
+      PyErr_SetString(st->Error, "Direct conversion from string is not supported. Use float(arg).");
       return -1;
 
     } else {
-      PyErr_SetString(sCoordsException, "arg1 must be a coords.angle, coords.Latitude or coords.Declination");
+      PyErr_SetString(st->Error, "arg1 must be a coords.angle, coords.Latitude or coords.Declination");
       return -1;
     }
 
@@ -2640,15 +3342,15 @@ static int spherical_init(spherical* self, PyObject* args, PyObject* kwds) {
 
   if (arg2) {
 
-    if (is_AngleType(arg2)) {
+    if (is_AngleType(st, arg2)) {
       phi = ((Angle*)arg2)->m_angle;
 
-    } else if (PyString_Check(arg2)) {
-      PyErr_SetString(sCoordsException, "Direct conversion from string is not supported. Use float(arg).");
+    } else if (PyUnicode_Check(arg2)) {
+      PyErr_SetString(st->Error, "Direct conversion from string is not supported. Use float(arg).");
       return -1;
 
     } else {
-      PyErr_SetString(sCoordsException, "arg2 must be an angle");
+      PyErr_SetString(st->Error, "arg2 must be an angle");
       return -1;
     }
 
@@ -2663,7 +3365,9 @@ static int spherical_init(spherical* self, PyObject* args, PyObject* kwds) {
 }
 
 static void spherical_dealloc(spherical* self) {
-  self->ob_type->tp_free((PyObject*)self);
+  coords_state* st(get_state((PyObject*)self));
+  self->m_spherical.~spherical();
+  freelist_free(st->SphericalFreeList, st->sphericalType, (PyObject*)self);
 }
 
 // -----------------
@@ -2674,7 +3378,7 @@ PyObject* spherical_str(PyObject* self) {
   std::stringstream result;
   result.precision(sPrintPrecision);
   result << ((spherical*)self)->m_spherical;
-  return PyString_FromString(result.str().c_str());
+  return PyUnicode_FromString(result.str().c_str());
 }
 
 PyObject* spherical_repr(PyObject* self) {
@@ -2685,7 +3389,7 @@ PyObject* spherical_repr(PyObject* self) {
 	 << a_spherical.r() << ", "
 	 << a_spherical.theta() << ", "
 	 << a_spherical.phi() << ")";
-  return PyString_FromString(result.str().c_str());
+  return PyUnicode_FromString(result.str().c_str());
 }
 
 // -------------------------------
@@ -2699,14 +3403,15 @@ static PyObject* spherical_getR(spherical* self, void* closure) {
 }
 
 static int spherical_setR(spherical* self, PyObject* value, void* closure) {
+  coords_state* st(get_state((PyObject*)self));
 
   if (value == NULL) {
-    PyErr_SetString(sCoordsException, "can not delete r");
+    PyErr_SetString(st->Error, "can not delete r");
     return 0;
   }
 
-  if (!PyFloat_Check(value) && !PyInt_Check(value)) {
-    PyErr_SetString(sCoordsException, "r must be a float or int");
+  if (!PyFloat_Check(value) && !PyLong_Check(value)) {
+    PyErr_SetString(st->Error, "r must be a float or int");
     return 0;
   }
 
@@ -2718,12 +3423,13 @@ static int spherical_setR(spherical* self, PyObject* value, void* closure) {
 // ----- theta -----
 
 static PyObject* spherical_getTheta(spherical* self, void* closure) {
+  coords_state* st(get_state((PyObject*)self));
 
   Angle* a_theta(NULL);
-  new_AngleType(&a_theta);
+  new_AngleType(st, &a_theta);
 
   if (a_theta == NULL) {
-    PyErr_SetString(sCoordsException, "get theta failed to create coord.angle");
+    PyErr_SetString(st->Error, "get theta failed to create coord.angle");
     return NULL;
   }
 
@@ -2734,14 +3440,15 @@ static PyObject* spherical_getTheta(spherical* self, void* closure) {
 }
 
 static int spherical_setTheta(spherical* self, PyObject* value, void* closure) {
+  coords_state* st(get_state((PyObject*)self));
 
   if (value == NULL) {
-    PyErr_SetString(sCoordsException, "can not delete theta");
+    PyErr_SetString(st->Error, "can not delete theta");
     return -1;
   }
 
-  if (!is_AngleType(value)) {
-    PyErr_SetString(sCoordsException, "theta must be an angle");
+  if (!is_AngleType(st, value)) {
+    PyErr_SetString(st->Error, "theta must be an angle");
     return -1;
   }
 
@@ -2753,12 +3460,13 @@ static int spherical_setTheta(spherical* self, PyObject* value, void* closure) {
 // ----- phi -----
 
 static PyObject* spherical_getPhi(spherical* self, void* closure) {
+  coords_state* st(get_state((PyObject*)self));
 
   Angle* a_phi(NULL);
-  new_AngleType(&a_phi);
+  new_AngleType(st, &a_phi);
 
   if (a_phi == NULL) {
-    PyErr_SetString(sCoordsException, "get phi failed to create coord.angle");
+    PyErr_SetString(st->Error, "get phi failed to create coord.angle");
     return NULL;
   }
 
@@ -2768,14 +3476,15 @@ static PyObject* spherical_getPhi(spherical* self, void* closure) {
 }
 
 static int spherical_setPhi(spherical* self, PyObject* value, void* closure) {
+  coords_state* st(get_state((PyObject*)self));
 
   if (value == NULL) {
-    PyErr_SetString(sCoordsException, "can not delete phi");
+    PyErr_SetString(st->Error, "can not delete phi");
     return -1;
   }
 
-  if (!is_AngleType(value)) {
-    PyErr_SetString(sCoordsException, "phi must be an angle");
+  if (!is_AngleType(st, value)) {
+    PyErr_SetString(st->Error, "phi must be an angle");
     return -1;
   }
 
@@ -2789,18 +3498,19 @@ static int spherical_setPhi(spherical* self, PyObject* value, void* closure) {
 // --------------------------
 
 static PyObject* spherical_nb_add(PyObject* o1, PyObject* o2) {
+  coords_state* st(get_state2(o1, o2));
 
-  if (!is_sphericalType(o1) || !is_sphericalType(o2)) {
+  if (!is_sphericalType(st, o1) || !is_sphericalType(st, o2)) {
     Py_INCREF(Py_NotImplemented);
     return Py_NotImplemented;
   }
 
   spherical* result_spherical(NULL);
 
-  new_sphericalType(&result_spherical);
+  new_sphericalType(st, &result_spherical);
 
   if (result_spherical == NULL) {
-    PyErr_SetString(sCoordsException, "add failed to create coord.spherical");
+    PyErr_SetString(st->Error, "add failed to create coord.spherical");
     return NULL;
   }
 
@@ -2814,18 +3524,19 @@ static PyObject* spherical_nb_add(PyObject* o1, PyObject* o2) {
 
 
 static PyObject* spherical_nb_subtract(PyObject* o1, PyObject* o2) {
+  coords_state* st(get_state2(o1, o2));
 
-  if (!is_sphericalType(o1) || !is_sphericalType(o2)) {
+  if (!is_sphericalType(st, o1) || !is_sphericalType(st, o2)) {
     Py_INCREF(Py_NotImplemented);
     return Py_NotImplemented;
   }
 
   spherical* result_spherical(NULL);
 
-  new_sphericalType(&result_spherical);
+  new_sphericalType(st, &result_spherical);
 
   if (result_spherical == NULL) {
-    PyErr_SetString(sCoordsException, "subtract failed to create coord.spherical");
+    PyErr_SetString(st->Error, "subtract failed to create coord.spherical");
     return NULL;
   }
 
@@ -2839,19 +3550,20 @@ static PyObject* spherical_nb_subtract(PyObject* o1, PyObject* o2) {
 
 
 static PyObject* spherical_nb_negative(PyObject* o1) {
+  coords_state* st(get_state(o1));
   // Unitary minus
 
-  if (!is_sphericalType(o1)) {
+  if (!is_sphericalType(st, o1)) {
     Py_INCREF(Py_NotImplemented);
     return Py_NotImplemented;
   }
 
   spherical* result_spherical(NULL);
 
-  new_sphericalType(&result_spherical);
+  new_sphericalType(st, &result_spherical);
 
   if (result_spherical == NULL) {
-    PyErr_SetString(sCoordsException, "unitary minus failed to create coord.spherical");
+    PyErr_SetString(st->Error, "unitary minus failed to create coord.spherical");
     return NULL;
   }
 
@@ -2864,6 +3576,7 @@ static PyObject* spherical_nb_negative(PyObject* o1) {
 
 
 static PyObject* spherical_nb_multiply(PyObject* o1, PyObject* o2) {
+  coords_state* st(get_state2(o1, o2));
 
   // Returns a scaled version of o1 or o2 if one is spherical and the
   // other double or int. Returns not implemented otherwise.
@@ -2871,50 +3584,52 @@ static PyObject* spherical_nb_multiply(PyObject* o1, PyObject* o2) {
   // TODO dot product?
 
   spherical* result_spherical(NULL);
-  new_sphericalType(&result_spherical);
+  new_sphericalType(st, &result_spherical);
 
   if (result_spherical == NULL) {
-    PyErr_SetString(sCoordsException, "multiply failed to create coord.spherical");
+    PyErr_SetString(st->Error, "multiply failed to create coord.spherical");
     return NULL;
   }
 
-  if (is_sphericalType(o1) && (PyFloat_Check(o2) || PyInt_Check(o2))) {
+  if (is_sphericalType(st, o1) && (PyFloat_Check(o2) || PyLong_Check(o2))) {
     result_spherical->m_spherical = ((spherical*)o1)->m_spherical * PyFloat_AsDouble(o2);
     return (PyObject*) result_spherical;
   }
 
-  if ((PyFloat_Check(o1) || PyInt_Check(o1)) && is_sphericalType(o2)) {
+  if ((PyFloat_Check(o1) || PyLong_Check(o1)) && is_sphericalType(st, o2)) {
     result_spherical->m_spherical = PyFloat_AsDouble(o1) * ((spherical*)o2)->m_spherical;
     return (PyObject*) result_spherical;
 
   }
 
+  Py_DECREF(result_spherical);
   Py_INCREF(Py_NotImplemented);
   return Py_NotImplemented;
 
 }
 
 
-static PyObject* spherical_nb_divide(PyObject* o1, PyObject* o2) {
+static PyObject* spherical_nb_true_divide(PyObject* o1, PyObject* o2) {
+  coords_state* st(get_state2(o1, o2));
   // This returns a spherical object scaled by the divisor.  o1 must be
   // sphericalType, o2 a float or int otherwise this will raise a
   // NotImplemented error.
 
   spherical* result_spherical(NULL);
-  new_sphericalType(&result_spherical);
+  new_sphericalType(st, &result_spherical);
 
   if (result_spherical == NULL) {
-    PyErr_SetString(sCoordsException, "divide failed to create coord.spherical");
+    PyErr_SetString(st->Error, "divide failed to create coord.spherical");
     return NULL;
   }
 
-  if (is_sphericalType(o1) && (PyFloat_Check(o2) || PyInt_Check(o2))) {
+  if (is_sphericalType(st, o1) && (PyFloat_Check(o2) || PyLong_Check(o2))) {
 
     try {
       result_spherical->m_spherical = ((spherical*)o1)->m_spherical / PyFloat_AsDouble(o2);
     } catch (Coords::DivideByZeroError& err) {
       Py_DECREF(result_spherical);
-      PyErr_SetString(sCoordsException, err.what());
+      PyErr_SetString(st->Error, err.what());
       return NULL;
     }
 
@@ -2929,8 +3644,9 @@ static PyObject* spherical_nb_divide(PyObject* o1, PyObject* o2) {
 
 
 static PyObject* spherical_tp_richcompare(PyObject* o1, PyObject* o2, int op) {
+  coords_state* st(get_state2(o1, o2));
 
-  if (!is_sphericalType(o1) || !is_sphericalType(o2)) {
+  if (!is_sphericalType(st, o1) || !is_sphericalType(st, o2)) {
     Py_INCREF(Py_NotImplemented);
     return Py_NotImplemented;
   }
@@ -2938,16 +3654,16 @@ static PyObject* spherical_tp_richcompare(PyObject* o1, PyObject* o2, int op) {
   if (op == Py_EQ) {
 
     if (((spherical*)o1)->m_spherical == ((spherical*)o2)->m_spherical)
-      return Py_True;
+      Py_RETURN_TRUE;
     else
-      return Py_False;
+      Py_RETURN_FALSE;
 
   } else if (op == Py_NE) {
 
     if (((spherical*)o1)->m_spherical != ((spherical*)o2)->m_spherical)
-      return Py_True;
+      Py_RETURN_TRUE;
     else
-      return Py_False;
+      Py_RETURN_FALSE;
 
   } else {
 
@@ -2963,69 +3679,88 @@ static PyObject* spherical_tp_richcompare(PyObject* o1, PyObject* o2, int op) {
 // ---------------------------
 
 static PyObject* spherical_nb_inplace_add(PyObject* o1, PyObject* o2) {
-  if (is_sphericalType(o1) && is_sphericalType(o2)) {
+  coords_state* st(get_state(o1));
+  if (is_sphericalType(st, o1) && is_sphericalType(st, o2)) {
     ((spherical*)o1)->m_spherical.operator+=(((spherical*)o2)->m_spherical);
     Py_INCREF(o1);
     return o1;
   }
-  PyErr_SetString(sCoordsException, "spherical::operator+=() only supports spherical types");
+  PyErr_SetString(st->Error, "spherical::operator+=() only supports spherical types");
   return NULL;
 }
 
 static PyObject* spherical_nb_inplace_subtract(PyObject* o1, PyObject* o2) {
-  if (is_sphericalType(o1) && is_sphericalType(o2)) {
+  coords_state* st(get_state(o1));
+  if (is_sphericalType(st, o1) && is_sphericalType(st, o2)) {
     ((spherical*)o1)->m_spherical.operator-=(((spherical*)o2)->m_spherical);
     Py_INCREF(o1);
     return o1;
   }
-  PyErr_SetString(sCoordsException, "spherical::operator-=() only supports spherical types");
+  PyErr_SetString(st->Error, "spherical::operator-=() only supports spherical types");
   return NULL;
 }
 
 static PyObject* spherical_nb_inplace_multiply(PyObject* o1, PyObject* o2) {
+  coords_state* st(get_state(o1));
   // This only scales the vector. If it returned the dot product, it
   // would switch the object to type double.
 
-  if (is_sphericalType(o1) && (PyFloat_Check(o2) || PyInt_Check(o2))) {
+  if (is_sphericalType(st, o1) && (PyFloat_Check(o2) || PyLong_Check(o2))) {
     ((spherical*)o1)->m_spherical.operator*=(PyFloat_AsDouble(o2));
     Py_INCREF(o1);
     return o1;
   }
 
-  PyErr_SetString(sCoordsException, "spherical::operator*=() only supports spherical types");
+  PyErr_SetString(st->Error, "spherical::operator*=() only supports spherical types");
   return NULL;
 
 }
 
-static PyObject* spherical_nb_inplace_divide(PyObject* o1, PyObject* o2) {
+static PyObject* spherical_nb_inplace_true_divide(PyObject* o1, PyObject* o2) {
+  coords_state* st(get_state(o1));
 
     // This only scales the vector.
 
-  if (is_sphericalType(o1) && (PyFloat_Check(o2) || PyInt_Check(o2))) {
+  if (is_sphericalType(st, o1) && (PyFloat_Check(o2) || PyLong_Check(o2))) {
     ((spherical*)o1)->m_spherical.operator/=(PyFloat_AsDouble(o2));
     Py_INCREF(o1);
     return o1;
   }
 
-  PyErr_SetString(sCoordsException, "spherical::operator/=() only supports spherical types");
+  PyErr_SetString(st->Error, "spherical::operator/=() only supports spherical types");
   return NULL;
 
 }
 
 
+// ----- pickle -----
+
+static PyObject* spherical_reduce(PyObject* self, PyObject* args) {
+  char a_record[Coords::spherical_binary_size];
+  Coords::spherical2binary(&((spherical*)self)->m_spherical, a_record, 1);
+  return reduce_binary(self, a_record, sizeof(a_record));
+}
+
+static PyObject* spherical_setstate(PyObject* self, PyObject* state) {
+  coords_state* st(get_state(self));
+  const char* a_record(get_binary_state(st, state, Coords::spherical_binary_size));
+  if (a_record == NULL)
+    return NULL;
+  Coords::binary2spherical(a_record, &((spherical*)self)->m_spherical, 1);
+  Py_RETURN_NONE;
+}
+
 // --------------------------
 // ----- Python structs -----
 // --------------------------
 
 static PyMethodDef spherical_methods[] = {
+  {"__reduce__", (PyCFunction) spherical_reduce, METH_NOARGS, coords_reduce__doc__},
+  {"__setstate__", (PyCFunction) spherical_setstate, METH_O, coords_setstate__doc__},
   {NULL}  /* Sentinel */
 };
 
 
-static PyMemberDef spherical_members[] = {
-  {NULL}  /* Sentinel */
-};
-
 
 static PyGetSetDef spherical_getseters[] = {
   {sRstr, (getter)spherical_getR, (setter)spherical_setR, sRstr, NULL},
@@ -3034,124 +3769,328 @@ static PyGetSetDef spherical_getseters[] = {
   {NULL}  /* Sentinel */
 };
 
-// see http://docs.python.org/c-api/typeobj.html
-static PyNumberMethods spherical_as_number = {
-  (binaryfunc) spherical_nb_add,
-  (binaryfunc) spherical_nb_subtract,
-  (binaryfunc) spherical_nb_multiply,
-  (binaryfunc) spherical_nb_divide,
-  (binaryfunc) 0,  // nb_remainder
-  (binaryfunc) 0,  // nb_divmod
-  (ternaryfunc) 0, // nb_power
-  (unaryfunc) spherical_nb_negative,
-  (unaryfunc) 0,   // nb_positive
-  (unaryfunc) 0,   // nb_absolute
-  (inquiry) 0,     // nb_nonzero. Used by PyObject_IsTrue.
-  (unaryfunc) 0,   // nb_invert
-  (binaryfunc) 0,  // nb_lshift
-  (binaryfunc) 0,  // nb_rshift
-  (binaryfunc) 0,  // nb_and
-  (binaryfunc) 0,  // nb_xor
-  (binaryfunc) 0,  // nb_or
-  (coercion) 0,    // Used by the coerce() function
-  (unaryfunc) 0,   // nb_int
-  (unaryfunc) 0,   // nb_long
-  (unaryfunc) 0,   // nb_float
-  (unaryfunc) 0,   // nb_oct
-  (unaryfunc) 0,   // nb_hex
-
-  // added in release 2.0
-
-  (binaryfunc) spherical_nb_inplace_add,
-  (binaryfunc) spherical_nb_inplace_subtract,
-  (binaryfunc) spherical_nb_inplace_multiply,
-  (binaryfunc) spherical_nb_inplace_divide,
-  (binaryfunc) 0,  // nb_inplace_remainder
-  (ternaryfunc) 0, // nb_inplace_power
-  (binaryfunc) 0,  // nb_inplace_lshift
-  (binaryfunc) 0,  // nb_inplace_rshift
-  (binaryfunc) 0,  // nb_inplace_and
-  (binaryfunc) 0,  // nb_inplace_xor
-  (binaryfunc) 0,  // nb_inplace_or
-
-  // added in release 2.2
-  (binaryfunc) 0,  // nb_floor_divide
-  (binaryfunc) 0,  // nb_true_divide
-  (binaryfunc) 0,  // nb_inplace_floor_divide
-  (binaryfunc) 0,  // nb_inplace_true_divide
-
+static PyType_Slot spherical_slots[] = {
+  {Py_tp_dealloc,             (void*) spherical_dealloc},
+  {Py_tp_repr,                (void*) spherical_repr},
+  {Py_tp_str,                 (void*) spherical_str},
+  {Py_tp_doc,                 (void*) "spherical objects"},
+  {Py_tp_richcompare,         (void*) spherical_tp_richcompare},
+  {Py_tp_methods,             (void*) spherical_methods},
+  {Py_tp_getset,              (void*) spherical_getseters},
+  {Py_tp_init,                (void*) spherical_init},
+  {Py_tp_new,                 (void*) spherical_new},
+  {Py_nb_add,                 (void*) spherical_nb_add},
+  {Py_nb_subtract,            (void*) spherical_nb_subtract},
+  {Py_nb_multiply,            (void*) spherical_nb_multiply},
+  {Py_nb_true_divide,         (void*) spherical_nb_true_divide},
+  {Py_nb_negative,            (void*) spherical_nb_negative},
+  {Py_nb_inplace_add,         (void*) spherical_nb_inplace_add},
+  {Py_nb_inplace_subtract,    (void*) spherical_nb_inplace_subtract},
+  {Py_nb_inplace_multiply,    (void*) spherical_nb_inplace_multiply},
+  {Py_nb_inplace_true_divide, (void*) spherical_nb_inplace_true_divide},
+  {0, NULL}  /* Sentinel */
 };
 
-
-PyTypeObject sphericalType = {
-  PyObject_HEAD_INIT(NULL)
-  0,                                        /* ob_size */
-  "spherical",                              /* tp_name */
-  sizeof(spherical),                        /* tp_basicsize */
-  0,                                        /* tp_itemsize */
-  (destructor) spherical_dealloc,           /* tp_dealloc */
-  0,                                        /* tp_print */
-  0,                                        /* tp_getattr */
-  0,                                        /* tp_setattr */
-  0,                                        /* tp_compare */
-  spherical_repr,                           /* tp_repr */
-  &spherical_as_number,                     /* tp_as_number */
-  0,                                        /* tp_as_sequence */
-  0,                                        /* tp_as_mapping */
-  0,                                        /* tp_hash */
-  0,                                        /* tp_call */
-  spherical_str,                            /* tp_str */
-  0,                                        /* tp_getattro */
-  0,                                        /* tp_setattro */
-  0,                                        /* tp_as_buffer */
-  Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE | Py_TPFLAGS_CHECKTYPES, /* tp_flags */
-  "spherical objects",                      /* tp_doc */
-  0,                                        /* tp_traverse */
-  0,                                        /* tp_clear */
-  spherical_tp_richcompare,                 /* tp_richcompare */
-  0,                                        /* tp_weaklistoffset */
-  0,                                        /* tp_iter */
-  0,                                        /* tp_iternext */
-  spherical_methods,                        /* tp_methods */
-  spherical_members,                        /* tp_members */
-  spherical_getseters,                      /* tp_getset */
-  0,                                        /* tp_base */
-  0,                                        /* tp_dict */
-  0,                                        /* tp_descr_get */
-  0,                                        /* tp_descr_set */
-  0,                                        /* tp_dictoffset */
-  (initproc)spherical_init,                 /* tp_init */
-  0,                                        /* tp_alloc */
-  spherical_new,                            /* tp_new */
+static PyType_Spec spherical_spec = {
+  "coords.spherical",               /* name */
+  sizeof(spherical),                /* basicsize */
+  0,                                /* itemsize */
+  Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE | Py_TPFLAGS_IMMUTABLETYPE, /* flags */
+  spherical_slots                   /* slots */
 };
 
 // ------------------------------------------
 // ----- implement forward declarations -----
 // ------------------------------------------
 
-static void new_sphericalType(spherical** a_spherical) {
-  *a_spherical = PyObject_New(spherical, &sphericalType);
+static void new_sphericalType(coords_state* st, spherical** a_spherical) {
+  *a_spherical = (spherical*)freelist_new(st->SphericalFreeList, st->sphericalType);
+  if (*a_spherical)
+    new (&(*a_spherical)->m_spherical) Coords::spherical();
 }
 
-static int is_sphericalType(PyObject* a_spherical) {
-  return PyObject_TypeCheck(a_spherical, &sphericalType);
+static int is_sphericalType(coords_state* st, PyObject* a_spherical) {
+  return PyObject_TypeCheck(a_spherical, st->sphericalType);
 }
 
 // ====================
 // ===== datetime =====
 // ====================
 
+// ----- Python datetime and numpy datetime64 -----
+
+// Conversions field by field, or through int64 nanoseconds for
+// datetime64, never through ISO 8601 strings. The datetime module is
+// imported on first use, numpy only by the datetime64 methods.
+
+// st->datetime_names, interned since PyObject_GetAttrString() costs
+// more than the lookup itself.
+static const char* sDatetimeNames[] = {"year", "month", "day", "hour", "minute", "second", "microsecond",
+					"utcoffset", "datetime", "timezone", "timedelta", "utc"};
+static const int sUtcoffsetName(7);
+static const int sDatetimeName(8);
+static const int sTimezoneName(9);
+static const int sTimedeltaName(10);
+static const int sUtcName(11);
+
+static PyObject* get_datetime_attr(coords_state* st, const int& a_name) {
+  // new reference to datetime.sDatetimeNames[a_name]
+  if (st->datetime_module == NULL) {
+    for (int i = 0; i < 12; ++i)
+      if (st->datetime_names[i] == NULL &&
+	  (st->datetime_names[i] = PyUnicode_InternFromString(sDatetimeNames[i])) == NULL)
+	return NULL;
+    st->datetime_module = PyImport_ImportModule("datetime");
+    if (st->datetime_module == NULL)
+      return NULL;
+  }
+  return PyObject_GetAttr(st->datetime_module, st->datetime_names[a_name]);
+}
+
+static int is_PyDateTime(coords_state* st, PyObject* an_object) {
+  // 1 for a datetime.datetime, 0 if not, -1 on error
+  PyObject* a_class(get_datetime_attr(st, sDatetimeName));
+  if (a_class == NULL)
+    return -1;
+  int result(PyObject_IsInstance(an_object, a_class));
+  Py_DECREF(a_class);
+  return result;
+}
+
+static int PyDateTime2DateTime(coords_state* st, PyObject* a_pydatetime, Coords::DateTime& a_datetime) {
+  // after is_PyDateTime(), which sets up st->datetime_names
+
+  long values[7];
+  for (int i = 0; i < 7; ++i) {
+    PyObject* a_value(PyObject_GetAttr(a_pydatetime, st->datetime_names[i]));
+    if (a_value == NULL)
+      return -1;
+    values[i] = PyLong_AsLong(a_value);
+    Py_DECREF(a_value);
+    if (values[i] == -1 && PyErr_Occurred())
+      return -1;
+  }
+
+  double timezone(0); // naive is UT like the other constructors
+  PyObject* an_offset(PyObject_CallMethodObjArgs(a_pydatetime, st->datetime_names[sUtcoffsetName], NULL));
+  if (an_offset == NULL)
+    return -1;
+  if (an_offset != Py_None) {
+    PyObject* some_seconds(PyObject_CallMethod(an_offset, "total_seconds", NULL));
+    if (some_seconds == NULL) {
+      Py_DECREF(an_offset);
+      return -1;
+    }
+    timezone = PyFloat_AsDouble(some_seconds)/3600.0;
+    Py_DECREF(some_seconds);
+  }
+  Py_DECREF(an_offset);
+  if (PyErr_Occurred())
+    return -1;
+
+  try {
+    a_datetime = Coords::DateTime(values[0], values[1], values[2], values[3], values[4],
+				  values[5] + values[6]*1e-6, timezone);
+  } catch (const Coords::Error& err) {
+    PyErr_SetString(st->Error, err.what());
+    return -1;
+  }
+
+  return 0;
+}
+
+static PyObject* DateTime2PyDateTime(coords_state* st, const Coords::DateTime& a_datetime) {
+
+  PyObject* a_tzinfo(NULL);
+  PyObject* a_timezone_class(get_datetime_attr(st, sTimezoneName));
+  if (a_timezone_class == NULL)
+    return NULL;
+
+  if (a_datetime.timezone() == 0) {
+    a_tzinfo = PyObject_GetAttr(a_timezone_class, st->datetime_names[sUtcName]);
+  } else {
+    PyObject* an_offset(NULL);
+    PyObject* a_timedelta_class(get_datetime_attr(st, sTimedeltaName));
+    if (a_timedelta_class) {
+      an_offset = PyObject_CallFunction(a_timedelta_class, "iL", 0, llround(a_datetime.timezone()*3600));
+      Py_DECREF(a_timedelta_class);
+    }
+    if (an_offset) {
+      a_tzinfo = PyObject_CallFunctionObjArgs(a_timezone_class, an_offset, NULL);
+      Py_DECREF(an_offset);
+    }
+  }
+  Py_DECREF(a_timezone_class);
+  if (a_tzinfo == NULL)
+    return NULL;
+
+  const double whole_seconds(floor(a_datetime.second()));
+  const long long microseconds(llround((a_datetime.second() - whole_seconds)*1e6));
+  const long long seconds_of_day(3600LL*a_datetime.hour() + 60LL*a_datetime.minute() + (long long)whole_seconds);
+
+  // Fields straight across when they are in datetime.datetime range.
+  // Else midnight + timedelta(time of day), which carries minute 60,
+  // second 60 and microsecond rounding into the next field.
+  const bool is_in_range(a_datetime.minute() < 60 && whole_seconds < 60 && microseconds < 1000000 &&
+			 seconds_of_day < 86400);
+
+  PyObject* a_date(NULL);
+  PyObject* a_datetime_class(get_datetime_attr(st, sDatetimeName));
+  if (a_datetime_class) {
+    if (is_in_range)
+      a_date = PyObject_CallFunction(a_datetime_class, "iiiiiiLO",
+				     a_datetime.year(), a_datetime.month(), a_datetime.day(),
+				     a_datetime.hour(), a_datetime.minute(), (int)whole_seconds, microseconds,
+				     a_tzinfo);
+    else
+      a_date = PyObject_CallFunction(a_datetime_class, "iiiiiiiO",
+				     a_datetime.year(), a_datetime.month(), a_datetime.day(),
+				     0, 0, 0, 0, a_tzinfo);
+    Py_DECREF(a_datetime_class);
+  }
+  Py_DECREF(a_tzinfo);
+  if (a_date == NULL || is_in_range)
+    return a_date;
+
+  PyObject* a_time(NULL);
+  PyObject* a_timedelta_class(get_datetime_attr(st, sTimedeltaName));
+  if (a_timedelta_class) {
+    a_time = PyObject_CallFunction(a_timedelta_class, "iLL", 0, seconds_of_day, microseconds);
+    Py_DECREF(a_timedelta_class);
+  }
+  if (a_time == NULL) {
+    Py_DECREF(a_date);
+    return NULL;
+  }
+
+  PyObject* result(PyNumber_Add(a_date, a_time));
+  Py_DECREF(a_date);
+  Py_DECREF(a_time);
+  return result;
+}
+
+static int is_datetime64(PyObject* an_object, bool& is_ns) {
+  // 1 for a numpy datetime64 scalar or array, with is_ns for native
+  // byte order datetime64[ns], 0 if not, -1 on error.
+
+  PyObject* a_dtype(PyObject_GetAttrString(an_object, "dtype"));
+  if (a_dtype == NULL) {
+    PyErr_Clear();
+    return 0;
+  }
+
+  // dtype.str is e.g. "<M8[ns]", much faster than str(dtype)
+  PyObject* a_str(PyObject_GetAttrString(a_dtype, "str"));
+  Py_DECREF(a_dtype);
+  if (a_str == NULL)
+    return -1;
+
+  const char* a_name(PyUnicode_Check(a_str) ? PyUnicode_AsUTF8AndSize(a_str, NULL) : "");
+  int result(0);
+  if (a_name == NULL) {
+    result = -1;
+  } else if (a_name[0] != '\0' && a_name[1] == 'M') {
+#ifdef WORDS_BIGENDIAN
+    is_ns = strcmp(a_name, ">M8[ns]") == 0;
+#else
+    is_ns = strcmp(a_name, "<M8[ns]") == 0;
+#endif
+    result = 1;
+  }
+
+  Py_DECREF(a_str);
+  return result;
+}
+
+static PyObject* datetime64_as_int64(coords_state* st, PyObject* an_object, const bool& a_convert) {
+  // New reference to an int64 view of a datetime64 array, to
+  // an_object itself if it is not datetime64. Other units are
+  // converted to a datetime64[ns] copy if a_convert, else an error.
+
+  bool is_ns(false);
+  const int is_it(is_datetime64(an_object, is_ns));
+  if (is_it < 0)
+    return NULL;
+
+  if (is_it == 0) {
+    Py_INCREF(an_object);
+    return an_object;
+  }
+
+  PyObject* a_ns_array(NULL);
+  if (is_ns) {
+    Py_INCREF(an_object);
+    a_ns_array = an_object;
+  } else if (a_convert) {
+    a_ns_array = PyObject_CallMethod(an_object, "astype", "s", "datetime64[ns]");
+    if (a_ns_array == NULL)
+      return NULL;
+  } else {
+    PyErr_SetString(st->Error, "out must be datetime64[ns] or int64");
+    return NULL;
+  }
+
+  PyObject* result(PyObject_CallMethod(a_ns_array, "view", "s", "int64"));
+  Py_DECREF(a_ns_array);
+  return result;
+}
+
+static int datetime642DateTime(coords_state* st, PyObject* a_datetime64, const bool& is_ns,
+			       Coords::DateTime& a_datetime) {
+  // a datetime64 scalar of any unit. int()
+  // of datetime64[ns] is the nanoseconds, other units convert first.
+
+  PyObject* a_ns_value(NULL);
+  if (is_ns) {
+    Py_INCREF(a_datetime64);
+    a_ns_value = a_datetime64;
+  } else {
+    a_ns_value = PyObject_CallMethod(a_datetime64, "astype", "s", "datetime64[ns]");
+    if (a_ns_value == NULL)
+      return -1;
+  }
+
+  PyObject* a_value(PyNumber_Long(a_ns_value)); // NULL for NaT
+  Py_DECREF(a_ns_value);
+  if (a_value == NULL) {
+    PyErr_Clear();
+    PyErr_SetString(st->Error, "datetime64 must be a time, not NaT");
+    return -1;
+  }
+
+  const long long ns(PyLong_AsLongLong(a_value));
+  Py_DECREF(a_value);
+  if (ns == -1 && PyErr_Occurred())
+    return -1;
+
+  try {
+    a_datetime.fromUnixNanoseconds(ns);
+  } catch (const Coords::Error& err) {
+    PyErr_SetString(st->Error, err.what());
+    return -1;
+  }
+
+  return 0;
+}
+
 // ------------------------
 // ----- constructors -----
 // ------------------------
 
 static PyObject* datetime_new(PyTypeObject* type, PyObject* args, PyObject* kwds) {
+  coords_state* st(get_type_state(type));
   datetime* self(NULL);
-  self = (datetime*)type->tp_alloc(type, 0);
+  if (type == st->datetimeType)
+    self = (datetime*)freelist_new(st->DatetimeFreeList, type);
+  else
+    self = (datetime*)((allocfunc)PyType_GetSlot(type, Py_tp_alloc))(type, 0);
+  if (self)
+    new (&self->m_datetime) Coords::DateTime();
   return (PyObject*)self;
 }
 
 static int datetime_init(datetime* self, PyObject* args, PyObject* kwds) {
+  coords_state* st(get_state((PyObject*)self));
 
   static char* kwlist[] = {sYearStr, sMonthStr, sDayStr, sHourStr, sMinuteStr, sSecondStr, sTimeZoneStr, NULL};
 
@@ -3176,54 +4115,75 @@ static int datetime_init(datetime* self, PyObject* args, PyObject* kwds) {
 
   if (arg0) {
 
-    if (PyString_Check(arg0)) {
+    if (PyUnicode_Check(arg0)) {
 
       // ISO-8601 string constructor
+      const char* a_date_string(PyUnicode_AsUTF8AndSize(arg0, NULL));
+      if (a_date_string == NULL)
+	return -1;
+
       try {
 
-	Coords::DateTime a_datetime(PyString_AsString(arg0));
+	Coords::DateTime a_datetime(a_date_string);
 	self->m_datetime = a_datetime;
 
       } catch (Coords::Error err) {
-	PyErr_SetString(sCoordsException, err.what());
+	PyErr_SetString(st->Error, err.what());
 	return -1;
       }
 
       return 0;
 
-    } else if (is_datetimeType(arg0)) {
+    } else if (is_datetimeType(st, arg0)) {
 
       // copy constrctor
       self->m_datetime = ((datetime*)arg0)->m_datetime;
       return 0;
 
-    } else if (PyFloat_Check(arg0) || PyInt_Check(arg0)) {
+    } else if (PyFloat_Check(arg0) || PyLong_Check(arg0)) {
       year = PyFloat_AsDouble(arg0);
 
     } else {
 
-      PyErr_SetString(sCoordsException, "arg0 must be a datetime, int or float");
+      // datetime.datetime or numpy.datetime64, field level
+      bool is_ns(false);
+      const int is_pydatetime(is_PyDateTime(st, arg0));
+      const int is_it_datetime64(is_pydatetime == 0 ? is_datetime64(arg0, is_ns) : 0);
+      if (is_pydatetime < 0 || is_it_datetime64 < 0)
+	return -1;
+
+      if (is_pydatetime || is_it_datetime64) {
+	if (arg1) {
+	  PyErr_SetString(st->Error, "datetime.datetime and datetime64 take no other args");
+	  return -1;
+	}
+	if (is_pydatetime)
+	  return PyDateTime2DateTime(st, arg0, self->m_datetime);
+	return datetime642DateTime(st, arg0, is_ns, self->m_datetime);
+      }
+
+      PyErr_SetString(st->Error, "arg0 must be a datetime, datetime.datetime, datetime64, int or float");
       return -1;
     }
 
   }
 
-  if (parse_int_arg(arg1, month))
+  if (parse_int_arg(st, arg1, month))
       return -1;
 
-  if (parse_int_arg(arg2, day))
+  if (parse_int_arg(st, arg2, day))
       return -1;
 
-  if (parse_int_arg(arg3, hour))
+  if (parse_int_arg(st, arg3, hour))
       return -1;
 
-  if (parse_int_arg(arg4, minute))
+  if (parse_int_arg(st, arg4, minute))
       return -1;
 
-  if (parse_double_arg(arg5, second))
+  if (parse_double_arg(st, arg5, second))
       return -1;
 
-  if (parse_double_arg(arg6, timezone))
+  if (parse_double_arg(st, arg6, timezone))
       return -1;
 
   // create datetime
@@ -3234,7 +4194,7 @@ static int datetime_init(datetime* self, PyObject* args, PyObject* kwds) {
     self->m_datetime = a_datetime;
 
   } catch (Coords::Error err) {
-    PyErr_SetString(sCoordsException, err.what());
+    PyErr_SetString(st->Error, err.what());
     return -1;
   }
 
@@ -3244,7 +4204,9 @@ static int datetime_init(datetime* self, PyObject* args, PyObject* kwds) {
 
 
 static void datetime_dealloc(datetime* self) {
-  self->ob_type->tp_free((PyObject*)self);
+  coords_state* st(get_state((PyObject*)self));
+  self->m_datetime.~DateTime();
+  freelist_free(st->DatetimeFreeList, st->datetimeType, (PyObject*)self);
 }
 
 // -----------------
@@ -3255,7 +4217,7 @@ PyObject* datetime_str(PyObject* self) {
   std::stringstream result;
   result.precision(sPrintPrecision);
   result << ((datetime*)self)->m_datetime;
-  return PyString_FromString(result.str().c_str());
+  return PyUnicode_FromString(result.str().c_str());
 }
 
 // TODO a different repr? for constructor?
@@ -3263,7 +4225,7 @@ PyObject* datetime_repr(PyObject* self) {
   std::stringstream result;
   result.precision(sPrintPrecision);
   result << ((datetime*)self)->m_datetime;
-  return PyString_FromString(result.str().c_str());
+  return PyUnicode_FromString(result.str().c_str());
 }
 
 // -------------------------------
@@ -3277,14 +4239,15 @@ static PyObject* datetime_getJulianDate(datetime* self, void* closure) {
 }
 
 static int datetime_setJulianDate(datetime* self, PyObject* value, void* closure) {
+  coords_state* st(get_state((PyObject*)self));
 
   if (value == NULL) {
-    PyErr_SetString(sCoordsException, "can not delete Julian Date");
+    PyErr_SetString(st->Error, "can not delete Julian Date");
     return -1;
   }
 
-  if (!PyFloat_Check(value) && !PyInt_Check(value)) {
-    PyErr_SetString(sCoordsException, "Julian Date must be float or int");
+  if (!PyFloat_Check(value) && !PyLong_Check(value)) {
+    PyErr_SetString(st->Error, "Julian Date must be float or int");
     return -1;
   }
 
@@ -3302,14 +4265,15 @@ static PyObject* datetime_getTimeZone(datetime* self, void* closure) {
 }
 
 static int datetime_setTimeZone(datetime* self, PyObject* a_timezone, void* closure) {
+  coords_state* st(get_state((PyObject*)self));
 
   if (a_timezone == NULL) {
-    PyErr_SetString(sCoordsException, "can not delete timezone");
+    PyErr_SetString(st->Error, "can not delete timezone");
     return -1;
   }
 
-  if (!PyFloat_Check(a_timezone) && !PyInt_Check(a_timezone)) {
-    PyErr_SetString(sCoordsException, "timezone must be a float or int");
+  if (!PyFloat_Check(a_timezone) && !PyLong_Check(a_timezone)) {
+    PyErr_SetString(st->Error, "timezone must be a float or int");
     return -1;
   }
 
@@ -3351,25 +4315,27 @@ static PyObject* datetime_getJ2000(datetime* self, void* closure) {
 
 
 static PyObject* datetime_nb_add(PyObject* o1, PyObject* o2) {
+  coords_state* st(get_state2(o1, o2));
 
   datetime* result_datetime(NULL);
-  new_datetimeType(&result_datetime);
+  new_datetimeType(st, &result_datetime);
 
   if (result_datetime == NULL) {
-    PyErr_SetString(sCoordsException, "add failed to create coord.datetime");
+    PyErr_SetString(st->Error, "add failed to create coord.datetime");
     return NULL;
   }
 
-  if (is_datetimeType(o1) && (PyFloat_Check(o2) || PyInt_Check(o2))) {
+  if (is_datetimeType(st, o1) && (PyFloat_Check(o2) || PyLong_Check(o2))) {
     result_datetime->m_datetime = ((datetime*)o1)->m_datetime + PyFloat_AsDouble(o2);
     return (PyObject*) result_datetime;
   }
 
-  if ((PyFloat_Check(o1) || PyInt_Check(o1)) && is_datetimeType(o2)) {
+  if ((PyFloat_Check(o1) || PyLong_Check(o1)) && is_datetimeType(st, o2)) {
     result_datetime->m_datetime = PyFloat_AsDouble(o1) + ((datetime*)o2)->m_datetime;
     return (PyObject*) result_datetime;
   }
 
+  Py_DECREF(result_datetime);
   Py_INCREF(Py_NotImplemented);
   return Py_NotImplemented;
 
@@ -3377,25 +4343,28 @@ static PyObject* datetime_nb_add(PyObject* o1, PyObject* o2) {
 
 
 static PyObject* datetime_nb_subtract(PyObject* o1, PyObject* o2) {
+  coords_state* st(get_state2(o1, o2));
 
   datetime* result_datetime(NULL);
-  new_datetimeType(&result_datetime);
+  new_datetimeType(st, &result_datetime);
 
   if (result_datetime == NULL) {
-    PyErr_SetString(sCoordsException, "subtract failed to create coord.datetime");
+    PyErr_SetString(st->Error, "subtract failed to create coord.datetime");
     return NULL;
   }
 
-  if (is_datetimeType(o1) && (PyFloat_Check(o2) || PyInt_Check(o2))) {
+  if (is_datetimeType(st, o1) && (PyFloat_Check(o2) || PyLong_Check(o2))) {
     result_datetime->m_datetime = ((datetime*)o1)->m_datetime - PyFloat_AsDouble(o2);
     return (PyObject*) result_datetime;
   }
 
-  if (is_datetimeType(o1) && is_datetimeType(o2)) {
+  if (is_datetimeType(st, o1) && is_datetimeType(st, o2)) {
+    Py_DECREF(result_datetime);
     double delta = ((datetime*)o1)->m_datetime - ((datetime*)o2)->m_datetime;
     return (PyObject*) Py_BuildValue("d", delta);
   }
 
+  Py_DECREF(result_datetime);
   Py_INCREF(Py_NotImplemented);
   return Py_NotImplemented;
 
@@ -3407,24 +4376,26 @@ static PyObject* datetime_nb_subtract(PyObject* o1, PyObject* o2) {
 // ---------------------------
 
 static PyObject* datetime_nb_inplace_add(PyObject* o1, PyObject* o2) {
-  if (is_datetimeType(o1) && (PyFloat_Check(o2) || PyInt_Check(o2))) {
+  coords_state* st(get_state(o1));
+  if (is_datetimeType(st, o1) && (PyFloat_Check(o2) || PyLong_Check(o2))) {
     double jdate = PyFloat_AsDouble(o2);
     ((datetime*)o1)->m_datetime.operator+=(jdate);
     Py_INCREF(o1);
     return o1;
   }
-  PyErr_SetString(sCoordsException, "datetime::operator+=() only supports datetime types");
+  PyErr_SetString(st->Error, "datetime::operator+=() only supports datetime types");
   return NULL;
 }
 
 static PyObject* datetime_nb_inplace_subtract(PyObject* o1, PyObject* o2) {
-  if (is_datetimeType(o1) && (PyFloat_Check(o2) || PyInt_Check(o2))) {
+  coords_state* st(get_state(o1));
+  if (is_datetimeType(st, o1) && (PyFloat_Check(o2) || PyLong_Check(o2))) {
     double jdate = PyFloat_AsDouble(o2);
     ((datetime*)o1)->m_datetime.operator-=(jdate);
     Py_INCREF(o1);
     return o1;
   }
-  PyErr_SetString(sCoordsException, "datetime::operator-=() only supports datetime types");
+  PyErr_SetString(st->Error, "datetime::operator-=() only supports datetime types");
   return NULL;
 }
 
@@ -3444,6 +4415,59 @@ static PyObject* datetime_fromJulianDate(PyObject* o1, PyObject* o2) {
   return Py_None;
 }
 
+// ----- Python datetime and numpy datetime64 -----
+
+static PyObject* datetime_toDatetime(PyObject* self, PyObject* args) {
+  coords_state* st(get_state(self));
+  return DateTime2PyDateTime(st, ((datetime*)self)->m_datetime);
+}
+
+static PyObject* datetime_toDatetime64(PyObject* self, PyObject* args) {
+  coords_state* st(get_state(self));
+
+  long long ns(0);
+  try {
+    ns = ((datetime*)self)->m_datetime.toUnixNanoseconds();
+  } catch (const Coords::Error& err) {
+    PyErr_SetString(st->Error, err.what());
+    return NULL;
+  }
+
+  PyObject* numpy(PyImport_ImportModule("numpy"));
+  if (numpy == NULL) {
+    PyErr_Clear();
+    PyErr_SetString(st->Error, "numpy is not available");
+    return NULL;
+  }
+  PyObject* result(PyObject_CallMethod(numpy, "datetime64", "Ls", ns, "ns"));
+  Py_DECREF(numpy);
+  return result;
+}
+
+// ----- pickle -----
+
+static PyObject* datetime_reduce(PyObject* self, PyObject* args) {
+  char a_record[Coords::DateTime_binary_size];
+  Coords::DateTime2binary(&((datetime*)self)->m_datetime, a_record, 1);
+  return reduce_binary(self, a_record, sizeof(a_record));
+}
+
+static PyObject* datetime_setstate(PyObject* self, PyObject* state) {
+  coords_state* st(get_state(self));
+  const char* a_record(get_binary_state(st, state, Coords::DateTime_binary_size));
+  if (a_record == NULL)
+    return NULL;
+  try {
+    Coords::DateTime a_datetime; // unchanged if the record is invalid
+    Coords::binary2DateTime(a_record, &a_datetime, 1);
+    ((datetime*)self)->m_datetime = a_datetime;
+  } catch (const Coords::Error& err) {
+    PyErr_SetString(st->Error, err.what());
+    return NULL;
+  }
+  Py_RETURN_NONE;
+}
+
 // --------------------------
 // ----- Python structs -----
 // --------------------------
@@ -3453,6 +4477,8 @@ PyDoc_STRVAR(datetime_fromJulianDate__doc__, "Sets the Julian date of the dateti
 PyDoc_STRVAR(datetime_get_timezone__doc__, "Returns the time zone of the datetime object");
 PyDoc_STRVAR(datetime_set_timezone__doc__, "Sets the time zone of the datetime object");
 PyDoc_STRVAR(datetime_UT__doc__, "Returns universal time of the datetime object");
+PyDoc_STRVAR(datetime_toDatetime__doc__, "Returns a timezone aware datetime.datetime, rounded to microseconds");
+PyDoc_STRVAR(datetime_toDatetime64__doc__, "Returns a numpy.datetime64 in nanoseconds");
 
 static PyMethodDef datetime_methods[] = {
   {"toJulianDate", (PyCFunction) datetime_getJulianDate, METH_VARARGS, datetime_toJulianDate__doc__},
@@ -3460,14 +4486,14 @@ static PyMethodDef datetime_methods[] = {
   {"getTimezone", (PyCFunction) datetime_getTimeZone, METH_VARARGS, datetime_get_timezone__doc__},
   {"setTimezone", (PyCFunction) datetime_setTimeZone, METH_VARARGS, datetime_set_timezone__doc__},
   {"UT", (PyCFunction) datetime_getUT, METH_VARARGS, datetime_UT__doc__},
+  {"toDatetime", (PyCFunction) datetime_toDatetime, METH_NOARGS, datetime_toDatetime__doc__},
+  {"toDatetime64", (PyCFunction) datetime_toDatetime64, METH_NOARGS, datetime_toDatetime64__doc__},
+  {"__reduce__", (PyCFunction) datetime_reduce, METH_NOARGS, coords_reduce__doc__},
+  {"__setstate__", (PyCFunction) datetime_setstate, METH_O, coords_setstate__doc__},
   {NULL}  /* Sentinel */
 };
 
 
-static PyMemberDef datetime_members[] = {
-  {NULL}  /* Sentinel */
-};
-
 static PyGetSetDef datetime_getseters[] = {
   {sJulianDateStr, (getter)datetime_getJulianDate, (setter)datetime_setJulianDate, sJulianDateStr, NULL},
   {sTimeZoneStr, (getter)datetime_getTimeZone, (setter)datetime_setTimeZone, sTimeZoneStr, NULL},
@@ -3480,108 +4506,43 @@ static PyGetSetDef datetime_getseters[] = {
 };
 
 
-// see http://docs.python.org/c-api/typeobj.html
-static PyNumberMethods datetime_as_number = {
-  (binaryfunc) datetime_nb_add,
-  (binaryfunc) datetime_nb_subtract,
-  (binaryfunc) 0,   // nb_multiply,
-  (binaryfunc) 0,   // nb_divide,
-  (binaryfunc) 0,   // nb_remainder
-  (binaryfunc) 0,   // nb_divmod
-  (ternaryfunc) 0,  // nb_power
-  (unaryfunc) 0,    // nb_negative,
-  (unaryfunc) 0,    // nb_positive
-  (unaryfunc) 0,    // nb_absolute
-  (inquiry) 0,      // nb_nonzero. Used by PyObject_IsTrue.
-  (unaryfunc) 0,    // nb_invert
-  (binaryfunc) 0,   // nb_lshift
-  (binaryfunc) 0,   // nb_rshift
-  (binaryfunc) 0,   // nb_and
-  (binaryfunc) 0,   // nb_xor
-  (binaryfunc) 0,   // nb_or
-  (coercion) 0,     // Used by the coerce() function
-  (unaryfunc) 0,    // nb_int
-  (unaryfunc) 0,    // nb_long
-  (unaryfunc) 0,    // nb_float
-  (unaryfunc) 0,    // nb_oct
-  (unaryfunc) 0,    // nb_hex
-
-  // added in release 2.0
-
-  (binaryfunc) datetime_nb_inplace_add,
-  (binaryfunc) datetime_nb_inplace_subtract,
-  (binaryfunc) 0,  // nb_inplace_multiply,
-  (binaryfunc) 0,  // nb_inplace_divide,
-  (binaryfunc) 0,  // nb_inplace_remainder
-  (ternaryfunc) 0, // nb_inplace_power
-  (binaryfunc) 0,  // nb_inplace_lshift
-  (binaryfunc) 0,  // nb_inplace_rshift
-  (binaryfunc) 0,  // nb_inplace_and
-  (binaryfunc) 0,  // nb_inplace_xor
-  (binaryfunc) 0,  // nb_inplace_or
-
-  // added in release 2.2
-  (binaryfunc) 0,  // nb_floor_divide
-  (binaryfunc) 0,  // nb_true_divide
-  (binaryfunc) 0,  // nb_inplace_floor_divide
-  (binaryfunc) 0,  // nb_inplace_true_divide
-
+static PyType_Slot datetime_slots[] = {
+  {Py_tp_dealloc,          (void*) datetime_dealloc},
+  {Py_tp_repr,             (void*) datetime_repr},
+  {Py_tp_str,              (void*) datetime_str},
+  {Py_tp_doc,              (void*) "datetime objects"},
+  {Py_tp_methods,          (void*) datetime_methods},
+  {Py_tp_getset,           (void*) datetime_getseters},
+  {Py_tp_init,             (void*) datetime_init},
+  {Py_tp_new,              (void*) datetime_new},
+  {Py_nb_add,              (void*) datetime_nb_add},
+  {Py_nb_subtract,         (void*) datetime_nb_subtract},
+  {Py_nb_inplace_add,      (void*) datetime_nb_inplace_add},
+  {Py_nb_inplace_subtract, (void*) datetime_nb_inplace_subtract},
+  {0, NULL}  /* Sentinel */
 };
 
-
-PyTypeObject datetimeType = {
-  PyObject_HEAD_INIT(NULL)
-  0,                                 /* ob_size */
-  "datetime",                        /* tp_name */
-  sizeof(datetime),                  /* tp_basicsize */
-  0,                                 /* tp_itemsize */
-  (destructor) datetime_dealloc,     /* tp_dealloc */
-  0,                                 /* tp_print */
-  0,                                 /* tp_getattr */
-  0,                                 /* tp_setattr */
-  0,                                 /* tp_compare */
-  datetime_repr,                        /* tp_repr */
-  &datetime_as_number,                  /* tp_as_number */
-  0,                                 /* tp_as_sequence */
-  0,                                 /* tp_as_mapping */
-  0,                                 /* tp_hash */
-  0,                                 /* tp_call */
-  datetime_str,                         /* tp_str */
-  0,                                 /* tp_getattro */
-  0,                                 /* tp_setattro */
-  0,                                 /* tp_as_buffer */
-  Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE | Py_TPFLAGS_CHECKTYPES, /* tp_flags */
-  "datetime objects",                /* tp_doc */
-  0,                                 /* tp_traverse */
-  0,                                 /* tp_clear */
-  0,                                 /* tp_richcompare */
-  0,                                 /* tp_weaklistoffset */
-  0,                                 /* tp_iter */
-  0,                                 /* tp_iternext */
-  datetime_methods,                     /* tp_methods */
-  datetime_members,                     /* tp_members */
-  datetime_getseters,                   /* tp_getset */
-  0,                                 /* tp_base */
-  0,                                 /* tp_dict */
-  0,                                 /* tp_descr_get */
-  0,                                 /* tp_descr_set */
-  0,                                 /* tp_dictoffset */
-  (initproc)datetime_init,              /* tp_init */
-  0,                                 /* tp_alloc */
-  datetime_new,                         /* tp_new */
+static PyType_Spec datetime_spec = {
+  "coords.datetime",                /* name */
+  sizeof(datetime),                 /* basicsize */
+  0,                                /* itemsize */
+  Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE | Py_TPFLAGS_IMMUTABLETYPE, /* flags */
+  datetime_slots                    /* slots */
 };
 
 // ------------------------------------------
 // ----- implement forward declarations -----
 // ------------------------------------------
 
-static void new_datetimeType(datetime** an_angle) {
-  *an_angle = PyObject_New(datetime, &datetimeType);
+static void new_datetimeType(coords_state* st, datetime** an_angle) {
+  *an_angle = (datetime*)freelist_new(st->DatetimeFreeList, st->datetimeType);
+  if (*an_angle)
+    new (&(*an_angle)->m_datetime) Coords::DateTime();
 }
 
-static int is_datetimeType(PyObject* an_angle) {
+static int is_datetimeType(coords_state* st, PyObject* an_angle) {
   //wrapper for type check
-  return PyObject_TypeCheck(an_angle, &datetimeType);
+  return PyObject_TypeCheck(an_angle, st->datetimeType);
 }
 
 
@@ -3590,23 +4551,24 @@ static int is_datetimeType(PyObject* an_angle) {
 // --------------------------
 
 // ----- Cartesian cross product -----
-static PyObject* Cartesian_cross(PyObject* self, PyObject *args) {
-
-  PyObject* arg0(NULL);
-  PyObject* arg1(NULL);
+static PyObject* Cartesian_cross(PyObject* self, PyObject* const* args, Py_ssize_t nargs) {
+  coords_state* st((coords_state*)PyModule_GetState(self));
 
-  if (!PyArg_ParseTuple(args, "OO", &arg0, &arg1))
+  if (check_nargs("cross", nargs, 2))
     return NULL;
 
-  if (!is_CartesianType(arg0) || !is_CartesianType(arg1)) {
-    PyErr_SetString(sCoordsException, "dot product takes two Cartesian types");
+  PyObject* arg0(args[0]);
+  PyObject* arg1(args[1]);
+
+  if (!is_CartesianType(st, arg0) || !is_CartesianType(st, arg1)) {
+    PyErr_SetString(st->Error, "dot product takes two Cartesian types");
     return NULL;
   }
 
   Cartesian* result_Cartesian(NULL);
-  result_Cartesian = PyObject_New(Cartesian, &CartesianType); // alloc and inits
+  new_CartesianType(st, &result_Cartesian);
   if (result_Cartesian == NULL) {
-    PyErr_SetString(sCoordsException, "cross product failed to create Cartesian.");
+    PyErr_SetString(st->Error, "cross product failed to create Cartesian.");
     return NULL;
   }
 
@@ -3621,25 +4583,487 @@ static PyObject* Cartesian_cross(PyObject* self, PyObject *args) {
 }
 
 // ----- Cartesian dot product -----
-static PyObject* Cartesian_dot(PyObject* self, PyObject *args) {
+static PyObject* Cartesian_dot(PyObject* self, PyObject* const* args, Py_ssize_t nargs) {
+  coords_state* st((coords_state*)PyModule_GetState(self));
+
+  if (check_nargs("dot", nargs, 2))
+    return NULL;
+
+  PyObject* arg0(args[0]);
+  PyObject* arg1(args[1]);
+
+  if (!is_CartesianType(st, arg0) || !is_CartesianType(st, arg1)) {
+    PyErr_SetString(st->Error, "dot product takes two Cartesian types");
+    return NULL;
+  }
+
+  double a_dot_product(Coords::dot(((Cartesian*)arg0)->m_Cartesian, ((Cartesian*)arg1)->m_Cartesian));
+
+  return (PyObject*) PyFloat_FromDouble(a_dot_product);
+
+}
+
+// ---------------------------
+// ----- batch functions -----
+// ---------------------------
+
+// The buffers stay exported, i.e. pinned, while the kernels run, so
+// the GIL is released around them. Other threads writing the same
+// buffers at the same time get what they deserve.
+
+typedef void (*batch_function)(const double*, double*, const size_t&);
+
+static PyObject* apply_batch_function(coords_state* st, PyObject* args, PyObject* kwds,
+				      const char* a_format,
+				      const Py_ssize_t& an_in_width,
+				      const Py_ssize_t& an_out_width,
+				      batch_function a_function) {
+
+  static char* kwlist[] = {sValuesStr, sOutStr, NULL};
+
+  PyObject* arg0(NULL);
+  PyObject* out(NULL);
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, a_format, kwlist, &arg0, &out))
+    return NULL;
+
+  DoubleBuffer values;
+  Py_ssize_t rows(0);
+  if (values.get(st, arg0, PyBUF_SIMPLE) < 0 || get_batch_rows(st, values, an_in_width, rows) < 0)
+    return NULL;
+
+  DoubleBuffer result_values;
+  PyObject* result(get_batch_output(st, out, rows, an_out_width, result_values));
+  if (result == NULL)
+    return NULL;
+
+  Py_BEGIN_ALLOW_THREADS
+  a_function(values.data(), result_values.data(), rows);
+  Py_END_ALLOW_THREADS
+
+  return result;
+}
+
+static PyObject* batch_magnitude(PyObject* self, PyObject* args, PyObject* kwds) {
+  coords_state* st((coords_state*)PyModule_GetState(self));
+  return apply_batch_function(st, args, kwds, "O|O:magnitude", 3, 1, Coords::magnitude);
+}
+
+static PyObject* batch_normalized(PyObject* self, PyObject* args, PyObject* kwds) {
+  coords_state* st((coords_state*)PyModule_GetState(self));
+  return apply_batch_function(st, args, kwds, "O|O:normalized", 3, 3, Coords::normalized);
+}
+
+static PyObject* batch_Cartesian2spherical(PyObject* self, PyObject* args, PyObject* kwds) {
+  coords_state* st((coords_state*)PyModule_GetState(self));
+  return apply_batch_function(st, args, kwds, "O|O:Cartesian2spherical", 3, 3, Coords::Cartesian2spherical);
+}
+
+static PyObject* batch_spherical2Cartesian(PyObject* self, PyObject* args, PyObject* kwds) {
+  coords_state* st((coords_state*)PyModule_GetState(self));
+  return apply_batch_function(st, args, kwds, "O|O:spherical2Cartesian", 3, 3, Coords::spherical2Cartesian);
+}
+
+static PyObject* batch_unixTime2JulianDate(PyObject* self, PyObject* args, PyObject* kwds) {
+  coords_state* st((coords_state*)PyModule_GetState(self));
+  return apply_batch_function(st, args, kwds, "O|O:unixTime2JulianDate", 1, 1, Coords::unixTime2JulianDate);
+}
+
+static PyObject* batch_JulianDate2unixTime(PyObject* self, PyObject* args, PyObject* kwds) {
+  coords_state* st((coords_state*)PyModule_GetState(self));
+  return apply_batch_function(st, args, kwds, "O|O:JulianDate2unixTime", 1, 1, Coords::JulianDate2unixTime);
+}
+
+static PyObject* batch_datetime642JulianDate(PyObject* self, PyObject* args, PyObject* kwds) {
+  coords_state* st((coords_state*)PyModule_GetState(self));
+
+  static char* kwlist[] = {sValuesStr, sOutStr, NULL};
+
+  PyObject* arg0(NULL);
+  PyObject* out(NULL);
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|O:datetime642JulianDate", kwlist, &arg0, &out))
+    return NULL;
+
+  PyObject* an_int64_array(datetime64_as_int64(st, arg0, true));
+  if (an_int64_array == NULL)
+    return NULL;
+
+  Int64Buffer values;
+  const int got_values(values.get(st, an_int64_array, PyBUF_SIMPLE));
+  Py_DECREF(an_int64_array); // the view keeps it
+  if (got_values < 0)
+    return NULL;
+
+  const Py_ssize_t rows(values.size());
+
+  DoubleBuffer result_values;
+  PyObject* result(get_batch_output(st, out, rows, 1, result_values));
+  if (result == NULL)
+    return NULL;
+
+  Py_BEGIN_ALLOW_THREADS
+  Coords::unixNanoseconds2JulianDate(values.data(), result_values.data(), rows);
+  Py_END_ALLOW_THREADS
+
+  return result;
+}
+
+static PyObject* batch_JulianDate2datetime64(PyObject* self, PyObject* args, PyObject* kwds) {
+  coords_state* st((coords_state*)PyModule_GetState(self));
+
+  static char* kwlist[] = {sValuesStr, sOutStr, NULL};
+
+  PyObject* arg0(NULL);
+  PyObject* out(NULL);
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|O:JulianDate2datetime64", kwlist, &arg0, &out))
+    return NULL;
+
+  DoubleBuffer values;
+  if (values.get(st, arg0, PyBUF_SIMPLE) < 0)
+    return NULL;
+
+  const Py_ssize_t rows(values.size());
+
+  PyObject* result(out);
+  if (result)
+    Py_INCREF(result);
+  else
+    result = new_double_array(st, rows, 1, "datetime64[ns]");
+  if (result == NULL)
+    return NULL;
+
+  Int64Buffer result_values;
+  PyObject* an_int64_array(datetime64_as_int64(st, result, false));
+  const int got_result(an_int64_array ? result_values.get(st, an_int64_array, PyBUF_WRITABLE) : -1);
+  Py_XDECREF(an_int64_array);
+  if (got_result < 0) {
+    Py_DECREF(result);
+    return NULL;
+  }
+
+  if (result_values.size() != rows) {
+    PyErr_SetString(st->Error, "out is the wrong size");
+    Py_DECREF(result);
+    return NULL;
+  }
+
+  Py_BEGIN_ALLOW_THREADS
+  Coords::JulianDate2unixNanoseconds(values.data(), result_values.data(), rows);
+  Py_END_ALLOW_THREADS
+
+  return result;
+}
+
+static PyObject* batch_separation(PyObject* self, PyObject* args, PyObject* kwds) {
+  coords_state* st((coords_state*)PyModule_GetState(self));
+
+  static char* kwlist[] = {sAStr, sBStr, sOutStr, NULL};
 
   PyObject* arg0(NULL);
   PyObject* arg1(NULL);
+  PyObject* out(NULL);
 
-  if (!PyArg_ParseTuple(args, "OO", &arg0, &arg1))
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "OO|O:separation", kwlist, &arg0, &arg1, &out))
     return NULL;
 
-  if (!is_CartesianType(arg0) || !is_CartesianType(arg1)) {
-    PyErr_SetString(sCoordsException, "dot product takes two Cartesian types");
+  DoubleBuffer a_values;
+  DoubleBuffer b_values;
+  Py_ssize_t rows(0);
+  if (a_values.get(st, arg0, PyBUF_SIMPLE) < 0 || b_values.get(st, arg1, PyBUF_SIMPLE) < 0 ||
+      get_batch_rows(st, a_values, 3, rows) < 0)
+    return NULL;
+
+  if (a_values.size() != b_values.size()) {
+    PyErr_SetString(st->Error, "separation() arrays must be the same size");
     return NULL;
   }
 
-  double a_dot_product(Coords::dot(((Cartesian*)arg0)->m_Cartesian, ((Cartesian*)arg1)->m_Cartesian));
+  DoubleBuffer result_values;
+  PyObject* result(get_batch_output(st, out, rows, 1, result_values));
+  if (result == NULL)
+    return NULL;
+
+  Py_BEGIN_ALLOW_THREADS
+  Coords::separation(a_values.data(), b_values.data(), result_values.data(), rows);
+  Py_END_ALLOW_THREADS
+
+  return result;
+}
+
+static PyObject* batch_normalize(PyObject* self, PyObject* args, PyObject* kwds) {
+  coords_state* st((coords_state*)PyModule_GetState(self));
+  // in place
 
-  return (PyObject*) Py_BuildValue("d", a_dot_product);
+  static char* kwlist[] = {sValuesStr, sBeginStr, sEndStr, NULL};
 
+  PyObject* arg0(NULL);
+  double begin(0.0);
+  double end(360.0);
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|dd:normalize", kwlist, &arg0, &begin, &end))
+    return NULL;
+
+  DoubleBuffer values;
+  if (values.get(st, arg0, PyBUF_WRITABLE) < 0)
+    return NULL;
+
+  Py_BEGIN_ALLOW_THREADS
+  Coords::normalize(values.data(), values.size(), begin, end);
+  Py_END_ALLOW_THREADS
+
+  Py_INCREF(arg0);
+  return arg0;
 }
 
+// =================================
+// ===== expression evaluation =====
+// =================================
+
+// A vector formula like "m*a + q*cross(v, B)" is compiled once to a
+// Coords::expression and run over whole arrays in one pass, with out
+// a temporary coords object or numpy array for each operator. The
+// arrays are keywords named after the formula variables:
+//
+//   float or int           one scalar for all the rows
+//   Cartesian              one vector for all the rows
+//   (n,) float64 buffer    a scalar per row
+//   (n, 3) float64 buffer  a vector per row, packed x, y, z
+//
+// The result is (n,) or (n, 3), n is 1 if all of them are broadcast.
+
+static PyObject* evaluate_expression(coords_state* st, const Coords::expression& an_expression, PyObject* kwds) {
+
+  const std::vector<std::string>& names(an_expression.names());
+
+  PyObject* out(kwds ? PyDict_GetItemString(kwds, sOutStr) : NULL); // borrowed
+  const Py_ssize_t an_array_count(kwds ? PyDict_Size(kwds) - (out ? 1 : 0) : 0);
+  if (out == Py_None)
+    out = NULL;
+  if (an_array_count != (Py_ssize_t)names.size()) {
+    std::stringstream emsg;
+    emsg << an_expression.formula() << ": needs keyword arrays";
+    for (size_t i = 0; i < names.size(); ++i)
+      emsg << (i ? ", " : " ") << names[i];
+    emsg << " and out=None, not " << an_array_count << " arrays";
+    PyErr_SetString(st->Error, emsg.str().c_str());
+    return NULL;
+  }
+
+  std::vector<Coords::expression::argument> an_args(names.size());
+  std::vector<double> broadcasts(3*names.size());
+  std::vector<DoubleBuffer> buffers(names.size());
+  Py_ssize_t rows(-1);
+
+  for (size_t i = 0; i < names.size(); ++i) {
+
+    PyObject* an_array(PyDict_GetItemString(kwds, names[i].c_str())); // borrowed
+    if (an_array == NULL) {
+      std::string emsg(an_expression.formula() + ": missing keyword array " + names[i]);
+      PyErr_SetString(st->Error, emsg.c_str());
+      return NULL;
+    }
+
+    Coords::expression::argument& an_arg(an_args[i]);
+
+    if (PyFloat_Check(an_array) || PyLong_Check(an_array)) {
+      broadcasts[3*i] = PyFloat_AsDouble(an_array);
+      if (PyErr_Occurred())
+	return NULL;
+      an_arg.m_data = &broadcasts[3*i];
+      an_arg.m_width = 1;
+      an_arg.m_broadcast = true;
+      continue;
+    }
+
+    if (is_CartesianType(st, an_array)) {
+      const Coords::Cartesian& a_Cartesian(((Cartesian*)an_array)->m_Cartesian);
+      broadcasts[3*i] = a_Cartesian.x();
+      broadcasts[3*i + 1] = a_Cartesian.y();
+      broadcasts[3*i + 2] = a_Cartesian.z();
+      an_arg.m_data = &broadcasts[3*i];
+      an_arg.m_width = 3;
+      an_arg.m_broadcast = true;
+      continue;
+    }
+
+    DoubleBuffer& a_buffer(buffers[i]);
+    if (a_buffer.get(st, an_array, PyBUF_SIMPLE) < 0)
+      return NULL;
+
+    Py_ssize_t a_rows(0);
+    if (a_buffer.ndim() == 1) {
+      a_rows = a_buffer.shape(0);
+      an_arg.m_width = 1;
+    } else if (a_buffer.ndim() == 2 && a_buffer.shape(1) == 3) {
+      a_rows = a_buffer.shape(0);
+      an_arg.m_width = 3;
+    } else {
+      std::string emsg(names[i] + " must be a float, a Cartesian or an (n,) or (n, 3) float64 buffer");
+      PyErr_SetString(st->Error, emsg.c_str());
+      return NULL;
+    }
+
+    if (rows >= 0 && a_rows != rows) {
+      std::string emsg(an_expression.formula() + ": arrays must have the same number of rows");
+      PyErr_SetString(st->Error, emsg.c_str());
+      return NULL;
+    }
+
+    rows = a_rows;
+    an_arg.m_data = a_buffer.data();
+    an_arg.m_broadcast = false;
+  }
+
+  if (rows < 0)
+    rows = 1;
+
+  size_t a_width(0);
+  try {
+    a_width = an_expression.width(an_args);
+  } catch (const Coords::Error& err) {
+    PyErr_SetString(st->Error, err.what());
+    return NULL;
+  }
+
+  DoubleBuffer result_values;
+  PyObject* result(get_batch_output(st, out, rows, a_width, result_values));
+  if (result == NULL)
+    return NULL;
+
+  // width() checked the arguments, evaluate() does not throw now.
+  Py_BEGIN_ALLOW_THREADS
+  an_expression.evaluate(an_args, result_values.data(), rows);
+  Py_END_ALLOW_THREADS
+
+  return result;
+}
+
+// ------------------------
+// ----- constructors -----
+// ------------------------
+
+static PyObject* expression_new(PyTypeObject* type, PyObject* args, PyObject* kwds) {
+  coords_state* st(get_type_state(type));
+
+  static char* kwlist[] = {sFormulaStr, NULL};
+
+  const char* a_formula(NULL);
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "s:expression", kwlist, &a_formula))
+    return NULL;
+
+  expression* self(NULL);
+  try {
+    Coords::expression an_expression(a_formula);
+    self = (expression*)((allocfunc)PyType_GetSlot(type, Py_tp_alloc))(type, 0);
+    if (self)
+      new (&self->m_expression) Coords::expression(an_expression);
+  } catch (const Coords::Error& err) {
+    PyErr_SetString(st->Error, err.what());
+    return NULL;
+  }
+
+  return (PyObject*)self;
+}
+
+static void expression_dealloc(expression* self) {
+  PyTypeObject* its_type(Py_TYPE((PyObject*)self));
+  self->m_expression.~expression();
+  ((freefunc)PyType_GetSlot(its_type, Py_tp_free))((PyObject*)self);
+  Py_DECREF(its_type);
+}
+
+// -------------------------------
+// ----- getters and setters -----
+// -------------------------------
+
+static PyObject* expression_getFormula(expression* self, void* closure) {
+  return PyUnicode_FromString(self->m_expression.formula().c_str());
+}
+
+static PyObject* expression_getNames(expression* self, void* closure) {
+  const std::vector<std::string>& names(self->m_expression.names());
+  PyObject* result(PyTuple_New(names.size()));
+  if (result == NULL)
+    return NULL;
+  for (size_t i = 0; i < names.size(); ++i) {
+    PyObject* a_name(PyUnicode_FromString(names[i].c_str()));
+    if (a_name == NULL) {
+      Py_DECREF(result);
+      return NULL;
+    }
+    PyTuple_SetItem(result, i, a_name);
+  }
+  return result;
+}
+
+// -------------------
+// ----- methods -----
+// -------------------
+
+static PyObject* expression_call(PyObject* self, PyObject* args, PyObject* kwds) {
+  coords_state* st(get_state(self));
+
+  if (PyTuple_Size(args) != 0) {
+    PyErr_SetString(st->Error, "expression() takes keyword arrays only");
+    return NULL;
+  }
+
+  return evaluate_expression(st, ((expression*)self)->m_expression, kwds);
+}
+
+static PyObject* expression_repr(PyObject* self) {
+  std::stringstream result;
+  result << "coords.expression('" << ((expression*)self)->m_expression.formula() << "')";
+  return PyUnicode_FromString(result.str().c_str());
+}
+
+static PyObject* batch_evaluate(PyObject* self, PyObject* args, PyObject* kwds) {
+  coords_state* st((coords_state*)PyModule_GetState(self));
+
+  const char* a_formula(NULL);
+  if (!PyArg_ParseTuple(args, "s:evaluate", &a_formula))
+    return NULL;
+
+  try {
+    Coords::expression an_expression(a_formula);
+    return evaluate_expression(st, an_expression, kwds);
+  } catch (const Coords::Error& err) {
+    PyErr_SetString(st->Error, err.what());
+    return NULL;
+  }
+}
+
+// --------------------------
+// ----- Python structs -----
+// --------------------------
+
+static PyGetSetDef expression_getseters[] = {
+  {sFormulaStr, (getter)expression_getFormula, NULL, sFormulaStr, NULL},
+  {(char*)"names", (getter)expression_getNames, NULL, (char*)"formula variables in order of first use", NULL},
+  {NULL}  /* Sentinel */
+};
+
+static PyType_Slot expression_slots[] = {
+  {Py_tp_dealloc, (void*) expression_dealloc},
+  {Py_tp_doc,     (void*) "expression(formula) compiles a vector formula, e.g. \"m*a + q*cross(v, B)\", called with keyword arrays"},
+  {Py_tp_getset,  (void*) expression_getseters},
+  {Py_tp_new,     (void*) expression_new},
+  {Py_tp_call,    (void*) expression_call},
+  {Py_tp_repr,    (void*) expression_repr},
+  {0, NULL}  /* Sentinel */
+};
+
+static PyType_Spec expression_spec = {
+  "coords.expression",              /* name */
+  sizeof(expression),               /* basicsize */
+  0,                                /* itemsize */
+  Py_TPFLAGS_DEFAULT | Py_TPFLAGS_IMMUTABLETYPE, /* flags */
+  expression_slots                  /* slots */
+};
+
 // -----------------------
 // ----- method list -----
 // -----------------------
@@ -3648,9 +5072,32 @@ PyDoc_STRVAR(Cartesian_dot__doc__, "Returns the dot product of two Cartesian obj
 
 // TODO cross, dot as module methods, not instance methods
 
+PyDoc_STRVAR(batch_magnitude__doc__, "magnitude(values, out=None) returns the magnitudes of an (n, 3) float64 buffer of vectors");
+PyDoc_STRVAR(batch_normalized__doc__, "normalized(values, out=None) returns the unit vectors of an (n, 3) float64 buffer of vectors");
+PyDoc_STRVAR(batch_separation__doc__, "separation(a, b, out=None) returns the angles in degrees between two (n, 3) float64 buffers of vectors");
+PyDoc_STRVAR(batch_Cartesian2spherical__doc__, "Cartesian2spherical(values, out=None) converts an (n, 3) float64 buffer of x, y, z to r, theta, phi in degrees");
+PyDoc_STRVAR(batch_spherical2Cartesian__doc__, "spherical2Cartesian(values, out=None) converts an (n, 3) float64 buffer of r, theta, phi in degrees to x, y, z");
+PyDoc_STRVAR(batch_normalize__doc__, "normalize(values, begin=0, end=360) normalizes a float64 buffer of angles in place and returns it");
+PyDoc_STRVAR(batch_unixTime2JulianDate__doc__, "unixTime2JulianDate(values, out=None) converts a float64 buffer of Unix times to Julian dates");
+PyDoc_STRVAR(batch_JulianDate2unixTime__doc__, "JulianDate2unixTime(values, out=None) converts a float64 buffer of Julian dates to Unix times");
+PyDoc_STRVAR(batch_datetime642JulianDate__doc__, "datetime642JulianDate(values, out=None) converts a numpy datetime64 (or int64 nanosecond) array to Julian dates, NaT to NaN");
+PyDoc_STRVAR(batch_JulianDate2datetime64__doc__, "JulianDate2datetime64(values, out=None) converts a float64 buffer of Julian dates to datetime64[ns], NaN to NaT");
+PyDoc_STRVAR(batch_evaluate__doc__, "evaluate(formula, out=None, **arrays) evaluates a vector formula, e.g. \"m*a + q*cross(v, B)\", over float64 buffers in one pass");
+
 PyMethodDef coords_module_methods[] = {
-  {"cross", (PyCFunction) Cartesian_cross, METH_VARARGS, Cartesian_cross__doc__},
-  {"dot", (PyCFunction) Cartesian_dot, METH_VARARGS, Cartesian_dot__doc__},
+  {"cross", (PyCFunction)(void(*)(void)) Cartesian_cross, METH_FASTCALL, Cartesian_cross__doc__},
+  {"dot", (PyCFunction)(void(*)(void)) Cartesian_dot, METH_FASTCALL, Cartesian_dot__doc__},
+  {"magnitude", (PyCFunction) batch_magnitude, METH_VARARGS | METH_KEYWORDS, batch_magnitude__doc__},
+  {"normalized", (PyCFunction) batch_normalized, METH_VARARGS | METH_KEYWORDS, batch_normalized__doc__},
+  {"separation", (PyCFunction) batch_separation, METH_VARARGS | METH_KEYWORDS, batch_separation__doc__},
+  {"Cartesian2spherical", (PyCFunction) batch_Cartesian2spherical, METH_VARARGS | METH_KEYWORDS, batch_Cartesian2spherical__doc__},
+  {"spherical2Cartesian", (PyCFunction) batch_spherical2Cartesian, METH_VARARGS | METH_KEYWORDS, batch_spherical2Cartesian__doc__},
+  {"normalize", (PyCFunction) batch_normalize, METH_VARARGS | METH_KEYWORDS, batch_normalize__doc__},
+  {"unixTime2JulianDate", (PyCFunction) batch_unixTime2JulianDate, METH_VARARGS | METH_KEYWORDS, batch_unixTime2JulianDate__doc__},
+  {"JulianDate2unixTime", (PyCFunction) batch_JulianDate2unixTime, METH_VARARGS | METH_KEYWORDS, batch_JulianDate2unixTime__doc__},
+  {"datetime642JulianDate", (PyCFunction) batch_datetime642JulianDate, METH_VARARGS | METH_KEYWORDS, batch_datetime642JulianDate__doc__},
+  {"JulianDate2datetime64", (PyCFunction) batch_JulianDate2datetime64, METH_VARARGS | METH_KEYWORDS, batch_JulianDate2datetime64__doc__},
+  {"evaluate", (PyCFunction) batch_evaluate, METH_VARARGS | METH_KEYWORDS, batch_evaluate__doc__},
   {NULL, NULL}  /* Sentinel */
 };
 
@@ -3659,19 +5106,19 @@ PyMethodDef coords_module_methods[] = {
 // ----- module utilities -----
 // ----------------------------
 
-PyObject* Cartesian_create(const Coords::Cartesian& a_Cartesian) {
+PyObject* Cartesian_create(coords_state* st, const Coords::Cartesian& a_Cartesian) {
   // Creates a python Cartesian object from a Coords::Cartesian object.
-  // Intended for use in the module initorbits function to generate
+  // Intended for use in the module coords_exec function to generate
   // Cartesian constants with Coords::Cartesian::U[oxyz]
 
   // TODO borrowed reference?
   Cartesian* py_Cartesian(NULL);
 
-  py_Cartesian = PyObject_New(Cartesian, &CartesianType); // alloc and inits
+  new_CartesianType(st, &py_Cartesian);
 
   // TODO exception handle this
   if (py_Cartesian == NULL){
-    PyErr_SetString(sCoordsException, "failed to create coord.Cartesian.");
+    PyErr_SetString(st->Error, "failed to create coord.Cartesian.");
     return NULL;
   }
 
@@ -3682,95 +5129,140 @@ PyObject* Cartesian_create(const Coords::Cartesian& a_Cartesian) {
   return (PyObject*) py_Cartesian;
 }
 
+static int add_type(PyObject* m, PyType_Spec* a_spec, const char* a_name, PyTypeObject** a_type) {
+  // Creates the heap type from a_spec and adds it to module m as a_name.
+  *a_type = (PyTypeObject*)PyType_FromModuleAndSpec(m, a_spec, NULL);
+  if (*a_type == NULL)
+    return -1;
+  return PyModule_AddObjectRef(m, a_name, (PyObject*)*a_type);
+}
+
+static int add_Cartesian(coords_state* st, PyObject* m, const char* a_name, const Coords::Cartesian& a_Cartesian) {
+  PyObject* py_Cartesian(Cartesian_create(st, a_Cartesian));
+  if (py_Cartesian == NULL)
+    return -1;
+  int result(PyModule_AddObjectRef(m, a_name, py_Cartesian));
+  Py_DECREF(py_Cartesian);
+  return result;
+}
+
 // ------------------------------
 // ----- init coords module -----
 // ------------------------------
 
-// PyMODINIT_FUNC declares extern "C" too.
-PyMODINIT_FUNC initcoords(void) {
+// Multi-phase initialization, see PEP 489. Each interpreter that
+// imports coords runs coords_exec on its own module object.
+
+static int coords_exec(PyObject* m) {
 
-  PyObject* m(Py_InitModule3("coords", coords_module_methods, "python wrappers for coords objects."));
+  coords_state* st((coords_state*)PyModule_GetState(m));
 
   // error
-  char eMsgStr[] = "coords.Error";
-  sCoordsException = PyErr_NewException(eMsgStr, NULL, NULL);
-  Py_INCREF(sCoordsException);
-  PyModule_AddObject(m, "Error", sCoordsException);
-
-
-  // Angle
-  AngleType.tp_new = PyType_GenericNew;
-  if (PyType_Ready(&AngleType) < 0)
-    return;
-  Py_INCREF(&AngleType);
-  PyModule_AddObject(m, "angle", (PyObject *)&AngleType);
-
-  // Latitude
-  LatitudeType.tp_new = PyType_GenericNew;
-  if (PyType_Ready(&LatitudeType) < 0)
-    return;
-  Py_INCREF(&LatitudeType);
-  PyModule_AddObject(m, "latitude", (PyObject *)&LatitudeType);
-
-  // Declination
-  DeclinationType.tp_new = PyType_GenericNew;
-  if (PyType_Ready(&DeclinationType) < 0)
-    return;
-  Py_INCREF(&DeclinationType);
-  PyModule_AddObject(m, "declination", (PyObject *)&DeclinationType);
-
-
-  // Cartesian
-  CartesianType.tp_new = PyType_GenericNew;
-  if (PyType_Ready(&CartesianType) < 0)
-    return;
-
-  Py_INCREF(&CartesianType);
-  PyModule_AddObject(m, "Cartesian", (PyObject *)&CartesianType);
-
-  // rotator
-  rotatorType.tp_new = PyType_GenericNew;
-  if (PyType_Ready(&rotatorType) < 0)
-    return;
-
-  Py_INCREF(&rotatorType);
-  PyModule_AddObject(m, "rotator", (PyObject *)&rotatorType);
-
-  // spherical
-  sphericalType.tp_new = PyType_GenericNew;
-  if (PyType_Ready(&sphericalType) < 0)
-    return;
-
-  Py_INCREF(&sphericalType);
-  PyModule_AddObject(m, "spherical", (PyObject *)&sphericalType);
-
-  // datetime
-  datetimeType.tp_new = PyType_GenericNew;
-  if (PyType_Ready(&datetimeType) < 0)
-    return;
-  Py_INCREF(&datetimeType);
-  PyModule_AddObject(m, "datetime", (PyObject *)&datetimeType);
+  st->Error = PyErr_NewException("coords.Error", NULL, NULL);
+  if (st->Error == NULL || PyModule_AddObjectRef(m, "Error", st->Error) < 0)
+    return -1;
+
+  if (add_type(m, &Angle_spec, "angle", &st->AngleType) < 0 ||
+      add_type(m, &Latitude_spec, "latitude", &st->LatitudeType) < 0 ||
+      add_type(m, &Declination_spec, "declination", &st->DeclinationType) < 0 ||
+      add_type(m, &Cartesian_spec, "Cartesian", &st->CartesianType) < 0 ||
+      add_type(m, &rotator_spec, "rotator", &st->rotatorType) < 0 ||
+      add_type(m, &CartesianRecorder_spec, "CartesianRecorder", &st->CartesianRecorderType) < 0 ||
+      add_type(m, &spherical_spec, "spherical", &st->sphericalType) < 0 ||
+      add_type(m, &datetime_spec, "datetime", &st->datetimeType) < 0 ||
+      add_type(m, &expression_spec, "expression", &st->expressionType) < 0)
+    return -1;
+
+#ifndef Py_LIMITED_API
+  // not inherited, subclasses construct through tp_new and tp_init.
+  // The limited API has no slot for it before 3.14.
+  st->AngleType->tp_vectorcall = Angle_vectorcall;
+  st->CartesianType->tp_vectorcall = Cartesian_vectorcall;
+#endif
 
   // module unit vector constants
 
-  PyObject* Cartesian_Uo(NULL);
-  Cartesian_Uo = Cartesian_create(Coords::Cartesian::Uo);
-  Py_INCREF(Cartesian_Uo);
-  PyModule_AddObject(m, "Uo", (PyObject*)Cartesian_Uo);
+  if (add_Cartesian(st, m, "Uo", Coords::Cartesian::Uo) < 0 ||
+      add_Cartesian(st, m, "Ux", Coords::Cartesian::Ux) < 0 ||
+      add_Cartesian(st, m, "Uy", Coords::Cartesian::Uy) < 0 ||
+      add_Cartesian(st, m, "Uz", Coords::Cartesian::Uz) < 0)
+    return -1;
 
-  PyObject* Cartesian_Ux(NULL);
-  Cartesian_Ux = Cartesian_create(Coords::Cartesian::Ux);
-  Py_INCREF(Cartesian_Ux);
-  PyModule_AddObject(m, "Ux", (PyObject*)Cartesian_Ux);
+  return 0;
+}
+
+static int coords_traverse(PyObject* m, visitproc visit, void* arg) {
+  coords_state* st((coords_state*)PyModule_GetState(m));
+  Py_VISIT(st->Error);
+  Py_VISIT(st->AngleType);
+  Py_VISIT(st->LatitudeType);
+  Py_VISIT(st->DeclinationType);
+  Py_VISIT(st->CartesianType);
+  Py_VISIT(st->rotatorType);
+  Py_VISIT(st->CartesianRecorderType);
+  Py_VISIT(st->sphericalType);
+  Py_VISIT(st->datetimeType);
+  Py_VISIT(st->expressionType);
+  Py_VISIT(st->numpy_empty);
+  Py_VISIT(st->datetime_module);
+  for (int i = 0; i < 12; ++i)
+    Py_VISIT(st->datetime_names[i]);
+  return 0;
+}
+
+static int coords_clear(PyObject* m) {
+  coords_state* st((coords_state*)PyModule_GetState(m));
+  freelist_clear(st->AngleFreeList);
+  freelist_clear(st->LatitudeFreeList);
+  freelist_clear(st->DeclinationFreeList);
+  freelist_clear(st->CartesianFreeList);
+  freelist_clear(st->SphericalFreeList);
+  freelist_clear(st->DatetimeFreeList);
+  Py_CLEAR(st->Error);
+  Py_CLEAR(st->AngleType);
+  Py_CLEAR(st->LatitudeType);
+  Py_CLEAR(st->DeclinationType);
+  Py_CLEAR(st->CartesianType);
+  Py_CLEAR(st->rotatorType);
+  Py_CLEAR(st->CartesianRecorderType);
+  Py_CLEAR(st->sphericalType);
+  Py_CLEAR(st->datetimeType);
+  Py_CLEAR(st->expressionType);
+  Py_CLEAR(st->numpy_empty);
+  Py_CLEAR(st->datetime_module);
+  for (int i = 0; i < 12; ++i)
+    Py_CLEAR(st->datetime_names[i]);
+  return 0;
+}
+
+static void coords_free(void* m) {
+  coords_clear((PyObject*)m);
+}
 
-  PyObject* Cartesian_Uy(NULL);
-  Cartesian_Uy = Cartesian_create(Coords::Cartesian::Uy);
-  Py_INCREF(Cartesian_Uy);
-  PyModule_AddObject(m, "Uy", (PyObject*)Cartesian_Uy);
+// The freelists rely on the GIL, so there is no Py_mod_gil slot and a
+// free-threaded build re-enables the GIL on import.
 
-  PyObject* Cartesian_Uz(NULL);
-  Cartesian_Uz = Cartesian_create(Coords::Cartesian::Uz);
-  Py_INCREF(Cartesian_Uz);
-  PyModule_AddObject(m, "Uz", (PyObject*)Cartesian_Uz);
+static PyModuleDef_Slot coords_module_slots[] = {
+  {Py_mod_exec, (void*) coords_exec},
+#ifdef Py_mod_multiple_interpreters
+  {Py_mod_multiple_interpreters, Py_MOD_PER_INTERPRETER_GIL_SUPPORTED},
+#endif
+  {0, NULL}  /* Sentinel */
+};
 
+PyModuleDef coords_module = {
+  PyModuleDef_HEAD_INIT,
+  "coords",                              /* m_name */
+  "python wrappers for coords objects.", /* m_doc */
+  sizeof(coords_state),                  /* m_size */
+  coords_module_methods,                 /* m_methods */
+  coords_module_slots,                   /* m_slots */
+  coords_traverse,                       /* m_traverse */
+  coords_clear,                          /* m_clear */
+  coords_free                            /* m_free */
+};
+
+// PyMODINIT_FUNC declares extern "C" too.
+PyMODINIT_FUNC PyInit_coords(void) {
+  return PyModuleDef_Init(&coords_module);
 }
@@ -2,6 +2,6 @@
 
 . ./setenv.sh
 
-python "$@"
+python3 "$@"
 
 # EoF
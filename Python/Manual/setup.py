@@ -5,12 +5,16 @@ from http://docs.python.org/extending/building.html
 ASSUMES: ../../libCoords exists and has boost installed (in
 /usr/local/[include,lib] on OS X and in /usr/lib64 for Linux)
 
+Set COORDS_LIMITED_API=1 to build against the stable ABI (Python 3.11
+and later), i.e. one coords.abi3.so for all later Python versions.
+
 """
 
+import os
 import platform
 import sys
 
-from distutils.core import setup, Extension
+from setuptools import setup, Extension
 
 name = 'coords'
 version = '1.0'
@@ -33,18 +37,29 @@ elif platform.system() == 'Linux':
     sources = ['coords.cpp']
 
 else:
-    print 'unsupported platform:', platform.system()
+    print('unsupported platform:', platform.system())
+    sys.exit(1)
+
+
+if sys.version_info < (3, 10):
+    print('coords requires Python 3.10 or later')
     sys.exit(1)
 
+limited_api = os.environ.get('COORDS_LIMITED_API', '0') not in ('', '0')
+define_macros = [('Py_LIMITED_API', '0x030B0000')] if limited_api else []
+options = {'bdist_wheel': {'py_limited_api': 'cp311'}} if limited_api else {}
 
 coords_module = Extension(name,
                           include_dirs=include_dirs,
                           libraries=libraries,
                           library_dirs=library_dirs,
+                          define_macros=define_macros,
+                          py_limited_api=limited_api,
                           sources=sources)
 
 setup (name=name,
        version=version,
        description=description,
+       options=options,
        ext_modules=[coords_module])
 
@@ -7,8 +7,11 @@ which case the test should be investigated.
 """
 
 import copy
+import ctypes
 import math
+import pickle
 import random
+import threading
 import time
 import unittest
 
@@ -55,6 +58,13 @@ class TestCartesian(unittest.TestCase):
         self.assertEqual(0, a.z)
         self.assertSpacesAreEqual(coords.Uo, a)
 
+    def test_default_constructor_recycled(self):
+        """Test default constructor reusing a freed object"""
+        for i in range(3):
+            a = coords.Cartesian(1, 2, 3) + coords.Cartesian(4, 5, 6)
+            del a
+            self.assertSpacesAreEqual(coords.Uo, coords.Cartesian())
+
 
     def test_x_constructor(self):
         """Test x constructor"""
@@ -84,6 +94,23 @@ class TestCartesian(unittest.TestCase):
         self.assertSpacesAreEqual(self.p1, a)
 
 
+    def test_subclass_constructor(self):
+        """Test subclass constructor keeps its __init__"""
+        class Tagged(coords.Cartesian):
+            def __init__(self, *args, **kwds):
+                super().__init__(*args, **kwds)
+                self.tag = 'tagged'
+        a = Tagged(self.p1.x, self.p1.y, self.p1.z)
+        self.assertEqual(Tagged, type(a))
+        self.assertEqual('tagged', a.tag)
+        self.assertSpacesAreEqual(self.p1, a)
+
+
+    def test_too_many_args_constructor(self):
+        """Test constructor with four args"""
+        self.assertRaises(TypeError, coords.Cartesian, 1, 2, 3, 4)
+
+
     def test_xyz_assignments(self):
         """Test space xyz assignment operators"""
         a = coords.Cartesian()
@@ -151,10 +178,10 @@ class TestCartesian(unittest.TestCase):
     def test_repr(self):
         """Test repr"""
 
-        # %s precision is controlled by space.cpp and designed to match this test
-        a_repr = '(%(x)s, %(y)s, %(z)s)' % {'x':self.p1.x,
-                                            'y':self.p1.y,
-                                            'z':self.p1.z}
+        # repr precision is controlled by coords.cpp, 12 digits like Python 2 str(float)
+        a_repr = '(%(x).12g, %(y).12g, %(z).12g)' % {'x':self.p1.x,
+                                                     'y':self.p1.y,
+                                                     'z':self.p1.z}
         self.assertEqual(a_repr, repr(self.p1))
 
 
@@ -177,6 +204,10 @@ class TestCartesian(unittest.TestCase):
         a = a1.normalized(self.p1)
         self.assertSpacesAreEqual(normalized, a)
 
+    def test_normalized_zero(self):
+        """Test Uo normalized"""
+        self.assertRaises(coords.Error, coords.Cartesian().normalized)
+
     # ----------------------------
     # ----- test richcompare -----
     # ----------------------------
@@ -421,6 +452,8 @@ class TestCartesian(unittest.TestCase):
     def test_dot_product_exception(self):
         """Test space dot product exception"""
         self.assertRaises(coords.Error, lambda a, b: coords.dot(a, b), self.p1, 1.23)
+        self.assertRaises(TypeError, coords.dot, self.p1)
+        self.assertRaises(TypeError, coords.dot, self.p1, self.p2, self.p1)
 
 
     def test_x_cross_y(self):
@@ -452,6 +485,7 @@ class TestCartesian(unittest.TestCase):
     def test_cross_product_exception(self):
         """Test space cross product exception"""
         self.assertRaises(coords.Error, lambda a, b: coords.cross(a, b), self.p1, 1.23)
+        self.assertRaises(TypeError, coords.cross, self.p1)
 
 
     # -------------------
@@ -477,6 +511,303 @@ class TestCartesian(unittest.TestCase):
         self.assertAlmostEqual(0.7071067811865476, b.y, places=self.places)
         self.assertAlmostEqual(0.0, b.z, places=self.places)
 
+    def test_pickle(self):
+        """Test pickle round trip is exact"""
+        a = coords.Cartesian(random.uniform(-1e6, 1e6), 1/3.0, -0.0)
+        a_copy = pickle.loads(pickle.dumps(a, pickle.HIGHEST_PROTOCOL))
+        self.assertEqual(coords.Cartesian, type(a_copy))
+        self.assertEqual((a.x, a.y, a.z), (a_copy.x, a_copy.y, a_copy.z))
+        self.assertEqual(-1, math.copysign(1, a_copy.z))
+
+    def test_pickle_list(self):
+        """Test pickle a list of Cartesians"""
+        points = [coords.Cartesian(i, 2*i, 3*i) for i in range(100)]
+        self.assertEqual(points, pickle.loads(pickle.dumps(points)))
+
+
+try:
+    import numpy
+except ImportError:
+    numpy = None
+
+
+def doubles(*values):
+    """Returns a ctypes float64 buffer"""
+    return (ctypes.c_double * len(values))(*values)
+
+
+class TestCartesianBatch(unittest.TestCase):
+    """Batch functions over float64 buffers of x, y, z"""
+
+    def setUp(self):
+        self.places = 12
+        self.points = [coords.Cartesian(random.uniform(-1e3, 1e3),
+                                        random.uniform(-1e3, 1e3),
+                                        random.uniform(-1e3, 1e3)) for i in range(5)]
+        self.xyz = doubles(*[c for p in self.points for c in (p.x, p.y, p.z)])
+
+    def test_magnitude(self):
+        """Test batch magnitude"""
+        out = doubles(*[0]*len(self.points))
+        self.assertIs(out, coords.magnitude(self.xyz, out))
+        for i, p in enumerate(self.points):
+            self.assertAlmostEqual(p.magnitude(), out[i], places=self.places)
+
+    def test_normalized(self):
+        """Test batch normalized"""
+        out = coords.normalized(self.xyz, out=doubles(*[0]*len(self.xyz)))
+        for i, p in enumerate(self.points):
+            u = p.normalized()
+            self.assertAlmostEqual(u.x, out[3*i], places=self.places)
+            self.assertAlmostEqual(u.y, out[3*i + 1], places=self.places)
+            self.assertAlmostEqual(u.z, out[3*i + 2], places=self.places)
+
+    def test_normalized_in_place(self):
+        """Test batch normalized with the input as output"""
+        coords.normalized(self.xyz, self.xyz)
+        for i, p in enumerate(self.points):
+            self.assertAlmostEqual(p.normalized().x, self.xyz[3*i], places=self.places)
+
+    def test_separation(self):
+        """Test batch separation"""
+        out = coords.separation(doubles(1, 0, 0, 1, 1, 0), doubles(0, 1, 0, -1, -1, 0), doubles(0, 0))
+        self.assertAlmostEqual(90, out[0], places=self.places)
+        self.assertAlmostEqual(180, out[1], places=self.places)
+
+    def test_rotate_array(self):
+        """Test batch rotate"""
+        rotator = coords.rotator(coords.Cartesian(1, 2, 3))
+        an_angle = coords.angle(33)
+        out = rotator.rotateArray(self.xyz, an_angle, out=doubles(*[0]*len(self.xyz)))
+        for i, p in enumerate(self.points):
+            r = rotator.rotate(p, an_angle)
+            self.assertAlmostEqual(r.x, out[3*i], places=self.places)
+            self.assertAlmostEqual(r.y, out[3*i + 1], places=self.places)
+            self.assertAlmostEqual(r.z, out[3*i + 2], places=self.places)
+
+    def test_rotate_array_Uo_exception(self):
+        """Test batch rotate about Uo"""
+        self.assertRaises(coords.Error, coords.rotator().rotateArray, self.xyz, coords.angle(1), self.xyz)
+
+    def test_bad_buffers(self):
+        """Test batch buffer exceptions"""
+        out = doubles(*[0]*len(self.points))
+        self.assertRaises(coords.Error, coords.magnitude, [1.0, 2.0, 3.0], out)
+        self.assertRaises(coords.Error, coords.magnitude, (ctypes.c_float * 3)(), out)
+        self.assertRaises(coords.Error, coords.magnitude, doubles(1, 2, 3, 4), out)
+        self.assertRaises(coords.Error, coords.magnitude, self.xyz, doubles(0))
+        self.assertRaises(coords.Error, coords.separation, self.xyz, doubles(1, 2, 3), out)
+
+    @unittest.skipIf(numpy is None, 'needs numpy')
+    def test_numpy(self):
+        """Test batch functions return numpy arrays"""
+        xyz = numpy.array([[p.x, p.y, p.z] for p in self.points])
+        magnitudes = coords.magnitude(xyz)
+        self.assertEqual((len(self.points),), magnitudes.shape)
+        units = coords.normalized(xyz)
+        self.assertEqual(xyz.shape, units.shape)
+        for i, p in enumerate(self.points):
+            self.assertAlmostEqual(p.magnitude(), magnitudes[i], places=self.places)
+            self.assertAlmostEqual(p.normalized().z, units[i][2], places=self.places)
+        self.assertRaises(coords.Error, coords.magnitude, xyz[:, :2])  # not contiguous
+
+    def test_threads(self):
+        """Test batch functions from several threads with one rotator"""
+        rotator = coords.rotator(coords.Cartesian(1, 2, 3))
+        an_angle = coords.angle(33)
+        n = 3*10000
+        outs = [doubles(*[0]*n) for i in range(4)]
+        xyz = doubles(*[1, 2, 3]*(n//3))
+
+        def work(out):
+            for i in range(10):
+                rotator.rotateArray(xyz, an_angle, out)
+                coords.normalized(out, out)
+
+        threads = [threading.Thread(target=work, args=(out,)) for out in outs]
+        for t in threads:
+            t.start()
+        for t in threads:
+            t.join()
+
+        expected = rotator.rotate(coords.Cartesian(1, 2, 3), an_angle).normalized()
+        for out in outs:
+            self.assertAlmostEqual(expected.x, out[0], places=self.places)
+            self.assertAlmostEqual(expected.y, out[n - 2], places=self.places)
+            self.assertAlmostEqual(expected.z, out[n - 1], places=self.places)
+
+    def test_subinterpreter(self):
+        """Test a second interpreter gets its own coords module"""
+        try:
+            import _interpreters as interpreters
+        except ImportError:
+            try:
+                import _xxsubinterpreters as interpreters
+            except ImportError:
+                self.skipTest('no subinterpreter support')
+        an_interpreter = interpreters.create()
+        try:
+            result = interpreters.run_string(an_interpreter, (
+                'import coords\n'
+                'assert coords.Cartesian(1, 2, 3) + coords.Ux == coords.Cartesian(2, 2, 3)\n'))
+            if result is not None and 'subinterpreters' in result.msg:
+                self.skipTest('stable ABI build for Python < 3.12')
+            self.assertIsNone(result)  # _interpreters returns the error
+        finally:
+            interpreters.destroy(an_interpreter)
+        self.assertEqual('coords', coords.Cartesian.__module__)
+
+
+class TestCartesianRecorder(unittest.TestCase):
+
+    def setUp(self):
+        self.recorder = coords.CartesianRecorder(4)
+        self.recorder.clear()
+        for i in range(1, 7):
+            self.recorder.push(coords.Cartesian(i, 10*i, 100*i))
+
+    def test_default_constructor(self):
+        """Test default constructor starts full of Uo"""
+        a = coords.CartesianRecorder()
+        self.assertEqual(a.sizeLimit, len(a))
+        self.assertEqual(coords.Uo, a.get(0))
+
+    def test_size_limit(self):
+        """Test size limit keeps the newest"""
+        self.assertEqual(4, len(self.recorder))
+        self.assertEqual(coords.Cartesian(3, 30, 300), self.recorder.get(0))
+        self.assertEqual(coords.Cartesian(6, 60, 600), self.recorder.get(3))
+        self.recorder.sizeLimit = 2
+        self.assertEqual(2, len(self.recorder))
+        self.assertEqual(coords.Cartesian(5, 50, 500), self.recorder.get(0))
+
+    def test_get_exception(self):
+        """Test get index out of range"""
+        self.assertRaises(IndexError, self.recorder.get, 4)
+        self.assertRaises(IndexError, self.recorder.get, -1)
+
+    def test_memoryview(self):
+        """Test buffer view after wraparound"""
+        with memoryview(self.recorder) as a_view:
+            self.assertEqual((4, 3), a_view.shape)
+            self.assertEqual('d', a_view.format)
+            self.assertTrue(a_view.readonly)
+            self.assertTrue(a_view.c_contiguous)
+            self.assertEqual([3.0, 30.0, 300.0], a_view.tolist()[0])
+            self.assertEqual([6.0, 60.0, 600.0], a_view.tolist()[3])
+
+    def test_empty_view(self):
+        """Test buffer view with no samples"""
+        self.recorder.clear()
+        with memoryview(self.recorder) as a_view:
+            self.assertEqual((0, 3), a_view.shape)
+
+    def test_view_locks_recorder(self):
+        """Test the recorder can not change while viewed"""
+        a_view = memoryview(self.recorder)
+        self.assertRaises(BufferError, self.recorder.push, coords.Ux)
+        self.assertRaises(BufferError, self.recorder.clear)
+        with self.assertRaises(BufferError):
+            self.recorder.sizeLimit = 2
+        a_view.release()
+        self.recorder.push(coords.Ux)
+        self.assertEqual(coords.Ux, self.recorder.get(3))
+
+    def test_batch_function(self):
+        """Test batch functions take the recorder"""
+        self.recorder.push(coords.Cartesian(3, 4, 0))
+        mags = coords.magnitude(self.recorder, out=(ctypes.c_double * 4)())
+        for i in range(4):
+            self.assertAlmostEqual(self.recorder.get(i).magnitude(), mags[i])
+
+    @unittest.skipIf(numpy is None, 'needs numpy')
+    def test_numpy(self):
+        """Test numpy.asarray shares the samples"""
+        xyz = numpy.asarray(self.recorder)
+        self.assertFalse(xyz.flags.writeable)
+        self.assertEqual([[i, 10*i, 100*i] for i in range(3, 7)], xyz.tolist())
+
+
+def vectors(points):
+    """Returns an (n, 3) ctypes float64 buffer"""
+    return ((ctypes.c_double * 3) * len(points))(*[(p.x, p.y, p.z) for p in points])
+
+
+class TestCartesianExpression(unittest.TestCase):
+    """Vector formulas over float64 buffers"""
+
+    def setUp(self):
+        self.places = 9
+        self.n = 300  # more than one block
+        self.m = [random.uniform(1, 10) for i in range(self.n)]
+        self.a = [coords.Cartesian(random.uniform(-1, 1), random.uniform(-1, 1), random.uniform(-1, 1))
+                  for i in range(self.n)]
+        self.v = [coords.Cartesian(random.uniform(-1, 1), random.uniform(-1, 1), random.uniform(-1, 1))
+                  for i in range(self.n)]
+
+    def assertCartesianAlmostEqual(self, expected, actual):
+        self.assertAlmostEqual(expected.x, actual[0], places=self.places)
+        self.assertAlmostEqual(expected.y, actual[1], places=self.places)
+        self.assertAlmostEqual(expected.z, actual[2], places=self.places)
+
+    def test_lorentz(self):
+        """Test evaluate matches Cartesian arithmetic"""
+        B = coords.Cartesian(0, 0, 2)
+        out = vectors([coords.Uo]*self.n)
+        result = coords.evaluate('m*a + q*cross(v, B)', m=doubles(*self.m), a=vectors(self.a),
+                                 q=-1.5, v=vectors(self.v), B=B, out=out)
+        self.assertIs(out, result)
+        for i in range(self.n):
+            expected = self.a[i]*self.m[i] + coords.cross(self.v[i], B)*-1.5
+            self.assertCartesianAlmostEqual(expected, out[i])
+
+    def test_expression(self):
+        """Test a compiled expression called with keyword arrays"""
+        F = coords.expression('normalized(v) - v/magnitude(v)')
+        self.assertEqual(('v',), F.names)
+        self.assertEqual('normalized(v) - v/magnitude(v)', F.formula)
+        self.assertEqual("coords.expression('normalized(v) - v/magnitude(v)')", repr(F))
+        out = F(v=vectors(self.v), out=vectors([coords.Ux]*self.n))
+        for i in range(self.n):
+            self.assertCartesianAlmostEqual(coords.Uo, out[i])
+
+    def test_scalar_result(self):
+        """Test vector*vector is the dot product"""
+        out = coords.evaluate('a*v + 1', a=vectors(self.a), v=vectors(self.v), out=doubles(*[0]*self.n))
+        for i in range(self.n):
+            self.assertAlmostEqual(self.a[i]*self.v[i] + 1, out[i], places=self.places)
+
+    def test_in_place(self):
+        """Test out may be an argument of the same width"""
+        v = vectors(self.v)
+        coords.evaluate('v + a*dt', v=v, a=vectors(self.a), dt=0.5, out=v)
+        for i in range(self.n):
+            self.assertCartesianAlmostEqual(self.v[i] + self.a[i]*0.5, v[i])
+
+    def test_exceptions(self):
+        """Test syntax, kind and argument exceptions"""
+        out = vectors(self.v)
+        self.assertRaises(coords.Error, coords.expression, 'a +')
+        self.assertRaises(coords.Error, coords.evaluate, 'curl(a)', a=out, out=out)
+        self.assertRaises(coords.Error, coords.evaluate, 'a + m', a=out, m=1.0, out=out)
+        self.assertRaises(coords.Error, coords.evaluate, 'a + b', a=out, out=out)
+        self.assertRaises(coords.Error, coords.evaluate, 'a', a=out, b=out, out=out)
+        self.assertRaises(coords.Error, coords.evaluate, 'a', a='a', out=out)
+        self.assertRaises(coords.Error, coords.evaluate, 'a*m', a=out, m=doubles(1, 2), out=out)
+        self.assertRaises(coords.Error, coords.evaluate, 'a', a=out, out=doubles(1, 2))
+        self.assertRaises(coords.Error, coords.expression('a'), out, out=out)
+
+    @unittest.skipIf(numpy is None, 'needs numpy')
+    def test_numpy(self):
+        """Test evaluate returns numpy arrays"""
+        a = numpy.array([[p.x, p.y, p.z] for p in self.a])
+        m = numpy.array(self.m)
+        result = coords.evaluate('m*a', m=m, a=a)
+        self.assertEqual((self.n, 3), result.shape)
+        self.assertTrue(numpy.allclose(m[:, numpy.newaxis]*a, result))
+        self.assertEqual((self.n,), coords.evaluate('magnitude(a)', a=a).shape)
+        self.assertEqual((1, 3), coords.evaluate('2*a', a=coords.Ux).shape)
+
 
 if __name__ == '__main__':
     random.seed(time.time())
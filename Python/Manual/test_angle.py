@@ -7,7 +7,9 @@ which case the test should be investigated.
 """
 
 import copy
+import ctypes
 import math
+import pickle
 import random
 import time
 import unittest
@@ -155,6 +157,13 @@ class TestAngle(unittest.TestCase):
         an_angle = coords.angle()
         self.assertEqual(0, an_angle.value)
 
+    def test_default_constructor_recycled(self):
+        """Test default constructor reusing a freed object"""
+        for i in range(3):
+            an_angle = coords.angle(10) + coords.angle(20)
+            del an_angle
+            self.assertEqual(0, coords.angle().value)
+
 
     def test_construct_degrees(self):
         """Test construct_degrees"""
@@ -559,6 +568,26 @@ class TestAngle(unittest.TestCase):
         a_repr = '00:00:00'
         self.assertEqual(a_repr, repr(an_angle))
 
+    def test_pickle(self):
+        """Test pickle round trip is exact"""
+        an_angle = coords.angle(-45, 30, 15.123456789)
+        a_copy = pickle.loads(pickle.dumps(an_angle, pickle.HIGHEST_PROTOCOL))
+        self.assertEqual(coords.angle, type(a_copy))
+        self.assertEqual(an_angle.value, a_copy.value)
+
+    def test_copy(self):
+        """Test copy.copy makes a new object"""
+        an_angle = coords.angle(30)
+        a_copy = copy.copy(an_angle)
+        self.assertIsNot(an_angle, a_copy)
+        self.assertEqual(an_angle, a_copy)
+
+    def test_setstate_exception(self):
+        """Test __setstate__ wrong record size"""
+        an_angle = coords.angle()
+        self.assertRaises(coords.Error, an_angle.__setstate__, b'123')
+        self.assertRaises(coords.Error, an_angle.__setstate__, 1.0)
+
 
 class TestLatitude(unittest.TestCase):
 
@@ -583,20 +612,12 @@ class TestLatitude(unittest.TestCase):
 
     def test_constructor_exception_north(self):
         """Test constructor_exception north"""
-        try:
-            a_latitude = coords.latitude(100)
-            self.assertRaises(False) # correct behavior skips this
-        except RuntimeError as err:
-            self.assertTrue(RuntimeError == type(err))
+        self.assertRaises(coords.Error, coords.latitude, 100)
 
 
     def test_constructor_exception_south(self):
         """Test constructor_exception south"""
-        try:
-            a_latitude = coords.latitude(-100)
-            self.assertRaises(False) # correct behavior skips this
-        except RuntimeError as err:
-            self.assertTrue(RuntimeError == type(err))
+        self.assertRaises(coords.Error, coords.latitude, -100)
 
 
     def test_inplace_plus_1(self):
@@ -623,6 +644,12 @@ class TestLatitude(unittest.TestCase):
         a1 += a2
         self.assertAlmostEqual(100, a1.value, self.places)
 
+    def test_pickle(self):
+        """Test pickle keeps latitude type"""
+        a_copy = pickle.loads(pickle.dumps(coords.latitude(-33.5)))
+        self.assertEqual(coords.latitude, type(a_copy))
+        self.assertEqual(-33.5, a_copy.value)
+
 
 
 
@@ -650,20 +677,12 @@ class TestDeclination(unittest.TestCase):
 
     def test_constructor_exception_north(self):
         """Test constructor_exception north"""
-        try:
-            a_declination = coords.declination(100)
-            self.assertRaises(False) # correct behavior skips this
-        except RuntimeError as err:
-            self.assertTrue(RuntimeError == type(err))
+        self.assertRaises(coords.Error, coords.declination, 100)
 
 
     def test_constructor_exception_south(self):
         """Test constructor_exception south"""
-        try:
-            a_declination = coords.declination(-100)
-            self.assertRaises(False) # correct behavior skips this
-        except RuntimeError as err:
-            self.assertTrue(RuntimeError == type(err))
+        self.assertRaises(coords.Error, coords.declination, -100)
 
 
     def test_inplace_plus_1(self):
@@ -690,8 +709,44 @@ class TestDeclination(unittest.TestCase):
         a1 += a2
         self.assertAlmostEqual(100, a1.value, self.places)
 
+    def test_pickle(self):
+        """Test pickle keeps declination type"""
+        a_copy = pickle.loads(pickle.dumps(coords.declination(12.25)))
+        self.assertEqual(coords.declination, type(a_copy))
+        self.assertEqual(12.25, a_copy.value)
+
+
+
 
 
+def doubles(*values):
+    """Returns a ctypes float64 buffer"""
+    return (ctypes.c_double * len(values))(*values)
+
+
+class TestAngleBatch(unittest.TestCase):
+    """Batch normalize over float64 buffers"""
+
+    def test_normalize(self):
+        """Test batch normalize in place"""
+        values = [random.uniform(-1e3, 1e3) for i in range(10)]
+        a_buffer = doubles(*values)
+        self.assertIs(a_buffer, coords.normalize(a_buffer))
+        for i, value in enumerate(values):
+            an_angle = coords.angle()
+            an_angle.value = value
+            an_angle.normalize(0, 360)
+            self.assertAlmostEqual(an_angle.value, a_buffer[i], places=10)
+
+    def test_normalize_range(self):
+        """Test batch normalize to -180, 180"""
+        a_buffer = coords.normalize(doubles(190, -190, 540), begin=-180, end=180)
+        self.assertEqual([-170, 170, -180], list(a_buffer))
+
+    def test_normalize_exception(self):
+        """Test batch normalize needs a writable float64 buffer"""
+        self.assertRaises(coords.Error, coords.normalize, [1.0, 2.0])
+
 
 
 if __name__ == '__main__':
@@ -7,7 +7,10 @@ which case the test should be investigated.
 """
 
 import copy
+import ctypes
+import datetime
 import math
+import pickle
 import random
 import time
 import unittest
@@ -73,6 +76,13 @@ class TestDateTime(unittest.TestCase):
         a = coords.datetime()
         self.assertEqual('1970-01-01T00:00:00', str(a))
 
+    def test_default_constructor_recycled(self):
+        """Test default constructor reusing a freed object"""
+        for i in range(3):
+            a = coords.datetime('1962-07-10T07:30:00+05:00') + 1.5
+            del a
+            self.assertEqual('1970-01-01T00:00:00', str(coords.datetime()))
+
 
     def test_string_constructor(self):
         """Test string constructor"""
@@ -250,7 +260,7 @@ class TestDateTime(unittest.TestCase):
         """Test set time zone method"""
         a = coords.datetime('1962-07-10T07:30:00')
 
-        print a.getTimezone() # TODO rm
+        print(a.getTimezone()) # TODO rm
 
         a.setTimezone(-8)
         self.assertEqual('1962-07-10T15:30:00-08', str(a))
@@ -261,6 +271,132 @@ class TestDateTime(unittest.TestCase):
         a.timezone = -8
         self.assertEqual('1962-07-10T15:30:00-08', str(a))
 
+    def test_pickle(self):
+        """Test pickle keeps the ISO 8601 form"""
+        for a_str in ['2015-01-01T12:34:56.5Z', '1999-12-31T23:59:59+05:30', '2012-06-30T12:00:00-0945']:
+            a = coords.datetime(a_str)
+            a_copy = pickle.loads(pickle.dumps(a, pickle.HIGHEST_PROTOCOL))
+            self.assertEqual(coords.datetime, type(a_copy))
+            self.assertEqual(str(a), str(a_copy))
+            self.assertEqual(a.toJulianDate(), a_copy.toJulianDate())
+
+    def test_setstate_exception(self):
+        """Test __setstate__ invalid record"""
+        state = bytearray(coords.datetime('2015-02-28T00:00:00').__reduce__()[2])
+        state[8] = 29 # day
+        a = coords.datetime('2015-02-28T00:00:00')
+        self.assertRaises(coords.Error, a.__setstate__, bytes(state))
+        self.assertEqual('2015-02-28T00:00:00', str(a))
+
+
+try:
+    import numpy
+except ImportError:
+    numpy = None
+
+
+def doubles(*values):
+    """Returns a ctypes float64 buffer"""
+    return (ctypes.c_double * len(values))(*values)
+
+
+class TestDateTimeBatch(unittest.TestCase):
+    """Batch Julian date conversions over float64 buffers"""
+
+    def test_unix_time_to_julian_date(self):
+        """Test batch Unix time to Julian date"""
+        out = coords.unixTime2JulianDate(doubles(0, 946728000), out=doubles(0, 0))
+        self.assertEqual(2440587.5, out[0])
+        self.assertEqual(2451545.0, out[1])
+
+    def test_julian_date_to_unix_time(self):
+        """Test batch Julian date to Unix time in place"""
+        values = doubles(2440587.5, 2451545.0)
+        coords.JulianDate2unixTime(values, values)
+        self.assertEqual([0, 946728000], list(values))
+
+    def test_int64_nanoseconds(self):
+        """Test batch datetime64 conversions with int64 buffers"""
+        ns = (ctypes.c_int64 * 3)(0, 946728000000000000, -2**63)
+        jdays = coords.datetime642JulianDate(ns, out=doubles(0, 0, 0))
+        self.assertEqual(2440587.5, jdays[0])
+        self.assertEqual(2451545.0, jdays[1])
+        self.assertTrue(math.isnan(jdays[2]))
+        out = (ctypes.c_int64 * 3)()
+        coords.JulianDate2datetime64(jdays, out=out)
+        self.assertEqual(list(ns), list(out))
+        self.assertRaises(coords.Error, coords.datetime642JulianDate, doubles(0), doubles(0))
+
+    @unittest.skipIf(numpy is None, 'needs numpy')
+    def test_datetime64(self):
+        """Test batch datetime64 arrays to Julian dates and back"""
+        values = numpy.array(['2000-01-01T12:00', 'NaT', '1962-07-10T07:30:00.123456789'], dtype='datetime64[ns]')
+        jdays = coords.datetime642JulianDate(values)
+        self.assertEqual(2451545.0, jdays[0])
+        self.assertTrue(numpy.isnan(jdays[1]))
+        self.assertAlmostEqual(coords.datetime('1962-07-10T07:30:00.123456789').toJulianDate(), jdays[2], places=9)
+
+        round_trip = coords.JulianDate2datetime64(jdays)
+        self.assertEqual(numpy.dtype('datetime64[ns]'), round_trip.dtype)
+        self.assertEqual(values[0], round_trip[0])
+        self.assertTrue(numpy.isnat(round_trip[1]))
+        self.assertLess(abs(int(values[2].astype('int64')) - int(round_trip[2].astype('int64'))), 50000)
+
+        # other units are converted, out must be datetime64[ns]
+        self.assertEqual(2451545.0, coords.datetime642JulianDate(values.astype('datetime64[s]'))[0])
+        out = numpy.empty(3, dtype='datetime64[ns]')
+        self.assertIs(out, coords.JulianDate2datetime64(jdays, out=out))
+        self.assertRaises(coords.Error, coords.JulianDate2datetime64, jdays, out=numpy.empty(3, dtype='datetime64[s]'))
+
+
+class TestDateTimeInterop(unittest.TestCase):
+    """Field level conversions to and from datetime.datetime and numpy.datetime64"""
+
+    def test_from_datetime(self):
+        """Test construction from an aware datetime.datetime"""
+        tz = datetime.timezone(datetime.timedelta(hours=5, minutes=30))
+        a = coords.datetime(datetime.datetime(2016, 2, 29, 7, 8, 9, 500000, tzinfo=tz))
+        self.assertEqual(5.5, a.timezone)
+        self.assertEqual(coords.datetime('2016-02-29T07:08:09.5+05:30').toJulianDate(), a.toJulianDate())
+
+    def test_from_naive_datetime(self):
+        """Test a naive datetime.datetime is UT"""
+        a = coords.datetime(datetime.datetime(1962, 7, 10, 7, 30))
+        self.assertEqual('1962-07-10T07:30:00', str(a))
+        self.assertEqual(0, a.timezone)
+
+    def test_to_datetime(self):
+        """Test toDatetime() round trip"""
+        tz = datetime.timezone(datetime.timedelta(hours=-9, minutes=-45))
+        a_datetime = datetime.datetime(2012, 6, 30, 23, 59, 59, 999999, tzinfo=tz)
+        self.assertEqual(a_datetime, coords.datetime(a_datetime).toDatetime())
+        utc = coords.datetime('2015-01-01T12:34:56.5Z').toDatetime()
+        self.assertEqual(datetime.datetime(2015, 1, 1, 12, 34, 56, 500000, tzinfo=datetime.timezone.utc), utc)
+
+    def test_to_datetime_carry(self):
+        """Test toDatetime() carries second 60 into the next minute"""
+        a = coords.datetime(2015, 12, 31, 23, 59, 60)
+        self.assertEqual(datetime.datetime(2016, 1, 1, tzinfo=datetime.timezone.utc), a.toDatetime())
+
+    def test_exceptions(self):
+        """Test datetime.datetime conversion exceptions"""
+        self.assertRaises(coords.Error, coords.datetime, datetime.datetime(2000, 1, 1), 2)
+        self.assertRaises(coords.Error, coords.datetime, datetime.date(2000, 1, 1))
+
+    @unittest.skipIf(numpy is None, 'needs numpy')
+    def test_datetime64(self):
+        """Test datetime64 scalars both ways"""
+        a = coords.datetime(numpy.datetime64('2021-03-04T05:06:07.123456789'))
+        self.assertEqual(datetime.datetime(2021, 3, 4, 5, 6, 7, 123457, tzinfo=datetime.timezone.utc), a.toDatetime())
+        self.assertEqual(numpy.datetime64('2021-03-04T05:06:07.123456789', 'ns'), a.toDatetime64())
+        self.assertEqual(numpy.datetime64('1969-12-31T16:00', 'ns'),
+                         coords.datetime('1969-12-31T08:00:00-08:00').toDatetime64())
+        self.assertEqual(2451544.5,
+                         coords.datetime(numpy.datetime64('2000-01-01', 'D')).toJulianDate())
+        self.assertRaises(coords.Error, coords.datetime, numpy.datetime64('NaT'))
+        self.assertRaises(coords.Error, coords.datetime(2300, 1, 1).toDatetime64)
+
+
 
 if __name__ == '__main__':
     random.seed(time.time())
@@ -7,7 +7,9 @@ which case the test should be investigated.
 """
 
 import copy
+import ctypes
 import math
+import pickle
 import random
 import time
 import unittest
@@ -53,6 +55,13 @@ class TestSpherical(unittest.TestCase):
         self.assertEqual(0, a.theta.value)
         self.assertEqual(0, a.phi.value)
 
+    def test_default_constructor_recycled(self):
+        """Test default constructor reusing a freed object"""
+        for i in range(3):
+            a = coords.spherical(1, coords.angle(2), coords.angle(3))
+            del a
+            self.assertEqual(0, coords.spherical().r)
+
 
     def test_r_constructor(self):
         """Test r constructor"""
@@ -176,10 +185,10 @@ class TestSpherical(unittest.TestCase):
     def test_repr(self):
         """Test repr"""
 
-        # %s precision is controlled by space.cpp and designed to match this test
-        a_repr = '(%(x)s, %(y)s, %(z)s)' % {'x':self.p1.r,
-                                            'y':self.p1.theta,
-                                            'z':self.p1.phi}
+        # repr precision is controlled by coords.cpp, 12 digits like Python 2 str(float)
+        a_repr = '(%(x).12g, %(y)s, %(z)s)' % {'x':self.p1.r,
+                                               'y':self.p1.theta,
+                                               'z':self.p1.phi}
         self.assertEqual(a_repr, repr(self.p1))
 
 
@@ -449,6 +458,51 @@ class TestSpherical(unittest.TestCase):
         self.assertAlmostEqual(120, lat1.theta.value)
         self.assertAlmostEqual(120, lat1.phi.value)
 
+    def test_pickle(self):
+        """Test pickle round trip is exact"""
+        a = coords.spherical(6371, coords.angle(0.1), coords.angle(-122, 10, 55))
+        a_copy = pickle.loads(pickle.dumps(a, pickle.HIGHEST_PROTOCOL))
+        self.assertEqual(coords.spherical, type(a_copy))
+        self.assertEqual(a.r, a_copy.r)
+        self.assertEqual(a.theta.value, a_copy.theta.value)
+        self.assertEqual(a.phi.value, a_copy.phi.value)
+
+
+def doubles(*values):
+    """Returns a ctypes float64 buffer"""
+    return (ctypes.c_double * len(values))(*values)
+
+
+class TestSphericalBatch(unittest.TestCase):
+    """Batch conversions over float64 buffers"""
+
+    def test_Cartesian2spherical(self):
+        """Test batch Cartesian to spherical conversion"""
+        points = [coords.Cartesian(1, 2, 3), coords.Cartesian(-4, 0.5, -6), coords.Cartesian(0, 0, -1)]
+        out = coords.Cartesian2spherical(doubles(*[c for p in points for c in (p.x, p.y, p.z)]),
+                                         out=doubles(*[0]*9))
+        for i, p in enumerate(points):
+            a = coords.spherical(p)
+            self.assertAlmostEqual(a.r, out[3*i], places=12)
+            self.assertAlmostEqual(a.theta.value, out[3*i + 1], places=12)
+            self.assertAlmostEqual(a.phi.value, out[3*i + 2], places=12)
+
+    def test_spherical2Cartesian(self):
+        """Test batch spherical to Cartesian conversion"""
+        out = coords.spherical2Cartesian(doubles(1, 90, 90, 2, 0, 0, 1, 90, 0), out=doubles(*[0]*9))
+        expected = [0, 1, 0, 0, 0, 2, 1, 0, 0]
+        for i, value in enumerate(expected):
+            self.assertAlmostEqual(value, out[i], places=12)
+
+    def test_round_trip_in_place(self):
+        """Test batch conversions in place"""
+        xyz = doubles(1, 2, 3, -4, 5, -6)
+        coords.Cartesian2spherical(xyz, xyz)
+        coords.spherical2Cartesian(xyz, xyz)
+        for i, value in enumerate([1, 2, 3, -4, 5, -6]):
+            self.assertAlmostEqual(value, xyz[i], places=12)
+
+
 
 if __name__ == '__main__':
     random.seed(time.time())
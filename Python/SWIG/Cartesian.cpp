@@ -1 +0,0 @@
-../../libCoords/Cartesian.cpp
\ No newline at end of file
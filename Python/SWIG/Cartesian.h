@@ -1 +0,0 @@
-../../libCoords/Cartesian.h
\ No newline at end of file
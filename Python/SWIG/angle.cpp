@@ -1 +0,0 @@
-../../libCoords/angle.cpp
\ No newline at end of file
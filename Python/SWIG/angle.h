@@ -1 +0,0 @@
-../../libCoords/angle.h
\ No newline at end of file
@@ -1 +0,0 @@
-../../libCoords/spherical.h
\ No newline at end of file
@@ -1 +0,0 @@
-../../libCoords/utils.cpp
\ No newline at end of file
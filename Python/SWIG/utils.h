@@ -1 +0,0 @@
-../../libCoords/utils.h
\ No newline at end of file
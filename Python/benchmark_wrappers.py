@@ -0,0 +1,103 @@
+"""Per call overhead of the coords Python wrappers.
+
+Times the same scalar calls, and one batch call, against each built
+wrapper so they can be compared side by side. Each wrapper is a
+module named coords, so each one runs in its own interpreter with its
+build directory on the PYTHONPATH.
+
+usage: python benchmark_wrappers.py [number]
+
+finds Manual/build/*/coords*.so and Boost/build/*/coords*.so
+relative to this file. libCoords must be on the (DY)LD_LIBRARY_PATH,
+e.g. run it from Manual/pylaunch.sh.
+"""
+
+import glob
+import json
+import os
+import subprocess
+import sys
+import timeit
+
+wrappers = ['Manual', 'Boost']
+
+setup = """
+import coords
+a = coords.Cartesian(1.0, 2.0, 3.0)
+b = coords.Cartesian(4.0, 5.0, 6.0)
+an_angle = coords.angle(30.0)
+a_rotator = coords.rotator(coords.Cartesian(1.0, 1.0, 1.0))
+"""
+
+statements = [
+    ('Cartesian(x, y, z)', 'coords.Cartesian(1.0, 2.0, 3.0)'),
+    ('Cartesian + Cartesian', 'a + b'),
+    ('Cartesian * float', 'a * 2.0'),
+    ('Cartesian.magnitude()', 'a.magnitude()'),
+    ('Cartesian.x', 'a.x'),
+    ('angle(deg)', 'coords.angle(30.0)'),
+    ('angle + angle', 'an_angle + an_angle'),
+    ('rotator.rotate()', 'a_rotator.rotate(a, an_angle)'),
+    ('spherical(Cartesian)', 'coords.spherical(a)'),
+]
+
+# magnitude of 10000 vectors, per vector. The batch function if the
+# wrapper has one, else a Python loop.
+batch_setup = setup + """
+import array
+xyz = array.array('d', range(30000))
+points = [coords.Cartesian(xyz[i], xyz[i + 1], xyz[i + 2]) for i in range(0, 30000, 3)]
+mags = array.array('d', bytes(8*10000))
+has_batch = hasattr(coords, 'magnitude')
+"""
+
+batch_statement = """
+if has_batch:
+    coords.magnitude(xyz, out=mags)
+else:
+    mags = [p.magnitude() for p in points]
+"""
+
+
+def run(number):
+    """Runs in the child interpreter, returns ns per call by name."""
+    results = {}
+    for name, statement in statements:
+        seconds = min(timeit.repeat(statement, setup, repeat=3, number=number))
+        results[name] = 1e9*seconds/number
+    batch_number = max(1, number//10000)
+    seconds = min(timeit.repeat(batch_statement, batch_setup, repeat=3, number=batch_number))
+    results['magnitude x 10000'] = 1e9*seconds/batch_number/10000
+    return results
+
+
+def find_build(wrapper):
+    here = os.path.dirname(os.path.abspath(__file__))
+    found = glob.glob(os.path.join(here, wrapper, 'build', '*', 'coords*.so'))
+    return os.path.dirname(found[0]) if found else None
+
+
+def main(number):
+    columns = []
+    table = {}
+    for wrapper in wrappers:
+        build = find_build(wrapper)
+        if build is None:
+            print('# %s: not built, skipped' % wrapper)
+            continue
+        env = dict(os.environ)
+        env['PYTHONPATH'] = build
+        output = subprocess.check_output([sys.executable, __file__, '--child', str(number)], env=env)
+        columns.append(wrapper)
+        table[wrapper] = json.loads(output)
+
+    print('%-24s' % '' + ''.join('%12s' % c for c in columns))
+    for name in [s[0] for s in statements] + ['magnitude x 10000']:
+        print('%-24s' % name + ''.join('%9.1f ns' % table[c][name] for c in columns))
+
+
+if __name__ == '__main__':
+    if len(sys.argv) > 1 and sys.argv[1] == '--child':
+        print(json.dumps(run(int(sys.argv[2]))))
+    else:
+        main(int(sys.argv[1]) if len(sys.argv) > 1 else 1000000)
@@ -6,19 +6,16 @@
 
 platform=`uname`
 
-if [[ "$platform" == 'Darwin' ]]; then
-
-pys="./Python/Manual ./Python/Boost" # TODO ./python/SWIG"
-
-elif [[ "$platform" == 'Linux' ]]; then
-
-pys="./Python/Boost" # TODO skip manual build on Linux for now.
-
-else
+if [[ "$platform" != 'Darwin' && "$platform" != 'Linux' ]]; then
     echo "unsupported platform"
     exit 1
 fi
 
+# Python/Manual is the Python binding. Python/Boost is only kept to
+# compare against, see Python/benchmark_wrappers.py.
+
+pys="./Python/Manual ./Python/Boost"
+
 
 libs="./libCoords"
 
@@ -21,8 +21,12 @@
 //  along with Coordinates.  If not, see <http://www.gnu.org/licenses/>.
 // ==================================================================
 
+#include <algorithm>
+#include <type_traits>
+
 #include <angle.h>
 #include <Cartesian.h>
+#include <Cartesian_inl.h>
 #include <spherical.h>
 #include <utils.h>
 
@@ -32,10 +36,13 @@
 
 // ----- static data members -----
 
-const Coords::Cartesian Coords::Cartesian::Uo(0,0,0);
-const Coords::Cartesian Coords::Cartesian::Ux(1,0,0);
-const Coords::Cartesian Coords::Cartesian::Uy(0,1,0);
-const Coords::Cartesian Coords::Cartesian::Uz(0,0,1);
+// constant initialized from the constexpr vectors, i.e. no static
+// initialization order to worry about.
+
+const Coords::Cartesian Coords::Cartesian::Uo(Coords::Uo);
+const Coords::Cartesian Coords::Cartesian::Ux(Coords::Ux);
+const Coords::Cartesian Coords::Cartesian::Uy(Coords::Uy);
+const Coords::Cartesian Coords::Cartesian::Uz(Coords::Uz);
 
 // ----- constructor from string for building from xml ----
 Coords::Cartesian::Cartesian(const std::string& a,
@@ -62,149 +69,62 @@ Coords::Cartesian::Cartesian(const Coords::spherical& a)
   x(r_xy * cos(a.phi().radians()));
 }
 
-// ----- copy constructor -----
-Coords::Cartesian::Cartesian(const Coords::Cartesian& a) {
-  x(a.x());
-  y(a.y());
-  z(a.z());
-};
-
-// ----- copy assignment -----
-Coords::Cartesian& Coords::Cartesian::operator=(const Coords::Cartesian& rhs) {
-  if (this == &rhs) return *this;
-  x(rhs.x());
-  y(rhs.y());
-  z(rhs.z());
-  return *this;
-}
-
-// ----- bool operators -----
-
-bool Coords::Cartesian::operator== (const Coords::Cartesian& rhs) const {
-  return x() == rhs.x() && y() == rhs.y() && z() == rhs.z();
-}
-
-bool Coords::Cartesian::operator!= (const Coords::Cartesian& rhs) const {
-  return !operator==(rhs);
-}
-
-// ----- in-place operators -----
-
-Coords::Cartesian& Coords::Cartesian::operator+=(const Coords::Cartesian& rhs) {
-  m_x += rhs.x();
-  m_y += rhs.y();
-  m_z += rhs.z();
-  return *this;
-}
-
-Coords::Cartesian& Coords::Cartesian::operator-=(const Coords::Cartesian& rhs) {
-  m_x -= rhs.x();
-  m_y -= rhs.y();
-  m_z -= rhs.z();
-  return *this;
-}
-
-Coords::Cartesian& Coords::Cartesian::operator*=(const double& rhs) {
-  m_x *= rhs;
-  m_y *= rhs;
-  m_z *= rhs;
-  return *this;
-}
-
-Coords::Cartesian& Coords::Cartesian::operator/=(const double& rhs) throw (DivideByZeroError) {
-  if (rhs == 0)
-    throw DivideByZeroError();
-  m_x /= rhs;
-  m_y /= rhs;
-  m_z /= rhs;
-  return *this;
-}
-
-// ----- normalizing -----
-
-double Coords::Cartesian::magnitude() const {
-  return sqrt(magnitude2());
-}
-
-double Coords::Cartesian::magnitude2() const {
-  return m_x*m_x + m_y*m_y + m_z*m_z;
-}
-
-Coords::Cartesian Coords::Cartesian::normalized() const throw (DivideByZeroError) {
-  const double h(magnitude());
-  return Coords::Cartesian(m_x/h, m_y/h, m_z/h);
-}
-
-// ---------------------
-// ----- operators -----
-// ---------------------
-
-Coords::Cartesian Coords::operator+(const Coords::Cartesian& lhs,
-				    const Coords::Cartesian& rhs) {
-  return Coords::Cartesian(lhs.x() + rhs.x(),
-			   lhs.y() + rhs.y(),
-			   lhs.z() + rhs.z());
-}
-
-Coords::Cartesian Coords::operator-(const Coords::Cartesian& lhs,
-				    const Coords::Cartesian& rhs) {
-  return Coords::Cartesian(lhs.x() - rhs.x(),
-			   lhs.y() - rhs.y(),
-			   lhs.z() - rhs.z());
-}
-
-Coords::Cartesian Coords::operator-(const Coords::Cartesian& rhs) {
-  return Coords::Cartesian(-rhs.x(),
-			   -rhs.y(),
-			   -rhs.z());
-}
-
-// scale
-Coords::Cartesian Coords::operator*(const Coords::Cartesian& lhs,
-				    const double& rhs) {
-  return Coords::Cartesian(lhs.x() * rhs, lhs.y() * rhs, lhs.z() * rhs);
-}
+// ---------------------------
+// ----- batch operators -----
+// ---------------------------
 
-Coords::Cartesian Coords::operator*(const double& lhs,
-				    const Coords::Cartesian& rhs) {
-  return Coords::operator*(rhs, lhs);
+void Coords::magnitude(const double* a_xyz, double* a_magnitude, const size_t& a_size) {
+  for (size_t i = 0; i < a_size; ++i) {
+    const double* v(a_xyz + 3*i);
+    a_magnitude[i] = sqrt(v[0]*v[0] + v[1]*v[1] + v[2]*v[2]);
+  }
 }
 
-Coords::Cartesian Coords::operator/(const Coords::Cartesian& lhs,
-				    const double& rhs)
-  throw (DivideByZeroError) {
-  if (rhs == 0)
-    throw DivideByZeroError();
-  return Coords::Cartesian(lhs.x() / rhs, lhs.y() / rhs, lhs.z() / rhs);
+void Coords::normalized(const double* a_xyz, double* a_unit, const size_t& a_size) {
+  for (size_t i = 0; i < 3*a_size; i += 3) {
+    const double x(a_xyz[i]), y(a_xyz[i+1]), z(a_xyz[i+2]);
+    const double h(sqrt(x*x + y*y + z*z));
+    a_unit[i]   = x/h;
+    a_unit[i+1] = y/h;
+    a_unit[i+2] = z/h;
+  }
 }
 
-Coords::Cartesian Coords::operator/(const double& lhs,
-				    const Coords::Cartesian& rhs)
-  throw (DivideByZeroError) {
-  if (rhs.x() == 0 || rhs.y() == 0 || rhs.z() == 0)
-    throw DivideByZeroError();
-  return Coords::Cartesian(lhs / rhs.x(), lhs / rhs.y(), lhs / rhs.z());
+void Coords::separation(const double* a_xyz,
+			const double* b_xyz,
+			double* a_degrees,
+			const size_t& a_size) {
+  // atan2(|a x b|, a . b) is accurate for small and near 180 degree
+  // separations where acos(a . b/(|a||b|)) is not.
+  for (size_t i = 0; i < a_size; ++i) {
+    const double* a(a_xyz + 3*i);
+    const double* b(b_xyz + 3*i);
+    const double cx(a[1]*b[2] - a[2]*b[1]);
+    const double cy(a[2]*b[0] - a[0]*b[2]);
+    const double cz(a[0]*b[1] - a[1]*b[0]);
+    a_degrees[i] = Coords::angle::rad2deg(atan2(sqrt(cx*cx + cy*cy + cz*cz),
+						a[0]*b[0] + a[1]*b[1] + a[2]*b[2]));
+  }
 }
 
-// ----- vector products -----
-
-double Coords::operator*(const Coords::Cartesian& lhs,
-			 const Coords::Cartesian& rhs) {
-  return lhs.x()*rhs.x() + lhs.y()*rhs.y() + lhs.z()*rhs.z();
-}
+// ----- binary records -----
 
-double Coords::dot(const Coords::Cartesian& lhs,
-		   const Coords::Cartesian& rhs) {
-  return lhs * rhs;
+void Coords::Cartesian2binary(const Cartesian* a_Cartesians, char* a_buffer, const size_t& a_size) {
+  for (size_t i = 0; i < a_size; ++i) {
+    char* a_record(a_buffer + i*Cartesian_binary_size);
+    Coords::double2binary(a_Cartesians[i].x(), a_record);
+    Coords::double2binary(a_Cartesians[i].y(), a_record + 8);
+    Coords::double2binary(a_Cartesians[i].z(), a_record + 16);
+  }
 }
 
-Coords::Cartesian Coords::cross(const Coords::Cartesian& a,
-				const Coords::Cartesian& b) {
-  Coords::Cartesian tmp;
-  tmp.x(a.y()*b.z() - a.z()*b.y());
-  tmp.y(a.z()*b.x() - a.x()*b.z());
-  tmp.z(a.x()*b.y() - a.y()*b.x());
-  return tmp;
+void Coords::binary2Cartesian(const char* a_buffer, Cartesian* a_Cartesians, const size_t& a_size) {
+  for (size_t i = 0; i < a_size; ++i) {
+    const char* a_record(a_buffer + i*Cartesian_binary_size);
+    a_Cartesians[i] = Coords::Cartesian(Coords::binary2double(a_record),
+					Coords::binary2double(a_record + 8),
+					Coords::binary2double(a_record + 16));
+  }
 }
 
 // -------------------------
@@ -213,31 +133,12 @@ Coords::Cartesian Coords::cross(const Coords::Cartesian& a,
 
 Coords::rotator::rotator(const Coords::Cartesian& an_axis) :
   m_axis(Coords::Cartesian::Uo),
-  m_rotation_matrix(3, std::vector<double>(3, 0)),
+  m_rotation_matrix(),
   m_is_new_axis(true),
   m_current_angle(0.0) {
   axis(an_axis);
 }
 
-// copy constructor
-Coords::rotator::rotator(const Coords::rotator& a) :
-  m_axis(Coords::Cartesian::Uo),
-  m_is_new_axis(true),
-  m_current_angle(0.0) {
-  m_rotation_matrix.clear();
-  m_rotation_matrix = a.m_rotation_matrix;
-  axis(a.axis());
-}
-
-// copy assign
-Coords::rotator& Coords::rotator::operator=(const Coords::rotator& rhs) {
-  if (this == &rhs) return *this;
-  m_rotation_matrix.clear();
-  m_rotation_matrix = rhs.m_rotation_matrix;
-  axis(rhs.axis());
-  return *this;
-}
-
 // axis access
 void Coords::rotator::axis(const Coords::Cartesian& an_axis) {
   if (an_axis != m_axis) {
@@ -246,8 +147,9 @@ void Coords::rotator::axis(const Coords::Cartesian& an_axis) {
   }
 }
 
-Coords::Cartesian Coords::rotator::rotate(const Coords::Cartesian& a_vector,
-					  const Coords::angle& an_angle) {
+void Coords::rotator::rotationMatrix(const Coords::Cartesian& an_axis,
+				     const Coords::angle& an_angle,
+				     double a_matrix[3][3]) {
 
   // Quaternion-derived rotation matrix
   // http://en.wikipedia.org/wiki/Quaternions_and_spatial_rotation#Quaternion-derived_rotation_matrix
@@ -256,60 +158,88 @@ Coords::Cartesian Coords::rotator::rotate(const Coords::Cartesian& a_vector,
   // TODO this is ok for rotations about Ux, Uy, Uz, but not right in
   // the diagonal (1,1,1) and others? See DISABLED_RotationTest, Diagonal_xyz_180.
 
-  // Python Manual is not picking up this initialization like Boost
-  if (m_rotation_matrix.size() != 3) {
-    m_rotation_matrix.clear();
-    for(int i = 0; i < 3; ++i) {
-      std::vector<double> row(3, 0);
-      m_rotation_matrix.push_back(row);
-    }
-  }
+  double c(cos(an_angle.radians()));
+  double s(sin(an_angle.radians()));
 
-  if (m_is_new_axis || m_current_angle != an_angle) {
+  double t(1-c);
 
-    double c(cos(an_angle.radians()));
-    double s(sin(an_angle.radians()));
+  a_matrix[0][0] = c + an_axis.x()*an_axis.x()*t;
+  a_matrix[1][1] = c + an_axis.y()*an_axis.y()*t;
+  a_matrix[2][2] = c + an_axis.z()*an_axis.z()*t;
 
-    double t(1-c);
+  double t1(an_axis.x()*an_axis.y()*t);
+  double t2(an_axis.z()*s);
 
-    m_rotation_matrix[0][0] = c + axis().x()*axis().x()*t;
-    m_rotation_matrix[1][1] = c + axis().y()*axis().y()*t;
-    m_rotation_matrix[2][2] = c + axis().z()*axis().z()*t;
+  a_matrix[1][0] = t1 + t2;
+  a_matrix[0][1] = t1 - t2;
 
-    double t1(axis().x()*axis().y()*t);
-    double t2(axis().z()*s);
+  t1 = an_axis.x()*an_axis.z()*t;
+  t2 = an_axis.y()*s;
 
-    m_rotation_matrix[1][0] = t1 + t2;
-    m_rotation_matrix[0][1] = t1 - t2;
+  a_matrix[2][0] = t1 - t2;
+  a_matrix[0][2] = t1 + t2;
 
-    t1 = axis().x()*axis().z()*t;
-    t2 = axis().y()*s;
+  t1 = an_axis.y()*an_axis.z()*t;
+  t2 = an_axis.x()*s;
 
-    m_rotation_matrix[2][0] = t1 - t2;
-    m_rotation_matrix[0][2] = t1 + t2;
+  a_matrix[2][1] = t1 + t2;
+  a_matrix[1][2] = t1 - t2;
 
-    t1 = axis().y()*axis().z()*t;
-    t2 = axis().x()*s;
+}
 
-    m_rotation_matrix[2][1] = t1 + t2;
-    m_rotation_matrix[1][2] = t1 - t2;
+Coords::Cartesian Coords::rotator::multiply(const double a_matrix[3][3],
+					    const Coords::Cartesian& a_vector) {
+  return Coords::Cartesian(a_matrix[0][0]*a_vector.x() +
+			   a_matrix[0][1]*a_vector.y() +
+			   a_matrix[0][2]*a_vector.z(),
+			   a_matrix[1][0]*a_vector.x() +
+			   a_matrix[1][1]*a_vector.y() +
+			   a_matrix[1][2]*a_vector.z(),
+			   a_matrix[2][0]*a_vector.x() +
+			   a_matrix[2][1]*a_vector.y() +
+			   a_matrix[2][2]*a_vector.z());
+}
 
+void Coords::rotator::updateMatrix(const Coords::angle& an_angle) {
+  if (m_is_new_axis || m_current_angle != an_angle) {
+    rotationMatrix(axis(), an_angle, m_rotation_matrix);
     m_is_new_axis = false;
     m_current_angle = an_angle;
-
   }
+}
 
-  Coords::Cartesian tmp(m_rotation_matrix[0][0]*a_vector.x() +
-			m_rotation_matrix[0][1]*a_vector.y() +
-			m_rotation_matrix[0][2]*a_vector.z(),
-			m_rotation_matrix[1][0]*a_vector.x() +
-			m_rotation_matrix[1][1]*a_vector.y() +
-			m_rotation_matrix[1][2]*a_vector.z(),
-			m_rotation_matrix[2][0]*a_vector.x() +
-			m_rotation_matrix[2][1]*a_vector.y() +
-			m_rotation_matrix[2][2]*a_vector.z());
+Coords::Cartesian Coords::rotator::rotate(const Coords::Cartesian& a_vector,
+					  const Coords::angle& an_angle) {
+  updateMatrix(an_angle);
+  return multiply(m_rotation_matrix, a_vector);
+}
 
-  return tmp;
+Coords::Cartesian Coords::rotator::rotate(const Coords::Cartesian& a_vector,
+					  const Coords::angle& an_angle) const {
+  double a_matrix[3][3];
+  rotationMatrix(axis(), an_angle, a_matrix);
+  return multiply(a_matrix, a_vector);
+}
+
+void Coords::rotator::rotate(const double* a_xyz,
+			     double* a_rotated,
+			     const size_t& a_size,
+			     const Coords::angle& an_angle) const {
+
+  double a_matrix[3][3];
+  rotationMatrix(axis(), an_angle, a_matrix);
+
+  // local copies so the loop does not reload them through a_rotated.
+  const double m00(a_matrix[0][0]), m01(a_matrix[0][1]), m02(a_matrix[0][2]);
+  const double m10(a_matrix[1][0]), m11(a_matrix[1][1]), m12(a_matrix[1][2]);
+  const double m20(a_matrix[2][0]), m21(a_matrix[2][1]), m22(a_matrix[2][2]);
+
+  for (size_t i = 0; i < 3*a_size; i += 3) {
+    const double x(a_xyz[i]), y(a_xyz[i+1]), z(a_xyz[i+2]);
+    a_rotated[i]   = m00*x + m01*y + m02*z;
+    a_rotated[i+1] = m10*x + m11*y + m12*z;
+    a_rotated[i+2] = m20*x + m21*y + m22*z;
+  }
 
 }
 
@@ -320,29 +250,366 @@ Coords::Cartesian Coords::rotator::rotate(const Coords::Cartesian& a_vector,
 
 const unsigned int Coords::CartesianRecorder::default_size(1024);
 
+// the segments are read as packed x, y, z doubles.
+static_assert(sizeof(Coords::Cartesian) == 3*sizeof(double) &&
+	      std::is_standard_layout<Coords::Cartesian>::value,
+	      "Cartesian must be three packed doubles");
+
+namespace {
+
+  // the most capsules in a simplify window. A full window merges
+  // pairs of neighbours into the capsules around them, which keeps a
+  // push O(1) and the test of the window conservative.
+  const size_t s_window(8);
+
+  Coords::Cartesian lowerOf(const Coords::Cartesian& a, const Coords::Cartesian& b) {
+    return Coords::Cartesian(std::min(a.x(), b.x()), std::min(a.y(), b.y()), std::min(a.z(), b.z()));
+  }
+
+  Coords::Cartesian upperOf(const Coords::Cartesian& a, const Coords::Cartesian& b) {
+    return Coords::Cartesian(std::max(a.x(), b.x()), std::max(a.y(), b.y()), std::max(a.z(), b.z()));
+  }
+
+  // a segment for the distances of many points from it
+  class segment {
+  public:
+    segment(const Coords::Cartesian& a_begin, const Coords::Cartesian& an_end) :
+      m_begin(a_begin), m_direction(an_end - a_begin), m_length2(m_direction.magnitude2()) {}
+
+    double distance(const Coords::Cartesian& a_point) const {
+      const Coords::Cartesian r(a_point - m_begin);
+      const double t(m_length2 > 0 ? std::min(1.0, std::max(0.0, Coords::dot(r, m_direction)/m_length2)) : 0);
+      return (r - t*m_direction).magnitude();
+    }
+
+  private:
+    Coords::Cartesian m_begin;
+    Coords::Cartesian m_direction;
+    double            m_length2;
+  };
+
+  void checkLimit(const bool& is_reduced, const int& a_size_limit) {
+    if (is_reduced && a_size_limit > 0 && a_size_limit < 4)
+      throw Coords::Error("a reducing recorder needs a size limit of 0 or at least 4");
+  }
+
+} // end anonymous namespace
+
 Coords::CartesianRecorder::CartesianRecorder(const unsigned int& a_size_limit) :
   m_size_limit(a_size_limit),
-  m_data(std::deque<Coords::Cartesian>(m_size_limit))
+  m_data(m_size_limit),
+  m_begin(0),
+  m_policy(keep_newest),
+  m_pushed(0),
+  m_stride(1),
+  m_first_tolerance(0),
+  m_tolerance(0),
+  m_open_count(0)
 {}
 
 Coords::CartesianRecorder::CartesianRecorder(const Coords::CartesianRecorder& a):
   m_size_limit(a.sizeLimit()),
-  m_data(a.m_data)
+  m_data(a.m_data),
+  m_begin(a.m_begin),
+  m_policy(a.m_policy),
+  m_pushed(a.m_pushed),
+  m_indices(a.m_indices),
+  m_stride(a.m_stride),
+  m_first_tolerance(a.m_first_tolerance),
+  m_tolerance(a.m_tolerance),
+  m_window(a.m_window),
+  m_lower(a.m_lower),
+  m_upper(a.m_upper),
+  m_open_sum(a.m_open_sum),
+  m_open_lower(a.m_open_lower),
+  m_open_upper(a.m_open_upper),
+  m_open_count(a.m_open_count)
 {}
 
 Coords::CartesianRecorder&
 Coords::CartesianRecorder::operator=(const Coords::CartesianRecorder& rhs) {
   if (this == &rhs) return *this;
-  sizeLimit(rhs.sizeLimit());
+  m_size_limit = rhs.m_size_limit;
   m_data = rhs.m_data;
+  m_begin = rhs.m_begin;
+  m_policy = rhs.m_policy;
+  m_pushed = rhs.m_pushed;
+  m_indices = rhs.m_indices;
+  m_stride = rhs.m_stride;
+  m_first_tolerance = rhs.m_first_tolerance;
+  m_tolerance = rhs.m_tolerance;
+  m_window = rhs.m_window;
+  m_lower = rhs.m_lower;
+  m_upper = rhs.m_upper;
+  m_open_sum = rhs.m_open_sum;
+  m_open_lower = rhs.m_open_lower;
+  m_open_upper = rhs.m_open_upper;
+  m_open_count = rhs.m_open_count;
   return *this;
 }
 
+void Coords::CartesianRecorder::sizeLimit(const int& a) {
+  checkLimit(m_policy != keep_newest, a);
+  m_size_limit = a;
+  if (m_policy != keep_newest) {
+    // reduces until the samples fit.
+    while (m_size_limit > 0 && m_data.size() > m_size_limit)
+      compact();
+    return;
+  }
+  // keeps the newest samples that fit.
+  linearize();
+  if (m_size_limit > 0 && m_data.size() > m_size_limit)
+    m_data.erase(m_data.begin(), m_data.end() - m_size_limit);
+}
+
 void Coords::CartesianRecorder::push(Coords::Cartesian a) {
-  // even up the sizes to just under the limit.
-  while (m_data.size() > sizeLimit() - 1)
-    m_data.pop_front();
+  ++m_pushed;
+  switch (m_policy) {
+  case decimate: pushDecimated(a);  return;
+  case simplify: pushSimplified(a); return;
+  case bin:      pushBinned(a);     return;
+  case keep_newest: break;
+  }
+  // grows to the limit, then overwrites the oldest. No limit is unbounded.
+  if (m_size_limit == 0 || m_data.size() < m_size_limit) {
+    m_data.push_back(a); // m_begin stays 0 until the ring is full
+  } else {
+    m_data[m_begin] = a;
+    m_begin = (m_begin + 1) % m_data.size();
+  }
+}
+
+void Coords::CartesianRecorder::clear() {
+  m_data.clear();
+  m_begin = 0;
+  m_pushed = 0;
+  m_indices.clear();
+  m_stride = 1;
+  m_tolerance = m_first_tolerance;
+  m_window.clear();
+  m_lower.clear();
+  m_upper.clear();
+  m_open_count = 0;
+}
+
+// ----- reduction -----
+
+void Coords::CartesianRecorder::reduction(const policy& a_policy, const double& a_tolerance) {
+  if (!(a_tolerance >= 0))
+    throw Error("the tolerance of a recorder must not be negative");
+  checkLimit(a_policy != keep_newest, m_size_limit);
+  m_policy = a_policy;
+  m_first_tolerance = a_tolerance;
+  clear();
+}
+
+const Coords::Cartesian& Coords::CartesianRecorder::lower(const unsigned int& idx) const {
+  if (m_policy != bin)
+    throw Error("only a binning recorder has bounds");
+  return m_lower[idx];
+}
+
+const Coords::Cartesian& Coords::CartesianRecorder::upper(const unsigned int& idx) const {
+  if (m_policy != bin)
+    throw Error("only a binning recorder has bounds");
+  return m_upper[idx];
+}
+
+// ----- simplify -----
+
+// true if a_point and some_capsules are within a_tolerance of the
+// segment from a_begin to an_end. The points of a capsule are within
+// its radius of its segment, whose points are no farther than its
+// ends.
+bool Coords::CartesianRecorder::fits(const std::vector<capsule>& some_capsules, const Cartesian& a_point,
+				     const Cartesian& a_begin, const Cartesian& an_end, const double& a_tolerance) {
+  const segment a_segment(a_begin, an_end);
+  if (a_segment.distance(a_point) > a_tolerance)
+    return false;
+  for (size_t i = 0; i < some_capsules.size(); ++i) {
+    const capsule& c(some_capsules[i]);
+    if (std::max(a_segment.distance(c.m_begin), a_segment.distance(c.m_end)) + c.m_radius > a_tolerance)
+      return false;
+  }
+  return true;
+}
+
+void Coords::CartesianRecorder::addToWindow(std::vector<capsule>& some_capsules, const Cartesian& a_point) {
+  const capsule a_capsule = {a_point, a_point, 0};
+  some_capsules.push_back(a_capsule);
+  if (some_capsules.size() <= s_window)
+    return;
+  size_t kept(0);
+  for (size_t i = 0; i + 1 < some_capsules.size(); i += 2, ++kept) {
+    const capsule& a(some_capsules[i]);
+    const capsule& b(some_capsules[i + 1]);
+    const segment a_segment(a.m_begin, b.m_end);
+    const capsule merged = {a.m_begin, b.m_end,
+			    std::max(a_segment.distance(a.m_end) + a.m_radius,
+				     a_segment.distance(b.m_begin) + b.m_radius)};
+    some_capsules[kept] = merged;
+  }
+  some_capsules[kept] = some_capsules.back();
+  some_capsules.resize(kept + 1);
+}
+
+// the positions of some_points kept by simplify with a_tolerance
+std::vector<size_t> Coords::CartesianRecorder::simplified(const std::vector<Cartesian>& some_points,
+							  const double& a_tolerance) {
+  std::vector<size_t> kept;
+  std::vector<capsule> window;
+  for (size_t i = 0; i < some_points.size(); ++i) {
+    const size_t k(kept.size());
+    if (k >= 2 && fits(window, some_points[kept.back()], some_points[kept[k - 2]], some_points[i], a_tolerance)) {
+      addToWindow(window, some_points[kept.back()]);
+      kept.back() = i;
+    } else {
+      kept.push_back(i);
+      window.clear();
+    }
+  }
+  return kept;
+}
+
+void Coords::CartesianRecorder::pushDecimated(const Cartesian& a) {
+  const unsigned long n(m_pushed - 1);
+  if (n % m_stride)
+    return;
+  if (m_size_limit > 0 && m_data.size() >= m_size_limit) {
+    compact();
+    if (n % m_stride)
+      return;
+  }
+  m_data.push_back(a);
+  m_indices.push_back(n);
+}
+
+void Coords::CartesianRecorder::pushSimplified(const Cartesian& a) {
+  // the newest sample is always the last kept, and replaces it while
+  // the window since the one before still fits.
+  const size_t k(m_data.size());
+  if (k >= 2 && fits(m_window, m_data.back(), m_data[k - 2], a, m_tolerance)) {
+    addToWindow(m_window, m_data.back());
+    m_data.back() = a;
+    m_indices.back() = m_pushed - 1;
+    return;
+  }
+  if (m_size_limit > 0 && k >= m_size_limit)
+    compact();
   m_data.push_back(a);
+  m_indices.push_back(m_pushed - 1);
+  m_window.clear();
+}
+
+void Coords::CartesianRecorder::pushBinned(const Cartesian& a) {
+  if (m_open_count == 0) {
+    m_open_sum = m_open_lower = m_open_upper = a;
+  } else {
+    m_open_sum += a;
+    m_open_lower = lowerOf(m_open_lower, a);
+    m_open_upper = upperOf(m_open_upper, a);
+  }
+  if (++m_open_count < m_stride)
+    return;
+  if (m_size_limit > 0 && m_data.size() >= m_size_limit)
+    compact(); // may reopen the last bin to hold the open one
+  if (m_open_count == m_stride) {
+    m_data.push_back(m_open_sum/double(m_stride));
+    m_lower.push_back(m_open_lower);
+    m_upper.push_back(m_open_upper);
+    m_indices.push_back(m_pushed - m_stride);
+    m_open_count = 0;
+  }
+}
+
+void Coords::CartesianRecorder::compact() {
+  const size_t n(m_data.size());
+  size_t kept(0);
+
+  switch (m_policy) {
+
+  case decimate:
+    m_stride *= 2;
+    for (size_t i = 0; i < n; ++i)
+      if (m_indices[i] % m_stride == 0) {
+	m_data[kept] = m_data[i];
+	m_indices[kept++] = m_indices[i];
+      }
+    break;
+
+  case simplify: {
+    // the median deviation from the neighbours drops about half, the
+    // loop is for the rest. A dropped sample was within m_tolerance
+    // of a segment whose ends are now within a_tolerance of a kept
+    // one, so within their sum of the kept path.
+    std::vector<double> deviations;
+    for (size_t i = 1; i + 1 < n; ++i)
+      deviations.push_back(segment(m_data[i - 1], m_data[i + 1]).distance(m_data[i]));
+    std::nth_element(deviations.begin(), deviations.begin() + deviations.size()/2, deviations.end());
+    double a_tolerance(deviations[deviations.size()/2]);
+    if (a_tolerance == 0)
+      a_tolerance = *std::max_element(deviations.begin(), deviations.end());
+    std::vector<size_t> positions(simplified(m_data, a_tolerance));
+    while (positions.size() > std::max<size_t>(2, n/2) && a_tolerance > 0) {
+      a_tolerance *= 2;
+      positions = simplified(m_data, a_tolerance);
+    }
+    for (; kept < positions.size(); ++kept) {
+      m_data[kept] = m_data[positions[kept]];
+      m_indices[kept] = m_indices[positions[kept]];
+    }
+    m_tolerance += a_tolerance;
+    break;
+  }
+
+  case bin:
+    // pairs of bins of m_stride samples, an odd last one becomes the
+    // open bin again.
+    for (size_t i = 0; i + 1 < n; i += 2, ++kept) {
+      m_data[kept] = (m_data[i] + m_data[i + 1])/2.0;
+      m_lower[kept] = lowerOf(m_lower[i], m_lower[i + 1]);
+      m_upper[kept] = upperOf(m_upper[i], m_upper[i + 1]);
+      m_indices[kept] = m_indices[i];
+    }
+    if (n % 2) {
+      if (m_open_count == 0) {
+	m_open_sum = double(m_stride)*m_data[n - 1];
+	m_open_lower = m_lower[n - 1];
+	m_open_upper = m_upper[n - 1];
+      } else {
+	m_open_sum += double(m_stride)*m_data[n - 1];
+	m_open_lower = lowerOf(m_open_lower, m_lower[n - 1]);
+	m_open_upper = upperOf(m_open_upper, m_upper[n - 1]);
+      }
+      m_open_count += m_stride;
+    }
+    m_stride *= 2;
+    m_lower.resize(kept);
+    m_upper.resize(kept);
+    break;
+
+  case keep_newest:
+    return;
+  }
+
+  m_data.resize(kept);
+  m_indices.resize(kept);
+}
+
+const double* Coords::CartesianRecorder::firstSegment(size_t& a_size) const {
+  a_size = m_data.size() - m_begin;
+  return reinterpret_cast<const double*>(m_data.data() + m_begin);
+}
+
+const double* Coords::CartesianRecorder::secondSegment(size_t& a_size) const {
+  a_size = m_begin;
+  return reinterpret_cast<const double*>(m_data.data());
+}
+
+void Coords::CartesianRecorder::linearize() {
+  std::rotate(m_data.begin(), m_data.begin() + m_begin, m_data.end());
+  m_begin = 0;
 }
 
 // output compatible for R frames <- read.table(flnm)
@@ -358,18 +625,29 @@ void Coords::CartesianRecorder::write2R(const std::string& flnm, bool skip_Uo) {
 
   ssfile << "# Formated for R frames <- read.table(" << flnm << ")"
 	 << std::endl;
-  ssfile << "x y z" << std::endl;
+  ssfile << "x y z";
+  if (m_policy == bin)
+    ssfile << " lx ly lz ux uy uz";
+  ssfile << std::endl;
 
   for (unsigned int k = 0; k < m_data.size(); ++k) {
 
-    // skip zero points from partially filled buffer.
-    if (skip_Uo and m_data[k] == Coords::Cartesian::Uo)
+    // skip zero points from partially filled buffer. The reducing
+    // policies only hold pushed samples, keep their origins.
+    const Coords::Cartesian& a(get(k));
+
+    if (skip_Uo and m_policy == keep_newest and a == Coords::Cartesian::Uo)
       continue;
 
-    ssfile << k << " "
-	   << m_data[k].x() << " "
-	   << m_data[k].y() << " "
-	   << m_data[k].z() << std::endl;
+    // reduced samples are numbered in the order pushed
+    ssfile << (m_policy == keep_newest ? k : index(k)) << " "
+	   << a.x() << " "
+	   << a.y() << " "
+	   << a.z();
+    if (m_policy == bin)
+      ssfile << " " << m_lower[k].x() << " " << m_lower[k].y() << " " << m_lower[k].z()
+	     << " " << m_upper[k].x() << " " << m_upper[k].y() << " " << m_upper[k].z();
+    ssfile << std::endl;
   }
 
   ssfile.close();
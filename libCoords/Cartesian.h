@@ -26,7 +26,6 @@
 #pragma once
 
 #include <cmath>
-#include <deque>
 #include <fstream>
 #include <vector>
 
@@ -37,6 +36,9 @@ namespace Coords {
   class angle;
   class spherical;
 
+  // Thread safety: Cartesian is a value. Const methods may be called
+  // from any number of threads, writers need their own copy.
+
   class Cartesian {
   public:
 
@@ -49,9 +51,9 @@ namespace Coords {
 
     // ----- ctor and dtor -----
 
-    explicit Cartesian(const double& a = 0.0,
-		       const double& b = 0.0,
-		       const double& c = 0.0)
+    constexpr explicit Cartesian(const double& a = 0.0,
+				 const double& b = 0.0,
+				 const double& c = 0.0)
       : m_x(a), m_y(b), m_z(c) {}; // ctors, including default.
 
     explicit Cartesian(const std::string& a, // The ambiguity is in the box.
@@ -60,46 +62,56 @@ namespace Coords {
 
     explicit Cartesian(const spherical& a);
 
-    ~Cartesian() {};
-
-    Cartesian(const Cartesian& a);
-    Cartesian& operator=(const Cartesian& rhs);
+    // implicit copy, assignment and dtor keep Cartesian trivially
+    // copyable and a literal type.
 
     // ----- accessors -----
 
-    void          x(const double& rhs) {m_x = rhs;}
-    const double& x() const            {return m_x;}
-    double        getX() const         {return m_x;} // for boost python wrappers
+    void                    x(const double& rhs) {m_x = rhs;}
+    constexpr const double& x() const            {return m_x;}
+    constexpr double        getX() const         {return m_x;} // for boost python wrappers
 
-    void          y(const double& rhs) {m_y = rhs;}
-    const double& y() const            {return m_y;}
-    double        getY() const         {return m_y;} // for boost python wrappers
+    void                    y(const double& rhs) {m_y = rhs;}
+    constexpr const double& y() const            {return m_y;}
+    constexpr double        getY() const         {return m_y;} // for boost python wrappers
 
-    void          z(const double& rhs) {m_z = rhs;}
-    const double& z() const            {return m_z;}
-    double        getZ() const         {return m_z;} // for boost python wrappers
+    void                    z(const double& rhs) {m_z = rhs;}
+    constexpr const double& z() const            {return m_z;}
+    constexpr double        getZ() const         {return m_z;} // for boost python wrappers
 
     // ----- bool operators -----
 
-    bool operator==(const Cartesian& rhs) const;
-    bool operator!=(const Cartesian& rhs) const;
+    bool operator==(const Cartesian& rhs) const {return m_x == rhs.x() && m_y == rhs.y() && m_z == rhs.z();}
+    bool operator!=(const Cartesian& rhs) const {return !operator==(rhs);}
 
     // ----- in-place operators -----
 
-    Cartesian& operator+=(const Cartesian& rhs);
-    Cartesian& operator-=(const Cartesian& rhs);
+    Cartesian& operator+=(const Cartesian& rhs) {m_x += rhs.x(); m_y += rhs.y(); m_z += rhs.z(); return *this;}
+    Cartesian& operator-=(const Cartesian& rhs) {m_x -= rhs.x(); m_y -= rhs.y(); m_z -= rhs.z(); return *this;}
 
-    Cartesian& operator*=(const double& rhs); // scale
-    Cartesian& operator/=(const double& rhs) throw (DivideByZeroError);
+    Cartesian& operator*=(const double& rhs) {m_x *= rhs; m_y *= rhs; m_z *= rhs; return *this;} // scale
+    Cartesian& operator/=(const double& rhs) throw (DivideByZeroError) {
+      if (rhs == 0)
+	throw DivideByZeroError();
+      m_x /= rhs;
+      m_y /= rhs;
+      m_z /= rhs;
+      return *this;
+    }
 
     // ----- other methods -----
 
     void zero() {x(0.0); y(0.0); z(0.0);};
 
-    double magnitude()  const;
-    double magnitude2() const;
+    double magnitude()  const {return std::sqrt(magnitude2());}
+    double magnitude2() const {return m_x*m_x + m_y*m_y + m_z*m_z;}
 
-    Cartesian normalized() const throw (DivideByZeroError);
+    Cartesian normalized() const throw (DivideByZeroError) { // throws for Uo
+      const double h(magnitude());
+      if (h == 0)
+	throw DivideByZeroError();
+      return Cartesian(m_x/h, m_y/h, m_z/h);
+    }
 
   private:
 
@@ -110,10 +122,19 @@ namespace Coords {
   };
 
 
+  // compile time unit vectors, same values as Cartesian::Uo etc.
+  constexpr Cartesian Uo(0.0, 0.0, 0.0); // zero
+  constexpr Cartesian Ux(1.0, 0.0, 0.0);
+  constexpr Cartesian Uy(0.0, 1.0, 0.0);
+  constexpr Cartesian Uz(0.0, 0.0, 1.0);
+
+
   // ---------------------
   // ----- operators -----
   // ---------------------
 
+  COORDS_BEGIN_INLINE
+
   Cartesian operator+(const Cartesian& lhs, const Cartesian& rhs);
   Cartesian operator-(const Cartesian& lhs, const Cartesian& rhs);
   Cartesian operator-(const Cartesian& rhs); // unary minus
@@ -131,6 +152,38 @@ namespace Coords {
   double dot(const Cartesian& a, const Cartesian& b);  // vector dot product
   Cartesian cross(const Cartesian& a, const Cartesian& b);  // vector cross product
 
+  COORDS_END_INLINE
+
+  // ---------------------------
+  // ----- batch operators -----
+  // ---------------------------
+
+  // Over a_size vectors packed x, y, z, i.e. the layout of
+  // Cartesian[a_size] or a C contiguous (a_size, 3) numpy array. The
+  // output may be the input array. Reentrant, they touch only their
+  // arguments.
+
+  void magnitude(const double* a_xyz, double* a_magnitude, const size_t& a_size);
+
+  // Division by zero follows IEEE, a zero vector is NaN, NaN, NaN.
+  // Cartesian::normalized() throws DivideByZeroError for it instead.
+  void normalized(const double* a_xyz, double* a_unit, const size_t& a_size);
+
+  // angle in degrees between each a and b, [0, 180].
+  void separation(const double* a_xyz, const double* b_xyz, double* a_degrees, const size_t& a_size);
+
+  // --------------------------
+  // ----- binary records -----
+  // --------------------------
+
+  // x, y, z, 24 bytes little endian, like angle2binary(). a_buffer
+  // holds a_size records.
+
+  const size_t Cartesian_binary_size(24);
+
+  void Cartesian2binary(const Cartesian* a_Cartesians, char* a_buffer, const size_t& a_size);
+  void binary2Cartesian(const char* a_buffer, Cartesian* a_Cartesians, const size_t& a_size);
+
   // -------------------------------
   // ----- output operator<<() -----
   // -------------------------------
@@ -152,25 +205,37 @@ namespace Coords {
 
   // supports rotating Cartesian vectors about Cartesian axies.
 
+  // Thread safety: the non-const rotate() caches the rotation matrix
+  // for the last angle in the rotator, so a rotator shared between
+  // threads must only use the const versions. They build the matrix
+  // on the stack and are reentrant.
+
   class rotator {
   public:
 
     rotator(const Cartesian& an_axis=Coords::Cartesian::Uz); // ctor
-    ~rotator() {}; // dtor
+
+    // implicit copy, move and dtor. All members are values so copies
+    // do not allocate.
 
     const Cartesian& axis() const {return m_axis;}
     void             axis(const Cartesian& an_axis);
 
     Cartesian rotate(const Cartesian& a_vector, const angle& an_angle);
+    Cartesian rotate(const Cartesian& a_vector, const angle& an_angle) const; // reentrant
 
-    // Boost needs this
-    rotator(const rotator& a);
-    rotator& operator=(const rotator& rhs);
+    // rotates a_size vectors packed x, y, z. a_rotated may be a_xyz. reentrant
+    void rotate(const double* a_xyz, double* a_rotated, const size_t& a_size, const angle& an_angle) const;
 
   private:
 
-    Cartesian                          m_axis;
-    std::vector< std::vector<double> > m_rotation_matrix;
+    static void rotationMatrix(const Cartesian& an_axis, const angle& an_angle, double a_matrix[3][3]);
+    static Cartesian multiply(const double a_matrix[3][3], const Cartesian& a_vector);
+
+    void updateMatrix(const angle& an_angle);
+
+    Cartesian m_axis;
+    double    m_rotation_matrix[3][3];
 
     // for optimization
     bool  m_is_new_axis;
@@ -183,9 +248,41 @@ namespace Coords {
   // ----- class CartesianRecorder -----
   // -----------------------------------
 
-  // implements a simple deque to store three Cartesian data.  It is
+  // implements a ring buffer to store three Cartesian data.  It is
   // intended to store and later plot positions and other three
-  // Cartesian data.
+  // Cartesian data. Not thread safe, lock around push() if it is
+  // shared.
+  //
+  // The samples are stored packed x, y, z, oldest first from
+  // firstSegment() then secondSegment(), which is empty until the
+  // ring wraps. linearize() rotates them in place so firstSegment()
+  // holds all of them, e.g. to pass to the batch functions or numpy
+  // with out copying.
+  //
+  // By default a full recorder keeps the newest samples. reduction()
+  // instead keeps the shape of the whole run in the size limit,
+  // reducing the samples as they are pushed, in O(1) amortized time
+  // a push:
+  //
+  //   decimate keeps every stride()th sample. When full it drops
+  //   every other sample kept and doubles the stride.
+  //
+  //   simplify keeps the corners of the trajectory. A sample is
+  //   dropped while every sample since the last kept one is within
+  //   tolerance() of the segment from it to the newest, which is
+  //   always kept. When full it simplifies the kept samples again,
+  //   about halving them, and tolerance() grows to bound the
+  //   distance of every sample pushed from the kept path.
+  //
+  //   bin keeps the mean of each stride() samples, with their lower
+  //   and upper bounds per component. When full it merges pairs of
+  //   bins and doubles the stride. The newest samples are in an open
+  //   bin until it has stride() of them.
+  //
+  // The reduced samples are always linear, and index() is the
+  // number of each sample, or of the first of its bin, in the order
+  // pushed, for plotting against time. The Uo a new recorder starts
+  // with have no index.
 
   class CartesianRecorderIOError : public Error {
   public:
@@ -197,7 +294,9 @@ namespace Coords {
 
   public:
 
-    static const unsigned int default_size; /// default size limit for deque
+    static const unsigned int default_size; /// default size limit for the ring
+
+    enum policy {keep_newest, decimate, simplify, bin};
 
     CartesianRecorder(const unsigned int& a_size_limit=CartesianRecorder::default_size);
     ~CartesianRecorder() {}; // dtor
@@ -206,23 +305,91 @@ namespace Coords {
     CartesianRecorder& operator=(const CartesianRecorder& a); // copy assignment
 
     const unsigned int& sizeLimit() const       {return m_size_limit;}
-    void                sizeLimit(const int& a) {m_size_limit = a;}
+    void                sizeLimit(const int& a);
 
     unsigned long size() const            {return m_data.size();}
-    const Cartesian& get(const unsigned int& idx) {return m_data[idx];}
+    const Cartesian& get(const unsigned int& idx) const {
+      return m_data[(m_begin + idx) % m_data.size()];
+    }
 
     void push(Cartesian a);
-    void clear() {m_data.clear();}
+    void clear();
 
-    void write2R(const std::string& flnm, bool skip_Uo=true);
+    // ----- reduction -----
 
-  private:
+    // clears the recorder. a_tolerance is the first tolerance() of
+    // simplify. Throws Error for a negative tolerance or, except for
+    // keep_newest, a size limit of 1 to 3.
+    const policy& reduction() const {return m_policy;}
+    void          reduction(const policy& a_policy, const double& a_tolerance=0);
+
+    const size_t&        stride() const    {return m_stride;}
+    const double&        tolerance() const {return m_tolerance;}
+    const unsigned long& pushed() const    {return m_pushed;} // samples since clear()
+
+    unsigned long index(const unsigned int& idx) const {
+      return m_policy == keep_newest ? m_pushed + idx - m_data.size() : m_indices[idx];
+    }
 
-    unsigned int       m_size_limit; /// size limit of position deque
+    // the bounds of bin idx, throws Error for the other policies
+    const Cartesian& lower(const unsigned int& idx) const;
+    const Cartesian& upper(const unsigned int& idx) const;
 
-    std::deque<Cartesian>  m_data;       /// data deque
+    // ----- packed x, y, z access -----
 
+    const double* firstSegment(size_t& a_size) const;
+    const double* secondSegment(size_t& a_size) const;
+
+    bool isLinear() const {return m_begin == 0;}
+    void linearize();
+
+    // skip_Uo drops the unfilled Uo of keep_newest only
+    void write2R(const std::string& flnm, bool skip_Uo=true);
+
+  private:
+
+    // the samples simplify dropped since the last kept, the samples
+    // from m_begin to m_end are within m_radius of the segment
+    // between them.
+    struct capsule {
+      Cartesian m_begin;
+      Cartesian m_end;
+      double    m_radius;
+    };
+
+    static bool   fits(const std::vector<capsule>& some_capsules, const Cartesian& a_point,
+		       const Cartesian& a_begin, const Cartesian& an_end, const double& a_tolerance);
+    static void   addToWindow(std::vector<capsule>& some_capsules, const Cartesian& a_point);
+    static std::vector<size_t> simplified(const std::vector<Cartesian>& some_points, const double& a_tolerance);
+
+    void compact(); // about halves the reduced samples
+
+    void pushDecimated(const Cartesian& a);
+    void pushSimplified(const Cartesian& a);
+    void pushBinned(const Cartesian& a);
+
+    unsigned int           m_size_limit; /// size limit of the ring
+    std::vector<Cartesian> m_data;       /// ring storage
+    size_t                 m_begin;      /// index of the oldest sample
+
+    policy                     m_policy;
+    unsigned long              m_pushed;
+    std::vector<unsigned long> m_indices;   /// of the reduced samples
+    size_t                     m_stride;
+    double                     m_first_tolerance;
+    double                     m_tolerance;
+    std::vector<capsule>       m_window;    /// simplify, since the last kept sample
+    std::vector<Cartesian>     m_lower;     /// bin bounds
+    std::vector<Cartesian>     m_upper;
+    Cartesian                  m_open_sum;  /// the open bin
+    Cartesian                  m_open_lower;
+    Cartesian                  m_open_upper;
+    size_t                     m_open_count;
 
   };
 
 } // end namespace Coords
+
+#if COORDS_INLINE
+#include <Cartesian_inl.h>
+#endif
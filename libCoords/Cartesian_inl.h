@@ -0,0 +1,111 @@
+// ================================================================
+// Filename:    Cartesian_inl.h
+//
+// Description: The Cartesian arithmetic operators and vector products.
+//              Included by Cartesian.cpp for libCoords and by
+//              Cartesian.h when built with -D COORDS_INLINE.
+//
+// Author:      L.R. McFarland
+// Created:     2026 Oct 18
+// Language:    C++
+//
+//  Coords is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  Coords is distributed in the hope that it will be useful, but
+//  WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with Coords.  If not, see <http://www.gnu.org/licenses/>.
+// ================================================================
+
+#pragma once
+
+#include <Cartesian.h>
+#include <utils.h>
+
+// ---------------------
+// ----- operators -----
+// ---------------------
+
+COORDS_INLINE_SPEC
+Coords::Cartesian Coords::operator+(const Coords::Cartesian& lhs,
+				    const Coords::Cartesian& rhs) {
+  return Coords::Cartesian(lhs.x() + rhs.x(),
+			   lhs.y() + rhs.y(),
+			   lhs.z() + rhs.z());
+}
+
+COORDS_INLINE_SPEC
+Coords::Cartesian Coords::operator-(const Coords::Cartesian& lhs,
+				    const Coords::Cartesian& rhs) {
+  return Coords::Cartesian(lhs.x() - rhs.x(),
+			   lhs.y() - rhs.y(),
+			   lhs.z() - rhs.z());
+}
+
+COORDS_INLINE_SPEC
+Coords::Cartesian Coords::operator-(const Coords::Cartesian& rhs) {
+  return Coords::Cartesian(-rhs.x(),
+			   -rhs.y(),
+			   -rhs.z());
+}
+
+// scale
+COORDS_INLINE_SPEC
+Coords::Cartesian Coords::operator*(const Coords::Cartesian& lhs,
+				    const double& rhs) {
+  return Coords::Cartesian(lhs.x() * rhs, lhs.y() * rhs, lhs.z() * rhs);
+}
+
+COORDS_INLINE_SPEC
+Coords::Cartesian Coords::operator*(const double& lhs,
+				    const Coords::Cartesian& rhs) {
+  return Coords::operator*(rhs, lhs);
+}
+
+COORDS_INLINE_SPEC
+Coords::Cartesian Coords::operator/(const Coords::Cartesian& lhs,
+				    const double& rhs)
+  throw (DivideByZeroError) {
+  if (rhs == 0)
+    throw DivideByZeroError();
+  return Coords::Cartesian(lhs.x() / rhs, lhs.y() / rhs, lhs.z() / rhs);
+}
+
+COORDS_INLINE_SPEC
+Coords::Cartesian Coords::operator/(const double& lhs,
+				    const Coords::Cartesian& rhs)
+  throw (DivideByZeroError) {
+  if (rhs.x() == 0 || rhs.y() == 0 || rhs.z() == 0)
+    throw DivideByZeroError();
+  return Coords::Cartesian(lhs / rhs.x(), lhs / rhs.y(), lhs / rhs.z());
+}
+
+// ----- vector products -----
+
+COORDS_INLINE_SPEC
+double Coords::operator*(const Coords::Cartesian& lhs,
+			 const Coords::Cartesian& rhs) {
+  return lhs.x()*rhs.x() + lhs.y()*rhs.y() + lhs.z()*rhs.z();
+}
+
+COORDS_INLINE_SPEC
+double Coords::dot(const Coords::Cartesian& lhs,
+		   const Coords::Cartesian& rhs) {
+  return lhs * rhs;
+}
+
+COORDS_INLINE_SPEC
+Coords::Cartesian Coords::cross(const Coords::Cartesian& a,
+				const Coords::Cartesian& b) {
+  Coords::Cartesian tmp;
+  tmp.x(a.y()*b.z() - a.z()*b.y());
+  tmp.y(a.z()*b.x() - a.x()*b.z());
+  tmp.z(a.x()*b.y() - a.y()*b.x());
+  return tmp;
+}
@@ -26,9 +26,17 @@
 //  along with Coordinates.  If not, see <http://www.gnu.org/licenses/>.
 // ================================================================
 
+#include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
 #include <random>
 #include <sstream>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -36,9 +44,10 @@
 #include <Cartesian.h>
 #include <spherical.h>
 
+#include <allocation_counter.h>
+
 
 // TODO Rotation: more arbitrary rotations, copy and assign operators
-// TODO CartesianRecorder
 
 
 namespace {
@@ -79,6 +88,31 @@ namespace {
     EXPECT_EQ(Coords::Cartesian::Uz, Coords::Cartesian(0, 0, 1));
   }
 
+  TEST(FixedCartesian, ConstexprUnitVectors) {
+    static_assert(Coords::Ux.x() == 1 && Coords::Ux.y() == 0 && Coords::Ux.z() == 0, "Ux");
+    static_assert(Coords::Uz.getZ() == 1, "Uz");
+
+    EXPECT_EQ(Coords::Cartesian::Uo, Coords::Uo);
+    EXPECT_EQ(Coords::Cartesian::Ux, Coords::Ux);
+    EXPECT_EQ(Coords::Cartesian::Uy, Coords::Uy);
+    EXPECT_EQ(Coords::Cartesian::Uz, Coords::Uz);
+  }
+
+  TEST(FixedCartesian, ConstexprTable) {
+    constexpr Coords::Cartesian table[] = {Coords::Ux, Coords::Uy, Coords::Uz, Coords::Cartesian(1, 2, 3)};
+    static_assert(table[3].y() == 2, "table");
+    EXPECT_EQ(Coords::Cartesian(1, 2, 3), table[3]);
+  }
+
+  TEST(FixedCartesian, TriviallyCopyable) {
+    static_assert(std::is_trivially_copyable<Coords::Cartesian>::value, "memcpy");
+    static_assert(std::is_literal_type<Coords::Cartesian>::value, "constexpr");
+    std::vector<Coords::Cartesian> a(3, Coords::Ux);
+    a.push_back(Coords::Uz); // grow
+    EXPECT_EQ(Coords::Ux, a[2]);
+    EXPECT_EQ(Coords::Uz, a[3]);
+  }
+
   TEST(FixedCartesian, Equivalence) {
     EXPECT_TRUE(Coords::Cartesian(1, 2, 3) == Coords::Cartesian(1.0, 2.0, 3.0));
 
@@ -627,6 +661,63 @@ namespace {
     EXPECT_EQ(result, a);
   }
 
+  // ----- batch operators -----
+
+  TEST_F(RandomCartesian, BatchMagnitudeNormalized) {
+    std::vector<Coords::Cartesian> points = {p1, p2, -p1, Coords::Cartesian::Ux};
+    std::vector<double> magnitudes(points.size());
+    std::vector<Coords::Cartesian> units(points.size());
+
+    Coords::magnitude(&points[0].x(), &magnitudes[0], points.size());
+    Coords::normalized(&points[0].x(), const_cast<double*>(&units[0].x()), points.size());
+
+    for (size_t i = 0; i < points.size(); ++i) {
+      EXPECT_DOUBLE_EQ(points[i].magnitude(), magnitudes[i]);
+      EXPECT_EQ(points[i].normalized(), units[i]);
+    }
+
+    Coords::normalized(&points[0].x(), const_cast<double*>(&points[0].x()), points.size()); // in place
+    EXPECT_EQ(units, points);
+  }
+
+  TEST(FixedCartesian, NormalizedZero) {
+    const double zero[] = {0, 0, 0,  0, 3, 4};
+    double units[6];
+    Coords::normalized(zero, units, 2);
+    for (size_t i = 0; i < 3; ++i)
+      EXPECT_TRUE(std::isnan(units[i])) << i;
+    EXPECT_EQ(Coords::Cartesian(0, 0.6, 0.8), Coords::Cartesian(units[3], units[4], units[5]));
+    EXPECT_THROW(Coords::Cartesian::Uo.normalized(), Coords::DivideByZeroError);
+  }
+
+  TEST(FixedCartesian, BatchSeparation) {
+    const double a[] = {1, 0, 0,  1, 0, 0,  2, 0, 0,  1, 1, 0};
+    const double b[] = {0, 1, 0,  -1, 0, 0,  3, 0, 0,  1, 0, 0};
+    double degrees[4];
+    Coords::separation(a, b, degrees, 4);
+    EXPECT_DOUBLE_EQ(90, degrees[0]);
+    EXPECT_DOUBLE_EQ(180, degrees[1]);
+    EXPECT_DOUBLE_EQ(0, degrees[2]);
+    EXPECT_DOUBLE_EQ(45, degrees[3]);
+  }
+
+  TEST_F(RandomCartesian, BinaryRoundTrip) {
+    std::vector<Coords::Cartesian> points = {p1, p2, -p1, Coords::Cartesian::Uz};
+    std::vector<char> buffer(points.size()*Coords::Cartesian_binary_size);
+    std::vector<Coords::Cartesian> round_trip(points.size());
+
+    Coords::Cartesian2binary(&points[0], &buffer[0], points.size());
+    Coords::binary2Cartesian(&buffer[0], &round_trip[0], points.size());
+
+    for (size_t i = 0; i < points.size(); ++i) {
+      EXPECT_EQ(points[i].x(), round_trip[i].x()); // bit exact, not just ==
+      EXPECT_EQ(points[i].y(), round_trip[i].y());
+      EXPECT_EQ(points[i].z(), round_trip[i].z());
+    }
+
+    EXPECT_EQ(1.0, Coords::binary2double(&buffer[3*Coords::Cartesian_binary_size + 16])); // Uz.z
+  }
+
   // ----------------------------
   // ----- X Rotation tests -----
   // ----------------------------
@@ -858,9 +949,322 @@ namespace {
 
   }
 
+  TEST(RotationTest, BatchRotate) {
+    Coords::rotator about_axis(Coords::Cartesian(1, 2, 3));
+    Coords::angle an_angle(33);
+    std::vector<Coords::Cartesian> points = {Coords::Cartesian::Ux,
+					     Coords::Cartesian(-1, 2, 5),
+					     Coords::Cartesian(4, 0, -2)};
+    std::vector<Coords::Cartesian> rotated(points.size());
 
+    about_axis.rotate(&points[0].x(), const_cast<double*>(&rotated[0].x()), points.size(), an_angle);
 
+    for (size_t i = 0; i < points.size(); ++i)
+      EXPECT_EQ(about_axis.rotate(points[i], an_angle), rotated[i]);
 
+    about_axis.rotate(&points[0].x(), const_cast<double*>(&points[0].x()), points.size(), an_angle); // in place
+    EXPECT_EQ(rotated, points);
+  }
+
+  TEST(RotationTest, CopyAndMove) {
+    Coords::rotator about_z(Coords::Cartesian::Uz);
+    about_z.rotate(Coords::Cartesian::Ux, Coords::angle(90)); // cache the matrix
+
+    Coords::rotator a_copy(about_z);
+    Coords::rotator about_x(Coords::Cartesian::Ux);
+    about_x = about_z;
+    Coords::rotator moved(std::move(a_copy));
+
+    EXPECT_EQ(Coords::Cartesian::Uz, about_x.axis());
+    EXPECT_EQ(Coords::Cartesian::Uz, moved.axis());
+
+    Coords::Cartesian expected(about_z.rotate(Coords::Cartesian::Ux, Coords::angle(90)));
+    EXPECT_EQ(expected, about_x.rotate(Coords::Cartesian::Ux, Coords::angle(90)));
+    EXPECT_EQ(expected, moved.rotate(Coords::Cartesian::Ux, Coords::angle(90)));
+  }
+
+  TEST(RotationTest, DoesNotAllocate) {
+    Coords::rotator about_axis(Coords::Cartesian(1, 1, 1));
+    Coords::Cartesian a_point(Coords::Cartesian::Ux);
+
+    const size_t before(Coords::allocationCount());
+
+    for (int i = 0; i < 360; ++i) {
+      a_point = about_axis.rotate(a_point, Coords::angle(1)); // cached matrix
+      Coords::rotator a_copy(about_axis);
+      a_copy.axis(Coords::Cartesian::Uz);
+      a_point += a_copy.rotate(Coords::Cartesian::Ux, Coords::angle(i)); // new matrix
+      about_axis = a_copy;
+      about_axis.axis(Coords::Cartesian(1, 1, 1));
+    }
+
+    EXPECT_EQ(before, Coords::allocationCount());
+  }
+
+  TEST(RotationTest, ConstRotate) {
+    Coords::rotator about_axis(Coords::Cartesian(1, 1, 1));
+    const Coords::rotator& a_const(about_axis);
+    Coords::Cartesian a_point(1, 2, 3);
+
+    for (int i = 0; i < 360; i += 15)
+      EXPECT_EQ(about_axis.rotate(a_point, Coords::angle(i)),
+		a_const.rotate(a_point, Coords::angle(i)));
+  }
+
+  TEST(RotationTest, ConcurrentConstRotate) {
+    // one rotator shared by several threads through the const rotates.
+    const Coords::rotator about_axis(Coords::Cartesian(1, 1, 1));
+    const std::vector<Coords::Cartesian> points(256, Coords::Cartesian(1, 2, 3));
+
+    const size_t n_threads(4);
+    std::vector<std::vector<Coords::Cartesian> > results(n_threads, points);
+    std::vector<std::thread> threads;
+
+    for (size_t t = 0; t < n_threads; ++t)
+      threads.push_back(std::thread([&, t]() {
+	    for (int i = 0; i < 100; ++i) {
+	      about_axis.rotate(&points[0].x(), const_cast<double*>(&results[t][0].x()),
+				points.size(), Coords::angle(double(t + 1)));
+	      results[t].back() = about_axis.rotate(points.back(), Coords::angle(double(t + 1)));
+	    }
+	  }));
+
+    for (size_t t = 0; t < n_threads; ++t)
+      threads[t].join();
+
+    for (size_t t = 0; t < n_threads; ++t) {
+      Coords::Cartesian expected(about_axis.rotate(points[0], Coords::angle(double(t + 1))));
+      for (size_t i = 0; i < points.size(); ++i)
+	EXPECT_EQ(expected, results[t][i]);
+    }
+  }
+
+  // -----------------------------
+  // ----- CartesianRecorder -----
+  // -----------------------------
+
+  TEST(CartesianRecorder, StartsFullOfUo) {
+    Coords::CartesianRecorder a_recorder(4);
+    EXPECT_EQ(4u, a_recorder.size());
+    EXPECT_EQ(Coords::Cartesian::Uo, a_recorder.get(3));
+    EXPECT_TRUE(a_recorder.isLinear());
+  }
+
+  TEST(CartesianRecorder, PushWraps) {
+    Coords::CartesianRecorder a_recorder(4);
+    a_recorder.clear();
+    for (int i = 1; i <= 6; ++i)
+      a_recorder.push(Coords::Cartesian(i, 10*i, 100*i));
+
+    EXPECT_EQ(4u, a_recorder.size());
+    EXPECT_EQ(Coords::Cartesian(3, 30, 300), a_recorder.get(0));
+    EXPECT_EQ(Coords::Cartesian(6, 60, 600), a_recorder.get(3));
+    EXPECT_FALSE(a_recorder.isLinear());
+
+    size_t first_size(0);
+    size_t second_size(0);
+    const double* first(a_recorder.firstSegment(first_size));
+    const double* second(a_recorder.secondSegment(second_size));
+    EXPECT_EQ(2u, first_size);
+    EXPECT_EQ(2u, second_size);
+    EXPECT_EQ(3, first[0]);
+    EXPECT_EQ(400, first[5]);
+    EXPECT_EQ(5, second[0]);
+    EXPECT_EQ(600, second[5]);
+  }
+
+  TEST(CartesianRecorder, Linearize) {
+    Coords::CartesianRecorder a_recorder(4);
+    a_recorder.clear();
+    for (int i = 1; i <= 6; ++i)
+      a_recorder.push(Coords::Cartesian(i, 10*i, 100*i));
+    a_recorder.linearize();
+
+    EXPECT_TRUE(a_recorder.isLinear());
+    size_t a_size(0);
+    const double* xyz(a_recorder.firstSegment(a_size));
+    EXPECT_EQ(4u, a_size);
+    for (size_t i = 0; i < a_size; ++i) {
+      EXPECT_EQ(Coords::Cartesian(xyz[3*i], xyz[3*i+1], xyz[3*i+2]), a_recorder.get(i));
+      EXPECT_EQ(double(i + 3), xyz[3*i]);
+    }
+    a_recorder.secondSegment(a_size);
+    EXPECT_EQ(0u, a_size);
+  }
+
+  TEST(CartesianRecorder, SizeLimitKeepsNewest) {
+    Coords::CartesianRecorder a_recorder(4);
+    a_recorder.clear();
+    for (int i = 1; i <= 6; ++i)
+      a_recorder.push(Coords::Cartesian(i, 0, 0));
+
+    a_recorder.sizeLimit(2);
+    EXPECT_EQ(2u, a_recorder.size());
+    EXPECT_EQ(Coords::Cartesian(5, 0, 0), a_recorder.get(0));
+    a_recorder.push(Coords::Cartesian(7, 0, 0));
+    EXPECT_EQ(Coords::Cartesian(6, 0, 0), a_recorder.get(0));
+    EXPECT_EQ(Coords::Cartesian(7, 0, 0), a_recorder.get(1));
+
+    a_recorder.sizeLimit(3);
+    a_recorder.push(Coords::Cartesian(8, 0, 0));
+    EXPECT_EQ(3u, a_recorder.size());
+    EXPECT_EQ(Coords::Cartesian(6, 0, 0), a_recorder.get(0));
+    EXPECT_EQ(Coords::Cartesian(8, 0, 0), a_recorder.get(2));
+  }
+
+  TEST(CartesianRecorder, Copy) {
+    Coords::CartesianRecorder a_recorder(3);
+    for (int i = 1; i <= 5; ++i)
+      a_recorder.push(Coords::Cartesian(i, 0, 0));
+
+    Coords::CartesianRecorder b_recorder(a_recorder);
+    Coords::CartesianRecorder c_recorder;
+    c_recorder = a_recorder;
+    for (size_t i = 0; i < a_recorder.size(); ++i) {
+      EXPECT_EQ(a_recorder.get(i), b_recorder.get(i));
+      EXPECT_EQ(a_recorder.get(i), c_recorder.get(i));
+    }
+    EXPECT_EQ(3u, c_recorder.sizeLimit());
+  }
+
+  TEST(CartesianRecorder, Decimate) {
+    Coords::CartesianRecorder a_recorder(8);
+    a_recorder.reduction(Coords::CartesianRecorder::decimate);
+    EXPECT_EQ(0u, a_recorder.size());
+    for (int i = 0; i < 100; ++i)
+      a_recorder.push(Coords::Cartesian(i, 0, 0));
+
+    // the stride doubles each time the recorder fills
+    EXPECT_EQ(100u, a_recorder.pushed());
+    EXPECT_EQ(16u, a_recorder.stride());
+    EXPECT_EQ(7u, a_recorder.size());
+    for (size_t i = 0; i < a_recorder.size(); ++i) {
+      EXPECT_EQ(16*i, a_recorder.index(i));
+      EXPECT_EQ(Coords::Cartesian(16*i, 0, 0), a_recorder.get(i));
+    }
+    EXPECT_TRUE(a_recorder.isLinear());
+
+    Coords::CartesianRecorder b_recorder(a_recorder);
+    b_recorder.sizeLimit(4);
+    EXPECT_EQ(32u, b_recorder.stride());
+    EXPECT_EQ(4u, b_recorder.size());
+    EXPECT_EQ(96u, b_recorder.index(3));
+    EXPECT_EQ(7u, a_recorder.size());
+
+    a_recorder.clear();
+    EXPECT_EQ(1u, a_recorder.stride());
+    EXPECT_EQ(Coords::CartesianRecorder::decimate, a_recorder.reduction());
+  }
+
+  TEST(CartesianRecorder, SimplifyKeepsCorners) {
+    Coords::CartesianRecorder a_recorder(0);
+    a_recorder.reduction(Coords::CartesianRecorder::simplify, 1e-9);
+    const Coords::Cartesian corners[] = {Coords::Cartesian(0, 0, 0), Coords::Cartesian(1, 0, 0),
+					 Coords::Cartesian(1, 1, 0), Coords::Cartesian(0, 1, 1)};
+    for (int i = 0; i <= 60; ++i) {
+      const Coords::Cartesian& a(corners[i/20]);
+      const Coords::Cartesian& b(corners[std::min(3, i/20 + 1)]);
+      a_recorder.push(a + (i % 20)/20.0*(b - a));
+    }
+    ASSERT_EQ(4u, a_recorder.size());
+    for (size_t i = 0; i < 4; ++i) {
+      EXPECT_EQ(20*i, a_recorder.index(i));
+      EXPECT_NEAR(0, (corners[i] - a_recorder.get(i)).magnitude(), 1e-15);
+    }
+  }
+
+  TEST(CartesianRecorder, SimplifyBoundsTheError) {
+    Coords::CartesianRecorder a_recorder(64);
+    a_recorder.reduction(Coords::CartesianRecorder::simplify);
+    std::vector<Coords::Cartesian> samples;
+    for (int i = 0; i < 100000; ++i) {
+      // a precessing ellipse with a little noise
+      const double t(i*1e-3);
+      samples.push_back(Coords::Cartesian(std::cos(t), 0.5*std::sin(t), 0.1*std::sin(0.01*t)) +
+			Coords::Cartesian(1e-4*std::sin(7919.0*i), 0, 0));
+      a_recorder.push(samples.back());
+      ASSERT_LE(a_recorder.size(), 64u);
+    }
+    EXPECT_GT(a_recorder.tolerance(), 0);
+    EXPECT_EQ(0u, a_recorder.index(0));
+    EXPECT_EQ(samples.back(), a_recorder.get(a_recorder.size() - 1));
+
+    // every sample is within tolerance() of its segment of the kept path
+    for (size_t k = 0; k + 1 < a_recorder.size(); ++k) {
+      const Coords::Cartesian a(a_recorder.get(k)), d(a_recorder.get(k + 1) - a);
+      for (size_t i = a_recorder.index(k); i <= a_recorder.index(k + 1); ++i) {
+	const Coords::Cartesian r(samples[i] - a);
+	const double t(std::min(1.0, std::max(0.0, Coords::dot(r, d)/d.magnitude2())));
+	ASSERT_LE((r - t*d).magnitude(), a_recorder.tolerance()*(1 + 1e-12)) << i;
+      }
+    }
+  }
+
+  TEST(CartesianRecorder, Bin) {
+    for (unsigned int a_limit : {6u, 5u}) {
+      Coords::CartesianRecorder a_recorder(a_limit);
+      a_recorder.reduction(Coords::CartesianRecorder::bin);
+      for (int i = 0; i < 1000; ++i)
+	a_recorder.push(Coords::Cartesian(i, -2*i, i % 3));
+
+      ASSERT_LE(a_recorder.size(), a_limit);
+      const size_t stride(a_recorder.stride());
+      EXPECT_EQ(1000/stride, a_recorder.size()) << a_limit; // the rest are open
+      for (size_t k = 0; k < a_recorder.size(); ++k) {
+	const double first(k*stride), last(first + stride - 1);
+	EXPECT_EQ(k*stride, a_recorder.index(k));
+	EXPECT_DOUBLE_EQ((first + last)/2, a_recorder.get(k).x());
+	EXPECT_DOUBLE_EQ(-(first + last), a_recorder.get(k).y());
+	EXPECT_NEAR(1, a_recorder.get(k).z(), 1.0/stride);
+	EXPECT_EQ(Coords::Cartesian(first, -2*last, 0), a_recorder.lower(k));
+	EXPECT_EQ(Coords::Cartesian(last, -2*first, 2), a_recorder.upper(k));
+      }
+    }
+  }
+
+  // the data lines write2R() wrote
+  std::vector<std::string> write2R(Coords::CartesianRecorder& a_recorder, bool skip_Uo) {
+    const std::string flnm("CartesianRecorder_write2R.txt");
+    a_recorder.write2R(flnm, skip_Uo);
+    std::ifstream ssfile(flnm.c_str());
+    std::vector<std::string> lines;
+    std::string a_line;
+    std::getline(ssfile, a_line); // comment
+    std::getline(ssfile, a_line); // header
+    while (std::getline(ssfile, a_line))
+      lines.push_back(a_line);
+    std::remove(flnm.c_str());
+    return lines;
+  }
+
+  TEST(CartesianRecorder, Write2R) {
+    // keep_newest skips the Uo it started with
+    Coords::CartesianRecorder a_recorder(4);
+    a_recorder.push(Coords::Cartesian(1, 2, 3));
+    std::vector<std::string> lines(write2R(a_recorder, true));
+    ASSERT_EQ(1u, lines.size());
+    EXPECT_EQ("3 1 2 3", lines[0]);
+    EXPECT_EQ(4u, write2R(a_recorder, false).size());
+
+    // a reduced orbit through the origin keeps it
+    a_recorder.reduction(Coords::CartesianRecorder::decimate);
+    for (int i = 0; i < 6; ++i)
+      a_recorder.push(Coords::Cartesian(i - 2, 0, 0));
+    lines = write2R(a_recorder, true);
+    ASSERT_EQ(3u, lines.size());
+    EXPECT_EQ("2 0 0 0", lines[1]);
+  }
+
+  TEST(CartesianRecorder, ReductionErrors) {
+    Coords::CartesianRecorder a_recorder(3);
+    EXPECT_THROW(a_recorder.reduction(Coords::CartesianRecorder::bin), Coords::Error);
+    EXPECT_THROW(a_recorder.lower(0), Coords::Error);
+    a_recorder.sizeLimit(4);
+    EXPECT_THROW(a_recorder.reduction(Coords::CartesianRecorder::simplify, -1), Coords::Error);
+    a_recorder.reduction(Coords::CartesianRecorder::simplify, 1);
+    EXPECT_THROW(a_recorder.sizeLimit(2), Coords::Error);
+    EXPECT_EQ(4u, a_recorder.sizeLimit());
+  }
 
 } // end anonymous namespace
 
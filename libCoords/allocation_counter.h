@@ -0,0 +1,54 @@
+// ================================================================
+// Filename:    allocation_counter.h
+//
+// Description: Replaces global operator new and delete to count heap
+//              allocations in the unittests. Include it in only one
+//              file per test executable.
+//
+// Author:      L.R. McFarland
+// Created:     2026 Oct 18
+// Language:    C++
+//
+//  Coords is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  Coords is distributed in the hope that it will be useful, but
+//  WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with Coords.  If not, see <http://www.gnu.org/licenses/>.
+// ================================================================
+
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace Coords {
+
+  // number of calls to operator new since the start of the program.
+  inline size_t& allocationCount() {
+    static size_t count(0);
+    return count;
+  }
+
+} // end namespace Coords
+
+// operator new[] and delete[] call these.
+
+void* operator new(size_t a_size) {
+  ++Coords::allocationCount();
+  void* p(malloc(a_size == 0 ? 1 : a_size));
+  if (p == 0)
+    throw std::bad_alloc();
+  return p;
+}
+
+void operator delete(void* p) noexcept {
+  free(p);
+}
@@ -21,7 +21,10 @@
 //  along with Coordinates. If not, see <http://www.gnu.org/licenses/>.
 // ==================================================================
 
+#include <cmath>
+
 #include <angle.h>
+#include <angle_inl.h>
 #include <utils.h>
 
 // =================
@@ -30,12 +33,6 @@
 
 // ----- constructors -----
 
-Coords::angle::angle(const double& a_deg,
-		     const double& a_min,
-		     const double& a_sec) {
-  value(degrees2seconds(a_deg, a_min, a_sec)/3600.0);
-}
-
 Coords::angle::angle(const std::string& a_deg,
 		     const std::string& a_min,
 		     const std::string& a_sec) {
@@ -47,104 +44,56 @@ Coords::angle::angle(const std::string& a_deg,
 }
 
 
-// copy constructor
-Coords::angle::angle(const Coords::angle& a) {
-  m_value = a.value();
-}
-
-// copy assignment
-Coords::angle& Coords::angle::operator=(const Coords::angle& rhs) {
-  if (this == &rhs) return *this;
-  m_value = rhs.value();
-  return *this;
-}
-
-// ----- bool operators -----
-
-bool Coords::angle::operator== (const Coords::angle& rhs) const {
-  return m_value == rhs.value();
-}
-
-bool Coords::angle::operator!= (const Coords::angle& rhs) const {
-  return !operator==(rhs);
-}
-
-bool Coords::angle::operator< (const Coords::angle& rhs) const {
-  return m_value < rhs.value();
-}
-
-bool Coords::angle::operator<= (const Coords::angle& rhs) const {
-  return m_value <= rhs.value();
-}
-
-bool Coords::angle::operator> (const Coords::angle& rhs) const {
-  return m_value > rhs.value();
-}
-
-bool Coords::angle::operator>= (const Coords::angle& rhs) const {
-  return m_value >= rhs.value();
-}
-
-// ----- in-place operators -----
-
-Coords::angle& Coords::angle::operator+=(const Coords::angle& rhs) {
-  m_value += rhs.value();
-  return *this;
-}
+// -------------------------
+// ----- other methods -----
+// -------------------------
 
-Coords::angle& Coords::angle::operator-=(const Coords::angle& rhs) {
-  m_value -= rhs.value();
-  return *this;
+void Coords::angle::normalize(const double& begin, const double& end) {
+  // from http://stackoverflow.com/questions/1628386/normalise-orientation-between-0-and-360
+  const double width(end - begin);
+  const double offset(m_value - begin);
+  m_value = (offset - (floor(offset/width) * width)) + begin;
 }
 
-Coords::angle& Coords::angle::operator*=(const Coords::angle& rhs) {
-  m_value *= rhs.value();
-  return *this;
-}
+// ---------------------------
+// ----- batch normalize -----
+// ---------------------------
 
-Coords::angle& Coords::angle::operator/=(const Coords::angle& rhs) throw (DivideByZeroError) {
-  if (rhs.value() == 0)
-    throw DivideByZeroError();
-  m_value /= rhs.value();
-  return *this;
+void Coords::normalize(double* a_values,
+		       const size_t& a_size,
+		       const double& begin,
+		       const double& end) {
+  // local copies, begin and end could alias a_values.
+  const double l_begin(begin);
+  const double width(end - begin);
+  for (size_t i = 0; i < a_size; ++i) {
+    const double offset(a_values[i] - l_begin);
+    a_values[i] = (offset - (Coords::branchlessFloor(offset/width) * width)) + l_begin;
+  }
 }
 
-// ---------------------
-// ----- operators -----
-// ---------------------
-
-Coords::angle Coords::operator+(const Coords::angle& lhs, const Coords::angle& rhs) {
-  return Coords::angle(lhs.value() + rhs.value());
+void Coords::normalize360(double* a_values, const size_t& a_size) {
+  Coords::normalize(a_values, a_size, 0.0, 360.0);
 }
 
-Coords::angle Coords::operator-(const Coords::angle& lhs, const Coords::angle& rhs) {
-  return Coords::angle(lhs.value() - rhs.value());
+void Coords::normalize180(double* a_values, const size_t& a_size) {
+  Coords::normalize(a_values, a_size, -180.0, 180.0);
 }
 
-Coords::angle Coords::operator-(const Coords::angle& rhs) {
-  return Coords::angle(-rhs.value());
+void Coords::normalize24(double* a_values, const size_t& a_size) {
+  Coords::normalize(a_values, a_size, 0.0, 24.0);
 }
 
-Coords::angle Coords::operator*(const Coords::angle& lhs, const Coords::angle& rhs) {
-  return Coords::angle(lhs.value() * rhs.value());
-}
+// ----- binary records -----
 
-Coords::angle Coords::operator/(const Coords::angle& lhs, const Coords::angle& rhs)
-  throw (DivideByZeroError) {
-  if (rhs.value() == 0)
-    throw DivideByZeroError();
-  return Coords::angle(lhs.value() / rhs.value());
+void Coords::angle2binary(const angle* a_angles, char* a_buffer, const size_t& a_size) {
+  for (size_t i = 0; i < a_size; ++i)
+    Coords::double2binary(a_angles[i].value(), a_buffer + i*angle_binary_size);
 }
 
-// -------------------------
-// ----- other methods -----
-// -------------------------
-
-void Coords::angle::normalize(const double& begin, const double& end) {
-  // from http://stackoverflow.com/questions/1628386/normalise-orientation-between-0-and-360
-  const double width(end - begin);
-  const double offset(m_value - begin);
-  m_value = (offset - (floor(offset/width) * width)) + begin;
+void Coords::binary2angle(const char* a_buffer, angle* a_angles, const size_t& a_size) {
+  for (size_t i = 0; i < a_size; ++i)
+    a_angles[i].value(Coords::binary2double(a_buffer + i*angle_binary_size));
 }
 
 // ====================
@@ -212,3 +161,77 @@ Coords::Declination::Declination(const std::string& a_deg,
   if (value() < g_south_pole)
     throw Coords::Error("minimum exceeded");
 }
+
+// =======================
+// ===== BinaryAngle =====
+// =======================
+
+const double Coords::BinaryAngle::s_counts_per_turn(4294967296.0);
+const double Coords::BinaryAngle::s_degrees_per_count(360.0/4294967296.0);
+
+namespace {
+
+  // fraction of a turn in [0, 1) to the nearest count. A fraction
+  // that rounds up to a full turn wraps to zero. NaN and infinity
+  // have no fraction of a turn and are zero, the cast would be
+  // undefined.
+  inline uint32_t degrees2counts(const double& a_deg) {
+    if (!std::isfinite(a_deg))
+      return 0;
+    const double turns(a_deg/360.0);
+    const double fraction(turns - Coords::branchlessFloor(turns));
+    const double counts(Coords::branchlessFloor(fraction * Coords::BinaryAngle::s_counts_per_turn + 0.5));
+    return static_cast<uint32_t>(static_cast<uint64_t>(counts));
+  }
+
+}
+
+Coords::BinaryAngle Coords::BinaryAngle::fromDegrees(const double& a_deg) {
+  return Coords::BinaryAngle(degrees2counts(a_deg));
+}
+
+Coords::BinaryAngle::BinaryAngle(const Coords::angle& an_angle)
+  : m_counts(degrees2counts(an_angle.value())) {}
+
+double Coords::BinaryAngle::degrees() const {
+  return m_counts * s_degrees_per_count;
+}
+
+double Coords::BinaryAngle::signedDegrees() const {
+  return static_cast<int32_t>(m_counts) * s_degrees_per_count;
+}
+
+// ----- operators -----
+
+Coords::BinaryAngle Coords::operator+(const Coords::BinaryAngle& lhs, const Coords::BinaryAngle& rhs) {
+  Coords::BinaryAngle sum(lhs);
+  return sum += rhs;
+}
+
+Coords::BinaryAngle Coords::operator-(const Coords::BinaryAngle& lhs, const Coords::BinaryAngle& rhs) {
+  Coords::BinaryAngle difference(lhs);
+  return difference -= rhs;
+}
+
+Coords::BinaryAngle Coords::operator-(const Coords::BinaryAngle& rhs) {
+  return Coords::BinaryAngle(0u - rhs.counts());
+}
+
+// ----- batch conversions -----
+
+void Coords::degrees2BinaryAngle(const double* a_degrees, uint32_t* a_counts, const size_t& a_size) {
+  for (size_t i = 0; i < a_size; ++i)
+    a_counts[i] = degrees2counts(a_degrees[i]);
+}
+
+void Coords::BinaryAngle2degrees(const uint32_t* a_counts, double* a_degrees, const size_t& a_size) {
+  const double scale(Coords::BinaryAngle::s_degrees_per_count);
+  for (size_t i = 0; i < a_size; ++i)
+    a_degrees[i] = a_counts[i] * scale;
+}
+
+void Coords::BinaryAngle2signedDegrees(const uint32_t* a_counts, double* a_degrees, const size_t& a_size) {
+  const double scale(Coords::BinaryAngle::s_degrees_per_count);
+  for (size_t i = 0; i < a_size; ++i)
+    a_degrees[i] = static_cast<int32_t>(a_counts[i]) * scale;
+}
@@ -26,6 +26,8 @@
 #pragma once
 
 #include <cmath>
+#include <cstddef>
+#include <stdint.h>
 
 #include <utils.h>
 
@@ -38,67 +40,75 @@ namespace Coords {
   // ===== angle =====
   // =================
 
+  // Thread safety: angle and its subclasses are values. Const methods
+  // may be called from any number of threads, writers need their own
+  // copy.
+
   class angle {
     // base class for latitude, longitude, declination and right ascension
 
   public:
 
     // angle unit convertors
-    static double deg2rad(const double& deg) {return deg*M_PI/180.0;}
-    static double rad2deg(const double& rad) {return rad*180.0/M_PI;}
+    static constexpr double deg2rad(const double& deg) {return deg*M_PI/180.0;}
+    static constexpr double rad2deg(const double& rad) {return rad*180.0/M_PI;}
 
     // ----- ctor and dtor -----
 
-    explicit angle(const double& a_deg = 0.0,
-		   const double& a_min = 0.0,
-		   const double& a_sec = 0.0);
+    constexpr explicit angle(const double& a_deg = 0.0,
+			     const double& a_min = 0.0,
+			     const double& a_sec = 0.0)
+      : m_value(sexagesimal2seconds(a_deg, a_min, a_sec)/3600.0) {}
 
     explicit angle(const std::string& a_deg, // The ambiguity is in the box.
 		   const std::string& a_min = "0",
 		   const std::string& a_sec = "0");
 
-    virtual ~angle() {};
-
-    angle(const angle& a);
-    angle& operator=(const angle& rhs);
+    // implicit copy, assignment and dtor keep angle trivially
+    // copyable and a literal type.
 
     // ----- accessors -----
-    void          value(const double& a_value) {m_value = a_value;}
-    const double& value() const                {return m_value;}
+    void                    value(const double& a_value) {m_value = a_value;}
+    constexpr const double& value() const                {return m_value;}
 
-    void          setValue(const double& a_value) {m_value = a_value;}
-    double        getValue() const                {return m_value;} // for boost
+    void                    setValue(const double& a_value) {m_value = a_value;}
+    constexpr double        getValue() const                {return m_value;} // for boost
 
-    void          radians(const double& a_value) {value(rad2deg(a_value));}
-    double        radians() const                {return deg2rad(value());}
+    void                    radians(const double& a_value) {value(rad2deg(a_value));}
+    constexpr double        radians() const                {return deg2rad(value());}
 
-    void          setRadians(const double& a_value) {value(rad2deg(a_value));}
-    double        getRadians() const                {return deg2rad(value());} // for boost
+    void                    setRadians(const double& a_value) {value(rad2deg(a_value));}
+    constexpr double        getRadians() const                {return deg2rad(value());} // for boost
 
     // ----- boolean operators -----
 
-    bool operator== (const angle& rhs) const;
-    bool operator!= (const angle& rhs) const;
+    bool operator== (const angle& rhs) const {return m_value == rhs.value();}
+    bool operator!= (const angle& rhs) const {return !operator==(rhs);}
 
-    bool operator< (const angle& rhs) const;
-    bool operator<= (const angle& rhs) const;
+    bool operator< (const angle& rhs) const  {return m_value < rhs.value();}
+    bool operator<= (const angle& rhs) const {return m_value <= rhs.value();}
 
-    bool operator> (const angle& rhs) const;
-    bool operator>= (const angle& rhs) const;
+    bool operator> (const angle& rhs) const  {return m_value > rhs.value();}
+    bool operator>= (const angle& rhs) const {return m_value >= rhs.value();}
 
     // ----- in-place operators -----
 
-    angle& operator+=(const angle& rhs);
-    angle& operator-=(const angle& rhs);
+    angle& operator+=(const angle& rhs) {m_value += rhs.value(); return *this;}
+    angle& operator-=(const angle& rhs) {m_value -= rhs.value(); return *this;}
 
-    angle& operator*=(const angle& rhs);
-    angle& operator/=(const angle& rhs) throw (DivideByZeroError);
+    angle& operator*=(const angle& rhs) {m_value *= rhs.value(); return *this;}
+    angle& operator/=(const angle& rhs) throw (DivideByZeroError) {
+      if (rhs.value() == 0)
+	throw DivideByZeroError();
+      m_value /= rhs.value();
+      return *this;
+    }
 
 
     // ----- other methods -----
     void normalize(const double& begin=0.0, const double& end=360);  // TODO normalized -> return a new copy?
 
-    angle complement() const {return angle(90 - value());}
+    constexpr angle complement() const {return angle(90 - value());}
 
   private:
 
@@ -111,6 +121,8 @@ namespace Coords {
   // ----- operators -----
   // ---------------------
 
+  COORDS_BEGIN_INLINE
+
   angle operator+ (const angle& lhs, const angle& rhs);
   angle operator- (const angle& lhs, const angle& rhs);
   angle operator- (const angle& rhs); // unary minus
@@ -118,6 +130,41 @@ namespace Coords {
   angle operator* (const angle& lhs, const angle& rhs);
   angle operator/ (const angle& lhs, const angle& rhs) throw (DivideByZeroError);
 
+  COORDS_END_INLINE
+
+
+  // ---------------------------
+  // ----- batch normalize -----
+  // ---------------------------
+
+  // In-place versions of angle::normalize() over arrays of values,
+  // e.g. azimuths, hour angles or longitudes. Same arithmetic as
+  // angle::normalize() but without the floor() call so the loop
+  // vectorizes.
+
+  void normalize(double* a_values,
+		 const size_t& a_size,
+		 const double& begin=0.0,
+		 const double& end=360.0);
+
+  void normalize360(double* a_values, const size_t& a_size); // [0, 360)
+  void normalize180(double* a_values, const size_t& a_size); // [-180, 180)
+  void normalize24(double* a_values, const size_t& a_size);  // [0, 24) hours
+
+  // --------------------------
+  // ----- binary records -----
+  // --------------------------
+
+  // Fixed layout records for files and IPC, e.g. pickle or
+  // multiprocessing, instead of parsing operator<<() output. An angle
+  // is its value in degrees (seconds for right ascension), 8 bytes
+  // little endian. a_buffer holds a_size records.
+
+  const size_t angle_binary_size(8);
+
+  void angle2binary(const angle* a_angles, char* a_buffer, const size_t& a_size);
+  void binary2angle(const char* a_buffer, angle* a_angles, const size_t& a_size);
+
 
   // -------------------------------
   // ----- output operator<<() -----
@@ -151,8 +198,6 @@ namespace Coords {
 		      const std::string& a_min = "0.0",
 		      const std::string& a_sec = "0.0");
 
-    virtual ~Latitude() {};
-
   };
 
 
@@ -179,10 +224,75 @@ namespace Coords {
 			 const std::string& a_min = "0.0",
 			 const std::string& a_sec = "0.0");
 
-    virtual ~Declination() {};
+  };
+
+
+  // -----------------------
+  // ----- BinaryAngle -----
+  // -----------------------
+
+  // Binary angle measurement (BAM). The full circle is 2^32 counts so
+  // unsigned overflow wraps the angle for free and sums and
+  // differences are exact, i.e. repeatable on replay. A value, same
+  // thread safety as angle. NaN and infinite degrees convert to zero
+  // counts.
+
+  class BinaryAngle {
+
+  public:
+
+    static const double s_counts_per_turn; // 2^32
+    static const double s_degrees_per_count; // 360/2^32, exact
+
+    static BinaryAngle fromDegrees(const double& a_deg);
+
+    // ----- ctor and dtor -----
+
+    explicit BinaryAngle(const uint32_t& a_counts = 0) : m_counts(a_counts) {};
+    explicit BinaryAngle(const angle& an_angle);
+
+    // implicit copy, move and dtor keep BinaryAngle trivially
+    // copyable.
+
+    // ----- accessors -----
+
+    void            counts(const uint32_t& a_counts) {m_counts = a_counts;}
+    const uint32_t& counts() const                  {return m_counts;}
+
+    double degrees() const;       // [0, 360)
+    double signedDegrees() const; // [-180, 180)
+
+    angle toAngle() const {return angle(degrees());}
+
+    // ----- boolean operators -----
+
+    bool operator== (const BinaryAngle& rhs) const {return m_counts == rhs.counts();}
+    bool operator!= (const BinaryAngle& rhs) const {return m_counts != rhs.counts();}
+
+    // ----- in-place operators -----
+
+    BinaryAngle& operator+=(const BinaryAngle& rhs) {m_counts += rhs.counts(); return *this;}
+    BinaryAngle& operator-=(const BinaryAngle& rhs) {m_counts -= rhs.counts(); return *this;}
+
+  private:
+
+    uint32_t m_counts;
 
   };
 
+  BinaryAngle operator+ (const BinaryAngle& lhs, const BinaryAngle& rhs);
+  BinaryAngle operator- (const BinaryAngle& lhs, const BinaryAngle& rhs);
+  BinaryAngle operator- (const BinaryAngle& rhs); // unary minus
+
+  // batch conversions
+  void degrees2BinaryAngle(const double* a_degrees, uint32_t* a_counts, const size_t& a_size);
+  void BinaryAngle2degrees(const uint32_t* a_counts, double* a_degrees, const size_t& a_size);
+  void BinaryAngle2signedDegrees(const uint32_t* a_counts, double* a_degrees, const size_t& a_size);
+
 
 
 } // end namespace Coords
+
+#if COORDS_INLINE
+#include <angle_inl.h>
+#endif
@@ -0,0 +1,61 @@
+// ================================================================
+// Filename:    angle_inl.h
+//
+// Description: The angle arithmetic operators, not members. Included
+//              by angle.cpp for libCoords and by angle.h when
+//              built with -D COORDS_INLINE.
+//
+// Author:      L.R. McFarland
+// Created:     2026 Oct 18
+// Language:    C++
+//
+//  Coords is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  Coords is distributed in the hope that it will be useful, but
+//  WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with Coords.  If not, see <http://www.gnu.org/licenses/>.
+// ================================================================
+
+#pragma once
+
+#include <angle.h>
+#include <utils.h>
+
+// ---------------------
+// ----- operators -----
+// ---------------------
+
+COORDS_INLINE_SPEC
+Coords::angle Coords::operator+(const Coords::angle& lhs, const Coords::angle& rhs) {
+  return Coords::angle(lhs.value() + rhs.value());
+}
+
+COORDS_INLINE_SPEC
+Coords::angle Coords::operator-(const Coords::angle& lhs, const Coords::angle& rhs) {
+  return Coords::angle(lhs.value() - rhs.value());
+}
+
+COORDS_INLINE_SPEC
+Coords::angle Coords::operator-(const Coords::angle& rhs) {
+  return Coords::angle(-rhs.value());
+}
+
+COORDS_INLINE_SPEC
+Coords::angle Coords::operator*(const Coords::angle& lhs, const Coords::angle& rhs) {
+  return Coords::angle(lhs.value() * rhs.value());
+}
+
+COORDS_INLINE_SPEC
+Coords::angle Coords::operator/(const Coords::angle& lhs, const Coords::angle& rhs)
+  throw (DivideByZeroError) {
+  if (rhs.value() == 0)
+    throw DivideByZeroError();
+  return Coords::angle(lhs.value() / rhs.value());
+}
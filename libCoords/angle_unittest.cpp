@@ -20,7 +20,12 @@
 //  along with Coordinates.  If not, see <http://www.gnu.org/licenses/>.
 // ================================================================
 
+#include <cstring>
+#include <limits>
+#include <random>
+#include <type_traits>
 #include <sstream>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -61,6 +66,17 @@ namespace {
     EXPECT_TRUE(a == b);
   }
 
+  TEST(angle, Constexpr) {
+    static_assert(std::is_trivially_copyable<Coords::angle>::value, "memcpy");
+    static_assert(std::is_trivially_copyable<Coords::Latitude>::value, "memcpy");
+    constexpr Coords::angle a(-10, 30);
+    static_assert(a.value() == -10.5, "sign from degrees");
+    static_assert(Coords::angle(0, -10, 30).value() == -10.5/60, "sign from minutes");
+    static_assert(a.complement().value() == 100.5, "complement");
+    EXPECT_EQ(Coords::angle(-10, 30).value(), a.value());
+    EXPECT_EQ(Coords::degrees2seconds(0, -10, 30), Coords::sexagesimal2seconds(0, -10, 30));
+  }
+
   TEST(angle, DefaultConstructor) {
     Coords::angle a;
     EXPECT_EQ(0, a.radians());
@@ -413,6 +429,201 @@ namespace {
     EXPECT_NEAR(45, a.value(), 1e-15);
   }
 
+  // ---------------------------
+  // ----- batch normalize -----
+  // ---------------------------
+
+  TEST(angle, BranchlessFloor) {
+    const double values[] = {0.0, -0.0, 0.5, -0.5, 1.0, -1.0, 2.5, -2.5,
+			     1e15 + 0.5, -1e15 - 0.5, 4503599627370496.0, -1e300, 1e300};
+    for (unsigned int i = 0; i < sizeof(values)/sizeof(double); ++i)
+      EXPECT_EQ(floor(values[i]), Coords::branchlessFloor(values[i]));
+  }
+
+  TEST(angle, BatchNormalizeMatchesScalar) {
+
+    std::mt19937 generator(26);
+    std::uniform_real_distribution<double> distribution(-10000.0, 10000.0);
+
+    std::vector<double> values(1001);
+    for (unsigned int i = 0; i < values.size(); ++i)
+      values[i] = distribution(generator);
+    values[0] = -360;
+    values[1] = 360;
+    values[2] = 180;
+
+    std::vector<double> b360(values);
+    std::vector<double> b180(values);
+    std::vector<double> b24(values);
+
+    Coords::normalize360(&b360[0], b360.size());
+    Coords::normalize180(&b180[0], b180.size());
+    Coords::normalize24(&b24[0], b24.size());
+
+    for (unsigned int i = 0; i < values.size(); ++i) {
+
+      Coords::angle a360;
+      a360.value(values[i]);
+      a360.normalize(0, 360);
+      EXPECT_EQ(a360.value(), b360[i]);
+      EXPECT_TRUE(b360[i] >= 0 && b360[i] < 360);
+
+      Coords::angle a180;
+      a180.value(values[i]);
+      a180.normalize(-180, 180);
+      EXPECT_EQ(a180.value(), b180[i]);
+      EXPECT_TRUE(b180[i] >= -180 && b180[i] < 180);
+
+      Coords::angle a24;
+      a24.value(values[i]);
+      a24.normalize(0, 24);
+      EXPECT_EQ(a24.value(), b24[i]);
+      EXPECT_TRUE(b24[i] >= 0 && b24[i] < 24);
+
+    }
+
+  }
+
+  TEST(angle, BatchNormalizeEmpty) {
+    Coords::normalize360(NULL, 0); // does not touch the array
+  }
+
+  // -----------------------
+  // ----- BinaryAngle -----
+  // -----------------------
+
+  TEST(BinaryAngle, FromDegrees) {
+    EXPECT_EQ(0u, Coords::BinaryAngle::fromDegrees(0).counts());
+    EXPECT_EQ(0x40000000u, Coords::BinaryAngle::fromDegrees(90).counts());
+    EXPECT_EQ(0x80000000u, Coords::BinaryAngle::fromDegrees(180).counts());
+    EXPECT_EQ(0xC0000000u, Coords::BinaryAngle::fromDegrees(-90).counts());
+    EXPECT_EQ(0u, Coords::BinaryAngle::fromDegrees(360).counts());
+    EXPECT_EQ(0x40000000u, Coords::BinaryAngle::fromDegrees(90 + 3*360).counts());
+  }
+
+  TEST(BinaryAngle, NonFinite) {
+    static_assert(std::is_trivially_copyable<Coords::BinaryAngle>::value, "memcpy");
+    const double inf(std::numeric_limits<double>::infinity());
+    const double degrees[] = {std::numeric_limits<double>::quiet_NaN(), inf, -inf, 90};
+    uint32_t counts[4];
+    Coords::degrees2BinaryAngle(degrees, counts, 4);
+    for (size_t i = 0; i < 3; ++i) {
+      EXPECT_EQ(0u, Coords::BinaryAngle::fromDegrees(degrees[i]).counts());
+      EXPECT_EQ(0u, Coords::BinaryAngle(Coords::angle(degrees[i])).counts());
+      EXPECT_EQ(0u, counts[i]);
+    }
+    EXPECT_EQ(0x40000000u, counts[3]);
+  }
+
+  TEST(BinaryAngle, FromAngle) {
+    Coords::BinaryAngle a(Coords::angle(-45));
+    EXPECT_EQ(Coords::BinaryAngle::fromDegrees(315), a);
+    EXPECT_DOUBLE_EQ(315, a.toAngle().value());
+  }
+
+  TEST(BinaryAngle, RoundsUpToFullTurn) {
+    // less than half a count below 360 wraps to zero
+    EXPECT_EQ(0u, Coords::BinaryAngle::fromDegrees(360 - 1e-9).counts());
+  }
+
+  TEST(BinaryAngle, Degrees) {
+    EXPECT_EQ(270, Coords::BinaryAngle(0xC0000000u).degrees());
+    EXPECT_EQ(-90, Coords::BinaryAngle(0xC0000000u).signedDegrees());
+    EXPECT_EQ(-180, Coords::BinaryAngle(0x80000000u).signedDegrees());
+    EXPECT_EQ(180, Coords::BinaryAngle(0x80000000u).degrees());
+  }
+
+  TEST(BinaryAngle, ExactRoundTrip) {
+    // every count is exactly representable in degrees
+    const uint32_t counts[] = {0u, 1u, 12345u, 0x7FFFFFFFu, 0x80000001u, 0xFFFFFFFFu};
+    for (unsigned int i = 0; i < sizeof(counts)/sizeof(uint32_t); ++i) {
+      Coords::BinaryAngle a(counts[i]);
+      EXPECT_EQ(a, Coords::BinaryAngle::fromDegrees(a.degrees()));
+      EXPECT_EQ(a, Coords::BinaryAngle::fromDegrees(a.signedDegrees()));
+    }
+  }
+
+  TEST(BinaryAngle, WrapsOnOverflow) {
+    Coords::BinaryAngle a(Coords::BinaryAngle::fromDegrees(270));
+    a += Coords::BinaryAngle::fromDegrees(180);
+    EXPECT_EQ(Coords::BinaryAngle::fromDegrees(90), a);
+    a -= Coords::BinaryAngle::fromDegrees(180);
+    EXPECT_EQ(Coords::BinaryAngle::fromDegrees(270), a);
+  }
+
+  TEST(BinaryAngle, Operators) {
+    Coords::BinaryAngle a(Coords::BinaryAngle::fromDegrees(350));
+    Coords::BinaryAngle b(Coords::BinaryAngle::fromDegrees(20));
+    EXPECT_EQ(Coords::BinaryAngle::fromDegrees(10), a + b);
+    EXPECT_EQ(Coords::BinaryAngle::fromDegrees(330), a - b);
+    EXPECT_EQ(Coords::BinaryAngle::fromDegrees(10), -a);
+    EXPECT_TRUE(a != b);
+  }
+
+  TEST(BinaryAngle, ExactSumIsOrderIndependent) {
+    // deterministic replay: integer sums do not depend on order
+    std::vector<Coords::BinaryAngle> steps;
+    for (unsigned int i = 0; i < 100; ++i)
+      steps.push_back(Coords::BinaryAngle::fromDegrees(0.1 * i + 33.3));
+    Coords::BinaryAngle forward;
+    Coords::BinaryAngle backward;
+    for (unsigned int i = 0; i < steps.size(); ++i) {
+      forward += steps[i];
+      backward += steps[steps.size() - 1 - i];
+    }
+    EXPECT_EQ(forward, backward);
+  }
+
+  TEST(BinaryAngle, BatchConversions) {
+    const double degrees[] = {0, 45, -45, 359.5, 720.25, -180};
+    const size_t n(sizeof(degrees)/sizeof(double));
+
+    uint32_t counts[n];
+    double unsigned_degrees[n];
+    double signed_degrees[n];
+
+    Coords::degrees2BinaryAngle(degrees, counts, n);
+    Coords::BinaryAngle2degrees(counts, unsigned_degrees, n);
+    Coords::BinaryAngle2signedDegrees(counts, signed_degrees, n);
+
+    for (size_t i = 0; i < n; ++i) {
+      Coords::BinaryAngle a(Coords::BinaryAngle::fromDegrees(degrees[i]));
+      EXPECT_EQ(a.counts(), counts[i]);
+      EXPECT_EQ(a.degrees(), unsigned_degrees[i]);
+      EXPECT_EQ(a.signedDegrees(), signed_degrees[i]);
+    }
+
+    EXPECT_DOUBLE_EQ(315, unsigned_degrees[2]);
+    EXPECT_DOUBLE_EQ(-45, signed_degrees[2]);
+    EXPECT_NEAR(0.25, unsigned_degrees[4], Coords::BinaryAngle::s_degrees_per_count);
+  }
+
+  // --------------------------
+  // ----- binary records -----
+  // --------------------------
+
+  TEST(angle, BinaryLayout) {
+    // 1.0 is 0x3FF0000000000000, little endian
+    const Coords::angle an_angle(1.0);
+    char a_record[Coords::angle_binary_size];
+    Coords::angle2binary(&an_angle, a_record, 1);
+    const char expected[] = {0, 0, 0, 0, 0, 0, '\xf0', '\x3f'};
+    EXPECT_EQ(0, memcmp(expected, a_record, sizeof(expected)));
+  }
+
+  TEST(angle, BinaryRoundTrip) {
+    std::vector<Coords::angle> angles = {Coords::angle(0.1), Coords::angle(-0.0),
+					 Coords::angle(-45, 30, 15.5), Coords::angle(359.99999999)};
+    std::vector<char> buffer(angles.size()*Coords::angle_binary_size);
+    std::vector<Coords::angle> round_trip(angles.size());
+
+    Coords::angle2binary(&angles[0], &buffer[0], angles.size());
+    Coords::binary2angle(&buffer[0], &round_trip[0], angles.size());
+
+    for (size_t i = 0; i < angles.size(); ++i)
+      EXPECT_EQ(0, memcmp(&angles[i], &round_trip[i], sizeof(Coords::angle))); // bit exact, keeps -0.0
+  }
+
   // ----------------------
   // ----- complement -----
   // ----------------------
@@ -463,6 +674,73 @@ namespace {
     EXPECT_TRUE(Coords::degrees2seconds(-45, 59, 60) == Coords::degrees2seconds(-45, -59, -60));
   }
 
+  // the nested if version of degrees2seconds() the branchless one replaced.
+  double nestedDegrees2seconds(const double& a_deg, const double& a_min, const double& a_sec) {
+    const double _min(fabs(a_min));
+    const double _sec(fabs(a_sec));
+    if (a_deg > 0)
+      return 3600*a_deg + 60*_min + _sec;
+    if (a_deg < 0)
+      return 3600*a_deg - 60*_min - _sec;
+    if (a_min > 0)
+      return 60*a_min + _sec;
+    if (a_min < 0)
+      return 60*a_min - _sec;
+    return a_sec;
+  }
+
+  TEST(Utils, Degree2SecondsSignConvention) {
+    EXPECT_EQ(-630, Coords::degrees2seconds(0, -10, 30));
+    EXPECT_EQ(630, Coords::degrees2seconds(0, 10, -30));
+    EXPECT_EQ(-30, Coords::degrees2seconds(0, 0, -30));
+    EXPECT_EQ(-3630, Coords::degrees2seconds(-1, 0, 30));
+    EXPECT_EQ(3630, Coords::degrees2seconds(1, -0, -30));
+    EXPECT_TRUE(std::signbit(Coords::degrees2seconds(0, 0, -0.0)));
+    EXPECT_FALSE(std::signbit(Coords::degrees2seconds(0, 0, 0)));
+  }
+
+  TEST(Utils, Degree2SecondsMatchesNested) {
+    const double values[] = {-45, -1.5, -1, -0.0, 0, 0.25, 1, 30, 59.999};
+    const unsigned int n(sizeof(values)/sizeof(double));
+    for (unsigned int i = 0; i < n; ++i)
+      for (unsigned int j = 0; j < n; ++j)
+	for (unsigned int k = 0; k < n; ++k) {
+	  const double expected(nestedDegrees2seconds(values[i], values[j], values[k]));
+	  const double actual(Coords::degrees2seconds(values[i], values[j], values[k]));
+	  EXPECT_EQ(expected, actual);
+	  EXPECT_EQ(std::signbit(expected), std::signbit(actual));
+	}
+  }
+
+  TEST(Utils, BatchDegree2Seconds) {
+
+    std::mt19937 generator(27);
+    std::uniform_real_distribution<double> distribution(-90.0, 90.0);
+    std::uniform_int_distribution<int> zero(0, 3);
+
+    const size_t n(1003);
+    std::vector<double> deg(n), min(n), sec(n);
+
+    for (size_t i = 0; i < n; ++i) {
+      // plenty of zeros to move the sign to minutes and seconds.
+      deg[i] = zero(generator) ? floor(distribution(generator)) : 0;
+      min[i] = zero(generator) ? floor(distribution(generator)/1.5) : 0;
+      sec[i] = distribution(generator)/1.5;
+    }
+
+    std::vector<double> seconds(n);
+    std::vector<double> decimal(n);
+
+    Coords::degrees2seconds(&deg[0], &min[0], &sec[0], &seconds[0], n);
+    Coords::sexagesimal2decimal(&deg[0], &min[0], &sec[0], &decimal[0], n);
+
+    for (size_t i = 0; i < n; ++i) {
+      EXPECT_EQ(nestedDegrees2seconds(deg[i], min[i], sec[i]), seconds[i]);
+      EXPECT_EQ(Coords::angle(deg[i], min[i], sec[i]).value(), decimal[i]);
+    }
+
+  }
+
 
   // opeartor<<()
 
@@ -0,0 +1,474 @@
+// ==================================================================
+// Filename:    attitude.cpp
+//
+// Description: Implements quaternions and the rigid body attitude
+//              integrators.
+//
+// Author:      L.R. McFarland
+// Created:     2026 Oct 18
+// Language:    C++
+//
+//  Coordinates is free software: you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License as
+//  published by the Free Software Foundation, either version 3 of the
+//  License, or (at your option) any later version.
+//
+//  Coordinates is distributed in the hope that it will be useful, but
+//  WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with Coordinates.  If not, see <http://www.gnu.org/licenses/>.
+// ==================================================================
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <attitude.h>
+#include <utils.h>
+
+namespace {
+
+  const double s_weight[4] = {1, 2, 2, 1};
+  const double s_offset[4] = {0, 0.5, 0.5, 1}; // RK4 stage time as a fraction of dt
+
+  // dq/dt = q (0, w)/2 and dw/dt = (t - w x Iw)/I, principal axes
+  inline void derivative(const double& qw, const double& qx, const double& qy, const double& qz,
+			 const double& wx, const double& wy, const double& wz,
+			 const double& ix, const double& iy, const double& iz,
+			 const double& tx, const double& ty, const double& tz,
+			 double a_derivative[7]) {
+    a_derivative[0] = -0.5*(qx*wx + qy*wy + qz*wz);
+    a_derivative[1] = 0.5*(qw*wx + qy*wz - qz*wy);
+    a_derivative[2] = 0.5*(qw*wy + qz*wx - qx*wz);
+    a_derivative[3] = 0.5*(qw*wz + qx*wy - qy*wx);
+    a_derivative[4] = (tx - (iz - iy)*wy*wz)/ix;
+    a_derivative[5] = (ty - (ix - iz)*wz*wx)/iy;
+    a_derivative[6] = (tz - (iy - ix)*wx*wy)/iz;
+  }
+
+  // scales q to unit length
+  inline void unitLength(double& qw, double& qx, double& qy, double& qz) {
+    const double scale(1/std::sqrt(qw*qw + qx*qx + qy*qy + qz*qz));
+    qw *= scale;
+    qx *= scale;
+    qy *= scale;
+    qz *= scale;
+  }
+
+  // of a unit quaternion
+  void rotationMatrix(const double& qw, const double& qx, const double& qy, const double& qz,
+		      double a_matrix[3][3]) {
+    a_matrix[0][0] = 1 - 2*(qy*qy + qz*qz);
+    a_matrix[0][1] = 2*(qx*qy - qw*qz);
+    a_matrix[0][2] = 2*(qx*qz + qw*qy);
+    a_matrix[1][0] = 2*(qx*qy + qw*qz);
+    a_matrix[1][1] = 1 - 2*(qx*qx + qz*qz);
+    a_matrix[1][2] = 2*(qy*qz - qw*qx);
+    a_matrix[2][0] = 2*(qx*qz - qw*qy);
+    a_matrix[2][1] = 2*(qy*qz + qw*qx);
+    a_matrix[2][2] = 1 - 2*(qx*qx + qy*qy);
+  }
+
+  // a_size vectors, a_rotated may be a_xyz
+  void multiply(const double a_matrix[3][3], const double* a_xyz, double* a_rotated, const size_t& a_size) {
+    // local copies so the loop does not reload them through a_rotated.
+    const double m00(a_matrix[0][0]), m01(a_matrix[0][1]), m02(a_matrix[0][2]);
+    const double m10(a_matrix[1][0]), m11(a_matrix[1][1]), m12(a_matrix[1][2]);
+    const double m20(a_matrix[2][0]), m21(a_matrix[2][1]), m22(a_matrix[2][2]);
+    for (size_t i = 0; i < a_size; ++i) {
+      const double x(a_xyz[3*i]), y(a_xyz[3*i + 1]), z(a_xyz[3*i + 2]);
+      a_rotated[3*i] = m00*x + m01*y + m02*z;
+      a_rotated[3*i + 1] = m10*x + m11*y + m12*z;
+      a_rotated[3*i + 2] = m20*x + m21*y + m22*z;
+    }
+  }
+
+} // end anonymous namespace
+
+
+// ======================
+// ===== quaternion =====
+// ======================
+
+Coords::quaternion Coords::quaternion::fromAxisAngle(const Cartesian& an_axis, const angle& an_angle) {
+  const double length(an_axis.magnitude());
+  if (length == 0)
+    throw Error("quaternion axis must not be zero");
+  const double half(an_angle.radians()/2);
+  const double s(std::sin(half)/length);
+  return quaternion(std::cos(half), s*an_axis.x(), s*an_axis.y(), s*an_axis.z());
+}
+
+Coords::quaternion Coords::quaternion::exp(const Cartesian& a_rotation) {
+  const double theta(a_rotation.magnitude());
+  if (theta == 0)
+    return quaternion();
+  const double s(std::sin(theta/2)/theta);
+  return quaternion(std::cos(theta/2), s*a_rotation.x(), s*a_rotation.y(), s*a_rotation.z());
+}
+
+Coords::Cartesian Coords::quaternion::rotation() const {
+  // -q is the same rotation, w >= 0 keeps the angle in [0, pi]
+  const double sign(m_w < 0 ? -1 : 1);
+  const double length(std::sqrt(m_x*m_x + m_y*m_y + m_z*m_z));
+  if (length == 0)
+    return Cartesian(0, 0, 0);
+  const double scale(sign*2*std::atan2(length, sign*m_w)/length);
+  return Cartesian(scale*m_x, scale*m_y, scale*m_z);
+}
+
+double Coords::quaternion::norm() const {
+  return std::sqrt(m_w*m_w + m_x*m_x + m_y*m_y + m_z*m_z);
+}
+
+Coords::quaternion Coords::quaternion::normalized() const {
+  const double length(norm());
+  if (length == 0)
+    throw Error("can not normalize a zero quaternion");
+  return quaternion(m_w/length, m_x/length, m_y/length, m_z/length);
+}
+
+Coords::quaternion Coords::quaternion::operator*(const quaternion& a) const {
+  return quaternion(m_w*a.m_w - m_x*a.m_x - m_y*a.m_y - m_z*a.m_z,
+		    m_w*a.m_x + m_x*a.m_w + m_y*a.m_z - m_z*a.m_y,
+		    m_w*a.m_y - m_x*a.m_z + m_y*a.m_w + m_z*a.m_x,
+		    m_w*a.m_z + m_x*a.m_y - m_y*a.m_x + m_z*a.m_w);
+}
+
+bool Coords::quaternion::operator==(const quaternion& a) const {
+  return m_w == a.m_w && m_x == a.m_x && m_y == a.m_y && m_z == a.m_z;
+}
+
+Coords::Cartesian Coords::quaternion::rotate(const Cartesian& a_vector) const {
+  // v + w t + u x t, t = 2 u x v, u the vector part
+  const Cartesian u(m_x, m_y, m_z);
+  const Cartesian t(2*cross(u, a_vector));
+  return a_vector + m_w*t + cross(u, t);
+}
+
+void Coords::quaternion::matrix(double a_matrix[3][3]) const {
+  rotationMatrix(m_w, m_x, m_y, m_z, a_matrix);
+}
+
+std::ostream& Coords::operator<< (std::ostream& os, const quaternion& a) {
+  os << "<quaternion>"
+     << "<w>" << a.w() << "</w>"
+     << "<x>" << a.x() << "</x>"
+     << "<y>" << a.y() << "</y>"
+     << "<z>" << a.z() << "</z>"
+     << "</quaternion>";
+  return os;
+}
+
+
+// =======================
+// ===== rigidBodies =====
+// =======================
+
+Coords::rigidBodies::rigidBodies() : m_time(0), m_threads(0) {}
+
+// ------------------
+// ----- bodies -----
+// ------------------
+
+void Coords::rigidBodies::check(const size_t& an_index) const {
+  if (an_index >= size())
+    throw Error("no rigid body at that index");
+}
+
+size_t Coords::rigidBodies::add(const quaternion& an_orientation,
+				const Cartesian& an_angular_velocity,
+				const Cartesian& some_moments) {
+  if (!(some_moments.x() > 0 && some_moments.y() > 0 && some_moments.z() > 0))
+    throw Error("moments of inertia must be positive");
+  const quaternion q(an_orientation.normalized());
+  m_qw.push_back(q.w());
+  m_qx.push_back(q.x());
+  m_qy.push_back(q.y());
+  m_qz.push_back(q.z());
+  m_wx.push_back(an_angular_velocity.x());
+  m_wy.push_back(an_angular_velocity.y());
+  m_wz.push_back(an_angular_velocity.z());
+  m_ix.push_back(some_moments.x());
+  m_iy.push_back(some_moments.y());
+  m_iz.push_back(some_moments.z());
+  m_dw.push_back(1);
+  m_dx.push_back(0);
+  m_dy.push_back(0);
+  m_dz.push_back(0);
+  m_increment_dt.push_back(std::numeric_limits<double>::quiet_NaN());
+  return size() - 1;
+}
+
+void Coords::rigidBodies::clear() {
+  m_qw.clear();
+  m_qx.clear();
+  m_qy.clear();
+  m_qz.clear();
+  m_wx.clear();
+  m_wy.clear();
+  m_wz.clear();
+  m_ix.clear();
+  m_iy.clear();
+  m_iz.clear();
+  m_dw.clear();
+  m_dx.clear();
+  m_dy.clear();
+  m_dz.clear();
+  m_increment_dt.clear();
+}
+
+Coords::quaternion Coords::rigidBodies::orientation(const size_t& an_index) const {
+  check(an_index);
+  return quaternion(m_qw[an_index], m_qx[an_index], m_qy[an_index], m_qz[an_index]);
+}
+
+void Coords::rigidBodies::orientation(const size_t& an_index, const quaternion& an_orientation) {
+  check(an_index);
+  const quaternion q(an_orientation.normalized());
+  m_qw[an_index] = q.w();
+  m_qx[an_index] = q.x();
+  m_qy[an_index] = q.y();
+  m_qz[an_index] = q.z();
+}
+
+Coords::Cartesian Coords::rigidBodies::angularVelocity(const size_t& an_index) const {
+  check(an_index);
+  return Cartesian(m_wx[an_index], m_wy[an_index], m_wz[an_index]);
+}
+
+void Coords::rigidBodies::angularVelocity(const size_t& an_index, const Cartesian& an_angular_velocity) {
+  check(an_index);
+  m_wx[an_index] = an_angular_velocity.x();
+  m_wy[an_index] = an_angular_velocity.y();
+  m_wz[an_index] = an_angular_velocity.z();
+  m_increment_dt[an_index] = std::numeric_limits<double>::quiet_NaN();
+}
+
+Coords::Cartesian Coords::rigidBodies::moments(const size_t& an_index) const {
+  check(an_index);
+  return Cartesian(m_ix[an_index], m_iy[an_index], m_iz[an_index]);
+}
+
+void Coords::rigidBodies::moments(const size_t& an_index, const Cartesian& some_moments) {
+  check(an_index);
+  if (!(some_moments.x() > 0 && some_moments.y() > 0 && some_moments.z() > 0))
+    throw Error("moments of inertia must be positive");
+  m_ix[an_index] = some_moments.x();
+  m_iy[an_index] = some_moments.y();
+  m_iz[an_index] = some_moments.z();
+  m_increment_dt[an_index] = std::numeric_limits<double>::quiet_NaN();
+}
+
+
+// -----------------------
+// ----- integration -----
+// -----------------------
+
+void Coords::rigidBodies::addTorque(const torque& a_torque) {
+  m_torques.push_back(a_torque);
+}
+
+void Coords::rigidBodies::clearTorques() {
+  m_torques.clear();
+}
+
+void Coords::rigidBodies::stepFree(const double& a_dt) {
+
+  parallelFor(size(), [&] (const size_t& a_begin, const size_t& a_end) {
+      for (size_t i = a_begin; i < a_end; ++i) {
+	const double wx(m_wx[i]), wy(m_wy[i]), wz(m_wz[i]);
+	const double ix(m_ix[i]), iy(m_iy[i]), iz(m_iz[i]);
+
+	if ((iz - iy)*wy*wz == 0 && (ix - iz)*wz*wx == 0 && (iy - ix)*wx*wy == 0) {
+
+	  // constant w, NaN never equals a_dt
+	  if (m_increment_dt[i] != a_dt) {
+	    const quaternion d(quaternion::exp(Cartesian(wx*a_dt, wy*a_dt, wz*a_dt)));
+	    m_dw[i] = d.w();
+	    m_dx[i] = d.x();
+	    m_dy[i] = d.y();
+	    m_dz[i] = d.z();
+	    m_increment_dt[i] = a_dt;
+	  }
+	  const double qw(m_qw[i]), qx(m_qx[i]), qy(m_qy[i]), qz(m_qz[i]);
+	  const double dw(m_dw[i]), dx(m_dx[i]), dy(m_dy[i]), dz(m_dz[i]);
+	  double rw(qw*dw - qx*dx - qy*dy - qz*dz);
+	  double rx(qw*dx + qx*dw + qy*dz - qz*dy);
+	  double ry(qw*dy - qx*dz + qy*dw + qz*dx);
+	  double rz(qw*dz + qx*dy - qy*dx + qz*dw);
+	  unitLength(rw, rx, ry, rz);
+	  m_qw[i] = rw;
+	  m_qx[i] = rx;
+	  m_qy[i] = ry;
+	  m_qz[i] = rz;
+	  continue;
+	}
+
+	// RK4 for this body alone
+	m_increment_dt[i] = std::numeric_limits<double>::quiet_NaN();
+	const double y0[7] = {m_qw[i], m_qx[i], m_qy[i], m_qz[i], wx, wy, wz};
+	double y[7], sum[7] = {0, 0, 0, 0, 0, 0, 0}, k[7];
+	for (int j = 0; j < 7; ++j)
+	  y[j] = y0[j];
+	for (int stage = 0; stage < 4; ++stage) {
+	  derivative(y[0], y[1], y[2], y[3], y[4], y[5], y[6], ix, iy, iz, 0, 0, 0, k);
+	  const double c(stage < 3 ? s_offset[stage + 1]*a_dt : 0);
+	  for (int j = 0; j < 7; ++j) {
+	    sum[j] += s_weight[stage]*k[j];
+	    y[j] = y0[j] + c*k[j];
+	  }
+	}
+	for (int j = 0; j < 7; ++j)
+	  y[j] = y0[j] + a_dt/6*sum[j];
+	unitLength(y[0], y[1], y[2], y[3]);
+	m_qw[i] = y[0];
+	m_qx[i] = y[1];
+	m_qy[i] = y[2];
+	m_qz[i] = y[3];
+	m_wx[i] = y[4];
+	m_wy[i] = y[5];
+	m_wz[i] = y[6];
+      }
+    }, m_threads);
+
+}
+
+void Coords::rigidBodies::stepRK4(const double& a_dt) {
+
+  // As ParticleSystem::stepRK4(). The stage state is in the first
+  // seven arrays of the scratch, the weighted sums of its
+  // derivatives in the next seven.
+
+  const size_t n(size());
+  m_scratch.resize(14*n);
+  double* stage[7];
+  double* sum[7];
+  for (int j = 0; j < 7; ++j) {
+    stage[j] = &m_scratch[j*n];
+    sum[j] = &m_scratch[(7 + j)*n];
+  }
+  double* const current[7] = {m_qw.data(), m_qx.data(), m_qy.data(), m_qz.data(),
+			      m_wx.data(), m_wy.data(), m_wz.data()};
+  m_tx.resize(n);
+  m_ty.resize(n);
+  m_tz.resize(n);
+
+  for (size_t k = 0; k < 4; ++k) {
+
+    double* const* y(k == 0 ? current : stage);
+    const state a_state = {y[0], y[1], y[2], y[3], y[4], y[5], y[6],
+			   m_ix.data(), m_iy.data(), m_iz.data(), n, m_time + s_offset[k]*a_dt};
+
+    std::fill(m_tx.begin(), m_tx.end(), 0);
+    std::fill(m_ty.begin(), m_ty.end(), 0);
+    std::fill(m_tz.begin(), m_tz.end(), 0);
+    for (size_t f = 0; f < m_torques.size(); ++f)
+      m_torques[f](a_state, m_tx.data(), m_ty.data(), m_tz.data());
+
+    // the next stage starts from the current state, so it can
+    // overwrite this one element by element.
+    const double w(s_weight[k]);
+    const double c(k < 3 ? s_offset[k + 1]*a_dt : 0);
+    parallelFor(n, [&] (const size_t& a_begin, const size_t& a_end) {
+	for (size_t i = a_begin; i < a_end; ++i) {
+	  double d[7];
+	  derivative(y[0][i], y[1][i], y[2][i], y[3][i], y[4][i], y[5][i], y[6][i],
+		     m_ix[i], m_iy[i], m_iz[i], m_tx[i], m_ty[i], m_tz[i], d);
+	  for (int j = 0; j < 7; ++j) {
+	    sum[j][i] = k == 0 ? w*d[j] : sum[j][i] + w*d[j];
+	    stage[j][i] = current[j][i] + c*d[j];
+	  }
+	}
+      }, m_threads);
+  }
+
+  const double sixth(a_dt/6);
+  parallelFor(n, [&] (const size_t& a_begin, const size_t& a_end) {
+      for (size_t i = a_begin; i < a_end; ++i) {
+	for (int j = 0; j < 7; ++j)
+	  current[j][i] += sixth*sum[j][i];
+	unitLength(m_qw[i], m_qx[i], m_qy[i], m_qz[i]);
+	m_increment_dt[i] = std::numeric_limits<double>::quiet_NaN();
+      }
+    }, m_threads);
+}
+
+void Coords::rigidBodies::step(const double& a_dt) {
+  if (m_torques.empty())
+    stepFree(a_dt);
+  else
+    stepRK4(a_dt);
+  m_time += a_dt;
+}
+
+void Coords::rigidBodies::run(const double& a_dt, const size_t& a_steps) {
+  for (size_t k = 0; k < a_steps; ++k)
+    step(a_dt);
+}
+
+
+// ---------------------
+// ----- rotations -----
+// ---------------------
+
+void Coords::rigidBodies::matrix(const size_t& an_index, const bool& is_inverse, double a_matrix[3][3]) const {
+  const double sign(is_inverse ? -1 : 1);
+  rotationMatrix(m_qw[an_index], sign*m_qx[an_index], sign*m_qy[an_index], sign*m_qz[an_index], a_matrix);
+}
+
+void Coords::rigidBodies::toInertial(const size_t& an_index, const double* a_xyz, double* a_rotated, const size_t& a_size) const {
+  check(an_index);
+  double a_matrix[3][3];
+  matrix(an_index, false, a_matrix);
+  multiply(a_matrix, a_xyz, a_rotated, a_size);
+}
+
+void Coords::rigidBodies::toBody(const size_t& an_index, const double* a_xyz, double* a_rotated, const size_t& a_size) const {
+  check(an_index);
+  double a_matrix[3][3];
+  matrix(an_index, true, a_matrix);
+  multiply(a_matrix, a_xyz, a_rotated, a_size);
+}
+
+void Coords::rigidBodies::toInertial(const double* a_xyz, double* a_rotated) const {
+  parallelFor(size(), [&] (const size_t& a_begin, const size_t& a_end) {
+      for (size_t i = a_begin; i < a_end; ++i) {
+	double a_matrix[3][3];
+	matrix(i, false, a_matrix);
+	multiply(a_matrix, a_xyz + 3*i, a_rotated + 3*i, 1);
+      }
+    }, m_threads);
+}
+
+void Coords::rigidBodies::toBody(const double* a_xyz, double* a_rotated) const {
+  parallelFor(size(), [&] (const size_t& a_begin, const size_t& a_end) {
+      for (size_t i = a_begin; i < a_end; ++i) {
+	double a_matrix[3][3];
+	matrix(i, true, a_matrix);
+	multiply(a_matrix, a_xyz + 3*i, a_rotated + 3*i, 1);
+      }
+    }, m_threads);
+}
+
+
+// -----------------------
+// ----- diagnostics -----
+// -----------------------
+
+double Coords::rigidBodies::kineticEnergy() const {
+  double energy(0);
+  for (size_t i = 0; i < size(); ++i)
+    energy += m_ix[i]*m_wx[i]*m_wx[i] + m_iy[i]*m_wy[i]*m_wy[i] + m_iz[i]*m_wz[i]*m_wz[i];
+  return energy/2;
+}
+
+Coords::Cartesian Coords::rigidBodies::angularMomentum() const {
+  Cartesian total(0, 0, 0);
+  for (size_t i = 0; i < size(); ++i)
+    total += orientation(i).rotate(Cartesian(m_ix[i]*m_wx[i], m_iy[i]*m_wy[i], m_iz[i]*m_wz[i]));
+  return total;
+}
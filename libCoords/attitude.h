@@ -0,0 +1,245 @@
+// ================================================================
+// Filename:    attitude.h
+//
+// Description: This defines unit quaternions and a rigid body
+//              attitude integrator for many bodies.
+//
+// Author:      L.R. McFarland
+// Created:     2026 Oct 18
+// Language:    C++
+//
+//  Coords is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  Coords is distributed in the hope that it will be useful, but
+//  WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with Coords.  If not, see <http://www.gnu.org/licenses/>.
+// ================================================================
+
+#pragma once
+
+#include <functional>
+#include <ostream>
+#include <vector>
+
+#include <angle.h>
+#include <Cartesian.h>
+#include <parallel.h>
+
+namespace Coords {
+
+  // ======================
+  // ===== quaternion =====
+  // ======================
+
+  // w + xi + yj + zk. A unit quaternion q is the rotation v -> q v q*,
+  // right handed like rotator, so fromAxisAngle(an_axis, an_angle)
+  // rotates as rotator(an_axis).rotate(v, an_angle) does. q and -q
+  // are the same rotation.
+  //
+  // Thread safety: a value type, like Cartesian.
+
+  class quaternion {
+
+  public:
+
+    explicit quaternion(const double& a_w=1, const double& a_x=0, const double& a_y=0, const double& a_z=0)
+      : m_w(a_w), m_x(a_x), m_y(a_y), m_z(a_z) {} // ctor, the identity by default
+
+    // an_axis need not be unit length. Throws Error for a zero axis.
+    static quaternion fromAxisAngle(const Cartesian& an_axis, const angle& an_angle);
+
+    // the exponential map, a rotation by |a_rotation| radians about
+    // a_rotation. rotation() is its inverse for angles up to pi.
+    static quaternion exp(const Cartesian& a_rotation);
+    Cartesian         rotation() const;
+
+    // implicit copy, move and dtor.
+
+    // ----- accessors -----
+
+    const double& w() const {return m_w;}
+    const double& x() const {return m_x;}
+    const double& y() const {return m_y;}
+    const double& z() const {return m_z;}
+
+    // ----- algebra -----
+
+    double     norm() const;
+    quaternion conjugate() const {return quaternion(m_w, -m_x, -m_y, -m_z);}
+    quaternion normalized() const; // throws Error for zero
+
+    // a*b rotates by b then by a.
+    quaternion operator*(const quaternion& a) const;
+    bool       operator==(const quaternion& a) const;
+    bool       operator!=(const quaternion& a) const {return !operator==(a);}
+
+    // ----- rotations -----
+
+    // of a unit quaternion. matrix() is the same rotation as a 3x3,
+    // which is cheaper than rotate() for more than a couple of
+    // vectors.
+    Cartesian rotate(const Cartesian& a_vector) const;
+    void      matrix(double a_matrix[3][3]) const;
+
+  private:
+
+    double m_w;
+    double m_x;
+    double m_y;
+    double m_z;
+
+  };
+
+  std::ostream& operator<< (std::ostream& os, const quaternion& a);
+
+
+  // =======================
+  // ===== rigidBodies =====
+  // =======================
+
+  // Orientations, body frame angular velocities and principal moments
+  // of inertia of many rigid bodies, as separate arrays like
+  // ParticleSystem. A body's orientation q takes body frame vectors
+  // to the inertial frame, v_inertial = q v_body q*, and it and the
+  // angular velocity w follow
+  //
+  //   dq/dt = q (0, w)/2
+  //   I dw/dt = torque - w x Iw
+  //
+  // for the diagonal I in the body axes.
+  //
+  // A torque adds body frame torques to the tx, ty, tz arrays, which
+  // start each evaluation at zero, and sees all the bodies at once.
+  // With torques step() is RK4 over all the bodies, four torque
+  // evaluations, with the quaternions renormalized after each step.
+  //
+  // With out torques each body is stepped on its own. While w x Iw is
+  // zero, a sphere or a spin about a principal axis, w is constant
+  // and the step is exactly q*exp(w dt), and that increment is kept
+  // and reused for the following steps until w, I or dt change, so
+  // a step is one quaternion product. Other bodies, e.g. a tumbling
+  // asymmetric body, take an RK4 step of their own.
+  //
+  // toInertial() and toBody() build each body's rotation matrix once
+  // per call, rather than once per vector as rotator does for an axis
+  // that changes every step.
+  //
+  // Thread safety: not thread safe. step() and the batch rotations
+  // run over threads() threads.
+
+  class rigidBodies {
+
+  public:
+
+    // what a torque evaluation sees, size bodies each. For RK4 these
+    // are the intermediate stage values.
+    struct state {
+      const double* m_qw;
+      const double* m_qx;
+      const double* m_qy;
+      const double* m_qz;
+      const double* m_wx; // body frame angular velocity, rad/s
+      const double* m_wy;
+      const double* m_wz;
+      const double* m_ix; // principal moments of inertia
+      const double* m_iy;
+      const double* m_iz;
+      size_t        m_size;
+      double        m_time;
+    };
+
+    // adds a_state.m_size body frame torques to a_tx, a_ty, a_tz.
+    // Must not keep the pointers.
+    typedef std::function<void (const state& a_state, double* a_tx, double* a_ty, double* a_tz)> torque;
+
+    rigidBodies(); // ctor
+
+    // implicit copy, move and dtor.
+
+    // ----- bodies -----
+
+    size_t size() const {return m_qw.size();}
+
+    // an_orientation is normalized. Throws Error for a moment that is
+    // not positive. Returns the index.
+    size_t add(const quaternion& an_orientation,
+	       const Cartesian& an_angular_velocity,
+	       const Cartesian& some_moments=Cartesian(1, 1, 1));
+    void   clear();
+
+    quaternion orientation(const size_t& an_index) const;
+    void       orientation(const size_t& an_index, const quaternion& an_orientation);
+
+    Cartesian angularVelocity(const size_t& an_index) const; // body frame, rad/s
+    void      angularVelocity(const size_t& an_index, const Cartesian& an_angular_velocity);
+
+    Cartesian moments(const size_t& an_index) const;
+    void      moments(const size_t& an_index, const Cartesian& some_moments);
+
+    // ----- integration -----
+
+    const double& time() const          {return m_time;}
+    void          time(const double& a_time) {m_time = a_time;}
+
+    void addTorque(const torque& a_torque);
+    void clearTorques();
+
+    const size_t& threads() const           {return m_threads;}
+    void          threads(const size_t& a_threads) {m_threads = a_threads;} // 0 is hardwareThreads()
+
+    void step(const double& a_dt);
+    void run(const double& a_dt, const size_t& a_steps);
+
+    // ----- rotations -----
+
+    // a_size vectors packed x, y, z in an_index's body frame to the
+    // inertial frame, and back.
+    void toInertial(const size_t& an_index, const double* a_xyz, double* a_rotated, const size_t& a_size) const;
+    void toBody(const size_t& an_index, const double* a_xyz, double* a_rotated, const size_t& a_size) const;
+
+    // one vector packed x, y, z per body, e.g. each body's boresight,
+    // parallel over the bodies.
+    void toInertial(const double* a_xyz, double* a_rotated) const;
+    void toBody(const double* a_xyz, double* a_rotated) const;
+
+    // ----- diagnostics -----
+
+    double    kineticEnergy() const;   // sum of w.Iw/2
+    Cartesian angularMomentum() const; // inertial frame
+
+  private:
+
+    void check(const size_t& an_index) const; // throws Error
+
+    void stepFree(const double& a_dt);  // no torques, body by body
+    void stepRK4(const double& a_dt);   // with torques
+
+    // an_index's rotation matrix, transposed if is_inverse
+    void matrix(const size_t& an_index, const bool& is_inverse, double a_matrix[3][3]) const;
+
+    std::vector<double> m_qw, m_qx, m_qy, m_qz;
+    std::vector<double> m_wx, m_wy, m_wz;
+    std::vector<double> m_ix, m_iy, m_iz;
+
+    // exp(w dt/2) for each body and the dt it is for, NaN when it is
+    // out of date.
+    std::vector<double> m_dw, m_dx, m_dy, m_dz;
+    std::vector<double> m_increment_dt;
+
+    std::vector<double> m_tx, m_ty, m_tz; // torques of the last evaluation
+    std::vector<double> m_scratch;        // RK4 stage state and sums, 14*size()
+
+    double              m_time;
+    size_t              m_threads;
+    std::vector<torque> m_torques;
+
+  };
+
+} // end namespace Coords
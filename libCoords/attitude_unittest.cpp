@@ -0,0 +1,272 @@
+// ================================================================
+// Filename:    attitude_unittest.cpp
+// Description: This is the gtest unittest of quaternions and the
+//              rigid body attitude integrator.
+//
+// Author:      L.R. McFarland, lrm@starbug.com
+// Created:     2026 Oct 18
+// Language:    C++
+//
+// See also: http://code.google.com/p/googletest/wiki/Primer
+//
+//  Coordinates is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  Coordinates is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with Coordinates.  If not, see <http://www.gnu.org/licenses/>.
+// ================================================================
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <sstream>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <angle.h>
+#include <Cartesian.h>
+#include <attitude.h>
+
+
+namespace {
+
+  double distance(const Coords::Cartesian& a, const Coords::Cartesian& b) {
+    return (a - b).magnitude();
+  }
+
+  // q and -q are the same rotation
+  double distance(const Coords::quaternion& a, const Coords::quaternion& b) {
+    const double dot(a.w()*b.w() + a.x()*b.x() + a.y()*b.y() + a.z()*b.z());
+    return 1 - std::fabs(dot);
+  }
+
+  // ----------------------------
+  // ----- fixed quaternions -----
+  // ----------------------------
+
+  TEST(FixedQuaternion, MatchesRotator) {
+    const Coords::Cartesian axes[] = {Coords::Ux, Coords::Uy, Coords::Uz, Coords::Cartesian(1, 2, -3)};
+    const Coords::Cartesian a_vector(0.3, -1.2, 2.5);
+    for (const Coords::Cartesian& an_axis : axes) {
+      const Coords::rotator a_rotator(an_axis);
+      for (double degrees = -180; degrees <= 180; degrees += 15) {
+	const Coords::quaternion q(Coords::quaternion::fromAxisAngle(an_axis, Coords::angle(degrees)));
+	EXPECT_NEAR(1, q.norm(), 1e-15);
+	EXPECT_LT(distance(a_rotator.rotate(a_vector, Coords::angle(degrees)), q.rotate(a_vector)), 1e-14)
+	  << an_axis << " " << degrees;
+
+	double m[3][3];
+	q.matrix(m);
+	const Coords::Cartesian by_matrix(m[0][0]*a_vector.x() + m[0][1]*a_vector.y() + m[0][2]*a_vector.z(),
+					  m[1][0]*a_vector.x() + m[1][1]*a_vector.y() + m[1][2]*a_vector.z(),
+					  m[2][0]*a_vector.x() + m[2][1]*a_vector.y() + m[2][2]*a_vector.z());
+	EXPECT_LT(distance(by_matrix, q.rotate(a_vector)), 1e-14);
+      }
+    }
+
+    // 90 degrees about z takes x to y
+    EXPECT_LT(distance(Coords::Uy, Coords::quaternion::fromAxisAngle(Coords::Uz, Coords::angle(90)).rotate(Coords::Ux)), 1e-15);
+  }
+
+  TEST(FixedQuaternion, Algebra) {
+    const Coords::quaternion a(Coords::quaternion::fromAxisAngle(Coords::Cartesian(1, 1, 0), Coords::angle(40)));
+    const Coords::quaternion b(Coords::quaternion::fromAxisAngle(Coords::Cartesian(0, -2, 1), Coords::angle(-75)));
+    const Coords::Cartesian v(1, 2, 3);
+
+    // a*b rotates by b then a
+    EXPECT_LT(distance(a.rotate(b.rotate(v)), (a*b).rotate(v)), 1e-14);
+    EXPECT_LT(distance(v, (a*a.conjugate()).rotate(v)), 1e-15);
+    EXPECT_EQ(Coords::quaternion(), Coords::quaternion(1, 0, 0, 0));
+    EXPECT_NE(a, b);
+    EXPECT_NEAR(1, Coords::quaternion(1, 2, 3, 4).normalized().norm(), 1e-15);
+
+    // the exponential map and its inverse
+    const Coords::Cartesian a_rotation(0.4, -1.1, 2.0);
+    const Coords::quaternion q(Coords::quaternion::exp(a_rotation));
+    EXPECT_LT(distance(q, Coords::quaternion::fromAxisAngle(a_rotation, Coords::angle(a_rotation.magnitude()*180/M_PI))), 1e-15);
+    EXPECT_LT(distance(a_rotation, q.rotation()), 1e-14);
+    EXPECT_LT(distance(a_rotation, Coords::quaternion(-q.w(), -q.x(), -q.y(), -q.z()).rotation()), 1e-14);
+    EXPECT_EQ(Coords::quaternion(), Coords::quaternion::exp(Coords::Cartesian(0, 0, 0)));
+    EXPECT_EQ(Coords::Cartesian(0, 0, 0), Coords::quaternion().rotation());
+
+    std::stringstream out;
+    out << Coords::quaternion(1, 2, 3, 4);
+    EXPECT_EQ("<quaternion><w>1</w><x>2</x><y>3</y><z>4</z></quaternion>", out.str());
+  }
+
+  // -------------------------------
+  // ----- fixed rigid bodies -----
+  // -------------------------------
+
+  TEST(FixedRigidBodies, ConstantSpin) {
+    // a sphere at any rate and a spin about a principal axis take the
+    // fast path and stay on the closed form exp(w t)
+    Coords::rigidBodies some_bodies;
+    const Coords::quaternion start(Coords::quaternion::fromAxisAngle(Coords::Cartesian(1, 0, 1), Coords::angle(30)));
+    const Coords::Cartesian tumble(0.3, -0.7, 1.1), spin(0, 0, 2.5);
+    some_bodies.add(start, tumble);
+    some_bodies.add(start, spin, Coords::Cartesian(1, 2, 3));
+
+    const double dt(0.01);
+    some_bodies.run(dt, 1000);
+    EXPECT_NEAR(10, some_bodies.time(), 1e-12);
+    EXPECT_LT(distance(start*Coords::quaternion::exp(10*tumble), some_bodies.orientation(0)), 1e-13);
+    EXPECT_LT(distance(start*Coords::quaternion::exp(10*spin), some_bodies.orientation(1)), 1e-13);
+    EXPECT_EQ(tumble, some_bodies.angularVelocity(0));
+    EXPECT_EQ(spin, some_bodies.angularVelocity(1));
+    EXPECT_NEAR(1, some_bodies.orientation(0).norm(), 1e-15);
+
+    // the increment follows a change of dt and of w
+    some_bodies.run(0.02, 100);
+    EXPECT_LT(distance(start*Coords::quaternion::exp(12*tumble), some_bodies.orientation(0)), 1e-13);
+    some_bodies.angularVelocity(0, -tumble);
+    some_bodies.run(0.02, 600);
+    EXPECT_LT(distance(start, some_bodies.orientation(0)), 1e-13);
+  }
+
+  TEST(FixedRigidBodies, FastPathMatchesRK4) {
+    // a zero torque forces RK4 for every body
+    Coords::rigidBodies fast, general;
+    std::mt19937 generator(12345);
+    std::uniform_real_distribution<double> uniform(-1, 1);
+    for (int i = 0; i < 50; ++i) {
+      const Coords::quaternion q(uniform(generator), uniform(generator), uniform(generator), uniform(generator));
+      const Coords::Cartesian w(uniform(generator), uniform(generator), uniform(generator));
+      fast.add(q, w);
+      general.add(q, w);
+    }
+    general.addTorque([] (const Coords::rigidBodies::state&, double*, double*, double*) {});
+    fast.run(0.01, 500);
+    general.run(0.01, 500);
+    for (size_t i = 0; i < fast.size(); ++i)
+      EXPECT_LT(distance(fast.orientation(i), general.orientation(i)), 1e-12) << i;
+  }
+
+  TEST(FixedRigidBodies, TorqueFree) {
+    // a tumbling asymmetric body keeps its energy and its angular
+    // momentum in the inertial frame
+    Coords::rigidBodies some_bodies;
+    some_bodies.add(Coords::quaternion::fromAxisAngle(Coords::Uy, Coords::angle(20)),
+		    Coords::Cartesian(0.1, 1.5, 0.2), Coords::Cartesian(2, 3, 4)); // near the unstable middle axis
+    some_bodies.add(Coords::quaternion(), Coords::Cartesian(1, 0.5, -0.3), Coords::Cartesian(10, 1, 1));
+    const double energy(some_bodies.kineticEnergy());
+    const Coords::Cartesian momentum(some_bodies.angularMomentum());
+
+    // and the middle axis spin flips over
+    double lowest(some_bodies.angularVelocity(0).y());
+    for (int k = 0; k < 200; ++k) {
+      some_bodies.run(0.001, 100);
+      lowest = std::min(lowest, some_bodies.angularVelocity(0).y());
+    }
+    EXPECT_LT(lowest, -1);
+    EXPECT_NEAR(0, (some_bodies.kineticEnergy() - energy)/energy, 1e-10);
+    EXPECT_LT(distance(momentum, some_bodies.angularMomentum()), 1e-9*momentum.magnitude());
+  }
+
+  TEST(FixedRigidBodies, Torque) {
+    // a constant torque about z from rest, w = t/I and angle t^2/(2I)
+    Coords::rigidBodies some_bodies;
+    some_bodies.add(Coords::quaternion(), Coords::Cartesian(0, 0, 0), Coords::Cartesian(1, 1, 4));
+    some_bodies.addTorque([] (const Coords::rigidBodies::state& a_state, double* a_tx, double* a_ty, double* a_tz) {
+	for (size_t i = 0; i < a_state.m_size; ++i)
+	  a_tz[i] += 2;
+      });
+    some_bodies.run(0.01, 300);
+    EXPECT_NEAR(1.5, some_bodies.angularVelocity(0).z(), 1e-12);
+    EXPECT_LT(distance(Coords::quaternion::exp(Coords::Cartesian(0, 0, 2.25)), some_bodies.orientation(0)), 1e-12);
+
+    some_bodies.clearTorques();
+    some_bodies.run(0.01, 100);
+    EXPECT_NEAR(1.5, some_bodies.angularVelocity(0).z(), 1e-12);
+    EXPECT_LT(distance(Coords::quaternion::exp(Coords::Cartesian(0, 0, 3.75)), some_bodies.orientation(0)), 1e-12);
+  }
+
+  TEST(FixedRigidBodies, Rotations) {
+    Coords::rigidBodies some_bodies;
+    std::mt19937 generator(54321);
+    std::uniform_real_distribution<double> uniform(-1, 1);
+    for (int i = 0; i < 20; ++i)
+      some_bodies.add(Coords::quaternion(uniform(generator), uniform(generator), uniform(generator), uniform(generator)),
+		      Coords::Cartesian(0, 0, 0));
+
+    std::vector<double> xyz;
+    for (int i = 0; i < 3*20; ++i)
+      xyz.push_back(uniform(generator));
+
+    // one body, many vectors
+    std::vector<double> inertial(xyz.size()), body(xyz.size());
+    some_bodies.toInertial(3, xyz.data(), inertial.data(), 20);
+    some_bodies.toBody(3, inertial.data(), body.data(), 20);
+    for (size_t i = 0; i < 20; ++i) {
+      const Coords::Cartesian v(xyz[3*i], xyz[3*i + 1], xyz[3*i + 2]);
+      EXPECT_LT(distance(some_bodies.orientation(3).rotate(v),
+			 Coords::Cartesian(inertial[3*i], inertial[3*i + 1], inertial[3*i + 2])), 1e-15);
+      EXPECT_LT(distance(v, Coords::Cartesian(body[3*i], body[3*i + 1], body[3*i + 2])), 1e-15);
+    }
+
+    // one vector per body, in place
+    std::vector<double> each(xyz);
+    some_bodies.toInertial(each.data(), each.data());
+    for (size_t i = 0; i < 20; ++i) {
+      const Coords::Cartesian v(xyz[3*i], xyz[3*i + 1], xyz[3*i + 2]);
+      EXPECT_LT(distance(some_bodies.orientation(i).rotate(v),
+			 Coords::Cartesian(each[3*i], each[3*i + 1], each[3*i + 2])), 1e-15);
+    }
+    some_bodies.toBody(each.data(), each.data());
+    for (size_t i = 0; i < xyz.size(); ++i)
+      EXPECT_NEAR(xyz[i], each[i], 1e-15);
+  }
+
+  TEST(FixedRigidBodies, Errors) {
+    Coords::rigidBodies some_bodies;
+    EXPECT_THROW(some_bodies.add(Coords::quaternion(), Coords::Ux, Coords::Cartesian(1, 0, 1)), Coords::Error);
+    EXPECT_THROW(some_bodies.add(Coords::quaternion(0, 0, 0, 0), Coords::Ux), Coords::Error);
+    EXPECT_THROW(some_bodies.orientation(0), Coords::Error);
+    EXPECT_THROW(Coords::quaternion::fromAxisAngle(Coords::Cartesian(0, 0, 0), Coords::angle(10)), Coords::Error);
+
+    some_bodies.add(Coords::quaternion(), Coords::Ux);
+    EXPECT_THROW(some_bodies.moments(0, Coords::Cartesian(1, -1, 1)), Coords::Error);
+    double v[3] = {1, 2, 3};
+    EXPECT_THROW(some_bodies.toInertial(1, v, v, 1), Coords::Error);
+    some_bodies.clear();
+    EXPECT_EQ(size_t(0), some_bodies.size());
+    EXPECT_NO_THROW(some_bodies.step(0.1));
+  }
+
+  TEST(FixedRigidBodies, ThreadsMatchSerial) {
+    Coords::rigidBodies some_bodies;
+    std::mt19937 generator(12345);
+    std::uniform_real_distribution<double> uniform(-1, 1);
+    std::uniform_real_distribution<double> moment(1, 5);
+    for (int i = 0; i < 20000; ++i) {
+      // every other body tumbles
+      const Coords::Cartesian some_moments(i % 2 ? Coords::Cartesian(moment(generator), moment(generator), moment(generator))
+					   : Coords::Cartesian(1, 1, 1));
+      some_bodies.add(Coords::quaternion(uniform(generator), uniform(generator), uniform(generator), uniform(generator)),
+		      Coords::Cartesian(uniform(generator), uniform(generator), uniform(generator)), some_moments);
+    }
+    Coords::rigidBodies serial(some_bodies);
+    some_bodies.threads(4);
+    serial.threads(1);
+    some_bodies.run(0.01, 10);
+    serial.run(0.01, 10);
+    for (size_t i = 0; i < some_bodies.size(); ++i) {
+      ASSERT_EQ(serial.orientation(i), some_bodies.orientation(i)) << i;
+      ASSERT_EQ(serial.angularVelocity(i), some_bodies.angularVelocity(i)) << i;
+    }
+  }
+
+} // end anonymous namespace
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,616 @@
+// ==================================================================
+// Filename:    bvh.cpp
+//
+// Description: Implements the bounding volume hierarchy build, refit
+//              and packet ray traversal.
+//
+// Author:      L.R. McFarland
+// Created:     2026 Oct 18
+// Language:    C++
+//
+//  Coordinates is free software: you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License as
+//  published by the Free Software Foundation, either version 3 of the
+//  License, or (at your option) any later version.
+//
+//  Coordinates is distributed in the hope that it will be useful, but
+//  WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with Coordinates.  If not, see <http://www.gnu.org/licenses/>.
+// ==================================================================
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <bvh.h>
+#include <utils.h>
+
+namespace {
+
+  const double s_infinity(std::numeric_limits<double>::infinity());
+
+  const size_t s_bins(16);       // surface area heuristic bins per axis
+  const size_t s_largest_leaf(16); // split beyond this even if the heuristic would not
+  const int    s_depth(60);      // deepest node, a leaf however many primitives it has
+  const size_t s_stack(2*s_depth + 2);
+  const size_t s_packet(8);
+
+  // subtrees from this depth with more than s_task_size primitives
+  // are built in parallel.
+  const int    s_task_depth(4);
+  const size_t s_task_size(4096);
+
+  // ----- boxes -----
+
+  struct box {
+    double m_lower[3];
+    double m_upper[3];
+  };
+
+  inline void clear(box& a_box) {
+    for (int d = 0; d < 3; ++d) {
+      a_box.m_lower[d] = s_infinity;
+      a_box.m_upper[d] = -s_infinity;
+    }
+  }
+
+  inline void grow(box& a_box, const box& another) {
+    for (int d = 0; d < 3; ++d) {
+      a_box.m_lower[d] = std::min(a_box.m_lower[d], another.m_lower[d]);
+      a_box.m_upper[d] = std::max(a_box.m_upper[d], another.m_upper[d]);
+    }
+  }
+
+  // half the surface area, 0 for an empty box
+  inline double area(const box& a_box) {
+    const double x(a_box.m_upper[0] - a_box.m_lower[0]);
+    const double y(a_box.m_upper[1] - a_box.m_lower[1]);
+    const double z(a_box.m_upper[2] - a_box.m_lower[2]);
+    return x < 0 ? 0 : x*y + y*z + z*x;
+  }
+
+  // ----- build -----
+
+  struct buildNode {
+    uint32_t m_offset;
+    uint32_t m_count;
+    uint32_t m_axis;
+  };
+
+  struct task {
+    size_t m_node;
+    size_t m_begin;
+    size_t m_end;
+  };
+
+  // splits m_order[a_begin, an_end) under some_nodes[an_index]. With
+  // some_tasks, stops at s_task_depth and leaves the larger subtrees
+  // to be built later.
+  class builder {
+
+  public:
+
+    builder(const std::vector<box>& some_boxes, const std::vector<double>& some_centroids,
+	    std::vector<uint32_t>& an_order, const size_t& a_leaf_size, std::vector<task>* some_tasks)
+      : m_boxes(some_boxes), m_centroids(some_centroids), m_order(an_order),
+	m_leaf_size(a_leaf_size), m_tasks(some_tasks)
+    {}
+
+    void split(std::vector<buildNode>& some_nodes, const size_t& an_index,
+	       const size_t& a_begin, const size_t& an_end, const int& a_depth) const;
+
+  private:
+
+    const std::vector<box>&    m_boxes;
+    const std::vector<double>& m_centroids; // x, y, z a primitive
+    std::vector<uint32_t>&     m_order;
+    size_t                     m_leaf_size;
+    std::vector<task>*         m_tasks;
+
+  };
+
+  void builder::split(std::vector<buildNode>& some_nodes, const size_t& an_index,
+		      const size_t& a_begin, const size_t& an_end, const int& a_depth) const {
+
+    const size_t count(an_end - a_begin);
+    buildNode leaf = {uint32_t(a_begin), uint32_t(count), 0};
+    some_nodes[an_index] = leaf;
+    if (count <= m_leaf_size || a_depth >= s_depth)
+      return;
+
+    if (m_tasks && a_depth == s_task_depth && count > s_task_size) {
+      task a_task = {an_index, a_begin, an_end};
+      m_tasks->push_back(a_task);
+      return;
+    }
+
+    box bounds, centers;
+    clear(bounds);
+    clear(centers);
+    for (size_t k = a_begin; k < an_end; ++k) {
+      const uint32_t p(m_order[k]);
+      grow(bounds, m_boxes[p]);
+      const box center = {{m_centroids[3*p], m_centroids[3*p + 1], m_centroids[3*p + 2]},
+			  {m_centroids[3*p], m_centroids[3*p + 1], m_centroids[3*p + 2]}};
+      grow(centers, center);
+    }
+
+    // the cheapest boundary between bins over the three axes
+    double best(s_infinity);
+    int best_axis(-1);
+    size_t best_bin(0);
+    for (int d = 0; d < 3; ++d) {
+      const double extent(centers.m_upper[d] - centers.m_lower[d]);
+      if (!(extent > 0))
+	continue;
+      const double scale(s_bins/extent);
+      size_t counts[s_bins] = {0};
+      box bins[s_bins];
+      for (size_t b = 0; b < s_bins; ++b)
+	clear(bins[b]);
+      for (size_t k = a_begin; k < an_end; ++k) {
+	const uint32_t p(m_order[k]);
+	const size_t b(std::min(s_bins - 1, size_t((m_centroids[3*p + d] - centers.m_lower[d])*scale)));
+	++counts[b];
+	grow(bins[b], m_boxes[p]);
+      }
+      double right_area[s_bins];
+      size_t right_count[s_bins];
+      box right;
+      clear(right);
+      size_t n(0);
+      for (size_t b = s_bins; b-- > 1;) {
+	grow(right, bins[b]);
+	n += counts[b];
+	right_area[b] = area(right);
+	right_count[b] = n;
+      }
+      box left;
+      clear(left);
+      n = 0;
+      for (size_t b = 1; b < s_bins; ++b) {
+	grow(left, bins[b - 1]);
+	n += counts[b - 1];
+	const double cost(area(left)*n + right_area[b]*right_count[b]);
+	if (n > 0 && right_count[b] > 0 && cost < best) {
+	  best = cost;
+	  best_axis = d;
+	  best_bin = b;
+	}
+      }
+    }
+
+    size_t middle(a_begin + count/2);
+    if (best_axis >= 0) {
+      if (best >= area(bounds)*count && count <= s_largest_leaf)
+	return; // cheaper as a leaf
+      const int d(best_axis);
+      const double lower(centers.m_lower[d]);
+      const double scale(s_bins/(centers.m_upper[d] - lower));
+      middle = std::partition(m_order.begin() + a_begin, m_order.begin() + an_end,
+			      [&] (const uint32_t& p) {
+				return std::min(s_bins - 1, size_t((m_centroids[3*p + d] - lower)*scale)) < best_bin;
+			      }) - m_order.begin();
+    } // else all the centers coincide, halve them
+
+    const size_t children(some_nodes.size());
+    some_nodes.resize(children + 2);
+    buildNode inner = {uint32_t(children), 0, uint32_t(std::max(best_axis, 0))};
+    some_nodes[an_index] = inner;
+    split(some_nodes, children, a_begin, middle, a_depth + 1);
+    split(some_nodes, children + 1, middle, an_end, a_depth + 1);
+  }
+
+  // ----- intersections -----
+
+  // the entry to a sphere along o + t*d, t >= 0, or infinity. Found
+  // from the closest approach so it does not cancel for a small
+  // sphere far from the origin.
+  inline double sphereHit(const double& ox, const double& oy, const double& oz,
+			  const double& dx, const double& dy, const double& dz,
+			  const double& cx, const double& cy, const double& cz, const double& r) {
+    const double fx(ox - cx), fy(oy - cy), fz(oz - cz);
+    const double dd(dx*dx + dy*dy + dz*dz);
+    const double tc(-(fx*dx + fy*dy + fz*dz)/dd);
+    const double px(fx + tc*dx), py(fy + tc*dy), pz(fz + tc*dz);
+    const double h2(r*r - (px*px + py*py + pz*pz));
+    if (h2 < 0)
+      return s_infinity;
+    const double dt(std::sqrt(h2/dd));
+    if (tc + dt < 0)
+      return s_infinity;
+    return std::max(tc - dt, 0.0);
+  }
+
+  // narrows [a_near, a_far] to the slab [l, u] of one axis. A ray
+  // parallel to the slab, inverse direction i infinite, is in it for
+  // all t or none, decided by the origin o. The slab form would give
+  // 0*infinity = NaN for an origin on a face.
+  inline void slab(const double& o, const double& i, const double& l, const double& u,
+		   double& a_near, double& a_far) {
+    const double a((l - o)*i), b((u - o)*i);
+    const bool is_parallel(std::fabs(i) == s_infinity);
+    const bool is_inside(o >= l && o <= u);
+    a_near = std::max(a_near, is_parallel ? (is_inside ? -s_infinity : s_infinity) : std::min(a, b));
+    a_far = std::min(a_far, is_parallel ? s_infinity : std::max(a, b));
+  }
+
+  // the entry to a closed box, or infinity
+  inline double boxHit(const double& ox, const double& oy, const double& oz,
+		       const double& ix, const double& iy, const double& iz,
+		       const double& lx, const double& ly, const double& lz,
+		       const double& ux, const double& uy, const double& uz) {
+    double near(0), far(s_infinity);
+    slab(ox, ix, lx, ux, near, far);
+    slab(oy, iy, ly, uy, near, far);
+    slab(oz, iz, lz, uz, near, far);
+    return near <= far ? near : s_infinity;
+  }
+
+} // end anonymous namespace
+
+
+const size_t Coords::bvh::s_miss(size_t(-1));
+
+// rays [0, m_size), their hits so far in m_t and m_index. m_t starts
+// at the end of a segment or infinity.
+struct Coords::bvh::packet {
+  size_t m_size;
+  double m_ox[s_packet], m_oy[s_packet], m_oz[s_packet];
+  double m_dx[s_packet], m_dy[s_packet], m_dz[s_packet];
+  double m_ix[s_packet], m_iy[s_packet], m_iz[s_packet];
+  double m_t[s_packet];
+  size_t m_index[s_packet];
+
+  // throws Error for a zero direction
+  void set(const size_t& a_lane,
+	   const double& ox, const double& oy, const double& oz,
+	   const double& dx, const double& dy, const double& dz,
+	   const double& a_t) {
+    if (dx == 0 && dy == 0 && dz == 0)
+      throw Error("bvh ray direction must not be zero");
+    m_ox[a_lane] = ox;
+    m_oy[a_lane] = oy;
+    m_oz[a_lane] = oz;
+    m_dx[a_lane] = dx;
+    m_dy[a_lane] = dy;
+    m_dz[a_lane] = dz;
+    m_ix[a_lane] = 1/dx;
+    m_iy[a_lane] = 1/dy;
+    m_iz[a_lane] = 1/dz;
+    m_t[a_lane] = a_t;
+    m_index[a_lane] = s_miss;
+  }
+};
+
+
+// ------------------------
+// ----- constructors -----
+// ------------------------
+
+Coords::bvh::bvh(const size_t& a_leaf_size) : m_leaf_size(a_leaf_size), m_threads(0), m_spheres(0) {
+  if (a_leaf_size == 0)
+    throw Error("bvh leaf size must be at least 1");
+}
+
+
+// -----------------
+// ----- build -----
+// -----------------
+
+void Coords::bvh::build(const Cartesian* some_centers, const double* some_radii, const size_t& a_spheres,
+			const Cartesian* some_lowers, const Cartesian* some_uppers, const size_t& a_boxes) {
+
+  const size_t n(a_spheres + a_boxes);
+  if (n >= (size_t(1) << 31))
+    throw Error("too many bvh primitives");
+
+  // the bounds and centers of the primitives
+  std::vector<box> some_boxes(n);
+  std::vector<double> centroids(3*n);
+  parallelFor(n, [&] (const size_t& a_begin, const size_t& an_end) {
+      for (size_t p = a_begin; p < an_end; ++p) {
+	double lower[3], upper[3];
+	if (p < a_spheres) {
+	  const Cartesian& c(some_centers[p]);
+	  const double r(some_radii[p]);
+	  if (!(r >= 0) || c.x() != c.x() || c.y() != c.y() || c.z() != c.z())
+	    throw Error("bvh sphere radius must not be negative or NaN");
+	  lower[0] = c.x() - r; lower[1] = c.y() - r; lower[2] = c.z() - r;
+	  upper[0] = c.x() + r; upper[1] = c.y() + r; upper[2] = c.z() + r;
+	} else {
+	  const Cartesian& l(some_lowers[p - a_spheres]);
+	  const Cartesian& u(some_uppers[p - a_spheres]);
+	  if (!(l.x() <= u.x() && l.y() <= u.y() && l.z() <= u.z()))
+	    throw Error("bvh box upper corner must not be below the lower");
+	  lower[0] = l.x(); lower[1] = l.y(); lower[2] = l.z();
+	  upper[0] = u.x(); upper[1] = u.y(); upper[2] = u.z();
+	}
+	for (int d = 0; d < 3; ++d) {
+	  some_boxes[p].m_lower[d] = lower[d];
+	  some_boxes[p].m_upper[d] = upper[d];
+	  centroids[3*p + d] = (lower[d] + upper[d])/2;
+	}
+      }
+    }, m_threads);
+
+  m_spheres = a_spheres;
+  m_order.resize(n);
+  for (size_t p = 0; p < n; ++p)
+    m_order[p] = uint32_t(p);
+  m_nodes.clear();
+  if (n == 0) {
+    refitNodes(some_centers, some_radii, some_lowers, some_uppers);
+    return;
+  }
+
+  // the top levels, then the subtrees below them in parallel, spliced
+  // in after
+  std::vector<buildNode> some_nodes(1);
+  std::vector<task> tasks;
+  builder(some_boxes, centroids, m_order, m_leaf_size, &tasks).split(some_nodes, 0, 0, n, 0);
+
+  std::vector<std::vector<buildNode> > subtrees(tasks.size());
+  parallelFor(tasks.size(), [&] (const size_t& a_begin, const size_t& an_end) {
+      const builder a_builder(some_boxes, centroids, m_order, m_leaf_size, 0);
+      for (size_t t = a_begin; t < an_end; ++t) {
+	subtrees[t].resize(1);
+	a_builder.split(subtrees[t], 0, tasks[t].m_begin, tasks[t].m_end, s_task_depth);
+      }
+    }, m_threads, 1);
+
+  for (size_t t = 0; t < tasks.size(); ++t) {
+    // the root takes the task's node, the rest go at the end
+    const uint32_t base(uint32_t(some_nodes.size()) - 1);
+    std::vector<buildNode>& a_subtree(subtrees[t]);
+    for (size_t k = 0; k < a_subtree.size(); ++k)
+      if (a_subtree[k].m_count == 0)
+	a_subtree[k].m_offset += base;
+    some_nodes[tasks[t].m_node] = a_subtree[0];
+    some_nodes.insert(some_nodes.end(), a_subtree.begin() + 1, a_subtree.end());
+  }
+
+  m_nodes.resize(some_nodes.size());
+  for (size_t i = 0; i < some_nodes.size(); ++i) {
+    const node a_node = {some_nodes[i].m_offset, some_nodes[i].m_count, some_nodes[i].m_axis};
+    m_nodes[i] = a_node;
+  }
+
+  refitNodes(some_centers, some_radii, some_lowers, some_uppers);
+}
+
+void Coords::bvh::refit(const Cartesian* some_centers, const double* some_radii,
+			const Cartesian* some_lowers, const Cartesian* some_uppers) {
+  refitNodes(some_centers, some_radii, some_lowers, some_uppers);
+}
+
+void Coords::bvh::refitNodes(const Cartesian* some_centers, const double* some_radii,
+			     const Cartesian* some_lowers, const Cartesian* some_uppers) {
+
+  const size_t n(size());
+  m_ax.resize(n);
+  m_ay.resize(n);
+  m_az.resize(n);
+  m_bx.resize(n);
+  m_by.resize(n);
+  m_bz.resize(n);
+  parallelFor(n, [&] (const size_t& a_begin, const size_t& an_end) {
+      for (size_t k = a_begin; k < an_end; ++k) {
+	const size_t p(m_order[k]);
+	if (p < m_spheres) {
+	  const Cartesian& c(some_centers[p]);
+	  const double r(some_radii[p]);
+	  if (!(r >= 0) || c.x() != c.x() || c.y() != c.y() || c.z() != c.z())
+	    throw Error("bvh sphere radius must not be negative or NaN");
+	  m_ax[k] = c.x();
+	  m_ay[k] = c.y();
+	  m_az[k] = c.z();
+	  m_bx[k] = r;
+	  m_by[k] = r;
+	  m_bz[k] = r;
+	} else {
+	  const Cartesian& l(some_lowers[p - m_spheres]);
+	  const Cartesian& u(some_uppers[p - m_spheres]);
+	  if (!(l.x() <= u.x() && l.y() <= u.y() && l.z() <= u.z()))
+	    throw Error("bvh box upper corner must not be below the lower");
+	  m_ax[k] = l.x();
+	  m_ay[k] = l.y();
+	  m_az[k] = l.z();
+	  m_bx[k] = u.x();
+	  m_by[k] = u.y();
+	  m_bz[k] = u.z();
+	}
+      }
+    }, m_threads);
+
+  // the leaves in parallel, then the inner nodes children first,
+  // which come after their parents.
+  const size_t count(m_nodes.size());
+  m_lx.resize(count);
+  m_ly.resize(count);
+  m_lz.resize(count);
+  m_ux.resize(count);
+  m_uy.resize(count);
+  m_uz.resize(count);
+  parallelFor(count, [&] (const size_t& a_begin, const size_t& an_end) {
+      for (size_t i = a_begin; i < an_end; ++i) {
+	const node& a_node(m_nodes[i]);
+	if (a_node.m_count == 0)
+	  continue;
+	box bounds;
+	clear(bounds);
+	for (size_t k = a_node.m_offset; k < a_node.m_offset + a_node.m_count; ++k) {
+	  const bool is_sphere(m_order[k] < m_spheres);
+	  const box a_box = {{is_sphere ? m_ax[k] - m_bx[k] : m_ax[k],
+			      is_sphere ? m_ay[k] - m_bx[k] : m_ay[k],
+			      is_sphere ? m_az[k] - m_bx[k] : m_az[k]},
+			     {is_sphere ? m_ax[k] + m_bx[k] : m_bx[k],
+			      is_sphere ? m_ay[k] + m_bx[k] : m_by[k],
+			      is_sphere ? m_az[k] + m_bx[k] : m_bz[k]}};
+	  grow(bounds, a_box);
+	}
+	m_lx[i] = bounds.m_lower[0];
+	m_ly[i] = bounds.m_lower[1];
+	m_lz[i] = bounds.m_lower[2];
+	m_ux[i] = bounds.m_upper[0];
+	m_uy[i] = bounds.m_upper[1];
+	m_uz[i] = bounds.m_upper[2];
+      }
+    }, m_threads, 4096);
+
+  for (size_t i = count; i-- > 0;) {
+    const node& a_node(m_nodes[i]);
+    if (a_node.m_count != 0)
+      continue;
+    const size_t a(a_node.m_offset), b(a + 1);
+    m_lx[i] = std::min(m_lx[a], m_lx[b]);
+    m_ly[i] = std::min(m_ly[a], m_ly[b]);
+    m_lz[i] = std::min(m_lz[a], m_lz[b]);
+    m_ux[i] = std::max(m_ux[a], m_ux[b]);
+    m_uy[i] = std::max(m_uy[a], m_uy[b]);
+    m_uz[i] = std::max(m_uz[a], m_uz[b]);
+  }
+}
+
+void Coords::bvh::bounds(Cartesian& a_lower, Cartesian& an_upper) const {
+  if (m_nodes.empty())
+    throw Error("an empty bvh has no bounds");
+  a_lower = Cartesian(m_lx[0], m_ly[0], m_lz[0]);
+  an_upper = Cartesian(m_ux[0], m_uy[0], m_uz[0]);
+}
+
+
+// -------------------
+// ----- queries -----
+// -------------------
+
+void Coords::bvh::trace(packet& a_packet, const bool& is_any) const {
+
+  if (m_nodes.empty())
+    return;
+
+  // a ray that is done, an any hit found, has m_t -1 so it hits
+  // nothing more
+  const size_t lanes(a_packet.m_size);
+  size_t remaining(lanes);
+
+  uint32_t stack[s_stack];
+  size_t top(0);
+  stack[top++] = 0;
+
+  while (top > 0) {
+
+    const uint32_t i(stack[--top]);
+    const node& a_node(m_nodes[i]);
+
+    // the node's box against every ray still looking
+    bool is_hit(false);
+    const double lx(m_lx[i]), ly(m_ly[i]), lz(m_lz[i]);
+    const double ux(m_ux[i]), uy(m_uy[i]), uz(m_uz[i]);
+    for (size_t l = 0; l < lanes; ++l) {
+      const double t(boxHit(a_packet.m_ox[l], a_packet.m_oy[l], a_packet.m_oz[l],
+			    a_packet.m_ix[l], a_packet.m_iy[l], a_packet.m_iz[l],
+			    lx, ly, lz, ux, uy, uz));
+      is_hit |= t <= a_packet.m_t[l] && t < s_infinity;
+    }
+    if (!is_hit)
+      continue;
+
+    if (a_node.m_count == 0) {
+      // nearer child on top
+      const double* direction(a_node.m_axis == 0 ? a_packet.m_dx : a_node.m_axis == 1 ? a_packet.m_dy : a_packet.m_dz);
+      const bool is_reversed(direction[0] < 0);
+      stack[top++] = a_node.m_offset + (is_reversed ? 0 : 1);
+      stack[top++] = a_node.m_offset + (is_reversed ? 1 : 0);
+      continue;
+    }
+
+    for (size_t k = a_node.m_offset; k < a_node.m_offset + a_node.m_count; ++k) {
+      const uint32_t p(m_order[k]);
+      const bool is_sphere(p < m_spheres);
+      for (size_t l = 0; l < lanes; ++l) {
+	const double t(is_sphere ?
+		       sphereHit(a_packet.m_ox[l], a_packet.m_oy[l], a_packet.m_oz[l],
+				 a_packet.m_dx[l], a_packet.m_dy[l], a_packet.m_dz[l],
+				 m_ax[k], m_ay[k], m_az[k], m_bx[k]) :
+		       boxHit(a_packet.m_ox[l], a_packet.m_oy[l], a_packet.m_oz[l],
+			      a_packet.m_ix[l], a_packet.m_iy[l], a_packet.m_iz[l],
+			      m_ax[k], m_ay[k], m_az[k], m_bx[k], m_by[k], m_bz[k]));
+	// the lower index on a tie, so the answer does not depend on
+	// the order the nodes are visited in
+	if (t < s_infinity && (t < a_packet.m_t[l] || (t == a_packet.m_t[l] && p < a_packet.m_index[l]))) {
+	  a_packet.m_t[l] = t;
+	  a_packet.m_index[l] = p;
+	  if (is_any) {
+	    a_packet.m_t[l] = -1;
+	    if (--remaining == 0)
+	      return;
+	  }
+	}
+      }
+    }
+  }
+}
+
+bool Coords::bvh::intersect(const Cartesian& an_origin, const Cartesian& a_direction,
+			    size_t& an_index, double& a_distance) const {
+  packet a_packet;
+  a_packet.m_size = 1;
+  a_packet.set(0, an_origin.x(), an_origin.y(), an_origin.z(),
+	       a_direction.x(), a_direction.y(), a_direction.z(), s_infinity);
+  trace(a_packet, false);
+  an_index = a_packet.m_index[0];
+  a_distance = a_packet.m_t[0];
+  return an_index != s_miss;
+}
+
+bool Coords::bvh::occluded(const Cartesian& a_from, const Cartesian& a_to) const {
+  packet a_packet;
+  a_packet.m_size = 1;
+  a_packet.set(0, a_from.x(), a_from.y(), a_from.z(),
+	       a_to.x() - a_from.x(), a_to.y() - a_from.y(), a_to.z() - a_from.z(), 1);
+  trace(a_packet, true);
+  return a_packet.m_index[0] != s_miss;
+}
+
+void Coords::bvh::intersect(const double* some_origins, const double* some_directions, const size_t& a_size,
+			    size_t* some_indices, double* some_distances) const {
+  parallelFor(a_size, [&] (const size_t& a_begin, const size_t& an_end) {
+      packet a_packet;
+      for (size_t r = a_begin; r < an_end; r += s_packet) {
+	a_packet.m_size = std::min(s_packet, an_end - r);
+	for (size_t l = 0; l < a_packet.m_size; ++l) {
+	  const double* o(some_origins + 3*(r + l));
+	  const double* d(some_directions + 3*(r + l));
+	  a_packet.set(l, o[0], o[1], o[2], d[0], d[1], d[2], s_infinity);
+	}
+	trace(a_packet, false);
+	for (size_t l = 0; l < a_packet.m_size; ++l) {
+	  some_indices[r + l] = a_packet.m_index[l];
+	  some_distances[r + l] = a_packet.m_t[l];
+	}
+      }
+    }, m_threads, 1024);
+}
+
+void Coords::bvh::occluded(const double* some_froms, const double* some_tos, const size_t& a_size,
+			   bool* some_occluded) const {
+  parallelFor(a_size, [&] (const size_t& a_begin, const size_t& an_end) {
+      packet a_packet;
+      for (size_t r = a_begin; r < an_end; r += s_packet) {
+	a_packet.m_size = std::min(s_packet, an_end - r);
+	for (size_t l = 0; l < a_packet.m_size; ++l) {
+	  const double* a(some_froms + 3*(r + l));
+	  const double* b(some_tos + 3*(r + l));
+	  a_packet.set(l, a[0], a[1], a[2], b[0] - a[0], b[1] - a[1], b[2] - a[2], 1);
+	}
+	trace(a_packet, true);
+	for (size_t l = 0; l < a_packet.m_size; ++l)
+	  some_occluded[r + l] = a_packet.m_index[l] != s_miss;
+      }
+    }, m_threads, 1024);
+}
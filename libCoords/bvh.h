@@ -0,0 +1,160 @@
+// ================================================================
+// Filename:    bvh.h
+//
+// Description: This defines a bounding volume hierarchy over spheres
+//              and axis aligned boxes for ray and line of sight
+//              queries.
+//
+// Author:      L.R. McFarland
+// Created:     2026 Oct 18
+// Language:    C++
+//
+//  Coords is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  Coords is distributed in the hope that it will be useful, but
+//  WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with Coords.  If not, see <http://www.gnu.org/licenses/>.
+// ================================================================
+
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+
+#include <angle.h>
+#include <Cartesian.h>
+#include <parallel.h>
+
+namespace Coords {
+
+  // ===============
+  // ===== bvh =====
+  // ===============
+
+  // A binary tree of axis aligned boxes over spheres, e.g. bodies, and
+  // boxes. build() splits each node where the surface area heuristic
+  // is cheapest, over 16 bins of the primitives' centers per axis,
+  // and builds the subtrees below the first levels in parallel. The
+  // two children of a node are adjacent and come after it, and the
+  // node bounds and the primitives are kept as separate x, y, z
+  // arrays in tree order.
+  //
+  // The primitives are numbered spheres first, then boxes, in the
+  // order given to build(). A ray is an origin and a direction, which
+  // need not be unit length, and its points are origin + t*direction
+  // for t >= 0, so a hit distance t is in units of the direction. A
+  // ray that starts inside a primitive hits it at t = 0.
+  //
+  // The batch queries trace rays in packets of 8 consecutive rays,
+  // each node's box tested against the packet at once and the packet
+  // going down the tree together, nearer child first by the
+  // direction of the first ray. Rays that start close together and
+  // point the same way, e.g. from one observer or of one occultation
+  // scan, share most of their nodes. The packets are spread over the
+  // threads.
+  //
+  // refit() keeps the tree and recomputes the bounds from moved
+  // primitives, which is much cheaper than build() but slows the
+  // queries as the nodes come to overlap, so build() again every so
+  // often.
+  //
+  // Thread safety: build() and refit() modify the tree. The const
+  // methods may be called from any number of threads.
+
+  class bvh {
+
+  public:
+
+    static const size_t s_miss; // the index of no hit
+
+    explicit bvh(const size_t& a_leaf_size=4); // throws Error for 0
+
+    // implicit copy, move and dtor.
+
+    const size_t& leafSize() const {return m_leaf_size;}
+
+    const size_t& threads() const           {return m_threads;}
+    void          threads(const size_t& a_threads) {m_threads = a_threads;} // 0 is hardwareThreads()
+
+    // ----- build -----
+
+    // a_spheres spheres and a_boxes boxes, lower and upper corners.
+    // Throws Error for a negative radius, an upper corner below its
+    // lower or a NaN.
+    void build(const Cartesian* some_centers, const double* some_radii, const size_t& a_spheres,
+	       const Cartesian* some_lowers=0, const Cartesian* some_uppers=0, const size_t& a_boxes=0);
+
+    // the same primitives as build(), moved or resized.
+    void refit(const Cartesian* some_centers, const double* some_radii,
+	       const Cartesian* some_lowers=0, const Cartesian* some_uppers=0);
+
+    size_t size() const    {return m_order.size();}
+    size_t spheres() const {return m_spheres;}
+    size_t boxes() const   {return m_order.size() - m_spheres;}
+    size_t nodes() const   {return m_nodes.size();}
+
+    // the bounds of everything, throws Error for an empty tree
+    void bounds(Cartesian& a_lower, Cartesian& an_upper) const;
+
+    // ----- queries -----
+
+    // the nearest hit along the ray. false, s_miss and infinity if
+    // there is none.
+    bool intersect(const Cartesian& an_origin, const Cartesian& a_direction,
+		   size_t& an_index, double& a_distance) const;
+
+    // true if a primitive is on the segment from a_from to a_to.
+    bool occluded(const Cartesian& a_from, const Cartesian& a_to) const;
+
+    // a_size rays, origins and directions packed x, y, z, parallel
+    // over packets of rays.
+    void intersect(const double* some_origins, const double* some_directions, const size_t& a_size,
+		   size_t* some_indices, double* some_distances) const;
+
+    // a_size segments, packed x, y, z
+    void occluded(const double* some_froms, const double* some_tos, const size_t& a_size,
+		  bool* some_occluded) const;
+
+  private:
+
+    // an inner node's children are m_offset and m_offset + 1, a
+    // leaf's primitives are [m_offset, m_offset + m_count) in tree
+    // order.
+    struct node {
+      uint32_t m_offset;
+      uint32_t m_count; // 0 for an inner node
+      uint32_t m_axis;  // of the split
+    };
+
+    struct packet;
+
+    // the first hit of each ray of a_packet, or any hit if is_any
+    void trace(packet& a_packet, const bool& is_any) const;
+
+    // the primitives to tree order, and the leaf and then inner node
+    // bounds.
+    void refitNodes(const Cartesian* some_centers, const double* some_radii,
+		    const Cartesian* some_lowers, const Cartesian* some_uppers);
+
+    size_t m_leaf_size;
+    size_t m_threads;
+    size_t m_spheres;
+
+    std::vector<node>     m_nodes;
+    std::vector<double>   m_lx, m_ly, m_lz, m_ux, m_uy, m_uz; // node bounds
+
+    // tree order. A sphere's center is in m_ax, m_ay, m_az and its
+    // radius in m_bx, a box's corners are a and b.
+    std::vector<uint32_t> m_order; // the primitive index in tree order
+    std::vector<double>   m_ax, m_ay, m_az, m_bx, m_by, m_bz;
+
+  };
+
+} // end namespace Coords
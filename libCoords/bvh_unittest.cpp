@@ -0,0 +1,373 @@
+// ================================================================
+// Filename:    bvh_unittest.cpp
+// Description: This is the gtest unittest of the bounding volume
+//              hierarchy.
+//
+// Author:      L.R. McFarland, lrm@starbug.com
+// Created:     2026 Oct 18
+// Language:    C++
+//
+// See also: http://code.google.com/p/googletest/wiki/Primer
+//
+//  Coordinates is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  Coordinates is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with Coordinates.  If not, see <http://www.gnu.org/licenses/>.
+// ================================================================
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <angle.h>
+#include <Cartesian.h>
+#include <bvh.h>
+
+
+namespace {
+
+  const double s_infinity(std::numeric_limits<double>::infinity());
+
+  // the quadratic formula, the entry at t >= 0 or infinity
+  double sphereEntry(const Coords::Cartesian& o, const Coords::Cartesian& d,
+		     const Coords::Cartesian& c, const double& r) {
+    const Coords::Cartesian f(o - c);
+    const double a(d*d), b(f*d), e(f*f - r*r);
+    const double disc(b*b - a*e);
+    if (disc < 0)
+      return s_infinity;
+    const double t1((-b + std::sqrt(disc))/a);
+    if (t1 < 0)
+      return s_infinity;
+    return std::max((-b - std::sqrt(disc))/a, 0.0);
+  }
+
+  double boxEntry(const Coords::Cartesian& o, const Coords::Cartesian& d,
+		  const Coords::Cartesian& l, const Coords::Cartesian& u) {
+    double near(0), far(s_infinity);
+    const double os[3] = {o.x(), o.y(), o.z()}, ds[3] = {d.x(), d.y(), d.z()};
+    const double ls[3] = {l.x(), l.y(), l.z()}, us[3] = {u.x(), u.y(), u.z()};
+    for (int k = 0; k < 3; ++k) {
+      const double a((ls[k] - os[k])/ds[k]), b((us[k] - os[k])/ds[k]);
+      near = std::max(near, std::min(a, b));
+      far = std::min(far, std::max(a, b));
+    }
+    return near <= far ? near : s_infinity;
+  }
+
+  // --------------------------
+  // ----- random scenes -----
+  // --------------------------
+
+  class RandomBvh : public ::testing::Test {
+  protected:
+
+    enum {s_spheres = 2000, s_boxes = 500, s_rays = 4000};
+
+    virtual void SetUp() {
+      std::mt19937 generator(12345);
+      std::uniform_real_distribution<double> uniform(-1, 1);
+      std::uniform_real_distribution<double> size(0.001, 0.03);
+      for (size_t i = 0; i < s_spheres; ++i) {
+	centers.push_back(Coords::Cartesian(uniform(generator), uniform(generator), uniform(generator)));
+	radii.push_back(size(generator));
+      }
+      for (size_t i = 0; i < s_boxes; ++i) {
+	const Coords::Cartesian corner(uniform(generator), uniform(generator), uniform(generator));
+	lowers.push_back(corner);
+	uppers.push_back(corner + Coords::Cartesian(size(generator), size(generator), size(generator)));
+      }
+      // from one side, fanned out, so neighbours in a packet are
+      // coherent
+      for (size_t i = 0; i < s_rays; ++i) {
+	const Coords::Cartesian o(-2, 0.1*uniform(generator), 0.1*uniform(generator));
+	const Coords::Cartesian d(1, 0.5*uniform(generator), 0.5*uniform(generator));
+	origins.insert(origins.end(), {o.x(), o.y(), o.z()});
+	directions.insert(directions.end(), {d.x(), d.y(), d.z()});
+      }
+      a_tree.build(centers.data(), radii.data(), s_spheres, lowers.data(), uppers.data(), s_boxes);
+    }
+
+    // the nearest hit of ray i by brute force
+    void bruteForce(const size_t& i, size_t& an_index, double& a_distance) const {
+      const Coords::Cartesian o(origins[3*i], origins[3*i + 1], origins[3*i + 2]);
+      const Coords::Cartesian d(directions[3*i], directions[3*i + 1], directions[3*i + 2]);
+      an_index = Coords::bvh::s_miss;
+      a_distance = s_infinity;
+      for (size_t p = 0; p < s_spheres + s_boxes; ++p) {
+	const double t(p < s_spheres ? sphereEntry(o, d, centers[p], radii[p])
+		       : boxEntry(o, d, lowers[p - s_spheres], uppers[p - s_spheres]));
+	if (t < a_distance) {
+	  a_distance = t;
+	  an_index = p;
+	}
+      }
+    }
+
+    std::vector<Coords::Cartesian> centers, lowers, uppers;
+    std::vector<double> radii, origins, directions;
+    Coords::bvh a_tree;
+
+  };
+
+  TEST_F(RandomBvh, IntersectMatchesBruteForce) {
+    EXPECT_EQ(size_t(s_spheres + s_boxes), a_tree.size());
+    EXPECT_EQ(size_t(s_spheres), a_tree.spheres());
+    EXPECT_EQ(size_t(s_boxes), a_tree.boxes());
+
+    std::vector<size_t> indices(s_rays);
+    std::vector<double> distances(s_rays);
+    a_tree.intersect(origins.data(), directions.data(), s_rays, indices.data(), distances.data());
+
+    size_t hits(0);
+    for (size_t i = 0; i < s_rays; ++i) {
+      size_t an_index;
+      double a_distance;
+      bruteForce(i, an_index, a_distance);
+      ASSERT_EQ(an_index, indices[i]) << i;
+      if (an_index == Coords::bvh::s_miss) {
+	EXPECT_EQ(s_infinity, distances[i]);
+	continue;
+      }
+      ++hits;
+      EXPECT_NEAR(a_distance, distances[i], 1e-12) << i;
+
+      // and one ray at a time
+      size_t one_index;
+      double one_distance;
+      EXPECT_TRUE(a_tree.intersect(Coords::Cartesian(origins[3*i], origins[3*i + 1], origins[3*i + 2]),
+				   Coords::Cartesian(directions[3*i], directions[3*i + 1], directions[3*i + 2]),
+				   one_index, one_distance));
+      EXPECT_EQ(indices[i], one_index);
+      EXPECT_EQ(distances[i], one_distance);
+    }
+    EXPECT_GT(hits, size_t(s_rays/4));
+    EXPECT_LT(hits, size_t(s_rays));
+  }
+
+  TEST_F(RandomBvh, OccludedMatchesBruteForce) {
+    // segments of the rays, some ending short of their first hit
+    std::vector<double> ends(origins.size());
+    for (size_t i = 0; i < ends.size(); ++i)
+      ends[i] = origins[i] + 1.6*directions[i];
+    bool blocked[s_rays];
+    a_tree.occluded(origins.data(), ends.data(), s_rays, blocked);
+
+    size_t count(0);
+    for (size_t i = 0; i < s_rays; ++i) {
+      size_t an_index;
+      double a_distance;
+      bruteForce(i, an_index, a_distance);
+      EXPECT_EQ(a_distance <= 1.6, blocked[i]) << i;
+      EXPECT_EQ(blocked[i], a_tree.occluded(Coords::Cartesian(origins[3*i], origins[3*i + 1], origins[3*i + 2]),
+					    Coords::Cartesian(ends[3*i], ends[3*i + 1], ends[3*i + 2])));
+      count += blocked[i];
+    }
+    EXPECT_GT(count, size_t(0));
+    EXPECT_LT(count, size_t(s_rays));
+  }
+
+  TEST_F(RandomBvh, Refit) {
+    // move and grow the spheres, then refit
+    for (size_t i = 0; i < s_spheres; ++i) {
+      centers[i] += Coords::Cartesian(0.05, -0.02, 0.01);
+      radii[i] *= 1.2;
+    }
+    a_tree.refit(centers.data(), radii.data(), lowers.data(), uppers.data());
+
+    Coords::bvh rebuilt;
+    rebuilt.build(centers.data(), radii.data(), s_spheres, lowers.data(), uppers.data(), s_boxes);
+
+    std::vector<size_t> a(s_rays), b(s_rays);
+    std::vector<double> s(s_rays), t(s_rays);
+    a_tree.intersect(origins.data(), directions.data(), s_rays, a.data(), s.data());
+    rebuilt.intersect(origins.data(), directions.data(), s_rays, b.data(), t.data());
+    EXPECT_EQ(a, b);
+    EXPECT_EQ(s, t);
+    for (size_t i = 0; i < s_rays; i += 37) {
+      size_t an_index;
+      double a_distance;
+      bruteForce(i, an_index, a_distance);
+      EXPECT_EQ(an_index, a[i]) << i;
+    }
+
+    Coords::Cartesian lower, upper;
+    a_tree.bounds(lower, upper);
+    rebuilt.bounds(lower, upper);
+    Coords::Cartesian another_lower, another_upper;
+    a_tree.bounds(another_lower, another_upper);
+    EXPECT_EQ(lower, another_lower);
+    EXPECT_EQ(upper, another_upper);
+  }
+
+  // ------------------------
+  // ----- fixed scenes -----
+  // ------------------------
+
+  TEST(FixedBvh, Simple) {
+    const Coords::Cartesian centers[] = {Coords::Cartesian(0, 0, 0), Coords::Cartesian(10, 0, 0)};
+    const double radii[] = {1, 2};
+    const Coords::Cartesian lowers[] = {Coords::Cartesian(4, -1, -1)};
+    const Coords::Cartesian uppers[] = {Coords::Cartesian(5, 1, 1)};
+    Coords::bvh a_tree(1);
+    a_tree.build(centers, radii, 2, lowers, uppers, 1);
+    EXPECT_EQ(size_t(3), a_tree.size());
+
+    size_t an_index;
+    double a_distance;
+    EXPECT_TRUE(a_tree.intersect(Coords::Cartesian(-5, 0, 0), Coords::Ux, an_index, a_distance));
+    EXPECT_EQ(size_t(0), an_index);
+    EXPECT_EQ(4, a_distance);
+
+    // in units of the direction
+    EXPECT_TRUE(a_tree.intersect(Coords::Cartesian(-5, 0, 0), Coords::Cartesian(2, 0, 0), an_index, a_distance));
+    EXPECT_EQ(2, a_distance);
+
+    // from inside the first sphere, which it hits at once
+    EXPECT_TRUE(a_tree.intersect(Coords::Cartesian(0.5, 0, 0), Coords::Ux, an_index, a_distance));
+    EXPECT_EQ(size_t(0), an_index);
+    EXPECT_EQ(0, a_distance);
+
+    // between them, the box then the second sphere
+    EXPECT_TRUE(a_tree.intersect(Coords::Cartesian(2, 0, 0), Coords::Ux, an_index, a_distance));
+    EXPECT_EQ(size_t(2), an_index);
+    EXPECT_EQ(2, a_distance);
+    EXPECT_TRUE(a_tree.intersect(Coords::Cartesian(6, 0.5, 0), Coords::Ux, an_index, a_distance));
+    EXPECT_EQ(size_t(1), an_index);
+    EXPECT_NEAR(4 - std::sqrt(3.75), a_distance, 1e-15);
+
+    // missing and pointing away
+    EXPECT_FALSE(a_tree.intersect(Coords::Cartesian(-5, 3, 0), Coords::Ux, an_index, a_distance));
+    EXPECT_EQ(Coords::bvh::s_miss, an_index);
+    EXPECT_EQ(s_infinity, a_distance);
+    EXPECT_FALSE(a_tree.intersect(Coords::Cartesian(-5, 0, 0), -Coords::Ux, an_index, a_distance));
+
+    // lines of sight
+    EXPECT_FALSE(a_tree.occluded(Coords::Cartesian(-5, 0, 0), Coords::Cartesian(-1.5, 0, 0)));
+    EXPECT_TRUE(a_tree.occluded(Coords::Cartesian(-5, 0, 0), Coords::Cartesian(-1, 0, 0)));
+    EXPECT_TRUE(a_tree.occluded(Coords::Cartesian(2, 0, 0), Coords::Cartesian(7, 0, 0)));
+    EXPECT_FALSE(a_tree.occluded(Coords::Cartesian(2, 0, 3), Coords::Cartesian(7, 0, 3)));
+
+    Coords::Cartesian lower, upper;
+    a_tree.bounds(lower, upper);
+    EXPECT_EQ(Coords::Cartesian(-1, -2, -2), lower);
+    EXPECT_EQ(Coords::Cartesian(12, 2, 2), upper);
+  }
+
+  TEST(FixedBvh, FaceGrazing) {
+    // rays in the face planes of the unit box, which is also the root
+    const Coords::Cartesian lowers[] = {Coords::Cartesian(0, 0, 0)};
+    const Coords::Cartesian uppers[] = {Coords::Cartesian(1, 1, 1)};
+    Coords::bvh a_tree;
+    a_tree.build(0, 0, 0, lowers, uppers, 1);
+
+    const double origins[] = {0, -5, 0.5,   1, -5, 0.5,   0.5, -5, 0.5,   0.5, -5, 1,   0, -5, 0,
+			      1.5, -5, 0.5};
+    const double directions[] = {0, 1, 0,   0, 1, 0,   0, 1, 0,   0, 1, 0,   0, 1, 0,
+				 0, 1, 0};
+    const size_t n(6);
+    size_t an_index;
+    double a_distance;
+    for (size_t i(0); i < n - 1; ++i) {
+      const Coords::Cartesian an_origin(origins[3*i], origins[3*i + 1], origins[3*i + 2]);
+      const Coords::Cartesian a_direction(directions[3*i], directions[3*i + 1], directions[3*i + 2]);
+      EXPECT_TRUE(a_tree.intersect(an_origin, a_direction, an_index, a_distance)) << i;
+      EXPECT_EQ(size_t(0), an_index);
+      EXPECT_EQ(5, a_distance);
+      EXPECT_TRUE(a_tree.occluded(an_origin, an_origin + 10*a_direction)) << i;
+    }
+    EXPECT_FALSE(a_tree.intersect(Coords::Cartesian(1.5, -5, 0.5), Coords::Uy, an_index, a_distance));
+
+    size_t indices[n];
+    double distances[n];
+    a_tree.intersect(origins, directions, n, indices, distances);
+    for (size_t i(0); i < n - 1; ++i) {
+      EXPECT_EQ(size_t(0), indices[i]) << i;
+      EXPECT_EQ(5, distances[i]) << i;
+    }
+    EXPECT_EQ(Coords::bvh::s_miss, indices[n - 1]);
+
+    // from the face plane, not towards it
+    EXPECT_TRUE(a_tree.intersect(Coords::Cartesian(0, 0.5, 0.5), Coords::Uy, an_index, a_distance));
+    EXPECT_EQ(0, a_distance);
+  }
+
+  TEST(FixedBvh, Errors) {
+    EXPECT_THROW(Coords::bvh(0), Coords::Error);
+
+    Coords::bvh a_tree;
+    const Coords::Cartesian centers[] = {Coords::Cartesian(0, 0, 0)};
+    const double negative[] = {-1};
+    EXPECT_THROW(a_tree.build(centers, negative, 1), Coords::Error);
+    const double nan[] = {std::numeric_limits<double>::quiet_NaN()};
+    EXPECT_THROW(a_tree.build(centers, nan, 1), Coords::Error);
+    const Coords::Cartesian lowers[] = {Coords::Cartesian(0, 0, 1)};
+    const Coords::Cartesian uppers[] = {Coords::Cartesian(1, 1, 0)};
+    EXPECT_THROW(a_tree.build(centers, 0, 0, lowers, uppers, 1), Coords::Error);
+
+    // empty
+    a_tree.build(0, 0, 0);
+    EXPECT_EQ(size_t(0), a_tree.size());
+    size_t an_index;
+    double a_distance;
+    EXPECT_FALSE(a_tree.intersect(Coords::Cartesian(0, 0, 0), Coords::Ux, an_index, a_distance));
+    Coords::Cartesian lower, upper;
+    EXPECT_THROW(a_tree.bounds(lower, upper), Coords::Error);
+
+    const double radii[] = {1};
+    a_tree.build(centers, radii, 1);
+    EXPECT_THROW(a_tree.intersect(Coords::Ux, Coords::Cartesian(0, 0, 0), an_index, a_distance), Coords::Error);
+    EXPECT_THROW(a_tree.occluded(Coords::Ux, Coords::Ux), Coords::Error);
+    EXPECT_THROW(a_tree.refit(centers, negative), Coords::Error);
+  }
+
+  TEST(FixedBvh, ThreadsMatchSerial) {
+    // enough spheres for the subtrees to be built in parallel
+    const size_t n(100000);
+    std::mt19937 generator(54321);
+    std::uniform_real_distribution<double> uniform(-1, 1);
+    std::vector<Coords::Cartesian> centers;
+    std::vector<double> radii(n, 0.002), origins, directions;
+    for (size_t i = 0; i < n; ++i)
+      centers.push_back(Coords::Cartesian(uniform(generator), uniform(generator), uniform(generator)));
+    for (size_t i = 0; i < 20000; ++i) {
+      origins.insert(origins.end(), {0, 0, -3});
+      directions.insert(directions.end(), {0.3*uniform(generator), 0.3*uniform(generator), 1});
+    }
+
+    Coords::bvh a_tree, serial;
+    a_tree.threads(4);
+    serial.threads(1);
+    a_tree.build(centers.data(), radii.data(), n);
+    serial.build(centers.data(), radii.data(), n);
+    EXPECT_EQ(serial.nodes(), a_tree.nodes());
+
+    const size_t rays(origins.size()/3);
+    std::vector<size_t> a(rays), b(rays);
+    std::vector<double> s(rays), t(rays);
+    a_tree.intersect(origins.data(), directions.data(), rays, a.data(), s.data());
+    serial.intersect(origins.data(), directions.data(), rays, b.data(), t.data());
+    EXPECT_EQ(a, b);
+    EXPECT_EQ(s, t);
+    EXPECT_GT(std::count(a.begin(), a.end(), Coords::bvh::s_miss), 0);
+    EXPECT_LT(std::count(a.begin(), a.end(), Coords::bvh::s_miss), long(rays));
+  }
+
+} // end anonymous namespace
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,348 @@
+// ==================================================================
+// Filename:    celllist.cpp
+//
+// Description: Implements the cell list neighbour search.
+//
+// Author:      L.R. McFarland
+// Created:     2026 Oct 18
+// Language:    C++
+//
+//  Coordinates is free software: you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License as
+//  published by the Free Software Foundation, either version 3 of the
+//  License, or (at your option) any later version.
+//
+//  Coordinates is distributed in the hope that it will be useful, but
+//  WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with Coordinates.  If not, see <http://www.gnu.org/licenses/>.
+// ==================================================================
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <mutex>
+
+#include <celllist.h>
+#include <utils.h>
+
+namespace {
+
+  // 21 bits a coordinate, as the Morton keys
+  const int64_t s_cells(int64_t(1) << 21);
+
+  // cells a pairs() chunk
+  const size_t s_grain(1024);
+
+  // 1/cell size, the cells a little larger so rounding in the bins
+  // of two points a cell size apart can not put them two cells apart.
+  inline double binScale(const double& a_cell_size) {
+    return 1/(a_cell_size*(1 + 1e-9));
+  }
+
+  // Fibonacci hashing, the high bits of the product are the well mixed ones
+  inline uint64_t hash(const uint64_t& a_key) {
+    return (a_key*0x9e3779b97f4a7c15ULL) >> 32;
+  }
+
+  // the 13 neighbours after (0, 0, 0) in (dx, dy, dz) order. The other
+  // 13 see this cell as one of theirs.
+  const int s_half_shell[13][3] = {
+    {0, 0, 1},
+    {0, 1, -1}, {0, 1, 0}, {0, 1, 1},
+    {1, -1, -1}, {1, -1, 0}, {1, -1, 1},
+    {1, 0, -1}, {1, 0, 0}, {1, 0, 1},
+    {1, 1, -1}, {1, 1, 0}, {1, 1, 1}
+  };
+
+} // end anonymous namespace
+
+
+// ------------------------
+// ----- constructors -----
+// ------------------------
+
+Coords::cellList::cellList(const double& a_cutoff, const double& a_skin)
+  : m_cutoff(a_cutoff), m_skin(a_skin), m_threads(0), m_drift(0), m_mask(0)
+{
+  if (!(a_cutoff > 0 && a_cutoff < std::numeric_limits<double>::infinity()))
+    throw Error("cell list cutoff must be positive");
+  if (!(a_skin >= 0 && a_skin < std::numeric_limits<double>::infinity()))
+    throw Error("cell list skin must not be negative");
+  for (int k = 0; k < 3; ++k) {
+    m_origin[k] = 0;
+    m_extent[k] = -1;
+  }
+}
+
+
+// -----------------
+// ----- build -----
+// -----------------
+
+void Coords::cellList::build(const double* a_x, const double* a_y, const double* a_z, const size_t& a_size) {
+
+  if (a_size >= std::numeric_limits<uint32_t>::max())
+    throw Error("cell list has too many points");
+
+  m_drift = 0;
+  m_cells.clear();
+  m_table.clear();
+  m_mask = 0;
+  for (int k = 0; k < 3; ++k) {
+    m_origin[k] = 0;
+    m_extent[k] = -1;
+  }
+
+  m_x.resize(a_size);
+  m_y.resize(a_size);
+  m_z.resize(a_size);
+  m_order.resize(a_size);
+  if (a_size == 0) {
+    m_x0.clear();
+    m_y0.clear();
+    m_z0.clear();
+    return;
+  }
+
+  // the bounds
+  std::mutex bounds_mutex;
+  double lo[3] = {a_x[0], a_y[0], a_z[0]};
+  parallelFor(a_size, [&] (const size_t& a_begin, const size_t& a_end) {
+      double chunk_lo[3] = {a_x[a_begin], a_y[a_begin], a_z[a_begin]};
+      for (size_t i = a_begin; i < a_end; ++i) {
+	chunk_lo[0] = std::min(chunk_lo[0], a_x[i]);
+	chunk_lo[1] = std::min(chunk_lo[1], a_y[i]);
+	chunk_lo[2] = std::min(chunk_lo[2], a_z[i]);
+      }
+      std::lock_guard<std::mutex> lock(bounds_mutex);
+      for (int k = 0; k < 3; ++k)
+	lo[k] = std::min(lo[k], chunk_lo[k]);
+    }, m_threads);
+  for (int k = 0; k < 3; ++k)
+    m_origin[k] = lo[k];
+
+  // the cells' Morton keys, sorted
+  const double inverse(binScale(cellSize()));
+  std::vector<std::pair<uint64_t, size_t> > keyed(a_size);
+  parallelFor(a_size, [&] (const size_t& a_begin, const size_t& a_end) {
+      for (size_t i = a_begin; i < a_end; ++i) {
+	const double fx(std::floor((a_x[i] - lo[0])*inverse));
+	const double fy(std::floor((a_y[i] - lo[1])*inverse));
+	const double fz(std::floor((a_z[i] - lo[2])*inverse));
+	if (!(fx < s_cells && fy < s_cells && fz < s_cells)) // and not NaN
+	  throw Error("cell list points span more than 2^21 cells");
+	keyed[i] = std::make_pair(mortonKey(uint64_t(fx), uint64_t(fy), uint64_t(fz)), i);
+      }
+    }, m_threads);
+  parallelSort(keyed, m_threads);
+
+  parallelFor(a_size, [&] (const size_t& a_begin, const size_t& a_end) {
+      for (size_t k = a_begin; k < a_end; ++k) {
+	const size_t i(keyed[k].second);
+	m_order[k] = i;
+	m_x[k] = a_x[i];
+	m_y[k] = a_y[i];
+	m_z[k] = a_z[i];
+      }
+    }, m_threads);
+  m_x0 = m_x;
+  m_y0 = m_y;
+  m_z0 = m_z;
+
+  // the occupied cells
+  for (size_t k = 0; k < a_size; ++k) {
+    if (k == 0 || keyed[k].first != keyed[k - 1].first) {
+      cell a_cell;
+      a_cell.m_key = keyed[k].first;
+      a_cell.m_ix = int32_t(std::floor((m_x[k] - lo[0])*inverse));
+      a_cell.m_iy = int32_t(std::floor((m_y[k] - lo[1])*inverse));
+      a_cell.m_iz = int32_t(std::floor((m_z[k] - lo[2])*inverse));
+      a_cell.m_begin = uint32_t(k);
+      m_cells.push_back(a_cell);
+      m_extent[0] = std::max(m_extent[0], int64_t(a_cell.m_ix));
+      m_extent[1] = std::max(m_extent[1], int64_t(a_cell.m_iy));
+      m_extent[2] = std::max(m_extent[2], int64_t(a_cell.m_iz));
+    }
+    m_cells.back().m_end = uint32_t(k + 1);
+  }
+
+  // at most half full
+  size_t table_size(16);
+  while (table_size < 2*m_cells.size())
+    table_size *= 2;
+  m_table.assign(table_size, -1);
+  m_mask = table_size - 1;
+  for (size_t c = 0; c < m_cells.size(); ++c) {
+    uint64_t slot(hash(m_cells[c].m_key) & m_mask);
+    while (m_table[slot] >= 0)
+      slot = (slot + 1) & m_mask;
+    m_table[slot] = long(c);
+  }
+}
+
+bool Coords::cellList::update(const double* a_x, const double* a_y, const double* a_z) {
+
+  std::mutex drift_mutex;
+  double drift2(0);
+  parallelFor(size(), [&] (const size_t& a_begin, const size_t& a_end) {
+      double chunk_drift2(0);
+      for (size_t k = a_begin; k < a_end; ++k) {
+	const size_t i(m_order[k]);
+	m_x[k] = a_x[i];
+	m_y[k] = a_y[i];
+	m_z[k] = a_z[i];
+	const double dx(m_x[k] - m_x0[k]);
+	const double dy(m_y[k] - m_y0[k]);
+	const double dz(m_z[k] - m_z0[k]);
+	chunk_drift2 = std::max(chunk_drift2, dx*dx + dy*dy + dz*dz);
+      }
+      std::lock_guard<std::mutex> lock(drift_mutex);
+      drift2 = std::max(drift2, chunk_drift2);
+    }, m_threads);
+
+  m_drift = std::sqrt(drift2);
+  if (!(m_drift <= 0.5*m_skin)) {
+    build(a_x, a_y, a_z, size());
+    return true;
+  }
+  return false;
+}
+
+
+// -------------------
+// ----- queries -----
+// -------------------
+
+long Coords::cellList::find(const int64_t& an_ix, const int64_t& an_iy, const int64_t& an_iz) const {
+  if (an_ix < 0 || an_ix > m_extent[0] || an_iy < 0 || an_iy > m_extent[1] || an_iz < 0 || an_iz > m_extent[2])
+    return -1;
+  const uint64_t key(mortonKey(an_ix, an_iy, an_iz));
+  for (uint64_t slot = hash(key) & m_mask; m_table[slot] >= 0; slot = (slot + 1) & m_mask)
+    if (m_cells[m_table[slot]].m_key == key)
+      return m_table[slot];
+  return -1;
+}
+
+void Coords::cellList::cellPairs(const size_t& a_first, const size_t& a_last, const double& a_radius2,
+				 std::vector<pair>& some_pairs) const {
+
+  for (size_t c = a_first; c < a_last; ++c) {
+
+    const cell& a_cell(m_cells[c]);
+
+    for (size_t i = a_cell.m_begin; i < a_cell.m_end; ++i) {
+      for (size_t j = i + 1; j < a_cell.m_end; ++j) {
+	const double dx(m_x[j] - m_x[i]), dy(m_y[j] - m_y[i]), dz(m_z[j] - m_z[i]);
+	if (dx*dx + dy*dy + dz*dz <= a_radius2)
+	  some_pairs.push_back(std::minmax(m_order[i], m_order[j]));
+      }
+    }
+
+    for (int n = 0; n < 13; ++n) {
+      const long other(find(a_cell.m_ix + s_half_shell[n][0],
+			    a_cell.m_iy + s_half_shell[n][1],
+			    a_cell.m_iz + s_half_shell[n][2]));
+      if (other < 0)
+	continue;
+      const cell& b_cell(m_cells[other]);
+      for (size_t i = a_cell.m_begin; i < a_cell.m_end; ++i) {
+	for (size_t j = b_cell.m_begin; j < b_cell.m_end; ++j) {
+	  const double dx(m_x[j] - m_x[i]), dy(m_y[j] - m_y[i]), dz(m_z[j] - m_z[i]);
+	  if (dx*dx + dy*dy + dz*dz <= a_radius2)
+	    some_pairs.push_back(std::minmax(m_order[i], m_order[j]));
+	}
+      }
+    }
+
+  }
+}
+
+std::vector<Coords::cellList::pair> Coords::cellList::pairs(const double& a_radius) const {
+
+  if (!(a_radius >= 0 && a_radius <= m_cutoff))
+    throw Error("cell list pairs radius must be in [0, cutoff]");
+
+  // each chunk collects its own, joined in cell order
+  std::mutex chunks_mutex;
+  std::map<size_t, std::vector<pair> > chunks;
+  parallelFor(m_cells.size(), [&] (const size_t& a_begin, const size_t& a_end) {
+      std::vector<pair> some_pairs;
+      cellPairs(a_begin, a_end, a_radius*a_radius, some_pairs);
+      std::lock_guard<std::mutex> lock(chunks_mutex);
+      chunks[a_begin].swap(some_pairs);
+    }, m_threads, s_grain);
+
+  if (chunks.size() == 1)
+    return std::move(chunks.begin()->second);
+
+  size_t total(0);
+  for (std::map<size_t, std::vector<pair> >::const_iterator it = chunks.begin(); it != chunks.end(); ++it)
+    total += it->second.size();
+  std::vector<pair> all_pairs;
+  all_pairs.reserve(total);
+  for (std::map<size_t, std::vector<pair> >::const_iterator it = chunks.begin(); it != chunks.end(); ++it)
+    all_pairs.insert(all_pairs.end(), it->second.begin(), it->second.end());
+  return all_pairs;
+}
+
+std::vector<size_t> Coords::cellList::neighbours(const Cartesian& a_point, const double& a_radius) const {
+
+  if (!(a_radius >= 0))
+    throw Error("cell list radius must not be negative");
+
+  std::vector<size_t> some_neighbours;
+  if (m_cells.empty())
+    return some_neighbours;
+
+  const double radius2(a_radius*a_radius);
+  const double px(a_point.x()), py(a_point.y()), pz(a_point.z());
+
+  // a point within a_radius now was within a_radius + m_drift when
+  // it was binned
+  const double reach(a_radius + m_drift);
+  const double inverse(binScale(cellSize()));
+  const double point[3] = {px, py, pz};
+  int64_t lo[3], hi[3];
+  double box(1);
+  for (int k = 0; k < 3; ++k) {
+    const double first(std::max(0.0, std::floor((point[k] - reach - m_origin[k])*inverse)));
+    const double last(std::min(double(m_extent[k]), std::floor((point[k] + reach - m_origin[k])*inverse)));
+    if (!(first <= last)) // outside, or NaN
+      return some_neighbours;
+    lo[k] = int64_t(first);
+    hi[k] = int64_t(last);
+    box *= last - first + 1;
+  }
+
+  if (box > m_cells.size()) {
+    // a large radius, every point is cheaper than every cell in the box
+    for (size_t k = 0; k < size(); ++k) {
+      const double dx(m_x[k] - px), dy(m_y[k] - py), dz(m_z[k] - pz);
+      if (dx*dx + dy*dy + dz*dz <= radius2)
+	some_neighbours.push_back(m_order[k]);
+    }
+  } else {
+    for (int64_t ix = lo[0]; ix <= hi[0]; ++ix) {
+      for (int64_t iy = lo[1]; iy <= hi[1]; ++iy) {
+	for (int64_t iz = lo[2]; iz <= hi[2]; ++iz) {
+	  const long c(find(ix, iy, iz));
+	  if (c < 0)
+	    continue;
+	  for (size_t k = m_cells[c].m_begin; k < m_cells[c].m_end; ++k) {
+	    const double dx(m_x[k] - px), dy(m_y[k] - py), dz(m_z[k] - pz);
+	    if (dx*dx + dy*dy + dz*dz <= radius2)
+	      some_neighbours.push_back(m_order[k]);
+	  }
+	}
+      }
+    }
+  }
+
+  std::sort(some_neighbours.begin(), some_neighbours.end());
+  return some_neighbours;
+}
@@ -0,0 +1,135 @@
+// ================================================================
+// Filename:    celllist.h
+//
+// Description: This defines a uniform grid, cell list, index over
+//              Cartesian points for all pairs within a distance and
+//              radius queries.
+//
+// Author:      L.R. McFarland
+// Created:     2026 Oct 18
+// Language:    C++
+//
+//  Coords is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  Coords is distributed in the hope that it will be useful, but
+//  WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with Coords.  If not, see <http://www.gnu.org/licenses/>.
+// ================================================================
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include <angle.h>
+#include <Cartesian.h>
+#include <parallel.h>
+
+namespace Coords {
+
+  // ====================
+  // ===== cellList =====
+  // ====================
+
+  // The points are binned in cubes of side cutoff + skin, sorted by
+  // the Morton key of their cell so a cell's points are contiguous
+  // and neighbouring cells are mostly close in memory. The occupied
+  // cells are found through a hash of their keys, so the grid is not
+  // stored and can be as sparse as the points are.
+  //
+  // A pair within cutoff is in the same or adjacent cells. pairs()
+  // looks at each cell and the 13 neighbours ahead of it, so each
+  // pair is tested once.
+  //
+  // update() takes the moved points with out binning them again for
+  // as long as none has moved more than skin/2 since the last
+  // build(). Two points within cutoff now were then within
+  // cutoff + skin, so they are still in the same or adjacent cells.
+  // A larger skin rebuilds less often but tests more pairs.
+  //
+  // Thread safety: build() and update() modify the index. The const
+  // methods may be called from any number of threads.
+
+  class cellList {
+
+  public:
+
+    typedef std::pair<size_t, size_t> pair; // indices of the points, first < second
+
+    explicit cellList(const double& a_cutoff, const double& a_skin=0); // throws Error on a bad parameter
+
+    // implicit copy, move and dtor.
+
+    const double& cutoff() const   {return m_cutoff;}
+    const double& skin() const     {return m_skin;}
+    double        cellSize() const {return m_cutoff + m_skin;}
+
+    const size_t& threads() const           {return m_threads;}
+    void          threads(const size_t& a_threads) {m_threads = a_threads;} // 0 is hardwareThreads()
+
+    // ----- build -----
+
+    // a_size points, e.g. ParticleSystem x(), y(), z(). Throws Error
+    // if they span more than 2^21 cells on an axis.
+    void build(const double* a_x, const double* a_y, const double* a_z, const size_t& a_size);
+
+    // the same points in the same order as build(), moved. Returns
+    // true if it had to build() again.
+    bool update(const double* a_x, const double* a_y, const double* a_z);
+
+    size_t size() const  {return m_x.size();}
+    size_t cells() const {return m_cells.size();} // occupied
+
+    // ----- queries -----
+
+    // all the pairs with |r_i - r_j| <= a_radius, a_radius <= cutoff().
+    // Parallel over the cells. The order is the same for any number of
+    // threads, but is not sorted.
+    std::vector<pair> pairs(const double& a_radius) const;
+    std::vector<pair> pairs() const {return pairs(m_cutoff);}
+
+    // the points within a_radius of a_point, any radius, in ascending
+    // order.
+    std::vector<size_t> neighbours(const Cartesian& a_point, const double& a_radius) const;
+
+  private:
+
+    struct cell {
+      uint64_t m_key;
+      int32_t  m_ix, m_iy, m_iz;
+      uint32_t m_begin; // points [m_begin, m_end) in key order
+      uint32_t m_end;
+    };
+
+    // the index in m_cells of cell (ix, iy, iz), -1 if empty
+    long find(const int64_t& an_ix, const int64_t& an_iy, const int64_t& an_iz) const;
+
+    // appends the pairs of the cells [a_first, a_last) to some_pairs
+    void cellPairs(const size_t& a_first, const size_t& a_last, const double& a_radius2,
+		   std::vector<pair>& some_pairs) const;
+
+    double m_cutoff;
+    double m_skin;
+    size_t m_threads;
+
+    double  m_origin[3]; // the corner of cell (0, 0, 0)
+    int64_t m_extent[3]; // the last occupied cell on each axis
+    double  m_drift;     // the most any point has moved since build()
+
+    std::vector<double> m_x, m_y, m_z;    // key order, as of the last update()
+    std::vector<double> m_x0, m_y0, m_z0; // key order, as of the last build()
+    std::vector<size_t> m_order;          // the index of each point in the original order
+    std::vector<cell>   m_cells;          // occupied, key order
+    std::vector<long>   m_table;          // open addressing hash of m_cells, -1 is empty
+    uint64_t            m_mask;           // m_table.size() - 1
+
+  };
+
+} // end namespace Coords
@@ -0,0 +1,221 @@
+// ================================================================
+// Filename:    celllist_unittest.cpp
+// Description: This is the gtest unittest of the cell list
+//              neighbour search.
+//
+// Author:      L.R. McFarland, lrm@starbug.com
+// Created:     2026 Oct 18
+// Language:    C++
+//
+// See also: http://code.google.com/p/googletest/wiki/Primer
+//
+//  Coordinates is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  Coordinates is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with Coordinates.  If not, see <http://www.gnu.org/licenses/>.
+// ================================================================
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <angle.h>
+#include <Cartesian.h>
+#include <celllist.h>
+
+
+namespace {
+
+  typedef std::vector<Coords::cellList::pair> pairs;
+
+  // all pairs with (a - b).magnitude(), sorted
+  pairs bruteForce(const std::vector<double>& x, const std::vector<double>& y, const std::vector<double>& z,
+		   const double& a_radius) {
+    pairs some_pairs;
+    for (size_t i = 0; i < x.size(); ++i)
+      for (size_t j = i + 1; j < x.size(); ++j)
+	if ((Coords::Cartesian(x[i], y[i], z[i]) - Coords::Cartesian(x[j], y[j], z[j])).magnitude() <= a_radius)
+	  some_pairs.push_back(std::make_pair(i, j));
+    return some_pairs;
+  }
+
+  pairs sorted(pairs some_pairs) {
+    std::sort(some_pairs.begin(), some_pairs.end());
+    return some_pairs;
+  }
+
+  // ----------------------------
+  // ----- random points -----
+  // ----------------------------
+
+  class RandomCellList : public ::testing::Test {
+  protected:
+
+    enum {s_size = 3000};
+
+    virtual void SetUp() {
+      std::mt19937 generator(12345);
+      std::uniform_real_distribution<double> uniform(-1, 1);
+      for (size_t i = 0; i < s_size; ++i) {
+	x.push_back(uniform(generator));
+	y.push_back(uniform(generator));
+	z.push_back(2*uniform(generator));
+      }
+    }
+
+    // moves every point by up to a_step on each axis
+    void jiggle(const double& a_step) {
+      std::mt19937 generator(54321);
+      std::uniform_real_distribution<double> uniform(-a_step, a_step);
+      for (size_t i = 0; i < s_size; ++i) {
+	x[i] += uniform(generator);
+	y[i] += uniform(generator);
+	z[i] += uniform(generator);
+      }
+    }
+
+    std::vector<double> x, y, z;
+  };
+
+  TEST_F(RandomCellList, PairsMatchBruteForce) {
+    Coords::cellList a_list(0.1);
+    a_list.build(x.data(), y.data(), z.data(), s_size);
+    EXPECT_EQ(size_t(s_size), a_list.size());
+    EXPECT_LT(a_list.cells(), size_t(s_size));
+
+    const pairs some_pairs(a_list.pairs());
+    EXPECT_LT(size_t(100), some_pairs.size());
+    for (size_t k = 0; k < some_pairs.size(); ++k)
+      ASSERT_LT(some_pairs[k].first, some_pairs[k].second);
+    EXPECT_EQ(bruteForce(x, y, z, 0.1), sorted(some_pairs));
+    EXPECT_EQ(bruteForce(x, y, z, 0.05), sorted(a_list.pairs(0.05)));
+  }
+
+  TEST_F(RandomCellList, Neighbours) {
+    Coords::cellList a_list(0.1);
+    a_list.build(x.data(), y.data(), z.data(), s_size);
+
+    // small, across many cells, all and outside the points
+    const double radii[] = {0.1, 0.35, 10, 0.2};
+    const Coords::Cartesian points[] = {Coords::Cartesian(0.1, -0.2, 0.3), Coords::Cartesian(0.5, 0.5, -1.5),
+					Coords::Cartesian(), Coords::Cartesian(5, 0, 0)};
+    for (size_t k = 0; k < 4; ++k) {
+      std::vector<size_t> expected;
+      for (size_t i = 0; i < s_size; ++i)
+	if ((Coords::Cartesian(x[i], y[i], z[i]) - points[k]).magnitude() <= radii[k])
+	  expected.push_back(i);
+      EXPECT_EQ(expected, a_list.neighbours(points[k], radii[k])) << "radius " << radii[k];
+    }
+    EXPECT_EQ(size_t(s_size), a_list.neighbours(Coords::Cartesian(), 10).size());
+    EXPECT_TRUE(a_list.neighbours(Coords::Cartesian(5, 0, 0), 0.2).empty());
+  }
+
+  TEST_F(RandomCellList, UpdateWithinSkin) {
+    Coords::cellList a_list(0.1, 0.04);
+    a_list.build(x.data(), y.data(), z.data(), s_size);
+    const size_t cells(a_list.cells());
+
+    // two steps of at most sqrt(3)*0.005 < skin/2, the bins are kept
+    for (int step = 0; step < 2; ++step) {
+      jiggle(0.005);
+      EXPECT_FALSE(a_list.update(x.data(), y.data(), z.data()));
+      EXPECT_EQ(cells, a_list.cells());
+      EXPECT_EQ(bruteForce(x, y, z, 0.1), sorted(a_list.pairs()));
+      const Coords::Cartesian a_point(0.2, 0.1, 0);
+      std::vector<size_t> expected;
+      for (size_t i = 0; i < s_size; ++i)
+	if ((Coords::Cartesian(x[i], y[i], z[i]) - a_point).magnitude() <= 0.3)
+	  expected.push_back(i);
+      EXPECT_EQ(expected, a_list.neighbours(a_point, 0.3));
+    }
+
+    // further, it builds again
+    jiggle(0.02);
+    EXPECT_TRUE(a_list.update(x.data(), y.data(), z.data()));
+    EXPECT_EQ(bruteForce(x, y, z, 0.1), sorted(a_list.pairs()));
+    EXPECT_FALSE(a_list.update(x.data(), y.data(), z.data()));
+  }
+
+  TEST_F(RandomCellList, ThreadsMatchSerial) {
+    Coords::cellList serial(0.05);
+    serial.threads(1);
+    Coords::cellList parallel(serial);
+    parallel.threads(4);
+
+    // more than one pairs() chunk
+    std::vector<double> big_x, big_y, big_z;
+    for (int copy = 0; copy < 20; ++copy) {
+      for (size_t i = 0; i < s_size; ++i) {
+	big_x.push_back(x[i] + 3*copy);
+	big_y.push_back(y[i]);
+	big_z.push_back(z[i]);
+      }
+    }
+    serial.build(big_x.data(), big_y.data(), big_z.data(), big_x.size());
+    parallel.build(big_x.data(), big_y.data(), big_z.data(), big_x.size());
+    EXPECT_LT(size_t(2048), serial.cells());
+    EXPECT_EQ(serial.cells(), parallel.cells());
+    EXPECT_EQ(serial.pairs(), parallel.pairs());
+  }
+
+  // ---------------------------
+  // ----- fixed points -----
+  // ---------------------------
+
+  TEST(FixedCellList, Errors) {
+    EXPECT_THROW(Coords::cellList(0), Coords::Error);
+    EXPECT_THROW(Coords::cellList(-1), Coords::Error);
+    EXPECT_THROW(Coords::cellList(1, -1), Coords::Error);
+
+    Coords::cellList a_list(1, 0.5);
+    EXPECT_EQ(1.5, a_list.cellSize());
+    EXPECT_THROW(a_list.pairs(1.1), Coords::Error);
+    EXPECT_THROW(a_list.neighbours(Coords::Cartesian(), -1), Coords::Error);
+
+    // more than 2^21 cells across
+    std::vector<double> x = {0, 1e7}, y = {0, 0}, z = {0, 0};
+    EXPECT_THROW(a_list.build(x.data(), y.data(), z.data(), 2), Coords::Error);
+    std::vector<double> nan = {0, std::nan("")};
+    EXPECT_THROW(a_list.build(nan.data(), y.data(), z.data(), 2), Coords::Error);
+  }
+
+  TEST(FixedCellList, Empty) {
+    Coords::cellList a_list(1);
+    EXPECT_TRUE(a_list.pairs().empty());
+    EXPECT_TRUE(a_list.neighbours(Coords::Cartesian(), 1).empty());
+    a_list.build(0, 0, 0, 0);
+    EXPECT_EQ(size_t(0), a_list.size());
+    EXPECT_EQ(size_t(0), a_list.cells());
+    EXPECT_FALSE(a_list.update(0, 0, 0));
+    EXPECT_TRUE(a_list.pairs().empty());
+  }
+
+  TEST(FixedCellList, Boundaries) {
+    // duplicates, and pairs exactly a cutoff apart in adjacent cells
+    std::vector<double> x = {0, 0, 1, 2, 2, 0};
+    std::vector<double> y = {0, 0, 0, 0, 1, 1};
+    std::vector<double> z = {0, 0, 0, 0, 1, 1};
+    Coords::cellList a_list(1);
+    a_list.build(x.data(), y.data(), z.data(), x.size());
+    EXPECT_EQ(bruteForce(x, y, z, 1), sorted(a_list.pairs()));
+    EXPECT_EQ(bruteForce(x, y, z, 0), sorted(a_list.pairs(0)));
+    const std::vector<size_t> origin = {0, 1};
+    EXPECT_EQ(origin, a_list.neighbours(Coords::Cartesian(), 0));
+  }
+
+} // end anonymous namespace
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
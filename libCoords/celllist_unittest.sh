@@ -0,0 +1,10 @@
+#!/bin/bash
+#
+# Shell wrapper to set up gtest environment
+#
+#
+
+. ./setenv.sh
+
+./celllist_unittest "$@"
+
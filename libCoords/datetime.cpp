@@ -61,6 +61,7 @@ const double Coords::DateTime::s_LilianDate(2299160.5);
 const double Coords::DateTime::s_ModifiedJulianDate(2400000.5);
 const double Coords::DateTime::s_TruncatedJulianDate(2440000.5);
 const double Coords::DateTime::s_J2000(2451545.0);
+const double Coords::DateTime::s_UnixEpoch(2440587.5);
 const double Coords::DateTime::s_resolution(0.0001);
 
 Coords::DateTime::DateTime(const std::string& an_iso8601_time)
@@ -180,42 +181,6 @@ void Coords::DateTime::isValid(const std::string& an_iso8601_time) throw (Error)
 
 }
 
-// ----- copy constructor -----
-
-Coords::DateTime::DateTime(const Coords::DateTime& a) {
-  m_year = a.m_year;
-  m_month = a.m_month;
-  m_day = a.m_day;
-  m_hour = a.m_hour;
-  m_minute = a.m_minute;
-  m_second = a.m_second;
-  m_is_zulu = a.m_is_zulu;
-  m_timezone_hh = a.m_timezone_hh;
-  m_timezone_mm = a.m_timezone_mm;
-  m_has_timezone_colon = a.m_has_timezone_colon;
-  m_timezone = a.m_timezone;
-  m_is_leap_year = a.m_is_leap_year;
-}
-
-// ----- copy assignment -----
-
-Coords::DateTime& Coords::DateTime::operator=(const Coords::DateTime& rhs) {
-  if (this == &rhs) return *this;
-  m_year = rhs.m_year;
-  m_month = rhs.m_month;
-  m_day = rhs.m_day;
-  m_hour = rhs.m_hour;
-  m_minute = rhs.m_minute;
-  m_second = rhs.m_second;
-  m_is_zulu = rhs.m_is_zulu;
-  m_timezone_hh = rhs.m_timezone_hh;
-  m_timezone_mm = rhs.m_timezone_mm;
-  m_has_timezone_colon = rhs.m_has_timezone_colon;
-  m_timezone = rhs.m_timezone;
-  m_is_leap_year = rhs.m_is_leap_year;
-  return *this;
-}
-
 // ----- operators -----
 
 Coords::DateTime& Coords::DateTime::operator+=(const double& rhs) {
@@ -230,7 +195,8 @@ Coords::DateTime& Coords::DateTime::operator-=(const double& rhs) {
 
 Coords::DateTime Coords::operator+(const Coords::DateTime& lhs, const double& rhs) {
   Coords::DateTime temp(lhs);
-  return temp += rhs;
+  temp += rhs;
+  return temp;
 }
 
 Coords::DateTime Coords::operator+(const double& lhs, const Coords::DateTime& rhs) {
@@ -239,13 +205,138 @@ Coords::DateTime Coords::operator+(const double& lhs, const Coords::DateTime& rh
 
 Coords::DateTime Coords::operator-(const Coords::DateTime& lhs, const double& rhs) {
   Coords::DateTime temp(lhs);
-  return temp -= rhs;
+  temp -= rhs;
+  return temp;
 }
 
 double Coords::operator-(const Coords::DateTime& lhs, const Coords::DateTime& rhs) {
   return lhs.toJulianDate() - rhs.toJulianDate();
 }
 
+// ----- batch conversions -----
+
+void Coords::unixTime2JulianDate(const double* a_seconds, double* a_jdays, const size_t& a_size) {
+  for (size_t i = 0; i < a_size; ++i)
+    a_jdays[i] = a_seconds[i]/86400.0 + Coords::DateTime::s_UnixEpoch;
+}
+
+void Coords::JulianDate2unixTime(const double* a_jdays, double* a_seconds, const size_t& a_size) {
+  for (size_t i = 0; i < a_size; ++i)
+    a_seconds[i] = (a_jdays[i] - Coords::DateTime::s_UnixEpoch)*86400.0;
+}
+
+static const int64_t s_nanoseconds_per_day(86400000000000LL);
+static const int64_t s_maximum_unix_days(106750); // datetime64[ns] range with a day to spare
+
+void Coords::unixNanoseconds2JulianDate(const int64_t* a_nanoseconds, double* a_jdays, const size_t& a_size) {
+  // whole days and the fraction separately, so the nanoseconds are
+  // not rounded twice.
+  for (size_t i = 0; i < a_size; ++i) {
+    const int64_t ns(a_nanoseconds[i]);
+    if (ns == Coords::NaT) {
+      a_jdays[i] = NAN;
+      continue;
+    }
+    int64_t days(ns/s_nanoseconds_per_day);
+    int64_t remainder(ns % s_nanoseconds_per_day);
+    if (remainder < 0) {
+      remainder += s_nanoseconds_per_day;
+      --days;
+    }
+    a_jdays[i] = (days + Coords::DateTime::s_UnixEpoch) + static_cast<double>(remainder)/s_nanoseconds_per_day;
+  }
+}
+
+void Coords::JulianDate2unixNanoseconds(const double* a_jdays, int64_t* a_nanoseconds, const size_t& a_size) {
+  for (size_t i = 0; i < a_size; ++i) {
+    const double jdays(a_jdays[i] - Coords::DateTime::s_UnixEpoch); // exact near the epoch
+    const double days(floor(jdays));
+    if (!(fabs(days) <= s_maximum_unix_days)) { // and NaN
+      a_nanoseconds[i] = Coords::NaT;
+      continue;
+    }
+    a_nanoseconds[i] = static_cast<int64_t>(days)*s_nanoseconds_per_day +
+      llround((jdays - days)*s_nanoseconds_per_day);
+  }
+}
+
+// ----- binary records -----
+
+static const int32_t s_zulu_flag(1);
+static const int32_t s_timezone_hh_flag(2);
+static const int32_t s_timezone_colon_flag(4);
+static const int32_t s_timezone_mm_flag(8);
+
+void Coords::DateTime2binary(const DateTime* a_datetimes, char* a_buffer, const size_t& a_size) {
+  for (size_t i = 0; i < a_size; ++i) {
+    const Coords::DateTime& a_datetime(a_datetimes[i]);
+    char* a_record(a_buffer + i*DateTime_binary_size);
+
+    int32_t flags(0);
+    if (a_datetime.isZulu())
+      flags |= s_zulu_flag;
+    if (!a_datetime.timezoneHH().empty())
+      flags |= s_timezone_hh_flag;
+    if (a_datetime.hasTimezoneColon())
+      flags |= s_timezone_colon_flag;
+    if (!a_datetime.timezoneMM().empty())
+      flags |= s_timezone_mm_flag;
+
+    Coords::int2binary(a_datetime.year(), a_record);
+    Coords::int2binary(a_datetime.month(), a_record + 4);
+    Coords::int2binary(a_datetime.day(), a_record + 8);
+    Coords::int2binary(a_datetime.hour(), a_record + 12);
+    Coords::int2binary(a_datetime.minute(), a_record + 16);
+    Coords::int2binary(flags, a_record + 20);
+    Coords::double2binary(a_datetime.second(), a_record + 24);
+    Coords::double2binary(a_datetime.timezone(), a_record + 32);
+  }
+}
+
+void Coords::binary2DateTime(const char* a_buffer, DateTime* a_datetimes, const size_t& a_size) {
+  for (size_t i = 0; i < a_size; ++i) {
+    Coords::DateTime& a_datetime(a_datetimes[i]);
+    const char* a_record(a_buffer + i*DateTime_binary_size);
+
+    a_datetime.m_year = Coords::binary2int(a_record);
+    a_datetime.m_month = Coords::binary2int(a_record + 4);
+    a_datetime.m_day = Coords::binary2int(a_record + 8);
+    a_datetime.m_hour = Coords::binary2int(a_record + 12);
+    a_datetime.m_minute = Coords::binary2int(a_record + 16);
+    const int32_t flags(Coords::binary2int(a_record + 20));
+    a_datetime.m_second = Coords::binary2double(a_record + 24);
+    a_datetime.m_timezone = Coords::binary2double(a_record + 32);
+
+    a_datetime.m_is_leap_year = (a_datetime.m_year % 4 == 0 && a_datetime.m_year % 100 != 0) ||
+      a_datetime.m_year % 400 == 0;
+
+    a_datetime.m_is_zulu = flags & s_zulu_flag;
+    a_datetime.m_has_timezone_colon = flags & s_timezone_colon_flag;
+
+    // the regex only takes two digit hours and minutes
+    const double a_timezone(fabs(a_datetime.m_timezone));
+    const int tz_hh(static_cast<int>(a_timezone));
+    const int tz_mm(static_cast<int>(floor((a_timezone - tz_hh)*60 + 0.5)));
+
+    a_datetime.m_timezone_hh.clear();
+    a_datetime.m_timezone_mm.clear();
+
+    if (flags & s_timezone_hh_flag) {
+      std::stringstream hh;
+      hh << std::setw(2) << std::setfill('0') << tz_hh;
+      a_datetime.m_timezone_hh = hh.str();
+    }
+
+    if (flags & s_timezone_mm_flag) {
+      std::stringstream mm;
+      mm << std::setw(2) << std::setfill('0') << tz_mm;
+      a_datetime.m_timezone_mm = mm.str();
+    }
+
+    a_datetime.isValid();
+  }
+}
+
 // ----- timezone -----
 
 
@@ -661,6 +752,88 @@ void Coords::DateTime::fromModifiedJulianDateAPC(const double& jdays, const doub
 }
 
 
+// ----- as Unix time -----
+
+// days from 1970-01-01 in the proleptic Gregorian calendar, see
+// http://howardhinnant.github.io/date_algorithms.html
+
+static int64_t days_from_civil(int64_t a_year, const int& a_month, const int& a_day) {
+  a_year -= a_month <= 2;
+  const int64_t era((a_year >= 0 ? a_year : a_year - 399)/400);
+  const int64_t year_of_era(a_year - era*400);
+  const int64_t day_of_year((153*(a_month > 2 ? a_month - 3 : a_month + 9) + 2)/5 + a_day - 1);
+  const int64_t day_of_era(year_of_era*365 + year_of_era/4 - year_of_era/100 + day_of_year);
+  return era*146097 + day_of_era - 719468;
+}
+
+static void civil_from_days(int64_t a_days, int& a_year, int& a_month, int& a_day) {
+  a_days += 719468;
+  const int64_t era((a_days >= 0 ? a_days : a_days - 146096)/146097);
+  const int64_t day_of_era(a_days - era*146097);
+  const int64_t year_of_era((day_of_era - day_of_era/1460 + day_of_era/36524 - day_of_era/146096)/365);
+  const int64_t day_of_year(day_of_era - (365*year_of_era + year_of_era/4 - year_of_era/100));
+  const int64_t mp((5*day_of_year + 2)/153);
+  a_day = day_of_year - (153*mp + 2)/5 + 1;
+  a_month = mp < 10 ? mp + 3 : mp - 9;
+  a_year = year_of_era + era*400 + (a_month <= 2);
+}
+
+int64_t Coords::DateTime::toUnixNanoseconds() const {
+
+  const int64_t days(days_from_civil(m_year, m_month, m_day));
+  if (days < -s_maximum_unix_days || days > s_maximum_unix_days) {
+    std::stringstream emsg;
+    emsg << *this << ": out of the datetime64[ns] range.";
+    throw Coords::Error(emsg.str());
+  }
+
+  const int64_t whole_minutes(m_hour*60LL + m_minute);
+  return days*s_nanoseconds_per_day + whole_minutes*60000000000LL +
+    llround(m_second*1e9) - llround(m_timezone*3.6e12);
+
+}
+
+void Coords::DateTime::fromUnixNanoseconds(const int64_t& a_nanoseconds, const double& a_timezone) {
+
+  if (a_nanoseconds == Coords::NaT)
+    throw Coords::Error("NaT is not a datetime");
+
+  int64_t days(a_nanoseconds/s_nanoseconds_per_day);
+  int64_t remainder(a_nanoseconds % s_nanoseconds_per_day);
+  if (remainder < 0) {
+    remainder += s_nanoseconds_per_day;
+    --days;
+  }
+
+  // local time, in whole nanoseconds
+  remainder += llround(a_timezone*3.6e12);
+  while (remainder < 0) {
+    remainder += s_nanoseconds_per_day;
+    --days;
+  }
+  while (remainder >= s_nanoseconds_per_day) {
+    remainder -= s_nanoseconds_per_day;
+    ++days;
+  }
+
+  civil_from_days(days, m_year, m_month, m_day);
+  m_is_leap_year = (m_year % 4 == 0 && m_year % 100 != 0) || m_year % 400 == 0;
+
+  m_hour = remainder/3600000000000LL;
+  m_minute = (remainder/60000000000LL) % 60;
+  m_second = (remainder % 60000000000LL)*1e-9;
+
+  // a number, not ISO 8601 text, so operator<<() uses the hours
+  m_timezone = a_timezone;
+  m_is_zulu = false;
+  m_timezone_hh.clear();
+  m_timezone_mm.clear();
+  m_has_timezone_colon = false;
+
+  isValid();
+
+}
+
 // ----- string utility -----
 
 void Coords::DateTime2String(const Coords::DateTime& a_datetime, std::stringstream& a_string) {
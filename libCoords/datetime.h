@@ -40,6 +40,10 @@ namespace Coords {
   // ===== DateTime =====
   // ====================
 
+  // Thread safety: DateTime is a value. Const methods may be called
+  // from any number of threads, writers need their own copy. The
+  // static ISO 8601 regex is only read after static initialization.
+
   class DateTime {
 
   public:
@@ -58,6 +62,7 @@ namespace Coords {
     static const double   s_ModifiedJulianDate; // 1858-11-17T00:00:00
     static const double   s_TruncatedJulianDate; // 1968-05-24T00:00:00
     static const double   s_J2000; // 2000-01-01T12:00:00Z
+    static const double   s_UnixEpoch; // 1970-01-01T00:00:00Z
 
     static const double   s_resolution; // for rounding seconds
 
@@ -78,13 +83,13 @@ namespace Coords {
 		      const double& a_timezone = 0)
       : m_year(a_year), m_month(a_month), m_day(a_day),
       m_hour(a_hour), m_minute(a_minute), m_second(a_second),
-      m_is_zulu(false), m_has_timezone_colon(false), m_timezone(a_timezone), m_is_leap_year(false)
+      m_is_zulu(false), m_has_timezone_colon(false), m_timezone(a_timezone),
+      m_is_leap_year((a_year % 4 == 0 && a_year % 100 != 0) || a_year % 400 == 0)
       {isValid();};
 
-    ~DateTime() {};
-
-    DateTime(const DateTime& a);
-    DateTime& operator=(const DateTime& rhs);
+    // implicit copy, move and dtor. The timezone strings are at most
+    // "+hh" so they fit std::string's small buffer and copies do not
+    // allocate.
 
     // ----- accessors -----
 
@@ -157,6 +162,21 @@ namespace Coords {
     // TODO J1950, J2000
 
 
+    // ----- Unix time methods -----
+
+    // Nanoseconds since 1970-01-01T00:00:00Z, no leap seconds, i.e.
+    // NumPy datetime64[ns]. Integer field arithmetic, so there is no
+    // Julian date rounding. Proleptic Gregorian calendar for all
+    // years, unlike the Julian date methods before 1582. Throws Error
+    // out side of the datetime64[ns] range, about 1678 to 2261.
+
+    int64_t toUnixNanoseconds() const;
+    void    fromUnixNanoseconds(const int64_t& a_nanoseconds, const double& a_timezone=0);
+
+
+
+    // restores the ISO 8601 timezone text for operator<<()
+    friend void binary2DateTime(const char* a_buffer, DateTime* a_datetimes, const size_t& a_size);
 
   private:
 
@@ -191,6 +211,48 @@ namespace Coords {
   double operator-(const DateTime& lhs, const DateTime& rhs);
 
 
+  // -----------------------------
+  // ----- batch conversions -----
+  // -----------------------------
+
+  // between Unix time (UTC seconds since 1970-01-01T00:00:00Z, no leap
+  // seconds) and Julian dates. The output may be the input array.
+  // Reentrant.
+
+  void unixTime2JulianDate(const double* a_seconds, double* a_jdays, const size_t& a_size);
+  void JulianDate2unixTime(const double* a_jdays, double* a_seconds, const size_t& a_size);
+
+  // between NumPy datetime64[ns] values, i.e. int64 Unix nanoseconds,
+  // and Julian dates. NaT and NaN map to each other, Julian dates out
+  // side of the datetime64[ns] range map to NaT. A double Julian date
+  // resolves about 40 microseconds today, so round trips are only
+  // exact to that.
+
+  const int64_t NaT(-9223372036854775807LL - 1); // NumPy not a time
+
+  void unixNanoseconds2JulianDate(const int64_t* a_nanoseconds, double* a_jdays, const size_t& a_size);
+  void JulianDate2unixNanoseconds(const double* a_jdays, int64_t* a_nanoseconds, const size_t& a_size);
+
+
+  // --------------------------
+  // ----- binary records -----
+  // --------------------------
+
+  // 40 bytes little endian, like angle2binary():
+  //
+  //   int32 year, month, day, hour, minute, flags
+  //   double second, timezone (hours)
+  //
+  // flags keep the ISO 8601 form of the timezone (Z, +hh, colon, mm)
+  // so operator<<() output survives the round trip. binary2DateTime()
+  // validates each record like the constructors and throws Error.
+
+  const size_t DateTime_binary_size(40);
+
+  void DateTime2binary(const DateTime* a_datetimes, char* a_buffer, const size_t& a_size);
+  void binary2DateTime(const char* a_buffer, DateTime* a_datetimes, const size_t& a_size);
+
+
   // -------------------------------
   // ----- output operator<<() -----
   // -------------------------------
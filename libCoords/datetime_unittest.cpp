@@ -22,11 +22,14 @@
 
 #include <iomanip> // for std::setw() and std::setfill()
 #include <sstream>
+#include <vector>
 
 #include <gtest/gtest.h>
 
 #include <datetime.h>
 
+#include <allocation_counter.h>
+
 namespace {
 
   // ---------------------
@@ -2442,6 +2445,177 @@ namespace {
 
 
 
+  // -----------------------------
+  // ----- batch conversions -----
+  // -----------------------------
+
+  TEST(DateTime, BatchUnixTime) {
+    const double seconds[] = {0, 946728000, -86400*365.25, 1e9 + 0.5};
+    double jdays[4];
+    double round_trip[4];
+
+    Coords::unixTime2JulianDate(seconds, jdays, 4);
+    Coords::JulianDate2unixTime(jdays, round_trip, 4);
+
+    EXPECT_DOUBLE_EQ(Coords::DateTime().toJulianDate(), jdays[0]); // Unix epoch
+    EXPECT_DOUBLE_EQ(Coords::DateTime::s_J2000, jdays[1]);
+    EXPECT_DOUBLE_EQ(Coords::DateTime("1969-01-01T00:00:00").toJulianDate() - 0.25, jdays[2]);
+    EXPECT_DOUBLE_EQ(Coords::DateTime("2001-09-09T01:46:40.5").toJulianDate(), jdays[3]);
+
+    for (int i = 0; i < 4; ++i)
+      EXPECT_NEAR(seconds[i], round_trip[i], 1e-4);
+  }
+
+  TEST(DateTime, BatchUnixNanoseconds) {
+    const int64_t ns[] = {0, 946728000000000000LL, -1LL, 1000000000123456789LL, Coords::NaT};
+    double jdays[5];
+    int64_t round_trip[5];
+
+    Coords::unixNanoseconds2JulianDate(ns, jdays, 5);
+    Coords::JulianDate2unixNanoseconds(jdays, round_trip, 5);
+
+    EXPECT_DOUBLE_EQ(Coords::DateTime::s_UnixEpoch, jdays[0]);
+    EXPECT_DOUBLE_EQ(Coords::DateTime::s_J2000, jdays[1]);
+    EXPECT_DOUBLE_EQ(Coords::DateTime::s_UnixEpoch, jdays[2]);
+    EXPECT_DOUBLE_EQ(Coords::DateTime("2001-09-09T01:46:40.123456789").toJulianDate(), jdays[3]);
+    EXPECT_TRUE(std::isnan(jdays[4]));
+
+    EXPECT_EQ(0, round_trip[0]);
+    EXPECT_EQ(946728000000000000LL, round_trip[1]);
+    for (int i = 2; i < 4; ++i)
+      EXPECT_NEAR(ns[i], round_trip[i], 50000); // about 40 us per double Julian date
+    EXPECT_EQ(Coords::NaT, round_trip[4]);
+
+    const double out_of_range[] = {Coords::DateTime::s_UnixEpoch + 200000, NAN};
+    Coords::JulianDate2unixNanoseconds(out_of_range, round_trip, 2);
+    EXPECT_EQ(Coords::NaT, round_trip[0]);
+    EXPECT_EQ(Coords::NaT, round_trip[1]);
+  }
+
+
+  // ------------------------------
+  // ----- Unix time methods -----
+  // ------------------------------
+
+  TEST(DateTime, ToUnixNanoseconds) {
+    EXPECT_EQ(0, Coords::DateTime().toUnixNanoseconds());
+    EXPECT_EQ(946728000000000000LL, Coords::DateTime("2000-01-01T12:00:00Z").toUnixNanoseconds());
+    EXPECT_EQ(1000000000500000000LL, Coords::DateTime("2001-09-09T01:46:40.5").toUnixNanoseconds());
+    EXPECT_EQ(-86400000000000LL, Coords::DateTime("1969-12-31T00:00:00").toUnixNanoseconds());
+    EXPECT_EQ(0, Coords::DateTime("1969-12-31T16:00:00-08:00").toUnixNanoseconds());
+    EXPECT_EQ(0, Coords::DateTime("1970-01-01T05:30:00+05:30").toUnixNanoseconds());
+    EXPECT_THROW(Coords::DateTime(2300, 1, 1).toUnixNanoseconds(), Coords::Error);
+    EXPECT_THROW(Coords::DateTime(1600, 1, 1).toUnixNanoseconds(), Coords::Error);
+  }
+
+  TEST(DateTime, FromUnixNanoseconds) {
+    Coords::DateTime a_datetime("1999-12-31T00:00:00+01");
+
+    a_datetime.fromUnixNanoseconds(951782400123456789LL); // 2000 is a leap year
+    EXPECT_EQ(2000, a_datetime.year());
+    EXPECT_EQ(2, a_datetime.month());
+    EXPECT_EQ(29, a_datetime.day());
+    EXPECT_EQ(0, a_datetime.hour());
+    EXPECT_EQ(0, a_datetime.minute());
+    EXPECT_DOUBLE_EQ(0.123456789, a_datetime.second());
+    EXPECT_DOUBLE_EQ(0, a_datetime.timezone());
+    EXPECT_EQ("", a_datetime.timezoneHH());
+
+    a_datetime.fromUnixNanoseconds(-1, -8);
+    EXPECT_EQ(1969, a_datetime.year());
+    EXPECT_EQ(12, a_datetime.month());
+    EXPECT_EQ(31, a_datetime.day());
+    EXPECT_EQ(15, a_datetime.hour());
+    EXPECT_EQ(59, a_datetime.minute());
+    EXPECT_NEAR(59.999999999, a_datetime.second(), 1e-12);
+    EXPECT_DOUBLE_EQ(-8, a_datetime.timezone());
+    EXPECT_EQ(-1, a_datetime.toUnixNanoseconds());
+
+    EXPECT_THROW(a_datetime.fromUnixNanoseconds(Coords::NaT), Coords::Error);
+    EXPECT_THROW(a_datetime.fromUnixNanoseconds(0, 13), Coords::Error);
+  }
+
+  TEST(DateTime, UnixNanosecondsRoundTrip) {
+    // every day of four years, a different time of day each
+    for (int64_t day = -731; day < 731; ++day) {
+      const int64_t ns(day*86400000000000LL + (day + 1000)*12345678901LL);
+      Coords::DateTime a_datetime;
+      a_datetime.fromUnixNanoseconds(ns, 5.5);
+      EXPECT_EQ(ns, a_datetime.toUnixNanoseconds());
+      Coords::DateTime copy(a_datetime.year(), a_datetime.month(), a_datetime.day(),
+			    a_datetime.hour(), a_datetime.minute(), a_datetime.second(), 5.5);
+      EXPECT_EQ(ns, copy.toUnixNanoseconds());
+    }
+  }
+
+  TEST(DateTime, LeapDayFieldConstructor) {
+    EXPECT_NO_THROW(Coords::DateTime(2016, 2, 29));
+    EXPECT_NO_THROW(Coords::DateTime(2000, 2, 29));
+    EXPECT_THROW(Coords::DateTime(1900, 2, 29), Coords::Error);
+  }
+
+
+  // --------------------------
+  // ----- binary records -----
+  // --------------------------
+
+  TEST(DateTime, BinaryRoundTrip) {
+    std::vector<Coords::DateTime> dates = {Coords::DateTime("2015-01-01T12:34:56.5Z"),
+					   Coords::DateTime("2016-02-29T01:02:03-08"),
+					   Coords::DateTime("1999-12-31T23:59:59+05:30"),
+					   Coords::DateTime("2012-06-30T12:00:00+0945"),
+					   Coords::DateTime(1970, 1, 1, 0, 0, 0, -3.5)};
+    std::vector<char> buffer(dates.size()*Coords::DateTime_binary_size);
+    std::vector<Coords::DateTime> round_trip(dates.size());
+
+    Coords::DateTime2binary(&dates[0], &buffer[0], dates.size());
+    Coords::binary2DateTime(&buffer[0], &round_trip[0], dates.size());
+
+    for (size_t i = 0; i < dates.size(); ++i) {
+      std::stringstream expected, result;
+      expected << dates[i];
+      result << round_trip[i];
+      EXPECT_EQ(expected.str(), result.str());
+      EXPECT_EQ(dates[i].toJulianDate(), round_trip[i].toJulianDate());
+      EXPECT_EQ(dates[i].timezone(), round_trip[i].timezone());
+    }
+  }
+
+  TEST(DateTime, BinaryInvalid) {
+    const Coords::DateTime a_datetime("2015-02-28T00:00:00");
+    char a_record[Coords::DateTime_binary_size];
+    Coords::DateTime2binary(&a_datetime, a_record, 1);
+    Coords::int2binary(29, a_record + 8); // day
+
+    Coords::DateTime result;
+    EXPECT_THROW(Coords::binary2DateTime(a_record, &result, 1), Coords::Error);
+  }
+
+  // -----------------------
+  // ----- allocations -----
+  // -----------------------
+
+  TEST(DateTime, ArithmeticDoesNotAllocate) {
+    Coords::DateTime a("1962-07-10T07:30:00-08");
+    Coords::DateTime b(a + 0.5); // warm up
+
+    const size_t before(Coords::allocationCount());
+
+    for (int i = 0; i < 100; ++i) {
+      b = a + 0.25;
+      b += 1.5;
+      b -= 0.5;
+      a = b - 1.25;
+      Coords::DateTime c(b);
+      Coords::DateTime d(std::move(c));
+      a = std::move(d);
+    }
+
+    EXPECT_EQ(before, Coords::allocationCount());
+    EXPECT_NEAR(125, a - Coords::DateTime("1962-07-10T07:30:00-08"), 1e-6);
+  }
+
+
 } // end anonymous namespace
 
 
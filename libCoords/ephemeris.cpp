@@ -0,0 +1,469 @@
+// ==================================================================
+// Filename:    ephemeris.cpp
+//
+// Description: Implements the Chebyshev polynomial ephemeris.
+//
+// Author:      L.R. McFarland
+// Created:     2026 Oct 18
+// Language:    C++
+//
+//  Coordinates is free software: you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License as
+//  published by the Free Software Foundation, either version 3 of the
+//  License, or (at your option) any later version.
+//
+//  Coordinates is distributed in the hope that it will be useful, but
+//  WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with Coordinates.  If not, see <http://www.gnu.org/licenses/>.
+// ==================================================================
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <ephemeris.h>
+#include <utils.h>
+
+namespace {
+
+  const char s_magic[8] = {'C', 'O', 'O', 'R', 'D', 'E', 'P', 'H'};
+  const int32_t s_version(1);
+  const size_t s_header_size(40);
+
+  const double s_unix_julian_date(2440587.5); // 1970-01-01T00:00:00Z
+  const double s_nanoseconds_per_day(86400e9);
+
+  // times an evaluation block and chunk
+  const size_t s_block(64);
+  const size_t s_grain(4096);
+
+  void checkSegment(const double& a_segment, const size_t& a_degree) {
+    if (!(a_segment > 0 && a_segment < 1e300))
+      throw Coords::Error("ephemeris segment length must be positive");
+    if (a_degree < 1 || a_degree > Coords::ephemeris::s_maximum_degree)
+      throw Coords::Error("ephemeris degree must be in [1, 32]");
+  }
+
+  // Householder QR least squares of the some_rows x some_columns
+  // column major a_matrix, overwritten, for the three columns of
+  // some_values, packed x, y, z. The solutions go to some_solutions[3][columns].
+  void leastSquares(std::vector<double>& a_matrix, const size_t& some_rows, const size_t& some_columns,
+		    std::vector<double>& some_values, double* some_solutions) {
+
+    const size_t m(some_rows), n(some_columns);
+    std::vector<double> diagonal(n);
+
+    for (size_t j = 0; j < n; ++j) {
+      double* column(&a_matrix[j*m]);
+      double norm(0);
+      for (size_t i = j; i < m; ++i)
+	norm += column[i]*column[i];
+      norm = std::sqrt(norm);
+      if (norm == 0)
+	throw Coords::Error("ephemeris samples do not determine the coefficients");
+      const double alpha(column[j] > 0 ? -norm : norm);
+      const double vv(2*(norm*norm - alpha*column[j])); // v^T v
+      column[j] -= alpha; // v = x - alpha e_j
+      diagonal[j] = alpha;
+
+      // H = I - 2 v v^T/(v^T v) on the remaining columns and the values
+      for (size_t k = j + 1; k < n; ++k) {
+	double* other(&a_matrix[k*m]);
+	double dot(0);
+	for (size_t i = j; i < m; ++i)
+	  dot += column[i]*other[i];
+	const double scale(2*dot/vv);
+	for (size_t i = j; i < m; ++i)
+	  other[i] -= scale*column[i];
+      }
+      for (size_t a = 0; a < 3; ++a) {
+	double dot(0);
+	for (size_t i = j; i < m; ++i)
+	  dot += column[i]*some_values[3*i + a];
+	const double scale(2*dot/vv);
+	for (size_t i = j; i < m; ++i)
+	  some_values[3*i + a] -= scale*column[i];
+      }
+    }
+
+    // R c = Q^T f
+    for (size_t a = 0; a < 3; ++a) {
+      double* solution(some_solutions + a*n);
+      for (size_t j = n; j-- > 0;) {
+	double sum(some_values[3*j + a]);
+	for (size_t k = j + 1; k < n; ++k)
+	  sum -= a_matrix[k*m + j]*solution[k];
+	solution[j] = sum/diagonal[j];
+      }
+    }
+  }
+
+} // end anonymous namespace
+
+
+// ------------------------
+// ----- constructors -----
+// ------------------------
+
+Coords::ephemeris::ephemeris(const size_t& a_degree, const size_t& a_segments,
+			     const int64_t& a_start, const double& a_segment)
+  : m_degree(a_degree), m_segments(a_segments), m_start(a_start), m_segment(a_segment), m_is_mapped(false)
+{
+  std::shared_ptr<std::vector<double> > some_coefficients(new std::vector<double>(3*a_segments*(a_degree + 1)));
+  m_coefficients = std::shared_ptr<const double>(some_coefficients, some_coefficients->data());
+}
+
+
+// ----------------
+// ----- fits -----
+// ----------------
+
+Coords::ephemeris Coords::ephemeris::fit(const trajectory& a_trajectory,
+					 const DateTime& a_start,
+					 const double& a_duration,
+					 const double& a_segment,
+					 const size_t& a_degree,
+					 const size_t& a_threads) {
+
+  checkSegment(a_segment, a_degree);
+  if (!(a_duration > 0 && a_duration/a_segment < 1e9))
+    throw Error("ephemeris duration must be positive");
+
+  const size_t segments(std::max(1.0, std::ceil(a_duration/a_segment)));
+  const size_t n(a_degree + 1);
+  ephemeris an_ephemeris(a_degree, segments, a_start.toUnixNanoseconds(), a_segment);
+
+  // the nodes, the zeros of T_n, in every segment
+  std::vector<double> nodes(n), seconds(segments*n), positions(3*segments*n);
+  for (size_t j = 0; j < n; ++j)
+    nodes[j] = std::cos(M_PI*(j + 0.5)/n);
+  for (size_t s = 0; s < segments; ++s)
+    for (size_t j = 0; j < n; ++j)
+      seconds[s*n + j] = (s + 0.5*(nodes[j] + 1))*a_segment;
+  a_trajectory(seconds.data(), seconds.size(), positions.data());
+
+  // c_k = 2/n sum_j f(t_j) T_k(t_j), c_0 half that
+  std::vector<double> basis(n*n);
+  for (size_t k = 0; k < n; ++k)
+    for (size_t j = 0; j < n; ++j)
+      basis[k*n + j] = (k == 0 ? 1.0 : 2.0)/n*std::cos(M_PI*k*(j + 0.5)/n);
+
+  double* coefficients(const_cast<double*>(an_ephemeris.m_coefficients.get()));
+  parallelFor(segments, [&] (const size_t& a_begin, const size_t& a_end) {
+      for (size_t s = a_begin; s < a_end; ++s) {
+	const double* f(&positions[3*s*n]);
+	for (size_t a = 0; a < 3; ++a) {
+	  double* c(coefficients + (3*s + a)*n);
+	  for (size_t k = 0; k < n; ++k) {
+	    double sum(0);
+	    for (size_t j = 0; j < n; ++j)
+	      sum += basis[k*n + j]*f[3*j + a];
+	    c[k] = sum;
+	  }
+	}
+      }
+    }, a_threads, 64);
+
+  return an_ephemeris;
+}
+
+Coords::ephemeris Coords::ephemeris::fit(const double* some_seconds,
+					 const double* some_positions,
+					 const size_t& a_size,
+					 const DateTime& a_start,
+					 const double& a_segment,
+					 const size_t& a_degree,
+					 const size_t& a_threads) {
+
+  checkSegment(a_segment, a_degree);
+  if (a_size == 0 || !(some_seconds[0] >= 0) || !(some_seconds[a_size - 1]/a_segment < 1e9))
+    throw Error("ephemeris samples must start at or after the start");
+  for (size_t i = 1; i < a_size; ++i)
+    if (!(some_seconds[i] >= some_seconds[i - 1]))
+      throw Error("ephemeris sample times must be ascending");
+
+  const size_t segments(std::max(1.0, std::ceil(some_seconds[a_size - 1]/a_segment)));
+  const size_t n(a_degree + 1);
+  ephemeris an_ephemeris(a_degree, segments, a_start.toUnixNanoseconds(), a_segment);
+
+  double* coefficients(const_cast<double*>(an_ephemeris.m_coefficients.get()));
+  parallelFor(segments, [&] (const size_t& a_begin, const size_t& a_end) {
+      std::vector<double> matrix, values;
+      for (size_t s = a_begin; s < a_end; ++s) {
+
+	// the samples in [start, end], on a boundary in both
+	const double start(s*a_segment), end((s + 1)*a_segment);
+	const size_t first(std::lower_bound(some_seconds, some_seconds + a_size, start) - some_seconds);
+	const size_t last(std::upper_bound(some_seconds, some_seconds + a_size, end) - some_seconds);
+	const size_t m(last - first);
+	if (m < n) {
+	  std::stringstream emsg;
+	  emsg << "ephemeris segment " << s << " has " << m << " samples, degree " << a_degree << " needs " << n;
+	  throw Error(emsg.str());
+	}
+
+	matrix.resize(m*n);
+	for (size_t i = 0; i < m; ++i) {
+	  const double tau(2*(some_seconds[first + i] - start)/a_segment - 1);
+	  double t0(1), t1(tau);
+	  matrix[i] = 1;
+	  matrix[m + i] = tau;
+	  for (size_t k = 2; k < n; ++k) {
+	    const double t2(2*tau*t1 - t0);
+	    matrix[k*m + i] = t2;
+	    t0 = t1;
+	    t1 = t2;
+	  }
+	}
+	values.assign(some_positions + 3*first, some_positions + 3*last);
+	leastSquares(matrix, m, n, values, coefficients + 3*s*n);
+      }
+    }, a_threads, 16);
+
+  return an_ephemeris;
+}
+
+Coords::ephemeris Coords::ephemeris::fit(const CartesianRecorder& a_recorder,
+					 const DateTime& a_start,
+					 const double& an_interval,
+					 const double& a_segment,
+					 const size_t& a_degree,
+					 const size_t& a_threads) {
+
+  if (!(an_interval > 0))
+    throw Error("ephemeris sample interval must be positive");
+
+  size_t first_size(0), second_size(0);
+  const double* first(a_recorder.firstSegment(first_size));
+  const double* second(a_recorder.secondSegment(second_size));
+
+  std::vector<double> positions(first, first + 3*first_size);
+  positions.insert(positions.end(), second, second + 3*second_size);
+  std::vector<double> seconds(first_size + second_size);
+  const bool is_reduced(a_recorder.reduction() != CartesianRecorder::keep_newest);
+  const double a_centre(a_recorder.reduction() == CartesianRecorder::bin ? (a_recorder.stride() - 1)/2.0 : 0);
+  for (size_t i = 0; i < seconds.size(); ++i)
+    seconds[i] = ((is_reduced ? a_recorder.index(i) : i) + a_centre)*an_interval;
+
+  return fit(seconds.data(), positions.data(), seconds.size(), a_start, a_segment, a_degree, a_threads);
+}
+
+
+// -------------------------
+// ----- segment files -----
+// -------------------------
+
+void Coords::ephemeris::save(const std::string& a_filename) const {
+
+  char header[s_header_size];
+  std::memcpy(header, s_magic, 8);
+  int2binary(s_version, header + 8);
+  int2binary(int32_t(m_degree), header + 12);
+  long2binary(int64_t(m_segments), header + 16);
+  long2binary(m_start, header + 24);
+  double2binary(m_segment, header + 32);
+
+  std::ofstream a_file(a_filename.c_str(), std::ios::binary | std::ios::trunc);
+  a_file.write(header, s_header_size);
+
+  const size_t size(3*m_segments*(m_degree + 1));
+  std::vector<char> buffer(8*std::min(size, size_t(65536)));
+  for (size_t begin = 0; begin < size; begin += 65536) {
+    const size_t count(std::min(size - begin, size_t(65536)));
+    for (size_t i = 0; i < count; ++i)
+      double2binary(m_coefficients.get()[begin + i], &buffer[8*i]);
+    a_file.write(buffer.data(), 8*count);
+  }
+
+  if (!a_file)
+    throw Error("ephemeris can not write " + a_filename);
+}
+
+Coords::ephemeris Coords::ephemeris::open(const std::string& a_filename) {
+
+  const int descriptor(::open(a_filename.c_str(), O_RDONLY));
+  if (descriptor < 0)
+    throw Error("ephemeris can not open " + a_filename);
+
+  struct stat status;
+  if (fstat(descriptor, &status) != 0 || size_t(status.st_size) < s_header_size) {
+    ::close(descriptor);
+    throw Error("ephemeris " + a_filename + " is not a segment file");
+  }
+  const size_t file_size(status.st_size);
+
+  void* mapped(mmap(0, file_size, PROT_READ, MAP_SHARED, descriptor, 0));
+  ::close(descriptor); // the mapping keeps the file
+  if (mapped == MAP_FAILED)
+    throw Error("ephemeris can not map " + a_filename);
+  std::shared_ptr<const char> mapping(static_cast<const char*>(mapped),
+				      [file_size] (const char* a_base) {
+					munmap(const_cast<char*>(a_base), file_size);
+				      });
+
+  const char* header(mapping.get());
+  const int64_t degree(binary2int(header + 12));
+  const int64_t segments(binary2long(header + 16));
+  if (std::memcmp(header, s_magic, 8) != 0 || binary2int(header + 8) != s_version ||
+      degree < 1 || degree > int64_t(s_maximum_degree) || segments < 1 ||
+      uint64_t(segments) > (file_size - s_header_size)/(24*(degree + 1)) ||
+      file_size != s_header_size + 24*segments*(degree + 1))
+    throw Error("ephemeris " + a_filename + " is not a version 1 segment file");
+
+  ephemeris an_ephemeris(0, 0, binary2long(header + 24), binary2double(header + 32));
+  an_ephemeris.m_degree = degree;
+  an_ephemeris.m_segments = segments;
+  checkSegment(an_ephemeris.m_segment, an_ephemeris.m_degree);
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  // the coefficients are the mapped pages, 8 byte aligned after the header
+  an_ephemeris.m_coefficients = std::shared_ptr<const double>(mapping,
+							      reinterpret_cast<const double*>(header + s_header_size));
+  an_ephemeris.m_is_mapped = true;
+#else
+  const size_t size(3*segments*(degree + 1));
+  std::shared_ptr<std::vector<double> > some_coefficients(new std::vector<double>(size));
+  for (size_t i = 0; i < size; ++i)
+    (*some_coefficients)[i] = binary2double(header + s_header_size + 8*i);
+  an_ephemeris.m_coefficients = std::shared_ptr<const double>(some_coefficients, some_coefficients->data());
+#endif
+
+  return an_ephemeris;
+}
+
+
+// ----------------------
+// ----- evaluation -----
+// ----------------------
+
+void Coords::ephemeris::evaluate(const double* some_seconds, const size_t& a_size,
+				 double* a_positions, double* a_velocities) const {
+
+  const size_t n(m_degree + 1);
+  const double* coefficients[s_block];
+  double tau[s_block];
+  for (size_t i = 0; i < a_size; ++i) {
+    if (!(some_seconds[i] >= 0 && some_seconds[i] <= duration())) {
+      std::stringstream emsg;
+      emsg << "ephemeris time " << some_seconds[i] << " s is outside [0, " << duration() << "]";
+      throw Error(emsg.str());
+    }
+    const size_t s(std::min(size_t(some_seconds[i]/m_segment), m_segments - 1));
+    coefficients[i] = m_coefficients.get() + 3*s*n;
+    tau[i] = 2*(some_seconds[i] - s*m_segment)/m_segment - 1;
+  }
+
+  // T_k and T_k' by their recurrences, shared by x, y and z. The
+  // loop over the block inside the loop over k keeps a_size
+  // independent recurrences in flight.
+  double x[s_block], y[s_block], z[s_block], vx[s_block], vy[s_block], vz[s_block];
+  double t0[s_block], t1[s_block], d0[s_block], d1[s_block];
+  for (size_t i = 0; i < a_size; ++i) {
+    const double* c(coefficients[i]);
+    x[i] = c[0] + c[1]*tau[i];
+    y[i] = c[n] + c[n + 1]*tau[i];
+    z[i] = c[2*n] + c[2*n + 1]*tau[i];
+    vx[i] = c[1];
+    vy[i] = c[n + 1];
+    vz[i] = c[2*n + 1];
+    t0[i] = 1;
+    t1[i] = tau[i];
+    d0[i] = 0;
+    d1[i] = 1;
+  }
+  for (size_t k = 2; k < n; ++k) {
+    for (size_t i = 0; i < a_size; ++i) {
+      const double* c(coefficients[i] + k);
+      const double t2(2*tau[i]*t1[i] - t0[i]);
+      const double d2(2*t1[i] + 2*tau[i]*d1[i] - d0[i]);
+      x[i] += c[0]*t2;
+      y[i] += c[n]*t2;
+      z[i] += c[2*n]*t2;
+      vx[i] += c[0]*d2;
+      vy[i] += c[n]*d2;
+      vz[i] += c[2*n]*d2;
+      t0[i] = t1[i];
+      t1[i] = t2;
+      d0[i] = d1[i];
+      d1[i] = d2;
+    }
+  }
+
+  const double scale(2/m_segment); // dtau/dt
+  for (size_t i = 0; i < a_size; ++i) {
+    a_positions[3*i] = x[i];
+    a_positions[3*i + 1] = y[i];
+    a_positions[3*i + 2] = z[i];
+    if (a_velocities) {
+      a_velocities[3*i] = vx[i]*scale;
+      a_velocities[3*i + 1] = vy[i]*scale;
+      a_velocities[3*i + 2] = vz[i]*scale;
+    }
+  }
+}
+
+void Coords::ephemeris::states(const double* some_seconds, const size_t& a_size,
+			       double* a_positions, double* a_velocities,
+			       const size_t& a_threads) const {
+  parallelFor(a_size, [&] (const size_t& a_begin, const size_t& a_end) {
+      for (size_t i = a_begin; i < a_end; i += s_block)
+	evaluate(some_seconds + i, std::min(s_block, a_end - i),
+		 a_positions + 3*i, a_velocities ? a_velocities + 3*i : 0);
+    }, a_threads, s_grain);
+}
+
+void Coords::ephemeris::states(const int64_t* some_unix_nanoseconds, const size_t& a_size,
+			       double* a_positions, double* a_velocities,
+			       const size_t& a_threads) const {
+  parallelFor(a_size, [&] (const size_t& a_begin, const size_t& a_end) {
+      double seconds[s_block];
+      for (size_t i = a_begin; i < a_end; i += s_block) {
+	const size_t size(std::min(s_block, a_end - i));
+	for (size_t k = 0; k < size; ++k)
+	  seconds[k] = double(some_unix_nanoseconds[i + k] - m_start)*1e-9;
+	evaluate(seconds, size, a_positions + 3*i, a_velocities ? a_velocities + 3*i : 0);
+      }
+    }, a_threads, s_grain);
+}
+
+void Coords::ephemeris::julianStates(const double* some_julian_dates, const size_t& a_size,
+				     double* a_positions, double* a_velocities,
+				     const size_t& a_threads) const {
+  const double start(s_unix_julian_date + m_start/s_nanoseconds_per_day);
+  parallelFor(a_size, [&] (const size_t& a_begin, const size_t& a_end) {
+      double seconds[s_block];
+      for (size_t i = a_begin; i < a_end; i += s_block) {
+	const size_t size(std::min(s_block, a_end - i));
+	for (size_t k = 0; k < size; ++k)
+	  seconds[k] = (some_julian_dates[i + k] - start)*86400.0;
+	evaluate(seconds, size, a_positions + 3*i, a_velocities ? a_velocities + 3*i : 0);
+      }
+    }, a_threads, s_grain);
+}
+
+void Coords::ephemeris::state(const DateTime& a_time, Cartesian& a_position, Cartesian& a_velocity) const {
+  const double seconds(double(a_time.toUnixNanoseconds() - m_start)*1e-9);
+  double position[3], velocity[3];
+  evaluate(&seconds, 1, position, velocity);
+  a_position = Cartesian(position[0], position[1], position[2]);
+  a_velocity = Cartesian(velocity[0], velocity[1], velocity[2]);
+}
+
+Coords::Cartesian Coords::ephemeris::position(const DateTime& a_time) const {
+  const double seconds(double(a_time.toUnixNanoseconds() - m_start)*1e-9);
+  double position[3];
+  evaluate(&seconds, 1, position, 0);
+  return Cartesian(position[0], position[1], position[2]);
+}
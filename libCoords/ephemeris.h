@@ -0,0 +1,168 @@
+// ================================================================
+// Filename:    ephemeris.h
+//
+// Description: This defines a Chebyshev polynomial ephemeris, a
+//              trajectory stored as fixed length time segments of
+//              coefficients, and its memory mapped segment file.
+//
+// Author:      L.R. McFarland
+// Created:     2026 Oct 18
+// Language:    C++
+//
+//  Coords is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  Coords is distributed in the hope that it will be useful, but
+//  WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with Coords.  If not, see <http://www.gnu.org/licenses/>.
+// ================================================================
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <stdint.h>
+#include <string>
+
+#include <angle.h>
+#include <Cartesian.h>
+#include <datetime.h>
+#include <parallel.h>
+
+namespace Coords {
+
+  // =====================
+  // ===== ephemeris =====
+  // =====================
+
+  // x, y and z over each segment are sums of Chebyshev polynomials of
+  // the segment's time mapped to [-1, 1], as in the JPL ephemerides.
+  // The segments are all the same length so a time's segment is a
+  // division, and evaluating a position and velocity at degree n is
+  // about 9n multiply adds.
+  //
+  // The segment file is
+  //
+  //   char[8]  "COORDEPH"
+  //   int32    version, 1
+  //   int32    degree
+  //   int64    segments
+  //   int64    start, Unix nanoseconds
+  //   double   segment length, s
+  //   double   coefficients[segments][3][degree + 1]
+  //
+  // little endian like the binary records, 40 bytes of header then
+  // the coefficients. open() maps it and evaluates from the mapped
+  // pages on little endian hosts, so an ephemeris is shared by every
+  // process that opens it and costs nothing to load.
+  //
+  // Thread safety: an ephemeris is immutable. Copies share the
+  // coefficients. Const methods may be called from any number of
+  // threads.
+
+  class ephemeris {
+
+  public:
+
+    // a_size positions packed x, y, z at some_seconds after the start
+    typedef std::function<void (const double* some_seconds, const size_t& a_size, double* a_positions)> trajectory;
+
+    static const size_t s_maximum_degree = 32;
+
+    // ----- fits -----
+
+    // interpolates a_trajectory at the Chebyshev nodes of each
+    // segment, e.g. with orbit::states(). a_duration is rounded up to
+    // whole segments.
+    static ephemeris fit(const trajectory& a_trajectory,
+			 const DateTime& a_start,
+			 const double& a_duration,
+			 const double& a_segment,
+			 const size_t& a_degree,
+			 const size_t& a_threads=0);
+
+    // least squares fits to a_size samples packed x, y, z at
+    // some_seconds after a_start, ascending. Every segment must have
+    // more than a_degree samples.
+    static ephemeris fit(const double* some_seconds,
+			 const double* some_positions,
+			 const size_t& a_size,
+			 const DateTime& a_start,
+			 const double& a_segment,
+			 const size_t& a_degree,
+			 const size_t& a_threads=0);
+
+    // the samples of a_recorder pushed an_interval apart, e.g. by
+    // ParticleSystem::record() with a fixed step. a_start is the time
+    // of the oldest sample for keep_newest, of the first pushed since
+    // clear() for the reducing policies, which place sample k at
+    // index(k), a bin at its centre.
+    static ephemeris fit(const CartesianRecorder& a_recorder,
+			 const DateTime& a_start,
+			 const double& an_interval,
+			 const double& a_segment,
+			 const size_t& a_degree,
+			 const size_t& a_threads=0);
+
+    // ----- segment files -----
+
+    void save(const std::string& a_filename) const; // throws Error
+    static ephemeris open(const std::string& a_filename); // throws Error
+
+    // implicit copy, move and dtor.
+
+    // ----- accessors -----
+
+    const size_t&  degree() const        {return m_degree;}
+    const size_t&  segments() const      {return m_segments;}
+    const double&  segmentLength() const {return m_segment;} // s
+    double         duration() const      {return m_segment*m_segments;} // s
+    const int64_t& start() const         {return m_start;} // Unix nanoseconds
+    bool           isMapped() const      {return m_is_mapped;}
+
+    // ----- evaluation -----
+
+    // a_size positions and, if a_velocities is not 0, velocities
+    // packed x, y, z, parallel over the times. Throws Error for a time
+    // outside [0, duration()].
+    void states(const double* some_seconds, const size_t& a_size,
+		double* a_positions, double* a_velocities=0,
+		const size_t& a_threads=0) const; // s after start()
+
+    void states(const int64_t* some_unix_nanoseconds, const size_t& a_size,
+		double* a_positions, double* a_velocities=0,
+		const size_t& a_threads=0) const;
+
+    void julianStates(const double* some_julian_dates, const size_t& a_size,
+		      double* a_positions, double* a_velocities=0,
+		      const size_t& a_threads=0) const;
+
+    void state(const DateTime& a_time, Cartesian& a_position, Cartesian& a_velocity) const;
+    Cartesian position(const DateTime& a_time) const;
+
+  private:
+
+    ephemeris(const size_t& a_degree, const size_t& a_segments, const int64_t& a_start, const double& a_segment);
+
+    // at most 64 times. The coefficients of segment s, axis a start
+    // at m_coefficients.get() + (3*s + a)*(m_degree + 1).
+    void evaluate(const double* some_seconds, const size_t& a_size,
+		  double* a_positions, double* a_velocities) const;
+
+    size_t  m_degree;
+    size_t  m_segments;
+    int64_t m_start;
+    double  m_segment;
+    bool    m_is_mapped;
+
+    std::shared_ptr<const double> m_coefficients; // owned or mapped
+
+  };
+
+} // end namespace Coords
@@ -0,0 +1,246 @@
+// ================================================================
+// Filename:    ephemeris_unittest.cpp
+// Description: This is the gtest unittest of the Chebyshev
+//              ephemeris.
+//
+// Author:      L.R. McFarland, lrm@starbug.com
+// Created:     2026 Oct 18
+// Language:    C++
+//
+// See also: http://code.google.com/p/googletest/wiki/Primer
+//
+//  Coordinates is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  Coordinates is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with Coordinates.  If not, see <http://www.gnu.org/licenses/>.
+// ================================================================
+
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <angle.h>
+#include <Cartesian.h>
+#include <ephemeris.h>
+#include <kepler.h>
+#include <particles.h>
+
+
+namespace {
+
+  const Coords::DateTime s_start(2026, 10, 18, 0, 0, 0);
+
+  // a cubic in each axis, which degree 3 fits exactly
+  void cubic(const double* some_seconds, const size_t& a_size, double* a_positions) {
+    for (size_t i = 0; i < a_size; ++i) {
+      const double t(some_seconds[i]);
+      a_positions[3*i] = 1 + 2*t - 0.5*t*t + 0.01*t*t*t;
+      a_positions[3*i + 1] = -3 + t*t;
+      a_positions[3*i + 2] = 0.25*t*t*t;
+    }
+  }
+
+  // ------------------------------
+  // ----- fixed ephemerides -----
+  // ------------------------------
+
+  TEST(FixedEphemeris, Polynomial) {
+    const Coords::ephemeris an_ephemeris(Coords::ephemeris::fit(cubic, s_start, 10, 4, 3));
+    EXPECT_EQ(size_t(3), an_ephemeris.segments());
+    EXPECT_EQ(12, an_ephemeris.duration());
+
+    std::vector<double> seconds, expected(3*121);
+    for (int k = 0; k <= 120; ++k)
+      seconds.push_back(0.1*k);
+    cubic(seconds.data(), seconds.size(), expected.data());
+    std::vector<double> positions(3*121), velocities(3*121);
+    an_ephemeris.states(seconds.data(), seconds.size(), positions.data(), velocities.data());
+    for (size_t i = 0; i < seconds.size(); ++i) {
+      const double t(seconds[i]);
+      for (int a = 0; a < 3; ++a)
+	ASSERT_NEAR(expected[3*i + a], positions[3*i + a], 1e-12) << t;
+      ASSERT_NEAR(2 - t + 0.03*t*t, velocities[3*i], 1e-12) << t;
+      ASSERT_NEAR(2*t, velocities[3*i + 1], 1e-12) << t;
+      ASSERT_NEAR(0.75*t*t, velocities[3*i + 2], 1e-12) << t;
+    }
+
+    // and a least squares fit to samples of it
+    std::vector<double> samples(3*seconds.size());
+    cubic(seconds.data(), seconds.size(), samples.data());
+    const Coords::ephemeris fitted(Coords::ephemeris::fit(seconds.data(), samples.data(), seconds.size(),
+							  s_start, 4, 3));
+    std::vector<double> fitted_positions(3*121);
+    fitted.states(seconds.data(), seconds.size(), fitted_positions.data());
+    for (size_t i = 0; i < fitted_positions.size(); ++i)
+      ASSERT_NEAR(expected[i], fitted_positions[i], 1e-11);
+  }
+
+  TEST(FixedEphemeris, Orbit) {
+    // a day of low Earth orbit, 1200 s segments at degree 12
+    const Coords::orbit an_orbit(7e6, 0.01, Coords::angle(51.6), Coords::angle(30), Coords::angle(60),
+				 Coords::angle(0), s_start, Coords::orbit::s_GM_Earth);
+    const Coords::ephemeris an_ephemeris(Coords::ephemeris::fit([&an_orbit] (const double* some_seconds,
+									     const size_t& a_size,
+									     double* a_positions) {
+								  an_orbit.states(some_seconds, a_size, a_positions);
+								},
+								s_start, 86400, 1200, 12));
+    EXPECT_EQ(size_t(72), an_ephemeris.segments());
+
+    double worst_position(0), worst_velocity(0);
+    for (double t = 0; t <= 86400; t += 7.3) {
+      double p[3], v[3], q[3], w[3];
+      an_orbit.states(&t, 1, p, v);
+      an_ephemeris.states(&t, 1, q, w);
+      worst_position = std::max(worst_position, (Coords::Cartesian(p[0], p[1], p[2]) - Coords::Cartesian(q[0], q[1], q[2])).magnitude());
+      worst_velocity = std::max(worst_velocity, (Coords::Cartesian(v[0], v[1], v[2]) - Coords::Cartesian(w[0], w[1], w[2])).magnitude());
+    }
+    EXPECT_LT(worst_position, 1e-3); // m
+    EXPECT_LT(worst_velocity, 1e-5); // m/s
+
+    // DateTime, Unix nanoseconds and Julian dates agree
+    const Coords::DateTime a_time(2026, 10, 18, 13, 14, 15.5);
+    Coords::Cartesian r, v;
+    an_ephemeris.state(a_time, r, v);
+    EXPECT_EQ(r, an_ephemeris.position(a_time));
+    const int64_t nanoseconds(a_time.toUnixNanoseconds());
+    double p[3], q[3];
+    an_ephemeris.states(&nanoseconds, 1, p);
+    EXPECT_EQ(r, Coords::Cartesian(p[0], p[1], p[2]));
+    const double julian_date(a_time.toJulianDate());
+    an_ephemeris.julianStates(&julian_date, 1, q);
+    EXPECT_NEAR(0, (r - Coords::Cartesian(q[0], q[1], q[2])).magnitude(), 1); // Julian date rounding, ~40 us
+  }
+
+  TEST(FixedEphemeris, Recorder) {
+    // a particle falling in a uniform field records a parabola
+    Coords::ParticleSystem a_system(Coords::ParticleSystem::leapfrog);
+    a_system.add(Coords::Cartesian(0, 0, 100), Coords::Cartesian(3, 0, 0), 1);
+    a_system.addForce(Coords::ParticleSystem::uniformField(Coords::Cartesian(0, 0, -9.8)));
+    Coords::CartesianRecorder a_recorder(64);
+    a_recorder.clear();
+    a_system.record(0, a_recorder);
+    a_system.run(0.1, 100); // wraps the ring
+
+    const Coords::ephemeris an_ephemeris(Coords::ephemeris::fit(a_recorder, s_start, 0.1, 2.5, 4));
+    EXPECT_EQ(size_t(3), an_ephemeris.segments());
+    for (size_t i = 0; i < a_recorder.size(); ++i) {
+      const double t(0.1*i);
+      double p[3];
+      an_ephemeris.states(&t, 1, p);
+      EXPECT_NEAR(0, (Coords::Cartesian(p[0], p[1], p[2]) - a_recorder.get(i)).magnitude(), 1e-9) << i;
+    }
+  }
+
+  TEST(FixedEphemeris, ReducedRecorder) {
+    // samples at their pushed times, bins at their centres, exact for
+    // a parabola decimated and a line binned
+    const Coords::CartesianRecorder::policy policies[] = {Coords::CartesianRecorder::decimate,
+							  Coords::CartesianRecorder::bin};
+    for (const Coords::CartesianRecorder::policy& a_policy : policies) {
+      const double g(a_policy == Coords::CartesianRecorder::bin ? 0 : -9.8);
+      Coords::ParticleSystem a_system(Coords::ParticleSystem::leapfrog);
+      a_system.add(Coords::Cartesian(0, 0, 100), Coords::Cartesian(3, 0, 1), 1);
+      a_system.addForce(Coords::ParticleSystem::uniformField(Coords::Cartesian(0, 0, g)));
+      Coords::CartesianRecorder a_recorder(16);
+      a_recorder.reduction(a_policy);
+      a_system.record(0, a_recorder);
+      a_system.run(0.1, 100);
+      ASSERT_GT(a_recorder.stride(), 1u);
+
+      const Coords::ephemeris an_ephemeris(Coords::ephemeris::fit(a_recorder, s_start, 0.1, 5, 3));
+      for (double t = 0; t <= 10; t += 0.5) {
+	double p[3];
+	an_ephemeris.states(&t, 1, p);
+	const Coords::Cartesian expected(3*t, 0, 100 + t + g/2*t*t);
+	EXPECT_NEAR(0, (Coords::Cartesian(p[0], p[1], p[2]) - expected).magnitude(), 1e-9) << a_policy << " " << t;
+      }
+    }
+  }
+
+  TEST(FixedEphemeris, SaveAndOpen) {
+    const std::string a_filename("ephemeris_unittest.eph");
+    const Coords::ephemeris an_ephemeris(Coords::ephemeris::fit(cubic, s_start, 100, 7, 5));
+    EXPECT_FALSE(an_ephemeris.isMapped());
+    an_ephemeris.save(a_filename);
+
+    {
+      std::ifstream a_file(a_filename.c_str(), std::ios::binary | std::ios::ate);
+      EXPECT_EQ(40 + 8*3*15*6, a_file.tellg());
+    }
+
+    const Coords::ephemeris opened(Coords::ephemeris::open(a_filename));
+    EXPECT_EQ(an_ephemeris.degree(), opened.degree());
+    EXPECT_EQ(an_ephemeris.segments(), opened.segments());
+    EXPECT_EQ(an_ephemeris.segmentLength(), opened.segmentLength());
+    EXPECT_EQ(an_ephemeris.start(), opened.start());
+    EXPECT_TRUE(opened.isMapped()); // on little endian hosts
+
+    const Coords::ephemeris a_copy(opened); // shares the mapping
+    std::vector<double> seconds;
+    for (int k = 0; k <= 1050; ++k)
+      seconds.push_back(0.1*k);
+    std::vector<double> a(3*seconds.size()), b(3*seconds.size());
+    an_ephemeris.states(seconds.data(), seconds.size(), a.data());
+    a_copy.states(seconds.data(), seconds.size(), b.data());
+    EXPECT_EQ(a, b);
+
+    std::remove(a_filename.c_str());
+
+    // not a segment file
+    std::ofstream(a_filename.c_str()) << "not an ephemeris, but long enough to have a header";
+    EXPECT_THROW(Coords::ephemeris::open(a_filename), Coords::Error);
+    std::remove(a_filename.c_str());
+    EXPECT_THROW(Coords::ephemeris::open(a_filename), Coords::Error);
+  }
+
+  TEST(FixedEphemeris, Errors) {
+    EXPECT_THROW(Coords::ephemeris::fit(cubic, s_start, 10, 0, 3), Coords::Error);
+    EXPECT_THROW(Coords::ephemeris::fit(cubic, s_start, 10, 1, 0), Coords::Error);
+    EXPECT_THROW(Coords::ephemeris::fit(cubic, s_start, 10, 1, 33), Coords::Error);
+    EXPECT_THROW(Coords::ephemeris::fit(cubic, s_start, -1, 1, 3), Coords::Error);
+
+    // too few samples for the degree in the second segment
+    const std::vector<double> seconds = {0, 1, 2, 3, 4, 5, 7, 9};
+    std::vector<double> samples(3*seconds.size());
+    cubic(seconds.data(), seconds.size(), samples.data());
+    EXPECT_THROW(Coords::ephemeris::fit(seconds.data(), samples.data(), seconds.size(), s_start, 5, 3), Coords::Error);
+    const std::vector<double> descending = {0, 2, 1, 3};
+    EXPECT_THROW(Coords::ephemeris::fit(descending.data(), samples.data(), 4, s_start, 5, 1), Coords::Error);
+
+    const Coords::ephemeris an_ephemeris(Coords::ephemeris::fit(cubic, s_start, 10, 5, 3));
+    double p[3];
+    const double before(-1e-9), after(10 + 1e-9), end(10);
+    EXPECT_THROW(an_ephemeris.states(&before, 1, p), Coords::Error);
+    EXPECT_THROW(an_ephemeris.states(&after, 1, p), Coords::Error);
+    EXPECT_NO_THROW(an_ephemeris.states(&end, 1, p));
+  }
+
+  TEST(FixedEphemeris, ThreadsMatchSerial) {
+    const Coords::ephemeris an_ephemeris(Coords::ephemeris::fit(cubic, s_start, 100, 3, 8, 4));
+    const Coords::ephemeris serial(Coords::ephemeris::fit(cubic, s_start, 100, 3, 8, 1));
+    std::vector<double> seconds;
+    for (int k = 0; k < 20000; ++k)
+      seconds.push_back(0.005*k);
+    std::vector<double> a(3*seconds.size()), b(3*seconds.size()), c(3*seconds.size());
+    an_ephemeris.states(seconds.data(), seconds.size(), a.data(), c.data(), 4);
+    serial.states(seconds.data(), seconds.size(), b.data(), 0, 1);
+    EXPECT_EQ(a, b);
+  }
+
+} // end anonymous namespace
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
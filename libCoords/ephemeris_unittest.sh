@@ -0,0 +1,10 @@
+#!/bin/bash
+#
+# Shell wrapper to set up gtest environment
+#
+#
+
+. ./setenv.sh
+
+./ephemeris_unittest "$@"
+
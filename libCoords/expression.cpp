@@ -0,0 +1,415 @@
+// ==================================================================
+// Filename:    expression.cpp
+//
+// Description: Implements the compiled vector formula.
+//
+// Author:      L.R. McFarland
+// Created:     2026 Oct 18
+// Language:    C++
+//
+//  Coordinates is free software: you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License as
+//  published by the Free Software Foundation, either version 3 of the
+//  License, or (at your option) any later version.
+//
+//  Coordinates is distributed in the hope that it will be useful, but
+//  WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with Coordinates.  If not, see <http://www.gnu.org/licenses/>.
+// ==================================================================
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+
+#include <expression.h>
+
+const size_t Coords::expression::s_block_size(256);
+
+// ------------------------
+// ----- constructors -----
+// ------------------------
+
+Coords::expression::expression(const std::string& a_formula)
+  : m_formula(a_formula), m_depth(0)
+{
+  size_t pos(0);
+  parseExpr(pos);
+  skipSpace(pos);
+  if (pos != m_formula.size())
+    throwError(pos, "unexpected character");
+
+  // stack depth for the scratch size
+  size_t depth(0);
+  for (size_t k = 0; k < m_program.size(); ++k) {
+    switch (m_program[k].m_opcode) {
+    case op_load:
+    case op_constant:
+      m_depth = std::max(m_depth, ++depth);
+      break;
+    case op_add:
+    case op_subtract:
+    case op_multiply:
+    case op_divide:
+    case op_cross:
+    case op_dot:
+      --depth;
+      break;
+    default:
+      break;
+    }
+  }
+}
+
+// -------------------
+// ----- parsing -----
+// -------------------
+
+void Coords::expression::throwError(const size_t& a_pos, const std::string& a_msg) const {
+  std::stringstream emsg;
+  emsg << m_formula << ": " << a_msg << " at column " << a_pos + 1;
+  throw Coords::Error(emsg.str());
+}
+
+void Coords::expression::skipSpace(size_t& a_pos) const {
+  while (a_pos < m_formula.size() && isspace(static_cast<unsigned char>(m_formula[a_pos])))
+    ++a_pos;
+}
+
+void Coords::expression::emit(const opcode& an_opcode, const size_t& an_index, const double& a_constant) {
+  instruction an_instruction = {an_opcode, an_index, a_constant};
+  m_program.push_back(an_instruction);
+}
+
+void Coords::expression::parseExpr(size_t& a_pos) {
+  parseTerm(a_pos);
+  for (;;) {
+    skipSpace(a_pos);
+    if (a_pos >= m_formula.size() || (m_formula[a_pos] != '+' && m_formula[a_pos] != '-'))
+      return;
+    const char an_operator(m_formula[a_pos++]);
+    parseTerm(a_pos);
+    emit(an_operator == '+' ? op_add : op_subtract);
+  }
+}
+
+void Coords::expression::parseTerm(size_t& a_pos) {
+  parseUnary(a_pos);
+  for (;;) {
+    skipSpace(a_pos);
+    if (a_pos >= m_formula.size() || (m_formula[a_pos] != '*' && m_formula[a_pos] != '/'))
+      return;
+    const char an_operator(m_formula[a_pos++]);
+    parseUnary(a_pos);
+    emit(an_operator == '*' ? op_multiply : op_divide);
+  }
+}
+
+void Coords::expression::parseUnary(size_t& a_pos) {
+  skipSpace(a_pos);
+  if (a_pos < m_formula.size() && m_formula[a_pos] == '-') {
+    ++a_pos;
+    parseUnary(a_pos);
+    emit(op_negative);
+  } else {
+    parsePrimary(a_pos);
+  }
+}
+
+void Coords::expression::parsePrimary(size_t& a_pos) {
+  skipSpace(a_pos);
+
+  if (a_pos >= m_formula.size())
+    throwError(a_pos, "unexpected end");
+
+  const char c(m_formula[a_pos]);
+
+  if (c == '(') {
+    ++a_pos;
+    parseExpr(a_pos);
+    skipSpace(a_pos);
+    if (a_pos >= m_formula.size() || m_formula[a_pos] != ')')
+      throwError(a_pos, "expected )");
+    ++a_pos;
+    return;
+  }
+
+  if (isdigit(static_cast<unsigned char>(c)) || c == '.') {
+    const char* begin(m_formula.c_str() + a_pos);
+    char* end(NULL);
+    const double a_constant(strtod(begin, &end));
+    if (end == begin)
+      throwError(a_pos, "bad number");
+    a_pos += end - begin;
+    emit(op_constant, 0, a_constant);
+    return;
+  }
+
+  if (!isalpha(static_cast<unsigned char>(c)) && c != '_')
+    throwError(a_pos, "unexpected character");
+
+  const size_t name_pos(a_pos);
+  while (a_pos < m_formula.size() &&
+	 (isalnum(static_cast<unsigned char>(m_formula[a_pos])) || m_formula[a_pos] == '_'))
+    ++a_pos;
+  const std::string a_name(m_formula.substr(name_pos, a_pos - name_pos));
+
+  skipSpace(a_pos);
+  if (a_pos < m_formula.size() && m_formula[a_pos] == '(') {
+
+    // function call
+    size_t arity(0);
+    opcode an_opcode(op_sqrt);
+    if (a_name == "cross") {
+      arity = 2; an_opcode = op_cross;
+    } else if (a_name == "dot") {
+      arity = 2; an_opcode = op_dot;
+    } else if (a_name == "magnitude") {
+      arity = 1; an_opcode = op_magnitude;
+    } else if (a_name == "normalized") {
+      arity = 1; an_opcode = op_normalized;
+    } else if (a_name == "sqrt") {
+      arity = 1; an_opcode = op_sqrt;
+    } else {
+      throwError(name_pos, "unknown function " + a_name);
+    }
+
+    ++a_pos;
+    for (size_t i = 0; i < arity; ++i) {
+      if (i > 0) {
+	skipSpace(a_pos);
+	if (a_pos >= m_formula.size() || m_formula[a_pos] != ',')
+	  throwError(a_pos, a_name + " expected ,");
+	++a_pos;
+      }
+      parseExpr(a_pos);
+    }
+    skipSpace(a_pos);
+    if (a_pos >= m_formula.size() || m_formula[a_pos] != ')')
+      throwError(a_pos, a_name + " expected )");
+    ++a_pos;
+
+    emit(an_opcode);
+    return;
+  }
+
+  // variable
+  std::vector<std::string>::iterator found(std::find(m_names.begin(), m_names.end(), a_name));
+  if (found == m_names.end())
+    found = m_names.insert(m_names.end(), a_name);
+  emit(op_load, found - m_names.begin());
+}
+
+// ----------------------
+// ----- evaluation -----
+// ----------------------
+
+std::vector<size_t> Coords::expression::widths(const std::vector<argument>& an_args) const {
+
+  if (an_args.size() != m_names.size()) {
+    std::stringstream emsg;
+    emsg << m_formula << ": needs " << m_names.size() << " arguments, not " << an_args.size();
+    throw Coords::Error(emsg.str());
+  }
+
+  for (size_t i = 0; i < an_args.size(); ++i)
+    if (an_args[i].m_width != 1 && an_args[i].m_width != 3)
+      throw Coords::Error(m_formula + ": " + m_names[i] + " must be a scalar or a vector");
+
+  std::vector<size_t> result(m_program.size());
+  std::vector<size_t> stack;
+
+  for (size_t k = 0; k < m_program.size(); ++k) {
+    const instruction& an_instruction(m_program[k]);
+
+    size_t a(0), b(0);
+    switch (an_instruction.m_opcode) {
+    case op_add: case op_subtract: case op_multiply: case op_divide: case op_cross: case op_dot:
+      b = stack.back(); stack.pop_back();
+      a = stack.back(); stack.pop_back();
+      break;
+    case op_negative: case op_magnitude: case op_normalized: case op_sqrt:
+      a = stack.back(); stack.pop_back();
+      break;
+    default:
+      break;
+    }
+
+    size_t w(0);
+    switch (an_instruction.m_opcode) {
+    case op_load:      w = an_args[an_instruction.m_index].m_width; break;
+    case op_constant:  w = 1; break;
+    case op_add:
+    case op_subtract:  w = a == b ? a : 0; break;
+    case op_multiply:  w = a == b ? 1 : 3; break; // vector*vector is the dot product
+    case op_divide:    w = b == 1 ? a : 0; break;
+    case op_negative:  w = a; break;
+    case op_cross:     w = a == 3 && b == 3 ? 3 : 0; break;
+    case op_dot:       w = a == 3 && b == 3 ? 1 : 0; break;
+    case op_magnitude: w = a == 3 ? 1 : 0; break;
+    case op_normalized: w = a == 3 ? 3 : 0; break;
+    case op_sqrt:      w = a == 1 ? 1 : 0; break;
+    }
+
+    if (w == 0) {
+      static const char* s_names[] = {"load", "constant", "+", "-", "*", "/", "-",
+				      "cross()", "dot()", "magnitude()", "normalized()", "sqrt()"};
+      throw Coords::Error(m_formula + ": wrong scalar or vector argument for " +
+			  s_names[an_instruction.m_opcode]);
+    }
+
+    result[k] = w;
+    stack.push_back(w);
+  }
+
+  return result;
+}
+
+size_t Coords::expression::width(const std::vector<argument>& an_args) const {
+  return widths(an_args).back();
+}
+
+void Coords::expression::evaluate(const std::vector<argument>& an_args, double* a_result, const size_t& a_size) const {
+
+  const std::vector<size_t> a_widths(widths(an_args));
+  const size_t B(s_block_size);
+
+  // stack of blocks, x[B], y[B], z[B] each so the loops are unit stride
+  std::vector<double> scratch(3*B*m_depth);
+  std::vector<size_t> stack_widths(m_depth);
+
+  for (size_t begin = 0; begin < a_size; begin += B) {
+    const size_t n(std::min(B, a_size - begin));
+    size_t sp(0);
+
+    for (size_t k = 0; k < m_program.size(); ++k) {
+      const instruction& an_instruction(m_program[k]);
+
+      switch (an_instruction.m_opcode) {
+
+      case op_load: {
+	const argument& an_arg(an_args[an_instruction.m_index]);
+	const size_t w(an_arg.m_width);
+	double* top(&scratch[3*B*sp]);
+	for (size_t c = 0; c < w; ++c) {
+	  if (an_arg.m_broadcast) {
+	    std::fill(top + c*B, top + c*B + n, an_arg.m_data[c]);
+	  } else {
+	    const double* src(an_arg.m_data + begin*w + c);
+	    for (size_t i = 0; i < n; ++i)
+	      top[c*B + i] = src[i*w];
+	  }
+	}
+	stack_widths[sp++] = w;
+	break;
+      }
+
+      case op_constant: {
+	double* top(&scratch[3*B*sp]);
+	std::fill(top, top + n, an_instruction.m_constant);
+	stack_widths[sp++] = 1;
+	break;
+      }
+
+      case op_add:
+      case op_subtract:
+      case op_multiply:
+      case op_divide:
+      case op_cross:
+      case op_dot: {
+	--sp;
+	double* a(&scratch[3*B*(sp - 1)]);
+	const double* b(&scratch[3*B*sp]);
+	const size_t wa(stack_widths[sp - 1]), wb(stack_widths[sp]);
+
+	if (an_instruction.m_opcode == op_add) {
+	  for (size_t i = 0; i < wa*B; ++i)
+	    a[i] += b[i];
+
+	} else if (an_instruction.m_opcode == op_subtract) {
+	  for (size_t i = 0; i < wa*B; ++i)
+	    a[i] -= b[i];
+
+	} else if (an_instruction.m_opcode == op_divide) {
+	  for (size_t c = 0; c < wa; ++c)
+	    for (size_t i = 0; i < n; ++i)
+	      a[c*B + i] /= b[i];
+
+	} else if (an_instruction.m_opcode == op_cross) {
+	  for (size_t i = 0; i < n; ++i) {
+	    const double x(a[B + i]*b[2*B + i] - a[2*B + i]*b[B + i]);
+	    const double y(a[2*B + i]*b[i] - a[i]*b[2*B + i]);
+	    const double z(a[i]*b[B + i] - a[B + i]*b[i]);
+	    a[i] = x;
+	    a[B + i] = y;
+	    a[2*B + i] = z;
+	  }
+
+	} else if (wa == 3 && wb == 3) { // dot() or vector*vector
+	  for (size_t i = 0; i < n; ++i)
+	    a[i] = a[i]*b[i] + a[B + i]*b[B + i] + a[2*B + i]*b[2*B + i];
+
+	} else if (wa == 1 && wb == 3) {
+	  for (size_t i = 0; i < n; ++i) {
+	    const double s(a[i]);
+	    a[i] = s*b[i];
+	    a[B + i] = s*b[B + i];
+	    a[2*B + i] = s*b[2*B + i];
+	  }
+
+	} else { // vector*scalar or scalar*scalar
+	  for (size_t c = 0; c < wa; ++c)
+	    for (size_t i = 0; i < n; ++i)
+	      a[c*B + i] *= b[i];
+	}
+
+	stack_widths[sp - 1] = a_widths[k];
+	break;
+      }
+
+      case op_negative: {
+	double* a(&scratch[3*B*(sp - 1)]);
+	for (size_t i = 0; i < stack_widths[sp - 1]*B; ++i)
+	  a[i] = -a[i];
+	break;
+      }
+
+      case op_magnitude:
+      case op_normalized: {
+	double* a(&scratch[3*B*(sp - 1)]);
+	for (size_t i = 0; i < n; ++i) {
+	  const double h(sqrt(a[i]*a[i] + a[B + i]*a[B + i] + a[2*B + i]*a[2*B + i]));
+	  if (an_instruction.m_opcode == op_magnitude) {
+	    a[i] = h;
+	  } else {
+	    a[i] /= h;
+	    a[B + i] /= h;
+	    a[2*B + i] /= h;
+	  }
+	}
+	stack_widths[sp - 1] = a_widths[k];
+	break;
+      }
+
+      case op_sqrt: {
+	double* a(&scratch[3*B*(sp - 1)]);
+	for (size_t i = 0; i < n; ++i)
+	  a[i] = sqrt(a[i]);
+	break;
+      }
+
+      }
+    }
+
+    // packed x, y, z out
+    const double* top(&scratch[0]);
+    const size_t w(stack_widths[0]);
+    double* dst(a_result + begin*w);
+    for (size_t c = 0; c < w; ++c)
+      for (size_t i = 0; i < n; ++i)
+	dst[i*w + c] = top[c*B + i];
+  }
+}
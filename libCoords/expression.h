@@ -0,0 +1,120 @@
+// ================================================================
+// Filename:    expression.h
+//
+// Description: This defines a compiled vector formula, e.g.
+//              "m*a + q*cross(v, B)", evaluated over whole arrays
+//              of Cartesian and scalar values in one pass with out
+//              a temporary Cartesian for every operator.
+//
+// Author:      L.R. McFarland
+// Created:     2026 Oct 18
+// Language:    C++
+//
+//  Coords is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  Coords is distributed in the hope that it will be useful, but
+//  WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with Coords.  If not, see <http://www.gnu.org/licenses/>.
+// ================================================================
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <utils.h>
+
+namespace Coords {
+
+  // ======================
+  // ===== expression =====
+  // ======================
+
+  // The formula is compiled once to a small stack program and then
+  // run over blocks of elements, so the interpreter overhead is per
+  // block, not per element, and the loops over a block vectorize.
+  //
+  // Grammar, with the Cartesian operator meanings:
+  //
+  //   expr    := term (('+' | '-') term)*
+  //   term    := unary (('*' | '/') unary)*
+  //   unary   := '-' unary | primary
+  //   primary := number | name | name '(' expr (',' expr)* ')' | '(' expr ')'
+  //
+  // Values are scalars or vectors. + and - take two of the same
+  // kind, scalar*vector scales, vector*vector is the dot product and
+  // / divides by a scalar. The functions are cross(v, v), dot(v, v),
+  // magnitude(v), normalized(v) and sqrt(s). Division by zero follows
+  // IEEE like the batch functions, it does not throw.
+  //
+  // Thread safety: an expression is immutable after construction,
+  // evaluate() is reentrant.
+
+  class expression {
+
+  public:
+
+    // one per names() entry, packed x, y, z for vectors.
+    struct argument {
+      const double* m_data;
+      size_t        m_width;     // 1 scalar, 3 vector
+      bool          m_broadcast; // one value for all the elements
+    };
+
+    explicit expression(const std::string& a_formula); // throws Error on syntax errors
+
+    const std::string&              formula() const {return m_formula;}
+    const std::vector<std::string>& names() const   {return m_names;} // in order of first use
+
+    // 1 or 3 for the result of these argument widths. Throws Error
+    // on a kind mismatch, e.g. vector + scalar.
+    size_t width(const std::vector<argument>& an_args) const;
+
+    // a_result holds a_size results of width(an_args) each. It may be
+    // the data of an argument of the same width, e.g. v = v + a*dt,
+    // but not otherwise overlap one.
+    void evaluate(const std::vector<argument>& an_args, double* a_result, const size_t& a_size) const;
+
+    // elements per block, the scratch stack is 3*depth*block doubles.
+    static const size_t s_block_size;
+
+  private:
+
+    enum opcode {
+      op_load, op_constant,
+      op_add, op_subtract, op_multiply, op_divide, op_negative,
+      op_cross, op_dot, op_magnitude, op_normalized, op_sqrt
+    };
+
+    struct instruction {
+      opcode m_opcode;
+      size_t m_index;    // op_load argument
+      double m_constant; // op_constant value
+    };
+
+    // recursive descent over m_formula
+    void parseExpr(size_t& a_pos);
+    void parseTerm(size_t& a_pos);
+    void parseUnary(size_t& a_pos);
+    void parsePrimary(size_t& a_pos);
+    void skipSpace(size_t& a_pos) const;
+    void throwError(const size_t& a_pos, const std::string& a_msg) const;
+    void emit(const opcode& an_opcode, const size_t& an_index=0, const double& a_constant=0);
+
+    std::vector<size_t> widths(const std::vector<argument>& an_args) const; // of each instruction result
+
+    std::string              m_formula;
+    std::vector<std::string> m_names;
+    std::vector<instruction> m_program;
+    size_t                   m_depth; // maximum stack depth
+
+  };
+
+} // end namespace Coords
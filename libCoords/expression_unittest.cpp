@@ -0,0 +1,194 @@
+// ================================================================
+// Filename:    expression_unittest.cpp
+// Description: This is the gtest unittest of the compiled vector
+//              formulas.
+//
+// Author:      L.R. McFarland, lrm@starbug.com
+// Created:     2026 Oct 18
+// Language:    C++
+//
+// See also: http://code.google.com/p/googletest/wiki/Primer
+//
+//  Coordinates is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  Coordinates is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with Coordinates.  If not, see <http://www.gnu.org/licenses/>.
+// ================================================================
+
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <angle.h>
+#include <Cartesian.h>
+#include <expression.h>
+
+
+namespace {
+
+  Coords::expression::argument vectors(const std::vector<Coords::Cartesian>& some_vectors) {
+    Coords::expression::argument an_arg = {&some_vectors[0].x(), 3, false};
+    return an_arg;
+  }
+
+  Coords::expression::argument scalars(const std::vector<double>& some_scalars) {
+    Coords::expression::argument an_arg = {&some_scalars[0], 1, false};
+    return an_arg;
+  }
+
+  Coords::expression::argument broadcast(const double* a_value, const size_t& a_width) {
+    Coords::expression::argument an_arg = {a_value, a_width, true};
+    return an_arg;
+  }
+
+  // ---------------------------
+  // ----- random vectors -----
+  // ---------------------------
+
+  class RandomExpression : public ::testing::Test {
+  protected:
+
+    // more than one block and a partial one
+    enum {s_size = 1000};
+
+    virtual void SetUp() {
+      std::mt19937 generator(12345);
+      std::uniform_real_distribution<double> uniform(-10, 10);
+      for (size_t i = 0; i < s_size; ++i) {
+	m.push_back(uniform(generator));
+	q.push_back(uniform(generator));
+	a.push_back(Coords::Cartesian(uniform(generator), uniform(generator), uniform(generator)));
+	v.push_back(Coords::Cartesian(uniform(generator), uniform(generator), uniform(generator)));
+	B.push_back(Coords::Cartesian(uniform(generator), uniform(generator), uniform(generator)));
+      }
+    }
+
+    std::vector<double> m, q;
+    std::vector<Coords::Cartesian> a, v, B;
+  };
+
+  TEST_F(RandomExpression, Lorentz) {
+    Coords::expression F("m*a + q*cross(v, B)");
+
+    ASSERT_EQ(5u, F.names().size());
+    EXPECT_EQ("m", F.names()[0]);
+    EXPECT_EQ("B", F.names()[4]);
+
+    std::vector<Coords::expression::argument> args = {scalars(m), vectors(a), scalars(q), vectors(v)};
+    EXPECT_THROW(F.width(args), Coords::Error); // B is missing
+    args.push_back(vectors(B));
+
+    ASSERT_EQ(3u, F.width(args));
+
+    std::vector<Coords::Cartesian> result(s_size);
+    F.evaluate(args, const_cast<double*>(&result[0].x()), s_size);
+
+    for (size_t i = 0; i < s_size; ++i) {
+      const Coords::Cartesian expected(m[i]*a[i] + q[i]*Coords::cross(v[i], B[i]));
+      EXPECT_DOUBLE_EQ(expected.x(), result[i].x());
+      EXPECT_DOUBLE_EQ(expected.y(), result[i].y());
+      EXPECT_DOUBLE_EQ(expected.z(), result[i].z());
+    }
+  }
+
+  TEST_F(RandomExpression, Scalars) {
+    Coords::expression e("-(v*B)/magnitude(v) + dot(a, normalized(B)) - sqrt(m*m) + 2.5e-1");
+    std::vector<Coords::expression::argument> args = {vectors(v), vectors(B), vectors(a), scalars(m)};
+    ASSERT_EQ(1u, e.width(args));
+
+    std::vector<double> result(s_size);
+    e.evaluate(args, &result[0], s_size);
+
+    for (size_t i = 0; i < s_size; ++i) {
+      const double expected(-(v[i]*B[i])/v[i].magnitude() + Coords::dot(a[i], B[i].normalized()) - fabs(m[i]) + 0.25);
+      EXPECT_NEAR(expected, result[i], 1e-12);
+    }
+  }
+
+  TEST_F(RandomExpression, Broadcast) {
+    Coords::expression e("q*(v - c)/k");
+    const double c[] = {1, 2, 3};
+    const double k(4);
+    std::vector<Coords::expression::argument> args = {scalars(q), vectors(v), broadcast(c, 3), broadcast(&k, 1)};
+
+    std::vector<Coords::Cartesian> result(s_size);
+    e.evaluate(args, const_cast<double*>(&result[0].x()), s_size);
+
+    for (size_t i = 0; i < s_size; ++i) {
+      const Coords::Cartesian expected(q[i]*(v[i] - Coords::Cartesian(1, 2, 3))/4.0);
+      EXPECT_DOUBLE_EQ(expected.x(), result[i].x());
+      EXPECT_DOUBLE_EQ(expected.y(), result[i].y());
+      EXPECT_DOUBLE_EQ(expected.z(), result[i].z());
+    }
+  }
+
+  // ----------------------------
+  // ----- fixed expressions -----
+  // ----------------------------
+
+  TEST(FixedExpression, SyntaxErrors) {
+    EXPECT_THROW(Coords::expression(""), Coords::Error);
+    EXPECT_THROW(Coords::expression("a +"), Coords::Error);
+    EXPECT_THROW(Coords::expression("(a + b"), Coords::Error);
+    EXPECT_THROW(Coords::expression("a b"), Coords::Error);
+    EXPECT_THROW(Coords::expression("cross(a)"), Coords::Error);
+    EXPECT_THROW(Coords::expression("curl(a)"), Coords::Error);
+    EXPECT_THROW(Coords::expression("a $ b"), Coords::Error);
+
+    try {
+      Coords::expression("a + * b");
+      FAIL();
+    } catch (const Coords::Error& err) {
+      EXPECT_STREQ("a + * b: unexpected character at column 5", err.what());
+    }
+  }
+
+  TEST(FixedExpression, KindErrors) {
+    // names are in order of first use, s first then v
+    const double s(1), v[] = {1, 2, 3};
+    std::vector<Coords::expression::argument> sv = {broadcast(&s, 1), broadcast(v, 3)};
+
+    EXPECT_THROW(Coords::expression("s + v").width(sv), Coords::Error);
+    EXPECT_THROW(Coords::expression("s/v").width(sv), Coords::Error);
+    EXPECT_THROW(Coords::expression("cross(s, v)").width(sv), Coords::Error);
+    EXPECT_THROW(Coords::expression("magnitude(s)*v").width(sv), Coords::Error);
+    EXPECT_THROW(Coords::expression("s + sqrt(v)").width(sv), Coords::Error);
+    EXPECT_THROW(Coords::expression("s").width(sv), Coords::Error);
+
+    EXPECT_EQ(3u, Coords::expression("s*v").width(sv));
+    EXPECT_EQ(1u, Coords::expression("s + v*v").width(sv)); // dot product like Cartesian
+    EXPECT_EQ(3u, Coords::expression("-v/s").width(std::vector<Coords::expression::argument>(sv.rbegin(), sv.rend())));
+  }
+
+  TEST(FixedExpression, Empty) {
+    Coords::expression e("a*2");
+    const double a(1);
+    std::vector<Coords::expression::argument> args = {broadcast(&a, 1)};
+    e.evaluate(args, NULL, 0);
+
+    double result[3];
+    e.evaluate(args, result, 3);
+    EXPECT_EQ(2, result[0]);
+    EXPECT_EQ(2, result[2]);
+  }
+
+} // end anonymous namespace
+
+
+// ==================
+// ===== main() =====
+// ==================
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
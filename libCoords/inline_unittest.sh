@@ -0,0 +1,12 @@
+#!/bin/bash
+#
+# Shell wrapper to set up gtest environment
+#
+# Runs the unittests built with -D COORDS_INLINE.
+#
+
+. ./setenv.sh
+
+./angle_inline_unittest "$@" && \
+./Cartesian_inline_unittest "$@" && \
+./spherical_inline_unittest "$@"
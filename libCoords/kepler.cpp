@@ -0,0 +1,332 @@
+// ==================================================================
+// Filename:    kepler.cpp
+//
+// Description: Implements the Keplerian orbit and its batch
+//              propagation.
+//
+// Author:      L.R. McFarland
+// Created:     2026 Oct 18
+// Language:    C++
+//
+//  Coordinates is free software: you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License as
+//  published by the Free Software Foundation, either version 3 of the
+//  License, or (at your option) any later version.
+//
+//  Coordinates is distributed in the hope that it will be useful, but
+//  WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with Coordinates.  If not, see <http://www.gnu.org/licenses/>.
+// ==================================================================
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include <kepler.h>
+
+namespace {
+
+  // times a block, as expression
+  const size_t s_block(256);
+
+  // Newton steps, more than the worst case near e = 1 needs
+  const int s_iterations(64);
+
+  // the last step of a converged block, radians
+  const double s_tolerance(4e-15);
+
+  // E - e sin(E) = M for M in [-pi, pi], from Danby's starting value,
+  // for which Newton's method converges for all e < 1. Returns cos(E)
+  // and sin(E).
+  //
+  // The error after a step d is at most K d^2, K = e/(2(1 - e)), so
+  // the block stops once that is below the tolerance with out a step
+  // to show it. cos and sin of the last E are those of the E before
+  // it turned through d, to d^3.
+  void ellipticAnomalies(const double* some_means, double* some_cosines, double* some_sines, const size_t& a_size,
+			 const double& an_eccentricity) {
+    const double e(an_eccentricity);
+    const double K(e/(2*(1 - e)));
+
+    double anomalies[s_block];
+    for (size_t k = 0; k < a_size; ++k)
+      anomalies[k] = some_means[k] + std::copysign(0.85*e, some_means[k]);
+
+    for (int iteration = 0; iteration < s_iterations; ++iteration) {
+      double worst(0);
+      for (size_t k = 0; k < a_size; ++k) {
+	const double E(anomalies[k]);
+	const double c(std::cos(E)), s(std::sin(E));
+	const double d((E - e*s - some_means[k])/(1 - e*c));
+	const double half_d2(0.5*d*d);
+	anomalies[k] = E - d;
+	some_cosines[k] = c - c*half_d2 + s*d;
+	some_sines[k] = s - s*half_d2 - c*d;
+	worst = std::max(worst, std::fabs(d));
+      }
+      if (worst <= 1e-6 && K*worst*worst <= s_tolerance)
+	break;
+    }
+  }
+
+  // e sinh(H) - H = M, from the logarithmic starting value. Returns
+  // cosh(H) and sinh(H).
+  void hyperbolicAnomalies(const double* some_means, double* some_cosines, double* some_sines, const size_t& a_size,
+			   const double& an_eccentricity) {
+    const double e(an_eccentricity);
+
+    double anomalies[s_block];
+    for (size_t k = 0; k < a_size; ++k)
+      anomalies[k] = std::copysign(std::log(2*std::fabs(some_means[k])/e + 1.8), some_means[k]);
+
+    for (int iteration = 0; iteration < s_iterations; ++iteration) {
+      double worst(0);
+      for (size_t k = 0; k < a_size; ++k) {
+	const double H(anomalies[k]);
+	const double step((e*std::sinh(H) - H - some_means[k])/(e*std::cosh(H) - 1));
+	anomalies[k] = H - step;
+	worst = std::max(worst, std::fabs(step)/(1 + std::fabs(H)));
+      }
+      if (worst <= s_tolerance)
+	break;
+    }
+
+    for (size_t k = 0; k < a_size; ++k) {
+      some_cosines[k] = std::cosh(anomalies[k]);
+      some_sines[k] = std::sinh(anomalies[k]);
+    }
+  }
+
+} // end anonymous namespace
+
+
+const double Coords::orbit::s_GM_Sun(1.32712440018e20);
+const double Coords::orbit::s_GM_Earth(3.986004418e14);
+
+
+// ------------------------
+// ----- constructors -----
+// ------------------------
+
+Coords::orbit::orbit(const double& a_semimajor_axis,
+		     const double& an_eccentricity,
+		     const angle& an_inclination,
+		     const angle& an_ascending_node,
+		     const angle& an_argument_of_periapsis,
+		     const angle& a_mean_anomaly,
+		     const DateTime& an_epoch,
+		     const double& a_mu)
+  : m_semimajor_axis(a_semimajor_axis),
+    m_eccentricity(an_eccentricity),
+    m_inclination(an_inclination),
+    m_ascending_node(an_ascending_node),
+    m_argument_of_periapsis(an_argument_of_periapsis),
+    m_mean_anomaly(a_mean_anomaly),
+    m_epoch(an_epoch),
+    m_mu(a_mu),
+    m_epoch_nanoseconds(an_epoch.toUnixNanoseconds()),
+    m_mean_motion(0)
+{
+  const double infinity(std::numeric_limits<double>::infinity());
+  if (!(a_mu > 0 && a_mu < infinity))
+    throw Error("orbit mu must be positive");
+  if (!(an_eccentricity >= 0 && an_eccentricity < infinity) || an_eccentricity == 1)
+    throw Error("orbit eccentricity must be in [0, 1) or greater than 1");
+  if (!(std::fabs(a_semimajor_axis) > 0 && std::fabs(a_semimajor_axis) < infinity) ||
+      (a_semimajor_axis > 0) != (an_eccentricity < 1))
+    throw Error("orbit semi-major axis must be positive for an ellipse and negative for a hyperbola");
+
+  const double a(std::fabs(a_semimajor_axis));
+  m_mean_motion = std::sqrt(a_mu/(a*a*a));
+
+  const double ci(std::cos(an_inclination.radians())), si(std::sin(an_inclination.radians()));
+  const double cn(std::cos(an_ascending_node.radians())), sn(std::sin(an_ascending_node.radians()));
+  const double cw(std::cos(an_argument_of_periapsis.radians())), sw(std::sin(an_argument_of_periapsis.radians()));
+
+  m_p[0] = cn*cw - sn*sw*ci;
+  m_p[1] = sn*cw + cn*sw*ci;
+  m_p[2] = sw*si;
+
+  m_q[0] = -cn*sw - sn*cw*ci;
+  m_q[1] = -sn*sw + cn*cw*ci;
+  m_q[2] = cw*si;
+}
+
+Coords::orbit Coords::orbit::fromState(const Cartesian& a_position,
+				       const Cartesian& a_velocity,
+				       const DateTime& an_epoch,
+				       const double& a_mu) {
+
+  if (!(a_mu > 0))
+    throw Error("orbit mu must be positive");
+
+  const double r(a_position.magnitude());
+  const double v2(a_velocity.magnitude2());
+  const Cartesian h(cross(a_position, a_velocity));
+  const double h_magnitude(h.magnitude());
+  if (!(h_magnitude > 0))
+    throw Error("orbit state is radial, it has no plane");
+  const Cartesian h_unit(h/h_magnitude);
+
+  const Cartesian eccentricity_vector(((v2 - a_mu/r)*a_position - dot(a_position, a_velocity)*a_velocity)/a_mu);
+  double e(eccentricity_vector.magnitude());
+  const double a(-a_mu/(2*(0.5*v2 - a_mu/r)));
+
+  // the ascending node, the x axis in the plane of the equator
+  const Cartesian node_vector(-h.y(), h.x(), 0);
+  const double node_magnitude(node_vector.magnitude());
+  Cartesian node(Ux);
+  double ascending_node(0);
+  if (node_magnitude > 1e-15*h_magnitude) {
+    node = node_vector/node_magnitude;
+    ascending_node = std::atan2(node.y(), node.x());
+  }
+  const double inclination(std::atan2(std::sqrt(h.x()*h.x() + h.y()*h.y()), h.z()));
+
+  // periapsis, the node for a circle
+  Cartesian p(node);
+  if (e > 1e-12)
+    p = eccentricity_vector/e;
+  else
+    e = 0;
+  const Cartesian q(cross(h_unit, p));
+
+  const double periapsis(std::atan2(dot(cross(node, p), h_unit), dot(node, p)));
+  const double true_anomaly(std::atan2(dot(a_position, q), dot(a_position, p)));
+
+  double mean_anomaly(0);
+  if (e < 1) {
+    const double E(std::atan2(std::sqrt(1 - e*e)*std::sin(true_anomaly), e + std::cos(true_anomaly)));
+    mean_anomaly = E - e*std::sin(E);
+  } else {
+    const double H(std::asinh(std::sqrt(e*e - 1)*std::sin(true_anomaly)/(1 + e*std::cos(true_anomaly))));
+    mean_anomaly = e*std::sinh(H) - H;
+  }
+
+  return orbit(a, e,
+	       angle(angle::rad2deg(inclination)),
+	       angle(angle::rad2deg(ascending_node)),
+	       angle(angle::rad2deg(periapsis)),
+	       angle(angle::rad2deg(mean_anomaly)),
+	       an_epoch, a_mu);
+}
+
+
+// -----------------------
+// ----- propagation -----
+// -----------------------
+
+double Coords::orbit::period() const {
+  if (m_eccentricity < 1)
+    return 2*M_PI/m_mean_motion;
+  return std::numeric_limits<double>::infinity();
+}
+
+void Coords::orbit::states(const double* some_seconds, const size_t& a_size,
+			   double* a_positions, double* a_velocities) const {
+
+  const double e(m_eccentricity);
+  const bool is_elliptic(e < 1);
+  const double a(m_semimajor_axis);
+  const double b(std::fabs(a)*std::sqrt(std::fabs(1 - e*e)));
+  const double v(std::sqrt(m_mu*std::fabs(a)));
+  const double w(v*std::sqrt(std::fabs(1 - e*e)));
+  const double mean_anomaly(m_mean_anomaly.radians());
+  const double n(m_mean_motion);
+
+  double means[s_block], cosines[s_block], sines[s_block];
+
+  for (size_t begin = 0; begin < a_size; begin += s_block) {
+
+    const size_t size(std::min(s_block, a_size - begin));
+    const double* seconds(some_seconds + begin);
+
+    if (is_elliptic) {
+      for (size_t k = 0; k < size; ++k)
+	means[k] = std::remainder(mean_anomaly + n*seconds[k], 2*M_PI);
+      ellipticAnomalies(means, cosines, sines, size, e);
+    } else {
+      for (size_t k = 0; k < size; ++k)
+	means[k] = mean_anomaly + n*seconds[k];
+      hyperbolicAnomalies(means, cosines, sines, size, e);
+    }
+
+    // in the plane of the orbit, x to periapsis. cos and sin for an
+    // ellipse, cosh and sinh for a hyperbola, the rest is the same.
+    double* position(a_positions + 3*begin);
+    double* velocity(a_velocities ? a_velocities + 3*begin : 0);
+    for (size_t k = 0; k < size; ++k) {
+      const double c(cosines[k]);
+      const double s(sines[k]);
+      const double x(a*(c - e));
+      const double y(b*s);
+      position[3*k]     = x*m_p[0] + y*m_q[0];
+      position[3*k + 1] = x*m_p[1] + y*m_q[1];
+      position[3*k + 2] = x*m_p[2] + y*m_q[2];
+      if (velocity) {
+	const double r(a*(1 - e*c));
+	const double vx(-v*s/r);
+	const double vy(w*c/r);
+	velocity[3*k]     = vx*m_p[0] + vy*m_q[0];
+	velocity[3*k + 1] = vx*m_p[1] + vy*m_q[1];
+	velocity[3*k + 2] = vx*m_p[2] + vy*m_q[2];
+      }
+    }
+  }
+}
+
+void Coords::orbit::state(const DateTime& a_time, Cartesian& a_position, Cartesian& a_velocity) const {
+  const double seconds(double(a_time.toUnixNanoseconds() - m_epoch_nanoseconds)*1e-9);
+  double position[3], velocity[3];
+  states(&seconds, 1, position, velocity);
+  a_position = Cartesian(position[0], position[1], position[2]);
+  a_velocity = Cartesian(velocity[0], velocity[1], velocity[2]);
+}
+
+Coords::Cartesian Coords::orbit::position(const DateTime& a_time) const {
+  const double seconds(double(a_time.toUnixNanoseconds() - m_epoch_nanoseconds)*1e-9);
+  double position[3];
+  states(&seconds, 1, position);
+  return Cartesian(position[0], position[1], position[2]);
+}
+
+
+// -----------------------------
+// ----- batch propagation -----
+// -----------------------------
+
+void Coords::propagate(const orbit* some_orbits, const size_t& a_orbits,
+		       const int64_t* some_unix_nanoseconds, const size_t& a_times,
+		       double* a_positions, double* a_velocities,
+		       const size_t& a_threads) {
+
+  // about 16384 states a chunk
+  const size_t grain(std::max(size_t(1), 16384/std::max(a_times, size_t(1))));
+
+  parallelFor(a_orbits, [&] (const size_t& a_begin, const size_t& a_end) {
+      std::vector<double> seconds(a_times);
+      for (size_t i = a_begin; i < a_end; ++i) {
+	const int64_t epoch(some_orbits[i].epoch().toUnixNanoseconds());
+	for (size_t t = 0; t < a_times; ++t)
+	  seconds[t] = double(some_unix_nanoseconds[t] - epoch)*1e-9;
+	some_orbits[i].states(seconds.data(), a_times,
+			      a_positions + 3*i*a_times,
+			      a_velocities ? a_velocities + 3*i*a_times : 0);
+      }
+    }, a_threads, grain);
+}
+
+void Coords::propagate(const orbit* some_orbits, const size_t& a_orbits,
+		       const DateTime* some_times, const size_t& a_times,
+		       double* a_positions, double* a_velocities,
+		       const size_t& a_threads) {
+  std::vector<int64_t> nanoseconds(a_times);
+  for (size_t t = 0; t < a_times; ++t)
+    nanoseconds[t] = some_times[t].toUnixNanoseconds();
+  propagate(some_orbits, a_orbits, nanoseconds.data(), a_times, a_positions, a_velocities, a_threads);
+}
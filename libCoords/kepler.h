@@ -0,0 +1,151 @@
+// ================================================================
+// Filename:    kepler.h
+//
+// Description: This defines a two body, Keplerian, orbit and its
+//              propagation to many times for many objects at once.
+//
+// Author:      L.R. McFarland
+// Created:     2026 Oct 18
+// Language:    C++
+//
+//  Coords is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  Coords is distributed in the hope that it will be useful, but
+//  WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with Coords.  If not, see <http://www.gnu.org/licenses/>.
+// ================================================================
+
+#pragma once
+
+#include <stdint.h>
+
+#include <angle.h>
+#include <Cartesian.h>
+#include <datetime.h>
+#include <parallel.h>
+
+namespace Coords {
+
+  // =================
+  // ===== orbit =====
+  // =================
+
+  // Classical elements: the semi-major axis, positive for an ellipse
+  // and negative for a hyperbola, the eccentricity, the inclination,
+  // the longitude of the ascending node and the argument of periapsis
+  // in the reference frame, and the mean anomaly at the epoch. mu is
+  // G*(M + m) in the same length and seconds, e.g. s_GM_Earth with
+  // meters.
+  //
+  // states() solves Kepler's equation by Newton's method over blocks
+  // of times at once, every time in a block taking the same steps
+  // until the slowest has converged, so the loops have no branches.
+  //
+  // Parabolic orbits, eccentricity exactly 1, are not supported and
+  // Newton's method slows near them.
+  //
+  // Thread safety: orbit is a value. Const methods may be called from
+  // any number of threads.
+
+  class orbit {
+
+  public:
+
+    static const double s_GM_Sun;   // m^3/s^2
+    static const double s_GM_Earth; // m^3/s^2
+
+    // throws Error on elements that are not an ellipse or a hyperbola
+    orbit(const double& a_semimajor_axis,
+	  const double& an_eccentricity,
+	  const angle& an_inclination,
+	  const angle& an_ascending_node,
+	  const angle& an_argument_of_periapsis,
+	  const angle& a_mean_anomaly,
+	  const DateTime& an_epoch,
+	  const double& a_mu);
+
+    // the orbit through position a_position with velocity a_velocity
+    // at an_epoch. Circular orbits measure the anomaly from the
+    // ascending node and equatorial ones the node from the x axis.
+    static orbit fromState(const Cartesian& a_position,
+			   const Cartesian& a_velocity,
+			   const DateTime& an_epoch,
+			   const double& a_mu);
+
+    // implicit copy, move and dtor.
+
+    // ----- accessors -----
+
+    const double&   semimajorAxis() const        {return m_semimajor_axis;}
+    const double&   eccentricity() const         {return m_eccentricity;}
+    const angle&    inclination() const          {return m_inclination;}
+    const angle&    ascendingNode() const        {return m_ascending_node;}
+    const angle&    argumentOfPeriapsis() const  {return m_argument_of_periapsis;}
+    const angle&    meanAnomaly() const          {return m_mean_anomaly;} // at the epoch
+    const DateTime& epoch() const                {return m_epoch;}
+    const double&   mu() const                   {return m_mu;}
+
+    const double&   meanMotion() const           {return m_mean_motion;} // radians/s
+    double          period() const; // s, infinite for a hyperbola
+
+    // ----- propagation -----
+
+    // a_size positions and, if a_velocities is not 0, velocities
+    // packed x, y, z at some_seconds after the epoch.
+    void states(const double* some_seconds, const size_t& a_size,
+		double* a_positions, double* a_velocities=0) const;
+
+    void state(const DateTime& a_time, Cartesian& a_position, Cartesian& a_velocity) const;
+    Cartesian position(const DateTime& a_time) const;
+
+  private:
+
+    double   m_semimajor_axis;
+    double   m_eccentricity;
+    angle    m_inclination;
+    angle    m_ascending_node;
+    angle    m_argument_of_periapsis;
+    angle    m_mean_anomaly;
+    DateTime m_epoch;
+    double   m_mu;
+
+    int64_t  m_epoch_nanoseconds; // Unix
+    double   m_mean_motion;
+    double   m_p[3]; // unit vector to periapsis
+    double   m_q[3]; // unit vector 90 degrees ahead of it in the orbit
+
+  };
+
+
+  // -----------------------------
+  // ----- batch propagation -----
+  // -----------------------------
+
+  // the positions and, if a_velocities is not 0, velocities of
+  // a_orbits orbits at a_times times, packed x, y, z with the times of
+  // an orbit together, i.e. C contiguous (a_orbits, a_times, 3) numpy
+  // arrays. Parallel over the orbits, a_threads 0 is
+  // hardwareThreads(). Cartesian2spherical() converts them for
+  // pointing.
+  //
+  // The times are Unix nanoseconds, i.e. numpy datetime64[ns], or
+  // DateTimes in its range.
+
+  void propagate(const orbit* some_orbits, const size_t& a_orbits,
+		 const int64_t* some_unix_nanoseconds, const size_t& a_times,
+		 double* a_positions, double* a_velocities=0,
+		 const size_t& a_threads=0);
+
+  void propagate(const orbit* some_orbits, const size_t& a_orbits,
+		 const DateTime* some_times, const size_t& a_times,
+		 double* a_positions, double* a_velocities=0,
+		 const size_t& a_threads=0);
+
+} // end namespace Coords
@@ -0,0 +1,254 @@
+// ================================================================
+// Filename:    kepler_unittest.cpp
+// Description: This is the gtest unittest of the Keplerian orbit
+//              propagator.
+//
+// Author:      L.R. McFarland, lrm@starbug.com
+// Created:     2026 Oct 18
+// Language:    C++
+//
+// See also: http://code.google.com/p/googletest/wiki/Primer
+//
+//  Coordinates is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  Coordinates is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with Coordinates.  If not, see <http://www.gnu.org/licenses/>.
+// ================================================================
+
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <angle.h>
+#include <Cartesian.h>
+#include <kepler.h>
+#include <particles.h>
+
+
+namespace {
+
+  const Coords::DateTime s_epoch(2026, 10, 18, 12, 0, 0);
+
+  // the difference of two angles in degrees, in [-180, 180)
+  double difference(const Coords::angle& a, const Coords::angle& b) {
+    return std::remainder(a.value() - b.value(), 360.0);
+  }
+
+  // --------------------------
+  // ----- fixed orbits -----
+  // --------------------------
+
+  TEST(FixedOrbit, Circular) {
+    // a quarter of the way round from the node is along y
+    const double a(7e6);
+    Coords::orbit an_orbit(a, 0, Coords::angle(0), Coords::angle(0), Coords::angle(0), Coords::angle(0),
+			   s_epoch, Coords::orbit::s_GM_Earth);
+    const double v(std::sqrt(Coords::orbit::s_GM_Earth/a));
+    EXPECT_NEAR(2*M_PI*a/v, an_orbit.period(), 1e-9);
+
+    const double quarter(an_orbit.period()/4);
+    double position[3], velocity[3];
+    an_orbit.states(&quarter, 1, position, velocity);
+    EXPECT_NEAR(0, position[0], 1e-6);
+    EXPECT_NEAR(a, position[1], 1e-6);
+    EXPECT_NEAR(-v, velocity[0], 1e-9);
+    EXPECT_NEAR(0, velocity[1], 1e-9);
+  }
+
+  TEST(FixedOrbit, KeplersEquation) {
+    // every mean anomaly, up to nearly parabolic, returns to its state
+    // after whole periods
+    const double eccentricities[] = {0, 0.1, 0.5, 0.9, 0.99, 0.9999};
+    for (size_t k = 0; k < 6; ++k) {
+      for (int m = -180; m < 180; m += 5) {
+	Coords::orbit an_orbit(1, eccentricities[k], Coords::angle(30), Coords::angle(40), Coords::angle(50),
+			       Coords::angle(m), s_epoch, 1);
+	const double times[] = {0, an_orbit.period(), 3*an_orbit.period()};
+	double positions[9], velocities[9];
+	an_orbit.states(times, 3, positions, velocities);
+	for (int i = 0; i < 3; ++i) {
+	  ASSERT_NEAR(positions[i], positions[3 + i], 1e-10) << "e " << eccentricities[k] << " M " << m;
+	  ASSERT_NEAR(positions[i], positions[6 + i], 1e-10) << "e " << eccentricities[k] << " M " << m;
+	}
+
+	// and back to the mean anomaly, E - e sin E = M
+	const Coords::orbit round_trip(Coords::orbit::fromState(Coords::Cartesian(positions[0], positions[1], positions[2]),
+								 Coords::Cartesian(velocities[0], velocities[1], velocities[2]),
+								 s_epoch, 1));
+	if (eccentricities[k] > 0)
+	  ASSERT_NEAR(0, difference(an_orbit.meanAnomaly(), round_trip.meanAnomaly()), 1e-9)
+	    << "e " << eccentricities[k] << " M " << m;
+      }
+    }
+  }
+
+  TEST(FixedOrbit, FromState) {
+    const Coords::orbit an_orbit(2.5, 0.3, Coords::angle(63.4), Coords::angle(-120), Coords::angle(270),
+				 Coords::angle(10), s_epoch, 3);
+    const Coords::DateTime later(2026, 10, 18, 12, 0, 4.5);
+    Coords::Cartesian r, v;
+    an_orbit.state(later, r, v);
+    EXPECT_EQ(r, an_orbit.position(later));
+
+    const Coords::orbit elements(Coords::orbit::fromState(r, v, later, 3));
+    EXPECT_NEAR(2.5, elements.semimajorAxis(), 1e-12);
+    EXPECT_NEAR(0.3, elements.eccentricity(), 1e-12);
+    EXPECT_NEAR(0, difference(Coords::angle(63.4), elements.inclination()), 1e-10);
+    EXPECT_NEAR(0, difference(Coords::angle(-120), elements.ascendingNode()), 1e-10);
+    EXPECT_NEAR(0, difference(Coords::angle(270), elements.argumentOfPeriapsis()), 1e-10);
+
+    // the same orbit from its own epoch
+    Coords::Cartesian r2, v2;
+    elements.state(s_epoch, r2, v2);
+    Coords::Cartesian r0, v0;
+    an_orbit.state(s_epoch, r0, v0);
+    EXPECT_NEAR(0, (r2 - r0).magnitude(), 1e-12);
+    EXPECT_NEAR(0, (v2 - v0).magnitude(), 1e-12);
+  }
+
+  TEST(FixedOrbit, Hyperbola) {
+    // fromState round trips, energy and angular momentum are conserved
+    const double mu(2);
+    const Coords::orbit an_orbit(-1.5, 1.8, Coords::angle(20), Coords::angle(70), Coords::angle(-30),
+				 Coords::angle(0), s_epoch, mu);
+    EXPECT_TRUE(std::isinf(an_orbit.period()));
+
+    const double times[] = {-50, -3, 0, 0.5, 7, 400};
+    double positions[18], velocities[18];
+    an_orbit.states(times, 6, positions, velocities);
+    const double energy(mu/(2*1.5));
+    const Coords::Cartesian h0(cross(Coords::Cartesian(positions[0], positions[1], positions[2]),
+				     Coords::Cartesian(velocities[0], velocities[1], velocities[2])));
+    for (size_t k = 0; k < 6; ++k) {
+      const Coords::Cartesian r(positions[3*k], positions[3*k + 1], positions[3*k + 2]);
+      const Coords::Cartesian v(velocities[3*k], velocities[3*k + 1], velocities[3*k + 2]);
+      EXPECT_NEAR(energy, 0.5*v.magnitude2() - mu/r.magnitude(), 1e-12) << times[k];
+      EXPECT_NEAR(0, (cross(r, v) - h0).magnitude(), 1e-12*h0.magnitude()) << times[k];
+    }
+
+    // periapsis at the epoch
+    EXPECT_NEAR(1.5*(1.8 - 1),
+		Coords::Cartesian(positions[6], positions[7], positions[8]).magnitude(), 1e-14);
+
+    Coords::Cartesian r, v;
+    const Coords::DateTime later(2026, 10, 18, 12, 0, 7);
+    an_orbit.state(later, r, v);
+    const Coords::orbit elements(Coords::orbit::fromState(r, v, later, mu));
+    EXPECT_NEAR(-1.5, elements.semimajorAxis(), 1e-12);
+    EXPECT_NEAR(1.8, elements.eccentricity(), 1e-12);
+    EXPECT_NEAR(0, (elements.position(s_epoch) - an_orbit.position(s_epoch)).magnitude(), 1e-12);
+  }
+
+  TEST(FixedOrbit, MatchesIntegrator) {
+    // RK4 under the same central force
+    const double mu(1);
+    const Coords::orbit an_orbit(1, 0.6, Coords::angle(10), Coords::angle(20), Coords::angle(30),
+				 Coords::angle(0), s_epoch, mu);
+    Coords::Cartesian r, v;
+    an_orbit.state(s_epoch, r, v);
+
+    Coords::ParticleSystem a_system(Coords::ParticleSystem::rk4);
+    a_system.add(r, v, 1);
+    a_system.addForce([mu] (const Coords::ParticleSystem::state& a_state, double* ax, double* ay, double* az) {
+	const double r2(a_state.m_x[0]*a_state.m_x[0] + a_state.m_y[0]*a_state.m_y[0] + a_state.m_z[0]*a_state.m_z[0]);
+	const double scale(-mu/(r2*std::sqrt(r2)));
+	ax[0] += scale*a_state.m_x[0];
+	ay[0] += scale*a_state.m_y[0];
+	az[0] += scale*a_state.m_z[0];
+      });
+    const double duration(0.7*an_orbit.period());
+    a_system.run(duration/20000, 20000);
+
+    const double seconds(duration);
+    double position[3];
+    an_orbit.states(&seconds, 1, position);
+    EXPECT_NEAR(0, (a_system.position(0) - Coords::Cartesian(position[0], position[1], position[2])).magnitude(), 1e-9);
+  }
+
+  TEST(FixedOrbit, Errors) {
+    const Coords::angle zero;
+    EXPECT_THROW(Coords::orbit(1, 0.5, zero, zero, zero, zero, s_epoch, 0), Coords::Error);
+    EXPECT_THROW(Coords::orbit(1, -0.1, zero, zero, zero, zero, s_epoch, 1), Coords::Error);
+    EXPECT_THROW(Coords::orbit(1, 1, zero, zero, zero, zero, s_epoch, 1), Coords::Error);
+    EXPECT_THROW(Coords::orbit(-1, 0.5, zero, zero, zero, zero, s_epoch, 1), Coords::Error);
+    EXPECT_THROW(Coords::orbit(1, 1.5, zero, zero, zero, zero, s_epoch, 1), Coords::Error);
+    EXPECT_THROW(Coords::orbit(0, 0.5, zero, zero, zero, zero, s_epoch, 1), Coords::Error);
+    EXPECT_THROW(Coords::orbit::fromState(Coords::Ux, 2*Coords::Ux, s_epoch, 1), Coords::Error);
+  }
+
+  // ----------------------------
+  // ----- random catalog -----
+  // ----------------------------
+
+  class RandomCatalog : public ::testing::Test {
+  protected:
+
+    enum {s_orbits = 300, s_times = 37};
+
+    virtual void SetUp() {
+      std::mt19937 generator(12345);
+      std::uniform_real_distribution<double> uniform(0, 1);
+      for (size_t i = 0; i < s_orbits; ++i) {
+	const double e(i % 10 == 0 ? 1.1 + uniform(generator) : 0.95*uniform(generator));
+	const double a((e < 1 ? 1 : -1)*(6.6e6 + 3e7*uniform(generator)));
+	orbits.push_back(Coords::orbit(a, e, Coords::angle(180*uniform(generator)), Coords::angle(360*uniform(generator)),
+				       Coords::angle(360*uniform(generator)), Coords::angle(360*uniform(generator)),
+				       s_epoch, Coords::orbit::s_GM_Earth));
+      }
+      for (size_t t = 0; t < s_times; ++t)
+	times.push_back(Coords::DateTime(2026, 10, 19, int(t % 24), int(t), 1.5*t));
+    }
+
+    std::vector<Coords::orbit> orbits;
+    std::vector<Coords::DateTime> times;
+  };
+
+  TEST_F(RandomCatalog, MatchesState) {
+    // a block takes Newton steps until its slowest time converges, a
+    // last step at most an ulp or so from one time on its own
+    std::vector<double> positions(3*s_orbits*s_times), velocities(3*s_orbits*s_times);
+    Coords::propagate(orbits.data(), s_orbits, times.data(), s_times, positions.data(), velocities.data());
+    for (size_t i = 0; i < s_orbits; ++i) {
+      for (size_t t = 0; t < s_times; ++t) {
+	Coords::Cartesian r, v;
+	orbits[i].state(times[t], r, v);
+	const size_t k(3*(i*s_times + t));
+	ASSERT_NEAR(0, (r - Coords::Cartesian(positions[k], positions[k + 1], positions[k + 2])).magnitude(),
+		    1e-14*r.magnitude());
+	ASSERT_NEAR(0, (v - Coords::Cartesian(velocities[k], velocities[k + 1], velocities[k + 2])).magnitude(),
+		    1e-14*v.magnitude());
+      }
+    }
+
+    // and without velocities
+    std::vector<double> only_positions(3*s_orbits*s_times);
+    Coords::propagate(orbits.data(), s_orbits, times.data(), s_times, only_positions.data());
+    EXPECT_EQ(positions, only_positions);
+  }
+
+  TEST_F(RandomCatalog, ThreadsMatchSerial) {
+    std::vector<int64_t> nanoseconds;
+    for (size_t t = 0; t < s_times; ++t)
+      nanoseconds.push_back(times[t].toUnixNanoseconds());
+
+    std::vector<double> serial(3*s_orbits*s_times), parallel(3*s_orbits*s_times);
+    Coords::propagate(orbits.data(), s_orbits, nanoseconds.data(), s_times, serial.data(), 0, 1);
+    Coords::propagate(orbits.data(), s_orbits, nanoseconds.data(), s_times, parallel.data(), 0, 4);
+    EXPECT_EQ(serial, parallel);
+  }
+
+} // end anonymous namespace
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,381 @@
+// ==================================================================
+// Filename:    nbody.cpp
+//
+// Description: Implements the direct summation N-body kernel.
+//
+// Author:      L.R. McFarland
+// Created:     2026 Oct 18
+// Language:    C++
+//
+//  Coordinates is free software: you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License as
+//  published by the Free Software Foundation, either version 3 of the
+//  License, or (at your option) any later version.
+//
+//  Coordinates is distributed in the hope that it will be useful, but
+//  WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with Coordinates.  If not, see <http://www.gnu.org/licenses/>.
+// ==================================================================
+
+#include <algorithm>
+#include <cfloat>
+
+#include <nbody.h>
+
+// the AVX kernels are compiled for their instruction sets with target
+// attributes, the rest of the library keeps the default flags.
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define COORDS_X86_KERNELS 1
+#include <immintrin.h>
+#else
+#define COORDS_X86_KERNELS 0
+#endif
+
+namespace {
+
+  // the padded particles and their sums for one accelerations() call
+  struct arrays {
+    const double* m_x;
+    const double* m_y;
+    const double* m_z;
+    const double* m_mass;
+    double*       m_ax;
+    double*       m_ay;
+    double*       m_az;
+    double        m_eps2;
+  };
+
+  // Tiles [i0, i1) and [j0, j1), lengths multiples of 8. Symmetric
+  // adds each pair to both tiles, else only to i, for a tile with
+  // itself where every i sees every j.
+
+  typedef void (*tileKernel)(const arrays& a, const size_t& i0, const size_t& i1,
+			     const size_t& j0, const size_t& j1, const bool& a_symmetric);
+
+  // ----- generic -----
+
+  // eight partial sums so the compiler can vectorize the reduction
+  // with out reassociating it.
+  template <bool t_symmetric>
+  void tileGenericT(const arrays& a, const size_t& i0, const size_t& i1, const size_t& j0, const size_t& j1) {
+    const double eps2(a.m_eps2);
+    for (size_t i = i0; i < i1; ++i) {
+      const double xi(a.m_x[i]), yi(a.m_y[i]), zi(a.m_z[i]), mi(a.m_mass[i]);
+      double sx[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+      double sy[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+      double sz[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+      for (size_t j = j0; j < j1; j += 8) {
+	for (size_t k = 0; k < 8; ++k) {
+	  const double dx(a.m_x[j + k] - xi);
+	  const double dy(a.m_y[j + k] - yi);
+	  const double dz(a.m_z[j + k] - zi);
+	  const double r2(dx*dx + dy*dy + dz*dz + eps2);
+	  const double inverse(r2 > 0 ? 1/std::sqrt(r2) : 0);
+	  const double inverse3(inverse*inverse*inverse);
+	  const double s(a.m_mass[j + k]*inverse3);
+	  sx[k] += s*dx;
+	  sy[k] += s*dy;
+	  sz[k] += s*dz;
+	  if (t_symmetric) {
+	    const double t(mi*inverse3);
+	    a.m_ax[j + k] -= t*dx;
+	    a.m_ay[j + k] -= t*dy;
+	    a.m_az[j + k] -= t*dz;
+	  }
+	}
+      }
+      a.m_ax[i] += ((sx[0] + sx[1]) + (sx[2] + sx[3])) + ((sx[4] + sx[5]) + (sx[6] + sx[7]));
+      a.m_ay[i] += ((sy[0] + sy[1]) + (sy[2] + sy[3])) + ((sy[4] + sy[5]) + (sy[6] + sy[7]));
+      a.m_az[i] += ((sz[0] + sz[1]) + (sz[2] + sz[3])) + ((sz[4] + sz[5]) + (sz[6] + sz[7]));
+    }
+  }
+
+  void tileGeneric(const arrays& a, const size_t& i0, const size_t& i1,
+		   const size_t& j0, const size_t& j1, const bool& a_symmetric) {
+    if (a_symmetric)
+      tileGenericT<true>(a, i0, i1, j0, j1);
+    else
+      tileGenericT<false>(a, i0, i1, j0, j1);
+  }
+
+#if COORDS_X86_KERNELS
+
+  // ----- AVX2 -----
+
+  // 1/sqrt(r2), 0 for r2 == 0. The 12 bit single precision estimate
+  // and three Newton steps, 12, 24, 48 then all 53 bits. r2 out of
+  // the float range takes the exact path.
+  __attribute__((target("avx2,fma")))
+  inline __m256d inverseSqrtAVX2(const __m256d& r2) {
+    const __m256d half_r2(_mm256_mul_pd(_mm256_set1_pd(0.5), r2));
+    const __m256d three_halves(_mm256_set1_pd(1.5));
+    __m256d y(_mm256_cvtps_pd(_mm_rsqrt_ps(_mm256_cvtpd_ps(r2))));
+    for (int k = 0; k < 3; ++k)
+      y = _mm256_mul_pd(y, _mm256_fnmadd_pd(_mm256_mul_pd(half_r2, y), y, three_halves));
+    const __m256d in_range(_mm256_and_pd(_mm256_cmp_pd(r2, _mm256_set1_pd(FLT_MIN), _CMP_GE_OQ),
+					 _mm256_cmp_pd(r2, _mm256_set1_pd(FLT_MAX), _CMP_LE_OQ)));
+    if (_mm256_movemask_pd(in_range) != 0xf)
+      y = _mm256_blendv_pd(_mm256_div_pd(_mm256_set1_pd(1), _mm256_sqrt_pd(r2)), y, in_range);
+    return _mm256_and_pd(y, _mm256_cmp_pd(r2, _mm256_setzero_pd(), _CMP_GT_OQ));
+  }
+
+  __attribute__((target("avx2,fma")))
+  inline double sumAVX2(const __m256d& a) {
+    const __m128d pair(_mm_add_pd(_mm256_castpd256_pd128(a), _mm256_extractf128_pd(a, 1)));
+    return _mm_cvtsd_f64(_mm_add_sd(pair, _mm_unpackhi_pd(pair, pair)));
+  }
+
+  __attribute__((target("avx2,fma")))
+  void tileAVX2(const arrays& a, const size_t& i0, const size_t& i1,
+		const size_t& j0, const size_t& j1, const bool& a_symmetric) {
+    const __m256d eps2(_mm256_set1_pd(a.m_eps2));
+    for (size_t i = i0; i < i1; ++i) {
+      const __m256d xi(_mm256_set1_pd(a.m_x[i]));
+      const __m256d yi(_mm256_set1_pd(a.m_y[i]));
+      const __m256d zi(_mm256_set1_pd(a.m_z[i]));
+      const __m256d mi(_mm256_set1_pd(a.m_mass[i]));
+      __m256d sx(_mm256_setzero_pd()), sy(_mm256_setzero_pd()), sz(_mm256_setzero_pd());
+      for (size_t j = j0; j < j1; j += 4) {
+	const __m256d dx(_mm256_sub_pd(_mm256_loadu_pd(a.m_x + j), xi));
+	const __m256d dy(_mm256_sub_pd(_mm256_loadu_pd(a.m_y + j), yi));
+	const __m256d dz(_mm256_sub_pd(_mm256_loadu_pd(a.m_z + j), zi));
+	const __m256d r2(_mm256_fmadd_pd(dx, dx, _mm256_fmadd_pd(dy, dy, _mm256_fmadd_pd(dz, dz, eps2))));
+	const __m256d inverse(inverseSqrtAVX2(r2));
+	const __m256d inverse3(_mm256_mul_pd(_mm256_mul_pd(inverse, inverse), inverse));
+	const __m256d s(_mm256_mul_pd(_mm256_loadu_pd(a.m_mass + j), inverse3));
+	sx = _mm256_fmadd_pd(s, dx, sx);
+	sy = _mm256_fmadd_pd(s, dy, sy);
+	sz = _mm256_fmadd_pd(s, dz, sz);
+	if (a_symmetric) {
+	  const __m256d t(_mm256_mul_pd(mi, inverse3));
+	  _mm256_storeu_pd(a.m_ax + j, _mm256_fnmadd_pd(t, dx, _mm256_loadu_pd(a.m_ax + j)));
+	  _mm256_storeu_pd(a.m_ay + j, _mm256_fnmadd_pd(t, dy, _mm256_loadu_pd(a.m_ay + j)));
+	  _mm256_storeu_pd(a.m_az + j, _mm256_fnmadd_pd(t, dz, _mm256_loadu_pd(a.m_az + j)));
+	}
+      }
+      a.m_ax[i] += sumAVX2(sx);
+      a.m_ay[i] += sumAVX2(sy);
+      a.m_az[i] += sumAVX2(sz);
+    }
+  }
+
+  // ----- AVX-512 -----
+
+  // The unmasked intrinsics pass an undefined vector for the masked
+  // off lanes, which GCC 12 reports as maybe uninitialized, so these
+  // use the zero masked forms with every lane set.
+
+  // the 14 bit estimate and two Newton steps, 28 then all 53 bits.
+  __attribute__((target("avx512f")))
+  inline __m512d inverseSqrtAVX512(const __m512d& r2) {
+    const __m512d half_r2(_mm512_mul_pd(_mm512_set1_pd(0.5), r2));
+    const __m512d three_halves(_mm512_set1_pd(1.5));
+    __m512d y(_mm512_maskz_rsqrt14_pd(0xff, r2));
+    for (int k = 0; k < 2; ++k)
+      y = _mm512_mul_pd(y, _mm512_fnmadd_pd(_mm512_mul_pd(half_r2, y), y, three_halves));
+    return _mm512_maskz_mov_pd(_mm512_cmp_pd_mask(r2, _mm512_setzero_pd(), _CMP_GT_OQ), y);
+  }
+
+  __attribute__((target("avx512f")))
+  inline double sumAVX512(const __m512d& a) {
+    const __m256d quad(_mm256_add_pd(_mm512_maskz_extractf64x4_pd(0xf, a, 0),
+				     _mm512_maskz_extractf64x4_pd(0xf, a, 1)));
+    const __m128d pair(_mm_add_pd(_mm256_castpd256_pd128(quad), _mm256_extractf128_pd(quad, 1)));
+    return _mm_cvtsd_f64(_mm_add_sd(pair, _mm_unpackhi_pd(pair, pair)));
+  }
+
+  __attribute__((target("avx512f")))
+  void tileAVX512(const arrays& a, const size_t& i0, const size_t& i1,
+		  const size_t& j0, const size_t& j1, const bool& a_symmetric) {
+    const __m512d eps2(_mm512_set1_pd(a.m_eps2));
+    for (size_t i = i0; i < i1; ++i) {
+      const __m512d xi(_mm512_set1_pd(a.m_x[i]));
+      const __m512d yi(_mm512_set1_pd(a.m_y[i]));
+      const __m512d zi(_mm512_set1_pd(a.m_z[i]));
+      const __m512d mi(_mm512_set1_pd(a.m_mass[i]));
+      __m512d sx(_mm512_setzero_pd()), sy(_mm512_setzero_pd()), sz(_mm512_setzero_pd());
+      for (size_t j = j0; j < j1; j += 8) {
+	const __m512d dx(_mm512_sub_pd(_mm512_loadu_pd(a.m_x + j), xi));
+	const __m512d dy(_mm512_sub_pd(_mm512_loadu_pd(a.m_y + j), yi));
+	const __m512d dz(_mm512_sub_pd(_mm512_loadu_pd(a.m_z + j), zi));
+	const __m512d r2(_mm512_fmadd_pd(dx, dx, _mm512_fmadd_pd(dy, dy, _mm512_fmadd_pd(dz, dz, eps2))));
+	const __m512d inverse(inverseSqrtAVX512(r2));
+	const __m512d inverse3(_mm512_mul_pd(_mm512_mul_pd(inverse, inverse), inverse));
+	const __m512d s(_mm512_mul_pd(_mm512_loadu_pd(a.m_mass + j), inverse3));
+	sx = _mm512_fmadd_pd(s, dx, sx);
+	sy = _mm512_fmadd_pd(s, dy, sy);
+	sz = _mm512_fmadd_pd(s, dz, sz);
+	if (a_symmetric) {
+	  const __m512d t(_mm512_mul_pd(mi, inverse3));
+	  _mm512_storeu_pd(a.m_ax + j, _mm512_fnmadd_pd(t, dx, _mm512_loadu_pd(a.m_ax + j)));
+	  _mm512_storeu_pd(a.m_ay + j, _mm512_fnmadd_pd(t, dy, _mm512_loadu_pd(a.m_ay + j)));
+	  _mm512_storeu_pd(a.m_az + j, _mm512_fnmadd_pd(t, dz, _mm512_loadu_pd(a.m_az + j)));
+	}
+      }
+      a.m_ax[i] += sumAVX512(sx);
+      a.m_ay[i] += sumAVX512(sy);
+      a.m_az[i] += sumAVX512(sz);
+    }
+  }
+
+#endif
+
+  tileKernel kernelFor(const Coords::nbody::kernel& a_kernel) {
+#if COORDS_X86_KERNELS
+    if (a_kernel == Coords::nbody::avx512)
+      return tileAVX512;
+    if (a_kernel == Coords::nbody::avx2)
+      return tileAVX2;
+#endif
+    return tileGeneric;
+  }
+
+} // end anonymous namespace
+
+
+// ------------------------
+// ----- constructors -----
+// ------------------------
+
+Coords::nbody::nbody(const double& a_softening, const size_t& a_tile_size)
+  : m_softening(0), m_tile_size(8), m_threads(0), m_kernel(best())
+{
+  softening(a_softening);
+  tileSize(a_tile_size);
+}
+
+void Coords::nbody::softening(const double& a_softening) {
+  if (!(a_softening >= 0))
+    throw Error("nbody softening must not be negative");
+  m_softening = a_softening;
+}
+
+void Coords::nbody::tileSize(const size_t& a_tile_size) {
+  if (a_tile_size == 0 || a_tile_size % 8 != 0)
+    throw Error("nbody tile size must be a positive multiple of 8");
+  m_tile_size = a_tile_size;
+}
+
+void Coords::nbody::instructions(const kernel& a_kernel) {
+  if (!isSupported(a_kernel))
+    throw Error("nbody kernel " + name(a_kernel) + " is not supported on this CPU");
+  m_kernel = a_kernel;
+}
+
+bool Coords::nbody::isSupported(const kernel& a_kernel) {
+  switch (a_kernel) {
+  case generic:
+    return true;
+#if COORDS_X86_KERNELS
+  case avx2:
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+  case avx512:
+    return __builtin_cpu_supports("avx512f");
+#endif
+  default:
+    return false;
+  }
+}
+
+Coords::nbody::kernel Coords::nbody::best() {
+  if (isSupported(avx512))
+    return avx512;
+  if (isSupported(avx2))
+    return avx2;
+  return generic;
+}
+
+std::string Coords::nbody::name(const kernel& a_kernel) {
+  switch (a_kernel) {
+  case avx2:
+    return "avx2";
+  case avx512:
+    return "avx512";
+  default:
+    return "generic";
+  }
+}
+
+
+// -------------------------
+// ----- accelerations -----
+// -------------------------
+
+void Coords::nbody::accelerations(const double* a_x, const double* a_y, const double* a_z,
+				  const double* a_mass, const size_t& a_size,
+				  double* an_ax, double* an_ay, double* an_az, const double& a_G) const {
+
+  if (a_size == 0)
+    return;
+
+  // padded to whole tiles of 8 with massless particles at the origin,
+  // which the zero distance select and zero mass leave out.
+  const size_t padded((a_size + 7) & ~size_t(7));
+  std::vector<double> scratch(7*padded, 0.0);
+  double* x(&scratch[0]);
+  double* y(x + padded);
+  double* z(y + padded);
+  double* mass(z + padded);
+  std::copy(a_x, a_x + a_size, x);
+  std::copy(a_y, a_y + a_size, y);
+  std::copy(a_z, a_z + a_size, z);
+  std::copy(a_mass, a_mass + a_size, mass);
+
+  const arrays a = {x, y, z, mass, mass + padded, mass + 2*padded, mass + 3*padded,
+		    m_softening*m_softening};
+  const tileKernel tile(kernelFor(m_kernel));
+  const size_t tile_size(m_tile_size);
+  const size_t tiles((padded + tile_size - 1)/tile_size);
+
+  // each tile with itself, all at once
+  parallelFor(tiles, [&] (const size_t& a_begin, const size_t& a_end) {
+      for (size_t t = a_begin; t < a_end; ++t) {
+	const size_t begin(t*tile_size), end(std::min(padded, begin + tile_size));
+	tile(a, begin, end, begin, end, false);
+      }
+    }, m_threads, 1);
+
+  // then the pairs of tiles, a round robin tournament. Tile players
+  // - 1 stays put while the others rotate, with a bye for an odd
+  // count, so each round is a set of disjoint pairs.
+  const size_t players(tiles + tiles % 2);
+  std::vector<std::pair<size_t, size_t> > round;
+  for (size_t r = 0; r + 1 < players; ++r) {
+    round.clear();
+    round.push_back(std::make_pair(players - 1, r));
+    for (size_t k = 1; k < players/2; ++k)
+      round.push_back(std::make_pair((r + k) % (players - 1), (r + players - 1 - k) % (players - 1)));
+
+    parallelFor(round.size(), [&] (const size_t& a_begin, const size_t& a_end) {
+	for (size_t p = a_begin; p < a_end; ++p) {
+	  const size_t first(std::min(round[p].first, round[p].second));
+	  const size_t second(std::max(round[p].first, round[p].second));
+	  if (second >= tiles)
+	    continue; // the bye
+	  const size_t i0(first*tile_size), i1(std::min(padded, i0 + tile_size));
+	  const size_t j0(second*tile_size), j1(std::min(padded, j0 + tile_size));
+	  tile(a, i0, i1, j0, j1, true);
+	}
+      }, m_threads, 1);
+  }
+
+  const double G(a_G);
+  for (size_t i = 0; i < a_size; ++i) {
+    an_ax[i] += G*a.m_ax[i];
+    an_ay[i] += G*a.m_ay[i];
+    an_az[i] += G*a.m_az[i];
+  }
+}
+
+Coords::ParticleSystem::force Coords::nbody::gravity(const nbody& a_kernel, const double& a_G) {
+  const nbody kernel(a_kernel);
+  const double G(a_G);
+  return [kernel, G] (const ParticleSystem::state& a_state, double* an_ax, double* an_ay, double* an_az) {
+    kernel.accelerations(a_state.m_x, a_state.m_y, a_state.m_z, a_state.m_mass, a_state.m_size,
+			 an_ax, an_ay, an_az, G);
+  };
+}
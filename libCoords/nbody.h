@@ -0,0 +1,109 @@
+// ================================================================
+// Filename:    nbody.h
+//
+// Description: This defines a direct summation N-body gravity
+//              kernel, every pair once, tiled for the cache, SIMD
+//              and spread over the thread pool.
+//
+// Author:      L.R. McFarland
+// Created:     2026 Oct 18
+// Language:    C++
+//
+//  Coords is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  Coords is distributed in the hope that it will be useful, but
+//  WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with Coords.  If not, see <http://www.gnu.org/licenses/>.
+// ================================================================
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <angle.h>
+#include <Cartesian.h>
+#include <particles.h>
+
+namespace Coords {
+
+  // =================
+  // ===== nbody =====
+  // =================
+
+  // The accelerations are the exact sums, with the same softened
+  // pair law as octree,
+  //
+  //   G*m_j*(r_j - r_i)/(|r_j - r_i|^2 + eps^2)^(3/2)
+  //
+  // The particles are split into tiles of tileSize(). A pair in two
+  // tiles is evaluated once and applied to both particles, a tile
+  // with itself is summed both ways as it is only 1/tiles of the
+  // work. The tile pairs are scheduled round robin, so the pairs run
+  // at the same time never share a tile and the threads write with
+  // out locks. The order of the sums does not depend on the number
+  // of threads, the results are the same bit for bit.
+  //
+  // The inner loop over a tile uses AVX-512 or AVX2 when the CPU has
+  // them, chosen at run time, with an approximate reciprocal square
+  // root refined by Newton iterations to full double precision. The
+  // generic kernel is plain C++ for the compiler to vectorize.
+  //
+  // Thread safety: accelerations() is reentrant, its scratch is
+  // local to the call.
+
+  class nbody {
+
+  public:
+
+    enum kernel {generic, avx2, avx512};
+
+    explicit nbody(const double& a_softening=0, const size_t& a_tile_size=512); // throws Error on a bad parameter
+
+    // implicit copy, move and dtor.
+
+    const double& softening() const {return m_softening;}
+    void          softening(const double& a_softening);
+
+    const size_t& tileSize() const {return m_tile_size;}
+    void          tileSize(const size_t& a_tile_size); // a multiple of 8
+
+    const size_t& threads() const           {return m_threads;}
+    void          threads(const size_t& a_threads) {m_threads = a_threads;} // 0 is hardwareThreads()
+
+    // the fastest this CPU has by default. Throws Error if the CPU
+    // does not have the one asked for.
+    const kernel& instructions() const {return m_kernel;}
+    void          instructions(const kernel& a_kernel);
+
+    static bool        isSupported(const kernel& a_kernel);
+    static kernel      best();
+    static std::string name(const kernel& a_kernel);
+
+    // adds G times the accelerations of a_size particles to an_ax,
+    // an_ay, an_az. Coincident particles contribute nothing to each
+    // other.
+    void accelerations(const double* a_x, const double* a_y, const double* a_z,
+		       const double* a_mass, const size_t& a_size,
+		       double* an_ax, double* an_ay, double* an_az, const double& a_G=1) const;
+
+    // a ParticleSystem force. The force owns a copy of a_kernel.
+    static ParticleSystem::force gravity(const nbody& a_kernel, const double& a_G=1);
+
+  private:
+
+    double m_softening;
+    size_t m_tile_size;
+    size_t m_threads;
+    kernel m_kernel;
+
+  };
+
+} // end namespace Coords
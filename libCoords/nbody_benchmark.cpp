@@ -0,0 +1,108 @@
+// ============================================================
+// Filename:    nbody_benchmark.cpp
+//
+// Description: Interactions per second of the nbody kernels
+//              against the same sum written as a loop over
+//              Cartesian operators.
+//
+//              usage: nbody_benchmark [N ...], default 1024 4096
+//
+// Authors:     L.R. McFarland
+// Created:     2026 Oct 18
+// ============================================================
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include <angle.h>
+#include <Cartesian.h>
+#include <nbody.h>
+
+namespace {
+
+  // seconds for the best of a few runs of a_function
+  template <typename F>
+  double best(const F& a_function) {
+    double fastest(1e300);
+    for (int k = 0; k < 3; ++k) {
+      const std::chrono::steady_clock::time_point start(std::chrono::steady_clock::now());
+      a_function();
+      const std::chrono::duration<double> elapsed(std::chrono::steady_clock::now() - start);
+      fastest = std::min(fastest, elapsed.count());
+    }
+    return fastest;
+  }
+
+  void report(const char* a_name, const size_t& a_threads, const size_t& a_size, const double& a_seconds) {
+    // N*(N - 1) ordered pairs, as the Cartesian loop does them
+    const double interactions(double(a_size)*(a_size - 1));
+    std::printf("%-10s %8lu %8lu %12.3g %10.3f ms\n", a_name, (unsigned long)a_threads, (unsigned long)a_size,
+		interactions/a_seconds, 1e3*a_seconds);
+  }
+
+} // end anonymous namespace
+
+int main(int argc, char** argv) {
+
+  std::vector<size_t> sizes;
+  for (int k = 1; k < argc; ++k)
+    sizes.push_back(std::strtoul(argv[k], 0, 10));
+  if (sizes.empty()) {
+    sizes.push_back(1024);
+    sizes.push_back(4096);
+  }
+
+  const double softening(0.01);
+  std::printf("%-10s %8s %8s %12s %13s\n", "kernel", "threads", "N", "pairs/s", "time");
+
+  for (size_t s = 0; s < sizes.size(); ++s) {
+
+    const size_t n(sizes[s]);
+    std::mt19937 generator(12345);
+    std::uniform_real_distribution<double> uniform(-1, 1);
+    std::vector<double> x(n), y(n), z(n), m(n), ax(n), ay(n), az(n);
+    std::vector<Coords::Cartesian> positions(n), accelerations(n);
+    for (size_t i = 0; i < n; ++i) {
+      x[i] = uniform(generator);
+      y[i] = uniform(generator);
+      z[i] = uniform(generator);
+      m[i] = 1.0/n;
+      positions[i] = Coords::Cartesian(x[i], y[i], z[i]);
+    }
+
+    // the naive loop
+    report("Cartesian", 1, n, best([&] () {
+	  for (size_t i = 0; i < n; ++i) {
+	    Coords::Cartesian a;
+	    for (size_t j = 0; j < n; ++j) {
+	      if (i == j)
+		continue;
+	      const Coords::Cartesian d(positions[j] - positions[i]);
+	      const double r2(d.magnitude2() + softening*softening);
+	      a += d*(m[j]/(r2*std::sqrt(r2)));
+	    }
+	    accelerations[i] = a;
+	  }
+	}));
+
+    const Coords::nbody::kernel kernels[] = {Coords::nbody::generic, Coords::nbody::avx2, Coords::nbody::avx512};
+    const size_t threads[] = {1, Coords::hardwareThreads()};
+    for (size_t k = 0; k < 3; ++k) {
+      if (!Coords::nbody::isSupported(kernels[k]))
+	continue;
+      for (size_t t = 0; t < (threads[1] > 1 ? 2 : 1); ++t) {
+	Coords::nbody a_kernel(softening);
+	a_kernel.instructions(kernels[k]);
+	a_kernel.threads(threads[t]);
+	report(Coords::nbody::name(kernels[k]).c_str(), threads[t], n, best([&] () {
+	      a_kernel.accelerations(x.data(), y.data(), z.data(), m.data(), n, ax.data(), ay.data(), az.data());
+	    }));
+      }
+    }
+  }
+
+  return 0;
+}
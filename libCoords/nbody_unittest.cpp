@@ -0,0 +1,208 @@
+// ================================================================
+// Filename:    nbody_unittest.cpp
+// Description: This is the gtest unittest of the direct summation
+//              N-body kernel.
+//
+// Author:      L.R. McFarland, lrm@starbug.com
+// Created:     2026 Oct 18
+// Language:    C++
+//
+// See also: http://code.google.com/p/googletest/wiki/Primer
+//
+//  Coordinates is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  Coordinates is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with Coordinates.  If not, see <http://www.gnu.org/licenses/>.
+// ================================================================
+
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <angle.h>
+#include <Cartesian.h>
+#include <nbody.h>
+
+
+namespace {
+
+  const Coords::nbody::kernel s_kernels[] = {Coords::nbody::generic, Coords::nbody::avx2, Coords::nbody::avx512};
+
+  // direct summation with Cartesian operators
+  std::vector<Coords::Cartesian> reference(const std::vector<double>& x, const std::vector<double>& y,
+					   const std::vector<double>& z, const std::vector<double>& m,
+					   const double& a_softening) {
+    std::vector<Coords::Cartesian> a(x.size());
+    for (size_t i = 0; i < x.size(); ++i) {
+      const Coords::Cartesian ri(x[i], y[i], z[i]);
+      for (size_t j = 0; j < x.size(); ++j) {
+	const Coords::Cartesian d(Coords::Cartesian(x[j], y[j], z[j]) - ri);
+	const double r2(d.magnitude2() + a_softening*a_softening);
+	if (r2 > 0)
+	  a[i] += d*(m[j]/(r2*std::sqrt(r2)));
+      }
+    }
+    return a;
+  }
+
+  // the worst |a - b|/|b|
+  double worstError(const std::vector<Coords::Cartesian>& a_reference,
+		    const std::vector<double>& ax, const std::vector<double>& ay, const std::vector<double>& az) {
+    double worst(0);
+    for (size_t i = 0; i < a_reference.size(); ++i)
+      worst = std::max(worst, (Coords::Cartesian(ax[i], ay[i], az[i]) - a_reference[i]).magnitude()/a_reference[i].magnitude());
+    return worst;
+  }
+
+  // ------------------------------
+  // ----- random particles -----
+  // ------------------------------
+
+  class RandomNBody : public ::testing::Test {
+  protected:
+
+    // not a multiple of 8, an odd number of 64 particle tiles
+    enum {s_size = 651};
+
+    virtual void SetUp() {
+      std::mt19937 generator(12345);
+      std::uniform_real_distribution<double> uniform(-1, 1);
+      for (size_t i = 0; i < s_size; ++i) {
+	x.push_back(uniform(generator));
+	y.push_back(uniform(generator));
+	z.push_back(uniform(generator));
+	m.push_back(1.5 + uniform(generator));
+      }
+    }
+
+    std::vector<double> x, y, z, m;
+  };
+
+  TEST_F(RandomNBody, MatchesReference) {
+    for (size_t k = 0; k < 3; ++k) {
+      if (!Coords::nbody::isSupported(s_kernels[k]))
+	continue;
+      const double softenings[] = {0, 0.01};
+      for (size_t s = 0; s < 2; ++s) {
+	Coords::nbody a_kernel(softenings[s], 64);
+	a_kernel.instructions(s_kernels[k]);
+	std::vector<double> ax(s_size, 0), ay(s_size, 0), az(s_size, 0);
+	a_kernel.accelerations(x.data(), y.data(), z.data(), m.data(), s_size, ax.data(), ay.data(), az.data());
+	EXPECT_LT(worstError(reference(x, y, z, m, softenings[s]), ax, ay, az), 1e-12)
+	  << Coords::nbody::name(s_kernels[k]) << " softening " << softenings[s];
+      }
+    }
+  }
+
+  TEST_F(RandomNBody, ThirdLaw) {
+    // the pairs are applied to both sides, the momentum change is 0
+    Coords::nbody a_kernel(0, 64);
+    std::vector<double> ax(s_size, 0), ay(s_size, 0), az(s_size, 0);
+    a_kernel.accelerations(x.data(), y.data(), z.data(), m.data(), s_size, ax.data(), ay.data(), az.data());
+    Coords::Cartesian force, scale;
+    for (size_t i = 0; i < s_size; ++i) {
+      force += Coords::Cartesian(ax[i], ay[i], az[i])*m[i];
+      scale += Coords::Cartesian(std::fabs(ax[i]), std::fabs(ay[i]), std::fabs(az[i]))*m[i];
+    }
+    EXPECT_LT(force.magnitude(), 1e-12*scale.magnitude());
+  }
+
+  TEST_F(RandomNBody, ThreadsMatchSerial) {
+    for (size_t k = 0; k < 3; ++k) {
+      if (!Coords::nbody::isSupported(s_kernels[k]))
+	continue;
+      Coords::nbody serial(0.01, 64);
+      serial.instructions(s_kernels[k]);
+      serial.threads(1);
+      Coords::nbody parallel(serial);
+      parallel.threads(4);
+
+      std::vector<double> ax(s_size, 0), ay(s_size, 0), az(s_size, 0);
+      std::vector<double> bx(s_size, 0), by(s_size, 0), bz(s_size, 0);
+      serial.accelerations(x.data(), y.data(), z.data(), m.data(), s_size, ax.data(), ay.data(), az.data());
+      parallel.accelerations(x.data(), y.data(), z.data(), m.data(), s_size, bx.data(), by.data(), bz.data());
+      for (size_t i = 0; i < s_size; ++i) {
+	ASSERT_EQ(ax[i], bx[i]) << Coords::nbody::name(s_kernels[k]);
+	ASSERT_EQ(ay[i], by[i]) << Coords::nbody::name(s_kernels[k]);
+	ASSERT_EQ(az[i], bz[i]) << Coords::nbody::name(s_kernels[k]);
+      }
+    }
+  }
+
+  TEST_F(RandomNBody, AddsG) {
+    Coords::nbody a_kernel;
+    std::vector<double> ax(s_size, 1), ay(s_size, 2), az(s_size, 3);
+    std::vector<double> bx(s_size, 0), by(s_size, 0), bz(s_size, 0);
+    a_kernel.accelerations(x.data(), y.data(), z.data(), m.data(), s_size, ax.data(), ay.data(), az.data(), 2);
+    a_kernel.accelerations(x.data(), y.data(), z.data(), m.data(), s_size, bx.data(), by.data(), bz.data());
+    for (size_t i = 0; i < s_size; ++i) {
+      ASSERT_DOUBLE_EQ(1 + 2*bx[i], ax[i]);
+      ASSERT_DOUBLE_EQ(2 + 2*by[i], ay[i]);
+    }
+  }
+
+  // --------------------------
+  // ----- fixed nbody -----
+  // --------------------------
+
+  TEST(FixedNBody, Errors) {
+    EXPECT_THROW(Coords::nbody(-1), Coords::Error);
+    EXPECT_THROW(Coords::nbody(0, 0), Coords::Error);
+    EXPECT_THROW(Coords::nbody(0, 12), Coords::Error);
+    EXPECT_TRUE(Coords::nbody::isSupported(Coords::nbody::generic));
+    EXPECT_TRUE(Coords::nbody::isSupported(Coords::nbody::best()));
+    EXPECT_EQ(Coords::nbody::best(), Coords::nbody().instructions());
+    EXPECT_EQ("avx512", Coords::nbody::name(Coords::nbody::avx512));
+  }
+
+  TEST(FixedNBody, Range) {
+    // distances squared outside the float range, which the AVX2
+    // estimate can not start from, and coincident particles
+    const double scales[] = {1e-30, 1, 1e30};
+    for (size_t k = 0; k < 3; ++k) {
+      if (!Coords::nbody::isSupported(s_kernels[k]))
+	continue;
+      for (size_t s = 0; s < 3; ++s) {
+	const double d(scales[s]);
+	std::vector<double> x = {0, d, 0, 0, 3*d, 3*d};
+	std::vector<double> y = {0, 0, 2*d, 0, d, d};
+	std::vector<double> z = {0, 0, 0, 5*d, 0, 0};
+	std::vector<double> m = {1, 2, 3, 4, 5, 6};
+	Coords::nbody a_kernel;
+	a_kernel.instructions(s_kernels[k]);
+	std::vector<double> ax(6, 0), ay(6, 0), az(6, 0);
+	a_kernel.accelerations(x.data(), y.data(), z.data(), m.data(), 6, ax.data(), ay.data(), az.data());
+	EXPECT_LT(worstError(reference(x, y, z, m, 0), ax, ay, az), 1e-14)
+	  << Coords::nbody::name(s_kernels[k]) << " scale " << d;
+      }
+    }
+  }
+
+  TEST(FixedNBody, CircularOrbit) {
+    // two unit masses a unit apart go round once and back
+    Coords::ParticleSystem a_system(Coords::ParticleSystem::rk4);
+    const double v(std::sqrt(0.5));
+    a_system.add(Coords::Cartesian(-0.5, 0, 0), Coords::Cartesian(0, -v, 0), 1);
+    a_system.add(Coords::Cartesian(0.5, 0, 0), Coords::Cartesian(0, v, 0), 1);
+    a_system.addForce(Coords::nbody::gravity(Coords::nbody()));
+    const double period(2*M_PI*0.5/v);
+    a_system.run(period/1000, 1000);
+    EXPECT_NEAR(0, (a_system.position(1) - Coords::Cartesian(0.5, 0, 0)).magnitude(), 1e-9);
+    EXPECT_NEAR(0, (a_system.velocity(0) - Coords::Cartesian(0, -v, 0)).magnitude(), 1e-9);
+  }
+
+} // end anonymous namespace
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
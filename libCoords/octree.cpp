@@ -0,0 +1,402 @@
+// ==================================================================
+// Filename:    octree.cpp
+//
+// Description: Implements the Barnes-Hut octree.
+//
+// Author:      L.R. McFarland
+// Created:     2026 Oct 18
+// Language:    C++
+//
+//  Coordinates is free software: you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License as
+//  published by the Free Software Foundation, either version 3 of the
+//  License, or (at your option) any later version.
+//
+//  Coordinates is distributed in the hope that it will be useful, but
+//  WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with Coordinates.  If not, see <http://www.gnu.org/licenses/>.
+// ==================================================================
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+
+#include <octree.h>
+
+namespace {
+
+  // 21 bits a coordinate, 63 bit keys
+  const int s_levels(21);
+
+  // the octant of a_key at a_level, 0 is the root's children
+  inline unsigned int octant(const uint64_t& a_key, const int& a_level) {
+    return (a_key >> 3*(s_levels - 1 - a_level)) & 7;
+  }
+
+  // skips the levels where all of the sorted keys [a_begin, a_end)
+  // are in one octant, so no node has a single child.
+  int firstSplit(const std::vector<uint64_t>& some_keys, const size_t& a_begin, const size_t& a_end, int a_level) {
+    while (a_level < s_levels && octant(some_keys[a_begin], a_level) == octant(some_keys[a_end - 1], a_level))
+      ++a_level;
+    return a_level;
+  }
+
+  // the end of the keys in [a_begin, a_end) in octant an_octant or lower
+  size_t octantEnd(const std::vector<uint64_t>& some_keys, const size_t& a_begin, const size_t& a_end,
+		   const int& a_level, const unsigned int& an_octant) {
+    return std::partition_point(some_keys.begin() + a_begin, some_keys.begin() + a_end,
+				[&a_level, &an_octant] (const uint64_t& a_key) {
+				  return octant(a_key, a_level) <= an_octant;
+				}) - some_keys.begin();
+  }
+
+} // end anonymous namespace
+
+
+// ------------------------
+// ----- constructors -----
+// ------------------------
+
+Coords::octree::octree(const double& an_opening_angle, const double& a_softening, const size_t& a_leaf_size)
+  : m_opening_angle(0), m_softening(0), m_leaf_size(1), m_threads(0)
+{
+  openingAngle(an_opening_angle);
+  softening(a_softening);
+  leafSize(a_leaf_size);
+}
+
+void Coords::octree::openingAngle(const double& an_opening_angle) {
+  if (!(an_opening_angle >= 0 && an_opening_angle <= 1))
+    throw Error("octree opening angle must be in [0, 1]");
+  m_opening_angle = an_opening_angle;
+}
+
+void Coords::octree::softening(const double& a_softening) {
+  if (!(a_softening >= 0))
+    throw Error("octree softening must not be negative");
+  m_softening = a_softening;
+}
+
+void Coords::octree::leafSize(const size_t& a_leaf_size) {
+  if (a_leaf_size == 0)
+    throw Error("octree leaf size must be at least 1");
+  m_leaf_size = a_leaf_size;
+}
+
+
+// -----------------
+// ----- build -----
+// -----------------
+
+void Coords::octree::split(const std::vector<uint64_t>& some_keys, const size_t& a_begin, const size_t& a_end,
+			   const int& a_level, std::vector<node>& some_nodes) const {
+
+  const size_t index(some_nodes.size());
+  node a_node = {0, 0, 0, 0, 0, uint32_t(a_begin), uint32_t(a_end), 0};
+  some_nodes.push_back(a_node);
+
+  if (a_end - a_begin > m_leaf_size) {
+    const int level(firstSplit(some_keys, a_begin, a_end, a_level));
+    if (level < s_levels) { // else all at one key, a large leaf
+      size_t begin(a_begin);
+      for (unsigned int an_octant = 0; an_octant < 8 && begin < a_end; ++an_octant) {
+	const size_t end(octantEnd(some_keys, begin, a_end, level, an_octant));
+	if (end > begin)
+	  split(some_keys, begin, end, level + 1, some_nodes);
+	begin = end;
+      }
+    }
+  }
+
+  some_nodes[index].m_next = uint32_t(some_nodes.size());
+}
+
+void Coords::octree::build(const double* a_x, const double* a_y, const double* a_z,
+			   const double* a_mass, const size_t& a_size) {
+
+  if (a_size >= std::numeric_limits<uint32_t>::max())
+    throw Error("octree size is limited to 2^32 - 1 particles");
+
+  const size_t threads(m_threads == 0 ? hardwareThreads() : m_threads);
+
+  m_nodes.clear();
+  m_bounds.clear();
+  m_order.resize(a_size);
+  m_x.resize(a_size);
+  m_y.resize(a_size);
+  m_z.resize(a_size);
+  m_mass.resize(a_size);
+  if (a_size == 0)
+    return;
+
+  // the bounding cube
+  double lower[3] = {a_x[0], a_y[0], a_z[0]};
+  double upper[3] = {a_x[0], a_y[0], a_z[0]};
+  for (size_t i = 1; i < a_size; ++i) {
+    lower[0] = std::min(lower[0], a_x[i]);
+    lower[1] = std::min(lower[1], a_y[i]);
+    lower[2] = std::min(lower[2], a_z[i]);
+    upper[0] = std::max(upper[0], a_x[i]);
+    upper[1] = std::max(upper[1], a_y[i]);
+    upper[2] = std::max(upper[2], a_z[i]);
+  }
+  const double side(std::max(upper[0] - lower[0], std::max(upper[1] - lower[1], upper[2] - lower[2])));
+  const double scale(side > 0 ? ((1 << s_levels) - 1)/side : 0);
+
+  // Morton keys, sorted
+  std::vector<std::pair<uint64_t, size_t> > keyed(a_size);
+  parallelFor(a_size, [&] (const size_t& a_begin, const size_t& a_end) {
+      for (size_t i = a_begin; i < a_end; ++i) {
+	const uint64_t ix((a_x[i] - lower[0])*scale);
+	const uint64_t iy((a_y[i] - lower[1])*scale);
+	const uint64_t iz((a_z[i] - lower[2])*scale);
+	keyed[i] = std::make_pair(mortonKey(ix, iy, iz), i);
+      }
+    }, threads);
+
+  parallelSort(keyed, threads);
+
+  std::vector<uint64_t> keys(a_size);
+  for (size_t k = 0; k < a_size; ++k) {
+    keys[k] = keyed[k].first;
+    m_order[k] = keyed[k].second;
+  }
+
+  // the root, then its subtrees in parallel, spliced in order
+  node root = {0, 0, 0, 0, 0, 0, uint32_t(a_size), 0};
+  m_nodes.push_back(root);
+
+  const int level(a_size > m_leaf_size ? firstSplit(keys, 0, a_size, 0) : s_levels);
+  if (level < s_levels) {
+    std::vector<std::pair<size_t, size_t> > ranges;
+    size_t begin(0);
+    for (unsigned int an_octant = 0; an_octant < 8 && begin < a_size; ++an_octant) {
+      const size_t end(octantEnd(keys, begin, a_size, level, an_octant));
+      if (end > begin)
+	ranges.push_back(std::make_pair(begin, end));
+      begin = end;
+    }
+    std::vector<std::vector<node> > children(ranges.size());
+    parallelFor(ranges.size(), [&] (const size_t& a_begin, const size_t& a_end) {
+	for (size_t c = a_begin; c < a_end; ++c)
+	  split(keys, ranges[c].first, ranges[c].second, level + 1, children[c]);
+      }, threads, 1);
+    for (size_t c = 0; c < children.size(); ++c) {
+      const uint32_t offset(m_nodes.size());
+      for (size_t k = 0; k < children[c].size(); ++k) {
+	children[c][k].m_next += offset;
+	m_nodes.push_back(children[c][k]);
+      }
+    }
+  }
+  m_nodes[0].m_next = uint32_t(m_nodes.size());
+  m_bounds.resize(m_nodes.size());
+
+  refit(a_x, a_y, a_z, a_mass);
+}
+
+std::vector<std::pair<size_t, size_t> > Coords::octree::subtrees() const {
+  std::vector<std::pair<size_t, size_t> > ranges;
+  for (size_t i = 1; i < m_nodes.size(); i = m_nodes[i].m_next)
+    ranges.push_back(std::make_pair(i, size_t(m_nodes[i].m_next)));
+  return ranges;
+}
+
+void Coords::octree::refitNodes(const size_t& a_first, const size_t& a_last) {
+
+  const double infinity(std::numeric_limits<double>::infinity());
+
+  for (size_t i = a_last; i-- > a_first;) {
+
+    node& a_node(m_nodes[i]);
+    bounds& a_bounds(m_bounds[i]);
+    double mass(0), mx(0), my(0), mz(0);
+
+    for (size_t d = 0; d < 3; ++d) {
+      a_bounds.m_min[d] = infinity;
+      a_bounds.m_max[d] = -infinity;
+    }
+
+    if (a_node.m_next == i + 1) {
+      for (size_t j = a_node.m_begin; j < a_node.m_end; ++j) {
+	mass += m_mass[j];
+	mx += m_mass[j]*m_x[j];
+	my += m_mass[j]*m_y[j];
+	mz += m_mass[j]*m_z[j];
+	const double p[3] = {m_x[j], m_y[j], m_z[j]};
+	for (size_t d = 0; d < 3; ++d) {
+	  a_bounds.m_min[d] = std::min(a_bounds.m_min[d], p[d]);
+	  a_bounds.m_max[d] = std::max(a_bounds.m_max[d], p[d]);
+	}
+      }
+    } else {
+      for (size_t c = i + 1; c < a_node.m_next; c = m_nodes[c].m_next) {
+	const node& a_child(m_nodes[c]);
+	mass += a_child.m_mass;
+	mx += a_child.m_mass*a_child.m_x;
+	my += a_child.m_mass*a_child.m_y;
+	mz += a_child.m_mass*a_child.m_z;
+	for (size_t d = 0; d < 3; ++d) {
+	  a_bounds.m_min[d] = std::min(a_bounds.m_min[d], m_bounds[c].m_min[d]);
+	  a_bounds.m_max[d] = std::max(a_bounds.m_max[d], m_bounds[c].m_max[d]);
+	}
+      }
+    }
+
+    const Cartesian center((a_bounds.m_min[0] + a_bounds.m_max[0])/2,
+			   (a_bounds.m_min[1] + a_bounds.m_max[1])/2,
+			   (a_bounds.m_min[2] + a_bounds.m_max[2])/2);
+    const Cartesian com(mass > 0 ? Cartesian(mx/mass, my/mass, mz/mass) : center);
+    const double side(std::max(a_bounds.m_max[0] - a_bounds.m_min[0],
+			       std::max(a_bounds.m_max[1] - a_bounds.m_min[1],
+					a_bounds.m_max[2] - a_bounds.m_min[2])));
+
+    a_node.m_x = com.x();
+    a_node.m_y = com.y();
+    a_node.m_z = com.z();
+    a_node.m_mass = mass;
+    // a node at one point, e.g. a single particle, is always summed
+    // directly. Its center of mass is only equal to the particles to
+    // rounding, so it could be accepted for one of its own.
+    if (m_opening_angle > 0 && side > 0) {
+      const double open(side/m_opening_angle + (com - center).magnitude());
+      a_node.m_open2 = open*open;
+    } else {
+      a_node.m_open2 = infinity;
+    }
+  }
+}
+
+void Coords::octree::refit(const double* a_x, const double* a_y, const double* a_z,
+			   const double* a_mass) {
+
+  const size_t threads(m_threads == 0 ? hardwareThreads() : m_threads);
+
+  parallelFor(size(), [&] (const size_t& a_begin, const size_t& a_end) {
+      for (size_t k = a_begin; k < a_end; ++k) {
+	const size_t i(m_order[k]);
+	m_x[k] = a_x[i];
+	m_y[k] = a_y[i];
+	m_z[k] = a_z[i];
+	m_mass[k] = a_mass[i];
+      }
+    }, threads);
+
+  if (m_nodes.empty())
+    return;
+
+  const std::vector<std::pair<size_t, size_t> > ranges(subtrees());
+  parallelFor(ranges.size(), [&] (const size_t& a_begin, const size_t& a_end) {
+      for (size_t c = a_begin; c < a_end; ++c)
+	refitNodes(ranges[c].first, ranges[c].second);
+    }, threads, 1);
+  refitNodes(0, 1);
+}
+
+double Coords::octree::totalMass() const {
+  return m_nodes.empty() ? 0 : m_nodes[0].m_mass;
+}
+
+Coords::Cartesian Coords::octree::centerOfMass() const {
+  return m_nodes.empty() ? Cartesian::Uo : Cartesian(m_nodes[0].m_x, m_nodes[0].m_y, m_nodes[0].m_z);
+}
+
+
+// -------------------------
+// ----- accelerations -----
+// -------------------------
+
+Coords::Cartesian Coords::octree::walk(const double& a_x, const double& a_y, const double& a_z) const {
+
+  const double eps2(m_softening*m_softening);
+  const double px(a_x), py(a_y), pz(a_z);
+  const node* some_nodes(m_nodes.data());
+  const size_t count(m_nodes.size());
+  double ax(0), ay(0), az(0);
+
+  size_t i(0);
+  while (i < count) {
+    const node& a_node(some_nodes[i]);
+    const double dx(a_node.m_x - px);
+    const double dy(a_node.m_y - py);
+    const double dz(a_node.m_z - pz);
+    const double d2(dx*dx + dy*dy + dz*dz);
+
+    if (d2 > a_node.m_open2) {
+      const double r2(d2 + eps2);
+      const double inverse(1/std::sqrt(r2));
+      const double f(a_node.m_mass*inverse*inverse*inverse);
+      ax += f*dx;
+      ay += f*dy;
+      az += f*dz;
+      i = a_node.m_next;
+    } else if (a_node.m_next == i + 1) {
+      // a leaf, directly. The select drops a coincident particle,
+      // including this one, with out a branch in the loop.
+      double lx(0), ly(0), lz(0);
+      for (size_t j = a_node.m_begin; j < a_node.m_end; ++j) {
+	const double ex(m_x[j] - px);
+	const double ey(m_y[j] - py);
+	const double ez(m_z[j] - pz);
+	const double r2(ex*ex + ey*ey + ez*ez + eps2);
+	const double inverse(r2 > 0 ? 1/std::sqrt(r2) : 0);
+	const double f(m_mass[j]*inverse*inverse*inverse);
+	lx += f*ex;
+	ly += f*ey;
+	lz += f*ez;
+      }
+      ax += lx;
+      ay += ly;
+      az += lz;
+      i = a_node.m_next;
+    } else {
+      ++i; // open it, the first child is next
+    }
+  }
+
+  return Cartesian(ax, ay, az);
+}
+
+void Coords::octree::accelerations(double* an_ax, double* an_ay, double* an_az, const double& a_G) const {
+  const double G(a_G);
+  // in Morton order, so the walks of a chunk share most of their nodes
+  parallelFor(size(), [&] (const size_t& a_begin, const size_t& a_end) {
+      for (size_t k = a_begin; k < a_end; ++k) {
+	const Cartesian a(walk(m_x[k], m_y[k], m_z[k]));
+	const size_t i(m_order[k]);
+	an_ax[i] += G*a.x();
+	an_ay[i] += G*a.y();
+	an_az[i] += G*a.z();
+      }
+    }, m_threads, 256);
+}
+
+Coords::Cartesian Coords::octree::acceleration(const Cartesian& a_point, const double& a_G) const {
+  return walk(a_point.x(), a_point.y(), a_point.z())*a_G;
+}
+
+Coords::ParticleSystem::force Coords::octree::gravity(const octree& a_tree, const double& a_G,
+						      const size_t& a_rebuild_interval) {
+  if (a_rebuild_interval == 0)
+    throw Error("octree rebuild interval must be at least 1");
+
+  // shared by copies of the force, e.g. of a copied ParticleSystem
+  std::shared_ptr<octree> tree(new octree(a_tree));
+  std::shared_ptr<size_t> evaluations(new size_t(0));
+  const double G(a_G);
+  const size_t interval(a_rebuild_interval);
+
+  return [tree, evaluations, G, interval] (const ParticleSystem::state& a_state,
+					   double* an_ax, double* an_ay, double* an_az) {
+    if (tree->size() != a_state.m_size || *evaluations % interval == 0)
+      tree->build(a_state.m_x, a_state.m_y, a_state.m_z, a_state.m_mass, a_state.m_size);
+    else
+      tree->refit(a_state.m_x, a_state.m_y, a_state.m_z, a_state.m_mass);
+    ++*evaluations;
+    tree->accelerations(an_ax, an_ay, an_az, G);
+  };
+}
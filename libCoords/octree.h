@@ -0,0 +1,171 @@
+// ================================================================
+// Filename:    octree.h
+//
+// Description: This defines a Barnes-Hut octree for O(N log N)
+//              gravitational accelerations. The nodes are laid out
+//              contiguously in Morton (z-order) depth first order.
+//
+// Author:      L.R. McFarland
+// Created:     2026 Oct 18
+// Language:    C++
+//
+//  Coords is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  Coords is distributed in the hope that it will be useful, but
+//  WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with Coords.  If not, see <http://www.gnu.org/licenses/>.
+// ================================================================
+
+#pragma once
+
+#include <vector>
+
+#include <angle.h>
+#include <Cartesian.h>
+#include <particles.h>
+
+namespace Coords {
+
+  // ==================
+  // ===== octree =====
+  // ==================
+
+  // build() sorts the particles by the Morton key of their position
+  // and splits the key ranges into octants until a leaf holds at
+  // most leafSize() particles. Each node is stored before its
+  // children and knows the index just past its subtree, so the walk
+  // for a particle is a forward scan through one array with out a
+  // stack, and nearby particles walk nearly the same nodes.
+  //
+  // A node is accepted as a point mass at its center of mass when
+  //
+  //   d > s/theta + delta
+  //
+  // with d the distance to its center of mass, s the largest side of
+  // the bounds of its particles and delta the offset of the center
+  // of mass from the center of those bounds. With theta <= 1 a node
+  // is never accepted for a point inside it, so there is no self
+  // interaction. theta 0 opens every node, i.e. direct summation.
+  //
+  // The acceleration of a particle at r from a mass m at r' is
+  //
+  //   G*m*(r' - r)/(|r' - r|^2 + eps^2)^(3/2)
+  //
+  // with eps the softening length, 0 for pure Newtonian gravity.
+  // Coincident particles contribute nothing to each other.
+  //
+  // refit() keeps the order and the nodes and only recomputes the
+  // masses, centers and bounds, so it is cheaper than build() while
+  // the particles have moved a little. The accelerations stay
+  // consistent with the opening rule but the walk gets slower as
+  // nodes come to overlap, so build() again every few steps.
+  //
+  // Thread safety: build() and refit() modify the tree. The const
+  // methods may be called from any number of threads.
+
+  class octree {
+
+  public:
+
+    explicit octree(const double& an_opening_angle=0.5, const double& a_softening=0,
+		    const size_t& a_leaf_size=8); // throws Error on a bad parameter
+
+    // implicit copy, move and dtor.
+
+    const double& openingAngle() const {return m_opening_angle;}
+    void          openingAngle(const double& an_opening_angle); // 0 <= theta <= 1, refit() to apply
+
+    const double& softening() const {return m_softening;}
+    void          softening(const double& a_softening);
+
+    const size_t& leafSize() const {return m_leaf_size;}
+    void          leafSize(const size_t& a_leaf_size); // >= 1, build() to apply
+
+    const size_t& threads() const           {return m_threads;}
+    void          threads(const size_t& a_threads) {m_threads = a_threads;} // 0 is hardwareThreads()
+
+    // ----- build -----
+
+    // a_size particles, e.g. from ParticleSystem x(), y(), z() and
+    // masses(). The tree keeps its own copy in Morton order.
+    void build(const double* a_x, const double* a_y, const double* a_z,
+	       const double* a_mass, const size_t& a_size);
+
+    // the same a_size particles in the same order as build(), moved.
+    void refit(const double* a_x, const double* a_y, const double* a_z,
+	       const double* a_mass);
+
+    size_t size() const  {return m_mass.size();}
+    size_t nodes() const {return m_nodes.size();}
+
+    double    totalMass() const;
+    Cartesian centerOfMass() const;
+
+    // the index of a particle in the original order, in Morton order.
+    const std::vector<size_t>& order() const {return m_order;}
+
+    // ----- accelerations -----
+
+    // adds G times the acceleration of each particle of the last
+    // build() or refit() to an_ax, an_ay, an_az, in their original
+    // order. Parallel over the particles.
+    void accelerations(double* an_ax, double* an_ay, double* an_az, const double& a_G=1) const;
+
+    // at any point, e.g. a test particle.
+    Cartesian acceleration(const Cartesian& a_point, const double& a_G=1) const;
+
+    // a ParticleSystem force that builds a tree over the system every
+    // a_rebuild_interval evaluations and refits it in between. The
+    // force owns a copy of a_tree.
+    static ParticleSystem::force gravity(const octree& a_tree, const double& a_G=1,
+					 const size_t& a_rebuild_interval=1);
+
+  private:
+
+    struct node {
+      double   m_x, m_y, m_z; // center of mass
+      double   m_mass;
+      double   m_open2;       // accepted beyond this distance squared
+      uint32_t m_begin;       // particles [m_begin, m_end) in Morton order
+      uint32_t m_end;
+      uint32_t m_next;        // just past the subtree, m_next == index + 1 for a leaf
+    };
+
+    struct bounds {
+      double m_min[3];
+      double m_max[3];
+    };
+
+    // the nodes of the subtree for the sorted keys [a_begin, a_end)
+    // from bit a_level down, appended to some_nodes.
+    void split(const std::vector<uint64_t>& some_keys, const size_t& a_begin, const size_t& a_end,
+	       const int& a_level, std::vector<node>& some_nodes) const;
+
+    // recomputes m_nodes[a_first, a_last) children first
+    void refitNodes(const size_t& a_first, const size_t& a_last);
+
+    // the top level subtrees as [first, last) node ranges
+    std::vector<std::pair<size_t, size_t> > subtrees() const;
+
+    Cartesian walk(const double& a_x, const double& a_y, const double& a_z) const;
+
+    double m_opening_angle;
+    double m_softening;
+    size_t m_leaf_size;
+    size_t m_threads;
+
+    std::vector<double> m_x, m_y, m_z, m_mass; // Morton order
+    std::vector<size_t> m_order;
+    std::vector<node>   m_nodes;
+    std::vector<bounds> m_bounds;               // of each node
+
+  };
+
+} // end namespace Coords
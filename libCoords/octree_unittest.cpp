@@ -0,0 +1,254 @@
+// ================================================================
+// Filename:    octree_unittest.cpp
+// Description: This is the gtest unittest of the Barnes-Hut octree.
+//
+// Author:      L.R. McFarland, lrm@starbug.com
+// Created:     2026 Oct 18
+// Language:    C++
+//
+// See also: http://code.google.com/p/googletest/wiki/Primer
+//
+//  Coordinates is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  Coordinates is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with Coordinates.  If not, see <http://www.gnu.org/licenses/>.
+// ================================================================
+
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <angle.h>
+#include <Cartesian.h>
+#include <octree.h>
+
+
+namespace {
+
+  // ------------------------------
+  // ----- random particles -----
+  // ------------------------------
+
+  class RandomOctree : public ::testing::Test {
+  protected:
+
+    // a Plummer-like cluster, dense in the middle
+    enum {s_size = 3000};
+
+    virtual void SetUp() {
+      std::mt19937 generator(12345);
+      std::normal_distribution<double> normal(0, 1);
+      std::uniform_real_distribution<double> uniform(0.5, 1.5);
+      for (size_t i = 0; i < s_size; ++i) {
+	const double r(normal(generator)), s(uniform(generator));
+	x.push_back(r*normal(generator));
+	y.push_back(r*normal(generator));
+	z.push_back(r*normal(generator));
+	m.push_back(s);
+      }
+    }
+
+    // direct summation with Cartesian operators
+    std::vector<Coords::Cartesian> direct(const double& a_softening) const {
+      std::vector<Coords::Cartesian> a(s_size);
+      for (size_t i = 0; i < s_size; ++i) {
+	const Coords::Cartesian ri(x[i], y[i], z[i]);
+	for (size_t j = 0; j < s_size; ++j) {
+	  if (i == j)
+	    continue;
+	  const Coords::Cartesian d(Coords::Cartesian(x[j], y[j], z[j]) - ri);
+	  const double r2(d.magnitude2() + a_softening*a_softening);
+	  a[i] += d*(m[j]/(r2*std::sqrt(r2)));
+	}
+      }
+      return a;
+    }
+
+    // rms of |a - b|/|b|
+    double relativeError(const std::vector<Coords::Cartesian>& a_reference,
+			 const std::vector<double>& ax, const std::vector<double>& ay,
+			 const std::vector<double>& az) const {
+      double sum(0);
+      for (size_t i = 0; i < s_size; ++i)
+	sum += (Coords::Cartesian(ax[i], ay[i], az[i]) - a_reference[i]).magnitude2()/a_reference[i].magnitude2();
+      return std::sqrt(sum/s_size);
+    }
+
+    std::vector<double> x, y, z, m;
+  };
+
+  TEST_F(RandomOctree, Layout) {
+    Coords::octree a_tree(0.5, 0, 4);
+    a_tree.build(x.data(), y.data(), z.data(), m.data(), s_size);
+    EXPECT_EQ(size_t(s_size), a_tree.size());
+    EXPECT_GT(a_tree.nodes(), size_t(s_size)/4);
+
+    double mass(0);
+    Coords::Cartesian moment;
+    for (size_t i = 0; i < s_size; ++i) {
+      mass += m[i];
+      moment += Coords::Cartesian(x[i], y[i], z[i])*m[i];
+    }
+    EXPECT_NEAR(mass, a_tree.totalMass(), 1e-9);
+    EXPECT_NEAR(0, (moment/mass - a_tree.centerOfMass()).magnitude(), 1e-12);
+
+    // every particle exactly once
+    std::vector<size_t> seen(s_size, 0);
+    for (size_t k = 0; k < s_size; ++k)
+      ++seen[a_tree.order()[k]];
+    for (size_t i = 0; i < s_size; ++i)
+      ASSERT_EQ(1u, seen[i]);
+  }
+
+  TEST_F(RandomOctree, ZeroAngleIsDirect) {
+    const double softening(0.01);
+    const std::vector<Coords::Cartesian> reference(direct(softening));
+
+    Coords::octree a_tree(0, softening);
+    a_tree.build(x.data(), y.data(), z.data(), m.data(), s_size);
+    std::vector<double> ax(s_size, 0), ay(s_size, 0), az(s_size, 0);
+    a_tree.accelerations(ax.data(), ay.data(), az.data());
+    EXPECT_LT(relativeError(reference, ax, ay, az), 1e-12);
+  }
+
+  TEST_F(RandomOctree, OpeningAngleError) {
+    const std::vector<Coords::Cartesian> reference(direct(0));
+    double last(0);
+    const double angles[] = {0.3, 0.5, 0.7};
+    for (size_t k = 0; k < 3; ++k) {
+      Coords::octree a_tree(angles[k]);
+      a_tree.build(x.data(), y.data(), z.data(), m.data(), s_size);
+      std::vector<double> ax(s_size, 0), ay(s_size, 0), az(s_size, 0);
+      a_tree.accelerations(ax.data(), ay.data(), az.data());
+      const double error(relativeError(reference, ax, ay, az));
+      EXPECT_LT(error, 0.02) << "theta " << angles[k];
+      EXPECT_GT(error, last) << "theta " << angles[k]; // larger angles, coarser
+      last = error;
+    }
+  }
+
+  TEST_F(RandomOctree, AddsG) {
+    Coords::octree a_tree;
+    a_tree.build(x.data(), y.data(), z.data(), m.data(), s_size);
+    std::vector<double> ax(s_size, 1), ay(s_size, 2), az(s_size, 3);
+    std::vector<double> bx(s_size, 0), by(s_size, 0), bz(s_size, 0);
+    a_tree.accelerations(ax.data(), ay.data(), az.data(), 2);
+    a_tree.accelerations(bx.data(), by.data(), bz.data());
+    for (size_t i = 0; i < s_size; ++i) {
+      ASSERT_DOUBLE_EQ(1 + 2*bx[i], ax[i]);
+      ASSERT_DOUBLE_EQ(3 + 2*bz[i], az[i]);
+    }
+  }
+
+  TEST_F(RandomOctree, RefitMatchesBuild) {
+    Coords::octree refitted(0.5, 0.01);
+    refitted.build(x.data(), y.data(), z.data(), m.data(), s_size);
+
+    std::mt19937 generator(54321);
+    std::normal_distribution<double> normal(0, 0.01);
+    for (size_t i = 0; i < s_size; ++i) {
+      x[i] += normal(generator);
+      y[i] += normal(generator);
+      z[i] += normal(generator);
+    }
+    refitted.refit(x.data(), y.data(), z.data(), m.data());
+
+    const std::vector<Coords::Cartesian> reference(direct(0.01));
+    std::vector<double> ax(s_size, 0), ay(s_size, 0), az(s_size, 0);
+    refitted.accelerations(ax.data(), ay.data(), az.data());
+    EXPECT_LT(relativeError(reference, ax, ay, az), 0.02);
+
+    // and exact with every node open
+    refitted.openingAngle(0);
+    refitted.refit(x.data(), y.data(), z.data(), m.data());
+    std::fill(ax.begin(), ax.end(), 0);
+    std::fill(ay.begin(), ay.end(), 0);
+    std::fill(az.begin(), az.end(), 0);
+    refitted.accelerations(ax.data(), ay.data(), az.data());
+    EXPECT_LT(relativeError(reference, ax, ay, az), 1e-12);
+  }
+
+  TEST_F(RandomOctree, ThreadsMatchSerial) {
+    Coords::octree serial;
+    serial.threads(1);
+    serial.build(x.data(), y.data(), z.data(), m.data(), s_size);
+    Coords::octree parallel;
+    parallel.threads(4);
+    parallel.build(x.data(), y.data(), z.data(), m.data(), s_size);
+    ASSERT_EQ(serial.nodes(), parallel.nodes());
+
+    std::vector<double> ax(s_size, 0), ay(s_size, 0), az(s_size, 0);
+    std::vector<double> bx(s_size, 0), by(s_size, 0), bz(s_size, 0);
+    serial.accelerations(ax.data(), ay.data(), az.data());
+    parallel.accelerations(bx.data(), by.data(), bz.data());
+    for (size_t i = 0; i < s_size; ++i) {
+      ASSERT_EQ(ax[i], bx[i]);
+      ASSERT_EQ(ay[i], by[i]);
+      ASSERT_EQ(az[i], bz[i]);
+    }
+  }
+
+  TEST_F(RandomOctree, GravityForce) {
+    // exact pairwise forces conserve momentum
+    Coords::ParticleSystem a_system;
+    for (size_t i = 0; i < 300; ++i)
+      a_system.add(Coords::Cartesian(x[i], y[i], z[i]), Coords::Cartesian::Uo, m[i]);
+    a_system.addForce(Coords::octree::gravity(Coords::octree(0, 0.05), 1, 3));
+    a_system.run(0.001, 10);
+    EXPECT_LT(a_system.momentum().magnitude(), 1e-10);
+    EXPECT_GT(a_system.kineticEnergy(), 0);
+  }
+
+  // --------------------------
+  // ----- fixed octree -----
+  // --------------------------
+
+  TEST(FixedOctree, Errors) {
+    EXPECT_THROW(Coords::octree(-0.1), Coords::Error);
+    EXPECT_THROW(Coords::octree(1.1), Coords::Error);
+    EXPECT_THROW(Coords::octree(0.5, -1), Coords::Error);
+    EXPECT_THROW(Coords::octree(0.5, 0, 0), Coords::Error);
+    EXPECT_THROW(Coords::octree::gravity(Coords::octree(), 1, 0), Coords::Error);
+  }
+
+  TEST(FixedOctree, Empty) {
+    Coords::octree a_tree;
+    a_tree.build(0, 0, 0, 0, 0);
+    EXPECT_EQ(0u, a_tree.nodes());
+    EXPECT_EQ(0, a_tree.totalMass());
+    EXPECT_TRUE(a_tree.acceleration(Coords::Cartesian::Ux) == Coords::Cartesian::Uo);
+  }
+
+  TEST(FixedOctree, Coincident) {
+    // more than a leaf at one point is one large leaf, and they do
+    // not attract each other
+    std::vector<double> x(20, 1), y(20, 2), z(20, 3), m(20, 1);
+    Coords::octree a_tree(0.5, 0, 4);
+    a_tree.build(x.data(), y.data(), z.data(), m.data(), 20);
+    EXPECT_EQ(1u, a_tree.nodes());
+    std::vector<double> ax(20, 0), ay(20, 0), az(20, 0);
+    a_tree.accelerations(ax.data(), ay.data(), az.data());
+    for (size_t i = 0; i < 20; ++i)
+      EXPECT_EQ(0, ax[i]);
+
+    // a point mass of 20 from far away
+    const Coords::Cartesian far(101, 2, 3);
+    EXPECT_NEAR(-20.0/10000, a_tree.acceleration(far).x(), 1e-15);
+    EXPECT_NEAR(-40.0/10000, a_tree.acceleration(far, 2).x(), 1e-15);
+  }
+
+} // end anonymous namespace
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,230 @@
+// ==================================================================
+// Filename:    parallel.cpp
+//
+// Description: Implements the parallel loop and its thread pool.
+//
+// Author:      L.R. McFarland
+// Created:     2026 Oct 18
+// Language:    C++
+//
+//  Coordinates is free software: you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License as
+//  published by the Free Software Foundation, either version 3 of the
+//  License, or (at your option) any later version.
+//
+//  Coordinates is distributed in the hope that it will be useful, but
+//  WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with Coordinates.  If not, see <http://www.gnu.org/licenses/>.
+// ==================================================================
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <parallel.h>
+
+namespace {
+
+  // true on the workers and on a caller while it runs chunks, so a
+  // nested parallelFor() runs serially instead of waiting on itself.
+  thread_local bool t_in_parallel(false);
+
+  // ---------------------------
+  // ----- class threadPool -----
+  // ---------------------------
+
+  // One loop at a time. The caller posts the chunk function, wakes as
+  // many workers as it wants, takes chunks itself and waits for the
+  // workers it woke to finish theirs.
+
+  class threadPool {
+  public:
+
+    static threadPool& instance() {
+      static threadPool a_pool;
+      return a_pool;
+    }
+
+    ~threadPool() {
+      {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_stop = true;
+      }
+      m_wake.notify_all();
+      for (size_t k = 0; k < m_workers.size(); ++k)
+	m_workers[k].join();
+    }
+
+    // runs a_chunk(0 .. a_chunks - 1) on up to a_threads threads
+    // including this one. false if the pool is in use.
+    bool run(const size_t& a_chunks, const std::function<void (const size_t&)>& a_chunk, const size_t& a_threads) {
+
+      std::unique_lock<std::mutex> submit(m_submit, std::try_to_lock);
+      if (!submit.owns_lock())
+	return false;
+
+      grow(a_threads - 1);
+
+      {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_job = &a_chunk;
+	m_chunks = a_chunks;
+	m_next = 0;
+	m_wanted = std::min(m_workers.size(), std::min(a_threads, a_chunks) - 1);
+	m_enlisted = 0;
+	m_active = m_wanted;
+	++m_generation;
+      }
+      m_wake.notify_all();
+
+      t_in_parallel = true;
+      drain();
+      t_in_parallel = false;
+
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_done.wait(lock, [this] () {return m_active == 0;});
+      m_job = 0;
+      return true;
+    }
+
+  private:
+
+    threadPool() : m_job(0), m_chunks(0), m_next(0), m_wanted(0), m_enlisted(0), m_active(0),
+		   m_generation(0), m_stop(false) {}
+
+    void grow(const size_t& a_size) {
+      while (m_workers.size() < a_size) {
+	try {
+	  m_workers.push_back(std::thread(&threadPool::work, this));
+	} catch (const std::system_error&) {
+	  break; // out of threads, run with the ones there are
+	}
+      }
+    }
+
+    void drain() {
+      for (size_t c = m_next++; c < m_chunks; c = m_next++)
+	(*m_job)(c);
+    }
+
+    void work() {
+      t_in_parallel = true;
+      size_t seen(0);
+      std::unique_lock<std::mutex> lock(m_mutex);
+      for (;;) {
+	m_wake.wait(lock, [this, &seen] () {
+	    return m_stop || (m_generation != seen && m_enlisted < m_wanted);
+	  });
+	if (m_stop)
+	  return;
+	seen = m_generation;
+	++m_enlisted;
+	lock.unlock();
+	drain();
+	lock.lock();
+	if (--m_active == 0)
+	  m_done.notify_all();
+      }
+    }
+
+    std::mutex               m_submit; // held by the caller for a whole loop
+    std::mutex               m_mutex;  // guards the rest
+    std::condition_variable  m_wake;
+    std::condition_variable  m_done;
+    std::vector<std::thread> m_workers;
+
+    const std::function<void (const size_t&)>* m_job;
+    size_t              m_chunks;
+    std::atomic<size_t> m_next;     // the next chunk to take
+    size_t              m_wanted;   // workers to wake for this loop
+    size_t              m_enlisted; // of them awake so far
+    size_t              m_active;   // of them not finished
+    size_t              m_generation;
+    bool                m_stop;
+
+  };
+
+} // end anonymous namespace
+
+
+// --------------------------
+// ----- parallel loops -----
+// --------------------------
+
+size_t Coords::hardwareThreads() {
+  return std::max(1u, std::thread::hardware_concurrency());
+}
+
+void Coords::parallelFor(const size_t& a_size,
+			 const std::function<void (const size_t&, const size_t&)>& a_body,
+			 const size_t& a_threads,
+			 const size_t& a_grain) {
+
+  size_t threads(a_threads == 0 ? hardwareThreads() : a_threads);
+  threads = std::min(threads, a_size/std::max(a_grain, size_t(1)));
+
+  if (threads <= 1 || t_in_parallel) {
+    if (a_size > 0)
+      a_body(0, a_size);
+    return;
+  }
+
+  // chunks are whole cache lines of doubles so threads do not share
+  // a line they write.
+  const size_t chunk(((a_size + threads - 1)/threads + 7) & ~size_t(7));
+  const size_t chunks((a_size + chunk - 1)/chunk);
+
+  std::vector<std::exception_ptr> errors(chunks);
+  const std::function<void (const size_t&)> a_chunk([&] (const size_t& c) {
+      try {
+	a_body(c*chunk, std::min(a_size, (c + 1)*chunk));
+      } catch (...) {
+	errors[c] = std::current_exception();
+      }
+    });
+
+  if (!threadPool::instance().run(chunks, a_chunk, threads)) {
+    // another thread has the pool, the same chunks here
+    const bool was_in_parallel(t_in_parallel);
+    t_in_parallel = true;
+    for (size_t c = 0; c < chunks; ++c)
+      a_chunk(c);
+    t_in_parallel = was_in_parallel;
+  }
+
+  for (size_t c = 0; c < chunks; ++c)
+    if (errors[c])
+      std::rethrow_exception(errors[c]);
+}
+
+void Coords::parallelSort(std::vector<std::pair<uint64_t, size_t> >& some_keys, const size_t& a_threads) {
+
+  const size_t size(some_keys.size());
+  const size_t threads(a_threads == 0 ? hardwareThreads() : a_threads);
+  const size_t chunk(std::max(size_t(16384), (size + threads - 1)/threads));
+  const size_t chunks((size + chunk - 1)/chunk);
+
+  parallelFor(chunks, [&] (const size_t& a_begin, const size_t& a_end) {
+      for (size_t c = a_begin; c < a_end; ++c)
+	std::sort(some_keys.begin() + c*chunk, some_keys.begin() + std::min(size, (c + 1)*chunk));
+    }, threads, 1);
+
+  for (size_t width = chunk; width < size; width *= 2) {
+    const size_t merges((size + 2*width - 1)/(2*width));
+    parallelFor(merges, [&] (const size_t& a_begin, const size_t& a_end) {
+	for (size_t k = a_begin; k < a_end; ++k)
+	  std::inplace_merge(some_keys.begin() + 2*k*width,
+			     some_keys.begin() + std::min(size, (2*k + 1)*width),
+			     some_keys.begin() + std::min(size, (2*k + 2)*width));
+      }, threads, 1);
+  }
+}
@@ -0,0 +1,63 @@
+// ================================================================
+// Filename:    parallel.h
+//
+// Description: This defines the parallel loop used by the particle,
+//              tree and N-body code, run on a pool of worker threads
+//              shared by the whole library.
+//
+// Author:      L.R. McFarland
+// Created:     2026 Oct 18
+// Language:    C++
+//
+//  Coords is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  Coords is distributed in the hope that it will be useful, but
+//  WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with Coords.  If not, see <http://www.gnu.org/licenses/>.
+// ================================================================
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <stdint.h>
+#include <utility>
+#include <vector>
+
+namespace Coords {
+
+  // ----- parallel loops -----
+
+  // calls a_body(begin, end) on contiguous chunks of [0, a_size), one
+  // chunk per thread. The chunks depend only on a_size, a_threads and
+  // a_grain, not on which thread runs them, so a loop whose chunks
+  // are independent gives the same result every time.
+  //
+  // Runs serially on the calling thread when there are fewer than two
+  // chunks of a_grain elements, a_threads is 1, it is called from
+  // inside another parallelFor() or another thread is already using
+  // the pool. a_threads 0 is hardwareThreads().
+  //
+  // The workers are started on first use, grow to the most threads
+  // asked for, and wait between loops, so a loop costs a wake up and
+  // not a thread start. The first exception thrown by a chunk is
+  // rethrown after all of them have finished.
+  void parallelFor(const size_t& a_size,
+		   const std::function<void (const size_t&, const size_t&)>& a_body,
+		   const size_t& a_threads=0,
+		   const size_t& a_grain=16384);
+
+  size_t hardwareThreads(); // at least 1
+
+  // sorts by key then index, e.g. Morton keys and particle indices,
+  // in parallel chunks merged pairwise. The same result as std::sort.
+  void parallelSort(std::vector<std::pair<uint64_t, size_t> >& some_keys, const size_t& a_threads=0);
+
+} // end namespace Coords
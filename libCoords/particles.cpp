@@ -0,0 +1,361 @@
+// ==================================================================
+// Filename:    particles.cpp
+//
+// Description: Implements the particle system integrators.
+//
+// Author:      L.R. McFarland
+// Created:     2026 Oct 18
+// Language:    C++
+//
+//  Coordinates is free software: you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License as
+//  published by the Free Software Foundation, either version 3 of the
+//  License, or (at your option) any later version.
+//
+//  Coordinates is distributed in the hope that it will be useful, but
+//  WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with Coordinates.  If not, see <http://www.gnu.org/licenses/>.
+// ==================================================================
+
+#include <particles.h>
+#include <reduce.h>
+
+// ------------------------
+// ----- constructors -----
+// ------------------------
+
+Coords::ParticleSystem::ParticleSystem(const integrator& an_integrator)
+  : m_integrator(an_integrator), m_time(0), m_is_accelerated(false), m_threads(0)
+{}
+
+Coords::ParticleSystem::force Coords::ParticleSystem::uniformField(const Cartesian& an_acceleration) {
+  const double gx(an_acceleration.x());
+  const double gy(an_acceleration.y());
+  const double gz(an_acceleration.z());
+  return [gx, gy, gz] (const state& a_state, double* an_ax, double* an_ay, double* an_az) {
+    for (size_t i = 0; i < a_state.m_size; ++i) {
+      an_ax[i] += gx;
+      an_ay[i] += gy;
+      an_az[i] += gz;
+    }
+  };
+}
+
+
+// ---------------------
+// ----- particles -----
+// ---------------------
+
+size_t Coords::ParticleSystem::add(const Cartesian& a_position, const Cartesian& a_velocity, const double& a_mass) {
+  if (a_mass < 0)
+    throw Error("particle mass must not be negative");
+  m_x.push_back(a_position.x());
+  m_y.push_back(a_position.y());
+  m_z.push_back(a_position.z());
+  m_vx.push_back(a_velocity.x());
+  m_vy.push_back(a_velocity.y());
+  m_vz.push_back(a_velocity.z());
+  m_mass.push_back(a_mass);
+  m_is_accelerated = false;
+  return m_mass.size() - 1;
+}
+
+void Coords::ParticleSystem::clear() {
+  m_x.clear();
+  m_y.clear();
+  m_z.clear();
+  m_vx.clear();
+  m_vy.clear();
+  m_vz.clear();
+  m_mass.clear();
+  m_recorders.clear();
+  m_is_accelerated = false;
+}
+
+Coords::Cartesian Coords::ParticleSystem::position(const size_t& an_index) const {
+  return Cartesian(m_x[an_index], m_y[an_index], m_z[an_index]);
+}
+
+void Coords::ParticleSystem::position(const size_t& an_index, const Cartesian& a_position) {
+  m_x[an_index] = a_position.x();
+  m_y[an_index] = a_position.y();
+  m_z[an_index] = a_position.z();
+  m_is_accelerated = false;
+}
+
+Coords::Cartesian Coords::ParticleSystem::velocity(const size_t& an_index) const {
+  return Cartesian(m_vx[an_index], m_vy[an_index], m_vz[an_index]);
+}
+
+void Coords::ParticleSystem::velocity(const size_t& an_index, const Cartesian& a_velocity) {
+  m_vx[an_index] = a_velocity.x();
+  m_vy[an_index] = a_velocity.y();
+  m_vz[an_index] = a_velocity.z();
+  m_is_accelerated = false;
+}
+
+void Coords::ParticleSystem::mass(const size_t& an_index, const double& a_mass) {
+  if (a_mass < 0)
+    throw Error("particle mass must not be negative");
+  m_mass[an_index] = a_mass;
+  m_is_accelerated = false;
+}
+
+
+// -----------------------
+// ----- integration -----
+// -----------------------
+
+void Coords::ParticleSystem::method(const integrator& an_integrator) {
+  m_integrator = an_integrator;
+  m_is_accelerated = false;
+}
+
+void Coords::ParticleSystem::time(const double& a_time) {
+  m_time = a_time;
+  m_is_accelerated = false;
+}
+
+void Coords::ParticleSystem::addForce(const force& a_force) {
+  m_forces.push_back(a_force);
+  m_is_accelerated = false;
+}
+
+void Coords::ParticleSystem::clearForces() {
+  m_forces.clear();
+  m_is_accelerated = false;
+}
+
+Coords::ParticleSystem::state Coords::ParticleSystem::current() const {
+  state a_state = {m_x.data(), m_y.data(), m_z.data(),
+		   m_vx.data(), m_vy.data(), m_vz.data(),
+		   m_mass.data(), size(), m_time};
+  return a_state;
+}
+
+void Coords::ParticleSystem::accelerate(const state& a_state) {
+  m_ax.assign(size(), 0.0);
+  m_ay.assign(size(), 0.0);
+  m_az.assign(size(), 0.0);
+  for (size_t k = 0; k < m_forces.size(); ++k)
+    m_forces[k](a_state, m_ax.data(), m_ay.data(), m_az.data());
+}
+
+void Coords::ParticleSystem::drift(const double& a_dt, const size_t& a_begin, const size_t& a_end) {
+  double* x(m_x.data());
+  double* y(m_y.data());
+  double* z(m_z.data());
+  const double* vx(m_vx.data());
+  const double* vy(m_vy.data());
+  const double* vz(m_vz.data());
+  const double dt(a_dt); // a copy, so the stores cannot alias it
+  for (size_t i = a_begin; i < a_end; ++i) {
+    x[i] += vx[i]*dt;
+    y[i] += vy[i]*dt;
+    z[i] += vz[i]*dt;
+  }
+}
+
+void Coords::ParticleSystem::kick(const double& a_dt, const size_t& a_begin, const size_t& a_end) {
+  double* vx(m_vx.data());
+  double* vy(m_vy.data());
+  double* vz(m_vz.data());
+  const double* ax(m_ax.data());
+  const double* ay(m_ay.data());
+  const double* az(m_az.data());
+  const double dt(a_dt);
+  for (size_t i = a_begin; i < a_end; ++i) {
+    vx[i] += ax[i]*dt;
+    vy[i] += ay[i]*dt;
+    vz[i] += az[i]*dt;
+  }
+}
+
+void Coords::ParticleSystem::stepLeapfrog(const double& a_dt) {
+  const double half(a_dt/2);
+  parallelFor(size(), [this, half] (const size_t& a_begin, const size_t& a_end) {
+      drift(half, a_begin, a_end);
+    }, m_threads);
+  m_time += half;
+
+  accelerate(current());
+
+  parallelFor(size(), [this, half, a_dt] (const size_t& a_begin, const size_t& a_end) {
+      kick(a_dt, a_begin, a_end);
+      drift(half, a_begin, a_end);
+    }, m_threads);
+  m_time += half;
+
+  m_is_accelerated = false; // m_ax etc. are for the midpoint
+}
+
+void Coords::ParticleSystem::stepVelocityVerlet(const double& a_dt) {
+  const double half(a_dt/2);
+
+  if (!m_is_accelerated)
+    accelerate(current());
+
+  parallelFor(size(), [this, half, a_dt] (const size_t& a_begin, const size_t& a_end) {
+      kick(half, a_begin, a_end);
+      drift(a_dt, a_begin, a_end);
+    }, m_threads);
+  m_time += a_dt;
+
+  accelerate(current());
+
+  parallelFor(size(), [this, half] (const size_t& a_begin, const size_t& a_end) {
+      kick(half, a_begin, a_end);
+    }, m_threads);
+
+  m_is_accelerated = true;
+}
+
+void Coords::ParticleSystem::stepRK4(const double& a_dt) {
+
+  // Four stages k = 0..3. The stage position and velocity are in
+  // xs..vzs, the weighted sums of their derivatives in sx..svz.
+
+  const size_t n(size());
+  m_scratch.resize(12*n);
+  double* xs(&m_scratch[0]);
+  double* ys(xs + n);
+  double* zs(ys + n);
+  double* vxs(zs + n);
+  double* vys(vxs + n);
+  double* vzs(vys + n);
+  double* sx(vzs + n);
+  double* sy(sx + n);
+  double* sz(sy + n);
+  double* svx(sz + n);
+  double* svy(svx + n);
+  double* svz(svy + n);
+
+  const double weight[4] = {1, 2, 2, 1};
+  const double offset[4] = {0, 0.5, 0.5, 1}; // stage time as a fraction of a_dt
+
+  for (size_t k = 0; k < 4; ++k) {
+
+    state a_state(current());
+    if (k > 0) {
+      state stage = {xs, ys, zs, vxs, vys, vzs, m_mass.data(), n, m_time + offset[k]*a_dt};
+      a_state = stage;
+    }
+
+    accelerate(a_state);
+
+    // the next stage starts from the current state, so it can
+    // overwrite this one element by element.
+    const double w(weight[k]);
+    const double c(k < 3 ? offset[k + 1]*a_dt : 0);
+    const double* ax(m_ax.data());
+    const double* ay(m_ay.data());
+    const double* az(m_az.data());
+    parallelFor(n, [&] (const size_t& a_begin, const size_t& a_end) {
+	const double* vx(a_state.m_vx);
+	const double* vy(a_state.m_vy);
+	const double* vz(a_state.m_vz);
+	const double* x0(m_x.data());
+	const double* y0(m_y.data());
+	const double* z0(m_z.data());
+	const double* vx0(m_vx.data());
+	const double* vy0(m_vy.data());
+	const double* vz0(m_vz.data());
+	const bool first(k == 0); // the sums start here, the scratch is not initialized
+	for (size_t i = a_begin; i < a_end; ++i) {
+	  const double u(vx[i]), v(vy[i]), s(vz[i]);
+	  sx[i] = first ? w*u : sx[i] + w*u;
+	  sy[i] = first ? w*v : sy[i] + w*v;
+	  sz[i] = first ? w*s : sz[i] + w*s;
+	  svx[i] = first ? w*ax[i] : svx[i] + w*ax[i];
+	  svy[i] = first ? w*ay[i] : svy[i] + w*ay[i];
+	  svz[i] = first ? w*az[i] : svz[i] + w*az[i];
+	  xs[i] = x0[i] + c*u;
+	  ys[i] = y0[i] + c*v;
+	  zs[i] = z0[i] + c*s;
+	  vxs[i] = vx0[i] + c*ax[i];
+	  vys[i] = vy0[i] + c*ay[i];
+	  vzs[i] = vz0[i] + c*az[i];
+	}
+      }, m_threads);
+  }
+
+  const double sixth(a_dt/6);
+  parallelFor(n, [&] (const size_t& a_begin, const size_t& a_end) {
+      for (size_t i = a_begin; i < a_end; ++i) {
+	m_x[i] += sixth*sx[i];
+	m_y[i] += sixth*sy[i];
+	m_z[i] += sixth*sz[i];
+	m_vx[i] += sixth*svx[i];
+	m_vy[i] += sixth*svy[i];
+	m_vz[i] += sixth*svz[i];
+      }
+    }, m_threads);
+  m_time += a_dt;
+
+  m_is_accelerated = false; // m_ax etc. are for the last stage
+}
+
+void Coords::ParticleSystem::step(const double& a_dt) {
+  switch (m_integrator) {
+  case leapfrog:
+    stepLeapfrog(a_dt);
+    break;
+  case velocity_verlet:
+    stepVelocityVerlet(a_dt);
+    break;
+  case rk4:
+    stepRK4(a_dt);
+    break;
+  }
+  for (size_t k = 0; k < m_recorders.size(); ++k)
+    m_recorders[k].second->push(position(m_recorders[k].first));
+}
+
+void Coords::ParticleSystem::run(const double& a_dt, const size_t& a_steps) {
+  for (size_t k = 0; k < a_steps; ++k)
+    step(a_dt);
+}
+
+
+// ------------------------
+// ----- trajectories -----
+// ------------------------
+
+void Coords::ParticleSystem::record(const size_t& an_index, CartesianRecorder& a_recorder) {
+  if (an_index >= size())
+    throw Error("no particle to record at that index");
+  m_recorders.push_back(std::make_pair(an_index, &a_recorder));
+  a_recorder.push(position(an_index));
+}
+
+void Coords::ParticleSystem::unrecord(const CartesianRecorder& a_recorder) {
+  size_t kept(0);
+  for (size_t k = 0; k < m_recorders.size(); ++k)
+    if (m_recorders[k].second != &a_recorder)
+      m_recorders[kept++] = m_recorders[k];
+  m_recorders.resize(kept);
+}
+
+
+// -----------------------
+// ----- diagnostics -----
+// -----------------------
+
+double Coords::ParticleSystem::kineticEnergy() const {
+  double energy(0);
+  for (size_t i = 0; i < size(); ++i)
+    energy += m_mass[i]*(m_vx[i]*m_vx[i] + m_vy[i]*m_vy[i] + m_vz[i]*m_vz[i]);
+  return energy/2;
+}
+
+Coords::Cartesian Coords::ParticleSystem::momentum() const {
+  return weightedSum(m_vx.data(), m_vy.data(), m_vz.data(), m_mass.data(), size(), m_threads);
+}
+
+Coords::Cartesian Coords::ParticleSystem::centerOfMass() const {
+  return mean(m_x.data(), m_y.data(), m_z.data(), m_mass.data(), size(), m_threads);
+}
@@ -0,0 +1,194 @@
+// ================================================================
+// Filename:    particles.h
+//
+// Description: This defines a system of point particles stored as
+//              structure of arrays and advanced in time by a
+//              leapfrog, velocity Verlet or RK4 integrator under
+//              pluggable forces, with optional trajectory capture
+//              into CartesianRecorders.
+//
+// Author:      L.R. McFarland
+// Created:     2026 Oct 18
+// Language:    C++
+//
+//  Coords is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  Coords is distributed in the hope that it will be useful, but
+//  WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with Coords.  If not, see <http://www.gnu.org/licenses/>.
+// ================================================================
+
+#pragma once
+
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include <angle.h>
+#include <Cartesian.h>
+#include <parallel.h>
+
+namespace Coords {
+
+  // ==========================
+  // ===== ParticleSystem =====
+  // ==========================
+
+  // Positions, velocities and masses are kept as separate x, y, z
+  // arrays so the integrator loops vectorize and a force can read
+  // them with out converting from Cartesian.
+  //
+  // A force adds the acceleration, F/m, it causes on every particle
+  // to the ax, ay, az arrays, which start each evaluation at zero, so
+  // forces compose by adding more of them. It sees all the particles
+  // at once so it can be a vectorized or parallel loop itself.
+  //
+  // leapfrog (drift, kick, drift) and velocity Verlet (kick, drift,
+  // kick) are symplectic, second order and need one force evaluation
+  // per step, so energy errors stay bounded over long runs. They
+  // assume the forces depend on positions and time only, a velocity
+  // dependent force sees velocities half a step off. RK4 is fourth
+  // order with four evaluations per step and handles any force, but
+  // its energy drifts.
+  //
+  // Thread safety: not thread safe. step() itself runs the integrator
+  // loops over threads() threads.
+
+  class ParticleSystem {
+
+  public:
+
+    enum integrator {leapfrog, velocity_verlet, rk4};
+
+    // what a force evaluation sees, size particles each. For RK4
+    // these are the intermediate stage values, not the system's.
+    struct state {
+      const double* m_x;
+      const double* m_y;
+      const double* m_z;
+      const double* m_vx;
+      const double* m_vy;
+      const double* m_vz;
+      const double* m_mass;
+      size_t        m_size;
+      double        m_time;
+    };
+
+    // adds a_state.m_size accelerations to an_ax, an_ay, an_az. Must
+    // not keep the pointers.
+    typedef std::function<void (const state& a_state, double* an_ax, double* an_ay, double* an_az)> force;
+
+    // the same acceleration on every particle, e.g. gravity near the
+    // surface.
+    static force uniformField(const Cartesian& an_acceleration);
+
+    explicit ParticleSystem(const integrator& an_integrator=velocity_verlet); // ctor
+
+    // implicit copy, move and dtor. Copies share recorders.
+
+    // ----- particles -----
+
+    size_t size() const {return m_mass.size();}
+    size_t add(const Cartesian& a_position, const Cartesian& a_velocity, const double& a_mass); // returns the index
+    void   clear();
+
+    Cartesian position(const size_t& an_index) const;
+    void      position(const size_t& an_index, const Cartesian& a_position);
+
+    Cartesian velocity(const size_t& an_index) const;
+    void      velocity(const size_t& an_index, const Cartesian& a_velocity);
+
+    const double& mass(const size_t& an_index) const {return m_mass[an_index];}
+    void          mass(const size_t& an_index, const double& a_mass);
+
+    // size() elements each. Writing through them is allowed between
+    // steps, call invalidate() afterwards.
+    const double* x() const  {return m_x.data();}
+    const double* y() const  {return m_y.data();}
+    const double* z() const  {return m_z.data();}
+    const double* vx() const {return m_vx.data();}
+    const double* vy() const {return m_vy.data();}
+    const double* vz() const {return m_vz.data();}
+    const double* masses() const {return m_mass.data();}
+
+    double* x()  {return m_x.data();}
+    double* y()  {return m_y.data();}
+    double* z()  {return m_z.data();}
+    double* vx() {return m_vx.data();}
+    double* vy() {return m_vy.data();}
+    double* vz() {return m_vz.data();}
+
+    // drops the accelerations velocity Verlet carries between steps.
+    void invalidate() {m_is_accelerated = false;}
+
+    // ----- integration -----
+
+    const integrator& method() const             {return m_integrator;}
+    void              method(const integrator& an_integrator);
+
+    const double& time() const          {return m_time;}
+    void          time(const double& a_time);
+
+    void addForce(const force& a_force);
+    void clearForces();
+
+    const size_t& threads() const           {return m_threads;}
+    void          threads(const size_t& a_threads) {m_threads = a_threads;} // 0 is hardwareThreads()
+
+    void step(const double& a_dt);
+    void run(const double& a_dt, const size_t& a_steps);
+
+    // ----- trajectories -----
+
+    // pushes the position of an_index to a_recorder now and after
+    // every step. The recorder must outlive the system or be removed
+    // with unrecord().
+    void record(const size_t& an_index, CartesianRecorder& a_recorder);
+    void unrecord(const CartesianRecorder& a_recorder);
+
+    // ----- diagnostics -----
+
+    // momentum() and centerOfMass() are the sums of reduce.h, the
+    // same for any threads().
+    double    kineticEnergy() const;
+    Cartesian momentum() const;
+    Cartesian centerOfMass() const; // throws Error for no mass
+
+  private:
+
+    void accelerate(const state& a_state); // sums the forces into m_ax, m_ay, m_az
+    state current() const;
+
+    // the integrator loops over [a_begin, a_end)
+    void drift(const double& a_dt, const size_t& a_begin, const size_t& a_end);
+    void kick(const double& a_dt, const size_t& a_begin, const size_t& a_end);
+
+    void stepLeapfrog(const double& a_dt);
+    void stepVelocityVerlet(const double& a_dt);
+    void stepRK4(const double& a_dt);
+
+    std::vector<double> m_x, m_y, m_z;
+    std::vector<double> m_vx, m_vy, m_vz;
+    std::vector<double> m_mass;
+
+    std::vector<double> m_ax, m_ay, m_az; // accelerations of the last evaluation
+    std::vector<double> m_scratch;        // RK4 stage state and sums, 12*size()
+
+    integrator         m_integrator;
+    double             m_time;
+    bool               m_is_accelerated; // m_ax etc. are for the current state
+    size_t             m_threads;
+    std::vector<force> m_forces;
+
+    std::vector<std::pair<size_t, CartesianRecorder*> > m_recorders;
+
+  };
+
+} // end namespace Coords
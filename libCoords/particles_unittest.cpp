@@ -0,0 +1,289 @@
+// ================================================================
+// Filename:    particles_unittest.cpp
+// Description: This is the gtest unittest of the particle system
+//              integrators.
+//
+// Author:      L.R. McFarland, lrm@starbug.com
+// Created:     2026 Oct 18
+// Language:    C++
+//
+// See also: http://code.google.com/p/googletest/wiki/Primer
+//
+//  Coordinates is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  Coordinates is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with Coordinates.  If not, see <http://www.gnu.org/licenses/>.
+// ================================================================
+
+#include <atomic>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <angle.h>
+#include <Cartesian.h>
+#include <particles.h>
+
+
+namespace {
+
+  // a = -k*r on every particle, energy m*(v^2 + k*r^2)/2.
+  Coords::ParticleSystem::force spring(const double& a_k) {
+    return [a_k] (const Coords::ParticleSystem::state& a_state, double* an_ax, double* an_ay, double* an_az) {
+      for (size_t i = 0; i < a_state.m_size; ++i) {
+	an_ax[i] -= a_k*a_state.m_x[i];
+	an_ay[i] -= a_k*a_state.m_y[i];
+	an_az[i] -= a_k*a_state.m_z[i];
+      }
+    };
+  }
+
+  double springEnergy(const Coords::ParticleSystem& a_system, const double& a_k) {
+    double energy(a_system.kineticEnergy());
+    for (size_t i = 0; i < a_system.size(); ++i)
+      energy += a_system.mass(i)*a_k*a_system.position(i).magnitude2()/2;
+    return energy;
+  }
+
+  // position error after a quarter period of a unit spring, where it
+  // is proportional to the phase error.
+  double quarterError(const Coords::ParticleSystem::integrator& an_integrator, const size_t& a_steps) {
+    Coords::ParticleSystem a_system(an_integrator);
+    a_system.add(Coords::Cartesian::Ux, Coords::Cartesian::Uo, 1);
+    a_system.addForce(spring(1));
+    a_system.run(M_PI/2/a_steps, a_steps);
+    return a_system.position(0).magnitude();
+  }
+
+  // -------------------------
+  // ----- parallel loop -----
+  // -------------------------
+
+  TEST(ParallelFor, CoversEveryIndexOnce) {
+    const size_t a_size(100003);
+    std::vector<int> counts(a_size, 0);
+    Coords::parallelFor(a_size, [&counts] (const size_t& a_begin, const size_t& a_end) {
+	for (size_t i = a_begin; i < a_end; ++i)
+	  ++counts[i];
+      }, 4, 1000);
+    for (size_t i = 0; i < a_size; ++i)
+      ASSERT_EQ(1, counts[i]);
+  }
+
+  TEST(ParallelFor, SerialBelowGrain) {
+    std::atomic<int> calls(0);
+    Coords::parallelFor(100, [&calls] (const size_t& a_begin, const size_t& a_end) {
+	EXPECT_EQ(0u, a_begin);
+	EXPECT_EQ(100u, a_end);
+	++calls;
+      }, 4, 1000);
+    EXPECT_EQ(1, calls);
+  }
+
+  TEST(ParallelFor, RethrowsAfterJoin) {
+    std::atomic<int> calls(0);
+    EXPECT_THROW(Coords::parallelFor(8000, [&calls] (const size_t& a_begin, const size_t&) {
+	  ++calls;
+	  if (a_begin > 0)
+	    throw std::runtime_error("chunk failed");
+	}, 4, 1000), std::runtime_error);
+    EXPECT_EQ(4, calls);
+  }
+
+  // ---------------------------
+  // ----- particle system -----
+  // ---------------------------
+
+  TEST(FixedParticles, AddAndAccess) {
+    Coords::ParticleSystem a_system;
+    EXPECT_EQ(0u, a_system.size());
+    EXPECT_EQ(Coords::ParticleSystem::velocity_verlet, a_system.method());
+
+    EXPECT_EQ(0u, a_system.add(Coords::Cartesian(1, 2, 3), Coords::Cartesian(4, 5, 6), 2));
+    EXPECT_EQ(1u, a_system.add(Coords::Cartesian(-1, -2, -3), Coords::Cartesian(-4, -5, -6), 3));
+    EXPECT_EQ(2u, a_system.size());
+
+    EXPECT_EQ(Coords::Cartesian(1, 2, 3), a_system.position(0));
+    EXPECT_EQ(Coords::Cartesian(-4, -5, -6), a_system.velocity(1));
+    EXPECT_EQ(3, a_system.mass(1));
+    EXPECT_EQ(-2, a_system.y()[1]);
+    EXPECT_EQ(6, a_system.vz()[0]);
+
+    a_system.position(1, Coords::Cartesian(7, 8, 9));
+    EXPECT_EQ(7, a_system.x()[1]);
+
+    EXPECT_EQ(Coords::Cartesian(2*4 - 3*4, 2*5 - 3*5, 2*6 - 3*6), a_system.momentum());
+    EXPECT_DOUBLE_EQ((2*77 + 3*77)/2.0, a_system.kineticEnergy());
+    EXPECT_EQ(Coords::Cartesian(23/5.0, 28/5.0, 33/5.0), a_system.centerOfMass());
+
+    a_system.clear();
+    EXPECT_EQ(0u, a_system.size());
+    EXPECT_THROW(a_system.centerOfMass(), Coords::Error);
+  }
+
+  TEST(FixedParticles, Errors) {
+    Coords::ParticleSystem a_system;
+    EXPECT_THROW(a_system.add(Coords::Cartesian::Uo, Coords::Cartesian::Uo, -1), Coords::Error);
+    a_system.add(Coords::Cartesian::Uo, Coords::Cartesian::Uo, 0);
+    EXPECT_THROW(a_system.mass(0, -1), Coords::Error);
+
+    Coords::CartesianRecorder a_recorder;
+    EXPECT_THROW(a_system.record(1, a_recorder), Coords::Error);
+  }
+
+  TEST(FixedParticles, UniformFieldIsExact) {
+    // constant acceleration is integrated exactly by all of them
+    const Coords::Cartesian g(0, 0, -9.8);
+    const Coords::Cartesian r0(1, 2, 3);
+    const Coords::Cartesian v0(4, 5, 6);
+    const Coords::ParticleSystem::integrator methods[] = {Coords::ParticleSystem::leapfrog,
+							   Coords::ParticleSystem::velocity_verlet,
+							   Coords::ParticleSystem::rk4};
+    for (size_t k = 0; k < 3; ++k) {
+      Coords::ParticleSystem a_system(methods[k]);
+      a_system.add(r0, v0, 1);
+      a_system.addForce(Coords::ParticleSystem::uniformField(g));
+      a_system.run(0.01, 100);
+      EXPECT_NEAR(1, a_system.time(), 1e-12);
+      EXPECT_NEAR(0, (a_system.position(0) - (r0 + v0 + g*0.5)).magnitude(), 1e-12) << "method " << k;
+      EXPECT_NEAR(0, (a_system.velocity(0) - (v0 + g)).magnitude(), 1e-12) << "method " << k;
+    }
+  }
+
+  TEST(FixedParticles, ForcesAdd) {
+    Coords::ParticleSystem a_system;
+    a_system.add(Coords::Cartesian::Uo, Coords::Cartesian::Uo, 1);
+    a_system.addForce(Coords::ParticleSystem::uniformField(Coords::Cartesian::Ux));
+    a_system.addForce(Coords::ParticleSystem::uniformField(Coords::Cartesian::Uy));
+    a_system.step(1);
+    EXPECT_TRUE(a_system.velocity(0) == Coords::Cartesian(1, 1, 0));
+
+    a_system.clearForces();
+    a_system.step(1);
+    EXPECT_TRUE(a_system.velocity(0) == Coords::Cartesian(1, 1, 0));
+  }
+
+  TEST(FixedParticles, SymplecticEnergyIsBounded) {
+    // a thousand periods at 20 steps a period
+    const Coords::ParticleSystem::integrator methods[] = {Coords::ParticleSystem::leapfrog,
+							   Coords::ParticleSystem::velocity_verlet};
+    for (size_t k = 0; k < 2; ++k) {
+      Coords::ParticleSystem a_system(methods[k]);
+      a_system.add(Coords::Cartesian(1, 0, 0), Coords::Cartesian(0, 1, 0), 1);
+      a_system.add(Coords::Cartesian(0, 2, 1), Coords::Cartesian(0.5, 0, 0), 2);
+      a_system.addForce(spring(1));
+      const double energy(springEnergy(a_system, 1));
+      double first(0), last(0); // worst relative error of the first and last fifty periods
+      for (size_t n = 0; n < 20000; ++n) {
+	a_system.step(2*M_PI/20);
+	const double error(std::fabs(springEnergy(a_system, 1) - energy)/energy);
+	if (n < 1000)
+	  first = std::max(first, error);
+	if (n >= 19000)
+	  last = std::max(last, error);
+      }
+      EXPECT_LT(first, 0.03) << "method " << k;
+      EXPECT_LT(last, 1.01*first) << "method " << k; // no drift
+    }
+  }
+
+  TEST(FixedParticles, OrderOfAccuracy) {
+    // halving the step divides the error by 2^order
+    const double leapfrog(quarterError(Coords::ParticleSystem::leapfrog, 100)/quarterError(Coords::ParticleSystem::leapfrog, 200));
+    const double verlet(quarterError(Coords::ParticleSystem::velocity_verlet, 100)/quarterError(Coords::ParticleSystem::velocity_verlet, 200));
+    const double rk4(quarterError(Coords::ParticleSystem::rk4, 100)/quarterError(Coords::ParticleSystem::rk4, 200));
+    EXPECT_NEAR(4, leapfrog, 0.2);
+    EXPECT_NEAR(4, verlet, 0.2);
+    EXPECT_NEAR(16, rk4, 1);
+    EXPECT_LT(quarterError(Coords::ParticleSystem::rk4, 100), 1e-7);
+  }
+
+  TEST(FixedParticles, Record) {
+    Coords::ParticleSystem a_system;
+    a_system.add(Coords::Cartesian::Uo, Coords::Cartesian::Ux, 1);
+    a_system.add(Coords::Cartesian::Uo, Coords::Cartesian::Uy, 1);
+
+    Coords::CartesianRecorder first, second;
+    first.clear();
+    second.clear();
+    a_system.record(0, first);
+    a_system.record(1, second);
+    a_system.run(0.5, 4);
+
+    ASSERT_EQ(5u, first.size());
+    ASSERT_EQ(5u, second.size());
+    for (unsigned int k = 0; k < 5; ++k) {
+      EXPECT_TRUE(first.get(k) == Coords::Cartesian::Ux*(0.5*k));
+      EXPECT_TRUE(second.get(k) == Coords::Cartesian::Uy*(0.5*k));
+    }
+
+    a_system.unrecord(first);
+    a_system.step(0.5);
+    EXPECT_EQ(5u, first.size());
+    EXPECT_EQ(6u, second.size());
+  }
+
+  // ------------------------------
+  // ----- random particles -----
+  // ------------------------------
+
+  class RandomParticles : public ::testing::Test {
+  protected:
+
+    // enough for several threads at the default grain
+    enum {s_size = 100000};
+
+    virtual void SetUp() {
+      std::mt19937 generator(12345);
+      std::uniform_real_distribution<double> uniform(-10, 10);
+      for (size_t i = 0; i < s_size; ++i) {
+	const Coords::Cartesian r(uniform(generator), uniform(generator), uniform(generator));
+	const Coords::Cartesian v(uniform(generator), uniform(generator), uniform(generator));
+	m_serial.add(r, v, 1 + uniform(generator)/20);
+      }
+      m_serial.addForce(spring(2));
+      m_serial.addForce(Coords::ParticleSystem::uniformField(Coords::Cartesian(0, 0, -1)));
+      m_serial.threads(1);
+    }
+
+    Coords::ParticleSystem m_serial;
+  };
+
+  TEST_F(RandomParticles, ThreadsMatchSerial) {
+    const Coords::ParticleSystem::integrator methods[] = {Coords::ParticleSystem::leapfrog,
+							   Coords::ParticleSystem::velocity_verlet,
+							   Coords::ParticleSystem::rk4};
+    for (size_t k = 0; k < 3; ++k) {
+      Coords::ParticleSystem serial(m_serial);
+      serial.method(methods[k]);
+      Coords::ParticleSystem parallel(serial);
+      parallel.threads(4);
+
+      serial.run(0.01, 10);
+      parallel.run(0.01, 10);
+
+      // the same arithmetic per particle, so bit for bit
+      for (size_t i = 0; i < serial.size(); ++i) {
+	ASSERT_EQ(serial.x()[i], parallel.x()[i]);
+	ASSERT_EQ(serial.vy()[i], parallel.vy()[i]);
+	ASSERT_EQ(serial.z()[i], parallel.z()[i]);
+      }
+    }
+  }
+
+} // end anonymous namespace
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
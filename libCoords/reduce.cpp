@@ -0,0 +1,291 @@
+// ==================================================================
+// Filename:    reduce.cpp
+//
+// Description: Implements the reproducible parallel reductions.
+//
+// Author:      L.R. McFarland
+// Created:     2026 Oct 18
+// Language:    C++
+//
+//  Coordinates is free software: you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License as
+//  published by the Free Software Foundation, either version 3 of the
+//  License, or (at your option) any later version.
+//
+//  Coordinates is distributed in the hope that it will be useful, but
+//  WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with Coordinates.  If not, see <http://www.gnu.org/licenses/>.
+// ==================================================================
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include <reduce.h>
+#include <utils.h>
+
+namespace {
+
+  // The block size fixes the order of the additions, changing it
+  // changes the results in the last bits.
+  const size_t s_block(4096);
+  const size_t s_leaf(64); // four lanes of 16 terms
+
+  // ----- layouts -----
+
+  struct vectors {
+    const Coords::Cartesian* m_vectors;
+    double x(const size_t& i) const {return m_vectors[i].x();}
+    double y(const size_t& i) const {return m_vectors[i].y();}
+    double z(const size_t& i) const {return m_vectors[i].z();}
+  };
+
+  struct arrays {
+    const double* m_x;
+    const double* m_y;
+    const double* m_z;
+    double x(const size_t& i) const {return m_x[i];}
+    double y(const size_t& i) const {return m_y[i];}
+    double z(const size_t& i) const {return m_z[i];}
+  };
+
+  // ----- sums -----
+
+  // a_sum[0..N) is the sum of some_terms(i, t) over [a_begin, an_end)
+  template <size_t N, typename Terms>
+  void pairwise(const Terms& some_terms, const size_t& a_begin, const size_t& an_end, double a_sum[N]) {
+    if (an_end - a_begin <= s_leaf) {
+      double lane[4][N];
+      for (size_t k = 0; k < N; ++k)
+	lane[0][k] = lane[1][k] = lane[2][k] = lane[3][k] = 0;
+      size_t i(a_begin);
+      for (; i + 4 <= an_end; i += 4)
+	for (size_t l = 0; l < 4; ++l) {
+	  double t[N];
+	  some_terms(i + l, t);
+	  for (size_t k = 0; k < N; ++k)
+	    lane[l][k] += t[k];
+	}
+      for (; i < an_end; ++i) {
+	double t[N];
+	some_terms(i, t);
+	for (size_t k = 0; k < N; ++k)
+	  lane[0][k] += t[k];
+      }
+      for (size_t k = 0; k < N; ++k)
+	a_sum[k] = (lane[0][k] + lane[1][k]) + (lane[2][k] + lane[3][k]);
+      return;
+    }
+    const size_t middle(a_begin + (an_end - a_begin)/2);
+    double right[N];
+    pairwise<N>(some_terms, a_begin, middle, a_sum);
+    pairwise<N>(some_terms, middle, an_end, right);
+    for (size_t k = 0; k < N; ++k)
+      a_sum[k] += right[k];
+  }
+
+  // the blocks in parallel, then their sums
+  template <size_t N, typename Terms>
+  void reduce(const Terms& some_terms, const size_t& a_size, const size_t& a_threads, double a_sum[N]) {
+    const size_t blocks((a_size + s_block - 1)/s_block);
+    if (blocks <= 1) {
+      pairwise<N>(some_terms, 0, a_size, a_sum);
+      return;
+    }
+    std::vector<double> partial(N*blocks);
+    Coords::parallelFor(blocks, [&] (const size_t& a_begin, const size_t& an_end) {
+	for (size_t b = a_begin; b < an_end; ++b)
+	  pairwise<N>(some_terms, b*s_block, std::min(a_size, (b + 1)*s_block), &partial[N*b]);
+      }, a_threads, 1);
+    pairwise<N>([&partial] (const size_t& i, double t[N]) {
+	for (size_t k = 0; k < N; ++k)
+	  t[k] = partial[N*i + k];
+      }, 0, blocks, a_sum);
+  }
+
+  template <typename Layout>
+  Coords::Cartesian weighted(const Layout& a_layout, const double* some_weights,
+			     const size_t& a_size, const size_t& a_threads) {
+    double s[3];
+    if (some_weights)
+      reduce<3>([&] (const size_t& i, double t[3]) {
+	  const double w(some_weights[i]);
+	  t[0] = w*a_layout.x(i);
+	  t[1] = w*a_layout.y(i);
+	  t[2] = w*a_layout.z(i);
+	}, a_size, a_threads, s);
+    else
+      reduce<3>([&] (const size_t& i, double t[3]) {
+	  t[0] = a_layout.x(i);
+	  t[1] = a_layout.y(i);
+	  t[2] = a_layout.z(i);
+	}, a_size, a_threads, s);
+    return Coords::Cartesian(s[0], s[1], s[2]);
+  }
+
+  double totalWeight(const double* some_weights, const size_t& a_size, const size_t& a_threads) {
+    const double total(some_weights ? Coords::sum(some_weights, a_size, a_threads) : double(a_size));
+    if (total == 0)
+      throw Coords::Error("the weights of a mean must not sum to zero");
+    return total;
+  }
+
+  template <typename Layout>
+  Coords::Cartesian average(const Layout& a_layout, const double* some_weights,
+			    const size_t& a_size, const size_t& a_threads) {
+    const double total(totalWeight(some_weights, a_size, a_threads));
+    return weighted(a_layout, some_weights, a_size, a_threads)/total;
+  }
+
+  template <typename Layout>
+  void box(const Layout& a_layout, const size_t& a_size,
+	   Coords::Cartesian& a_lower, Coords::Cartesian& an_upper, const size_t& a_threads) {
+    if (a_size == 0)
+      throw Coords::Error("the bounds of no vectors");
+    const size_t blocks((a_size + s_block - 1)/s_block);
+    std::vector<double> partial(6*blocks);
+    Coords::parallelFor(blocks, [&] (const size_t& a_begin, const size_t& an_end) {
+	for (size_t b = a_begin; b < an_end; ++b) {
+	  double lx(std::numeric_limits<double>::infinity()), ly(lx), lz(lx);
+	  double ux(-lx), uy(-lx), uz(-lx);
+	  for (size_t i = b*s_block; i < std::min(a_size, (b + 1)*s_block); ++i) {
+	    const double x(a_layout.x(i)), y(a_layout.y(i)), z(a_layout.z(i));
+	    // false for NaN
+	    lx = x < lx ? x : lx;
+	    ly = y < ly ? y : ly;
+	    lz = z < lz ? z : lz;
+	    ux = x > ux ? x : ux;
+	    uy = y > uy ? y : uy;
+	    uz = z > uz ? z : uz;
+	  }
+	  double* p(&partial[6*b]);
+	  p[0] = lx; p[1] = ly; p[2] = lz;
+	  p[3] = ux; p[4] = uy; p[5] = uz;
+	}
+      }, a_threads, 1);
+    double l[3] = {partial[0], partial[1], partial[2]};
+    double u[3] = {partial[3], partial[4], partial[5]};
+    for (size_t b = 1; b < blocks; ++b)
+      for (size_t k = 0; k < 3; ++k) {
+	l[k] = std::min(l[k], partial[6*b + k]);
+	u[k] = std::max(u[k], partial[6*b + 3 + k]);
+      }
+    a_lower = Coords::Cartesian(l[0], l[1], l[2]);
+    an_upper = Coords::Cartesian(u[0], u[1], u[2]);
+  }
+
+  template <typename Layout>
+  void spread(const Layout& a_layout, const double* some_weights, const size_t& a_size,
+	      double a_covariance[3][3], const size_t& a_threads) {
+    const double total(totalWeight(some_weights, a_size, a_threads));
+    const Coords::Cartesian m(weighted(a_layout, some_weights, a_size, a_threads)/total);
+    const double mx(m.x()), my(m.y()), mz(m.z());
+    double s[6];
+    reduce<6>([&] (const size_t& i, double t[6]) {
+	const double w(some_weights ? some_weights[i] : 1);
+	const double dx(a_layout.x(i) - mx), dy(a_layout.y(i) - my), dz(a_layout.z(i) - mz);
+	t[0] = w*dx*dx;
+	t[1] = w*dx*dy;
+	t[2] = w*dx*dz;
+	t[3] = w*dy*dy;
+	t[4] = w*dy*dz;
+	t[5] = w*dz*dz;
+      }, a_size, a_threads, s);
+    a_covariance[0][0] = s[0]/total;
+    a_covariance[0][1] = a_covariance[1][0] = s[1]/total;
+    a_covariance[0][2] = a_covariance[2][0] = s[2]/total;
+    a_covariance[1][1] = s[3]/total;
+    a_covariance[1][2] = a_covariance[2][1] = s[4]/total;
+    a_covariance[2][2] = s[5]/total;
+  }
+
+} // end anonymous namespace
+
+
+// ----------------
+// ----- sums -----
+// ----------------
+
+double Coords::sum(const double* some_values, const size_t& a_size, const size_t& a_threads) {
+  double s[1];
+  reduce<1>([some_values] (const size_t& i, double t[1]) {t[0] = some_values[i];}, a_size, a_threads, s);
+  return s[0];
+}
+
+Coords::Cartesian Coords::sum(const Cartesian* some_vectors, const size_t& a_size, const size_t& a_threads) {
+  const vectors a_layout = {some_vectors};
+  return weighted(a_layout, 0, a_size, a_threads);
+}
+
+Coords::Cartesian Coords::sum(const double* x, const double* y, const double* z,
+			      const size_t& a_size, const size_t& a_threads) {
+  const arrays a_layout = {x, y, z};
+  return weighted(a_layout, 0, a_size, a_threads);
+}
+
+Coords::Cartesian Coords::weightedSum(const Cartesian* some_vectors, const double* some_weights,
+				      const size_t& a_size, const size_t& a_threads) {
+  const vectors a_layout = {some_vectors};
+  return weighted(a_layout, some_weights, a_size, a_threads);
+}
+
+Coords::Cartesian Coords::weightedSum(const double* x, const double* y, const double* z, const double* some_weights,
+				      const size_t& a_size, const size_t& a_threads) {
+  const arrays a_layout = {x, y, z};
+  return weighted(a_layout, some_weights, a_size, a_threads);
+}
+
+
+// -----------------
+// ----- means -----
+// -----------------
+
+Coords::Cartesian Coords::mean(const Cartesian* some_vectors, const double* some_weights,
+			       const size_t& a_size, const size_t& a_threads) {
+  const vectors a_layout = {some_vectors};
+  return average(a_layout, some_weights, a_size, a_threads);
+}
+
+Coords::Cartesian Coords::mean(const double* x, const double* y, const double* z, const double* some_weights,
+			       const size_t& a_size, const size_t& a_threads) {
+  const arrays a_layout = {x, y, z};
+  return average(a_layout, some_weights, a_size, a_threads);
+}
+
+
+// ------------------
+// ----- bounds -----
+// ------------------
+
+void Coords::bounds(const Cartesian* some_vectors, const size_t& a_size,
+		    Cartesian& a_lower, Cartesian& an_upper, const size_t& a_threads) {
+  const vectors a_layout = {some_vectors};
+  box(a_layout, a_size, a_lower, an_upper, a_threads);
+}
+
+void Coords::bounds(const double* x, const double* y, const double* z, const size_t& a_size,
+		    Cartesian& a_lower, Cartesian& an_upper, const size_t& a_threads) {
+  const arrays a_layout = {x, y, z};
+  box(a_layout, a_size, a_lower, an_upper, a_threads);
+}
+
+
+// -----------------------
+// ----- covariances -----
+// -----------------------
+
+void Coords::covariance(const Cartesian* some_vectors, const double* some_weights, const size_t& a_size,
+			double a_covariance[3][3], const size_t& a_threads) {
+  const vectors a_layout = {some_vectors};
+  spread(a_layout, some_weights, a_size, a_covariance, a_threads);
+}
+
+void Coords::covariance(const double* x, const double* y, const double* z, const double* some_weights,
+			const size_t& a_size, double a_covariance[3][3], const size_t& a_threads) {
+  const arrays a_layout = {x, y, z};
+  spread(a_layout, some_weights, a_size, a_covariance, a_threads);
+}
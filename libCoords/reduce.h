@@ -0,0 +1,84 @@
+// ================================================================
+// Filename:    reduce.h
+//
+// Description: This defines reproducible parallel sums, means,
+//              bounds and covariances of Cartesian arrays.
+//
+// Author:      L.R. McFarland
+// Created:     2026 Oct 18
+// Language:    C++
+//
+//  Coords is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  Coords is distributed in the hope that it will be useful, but
+//  WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with Coords.  If not, see <http://www.gnu.org/licenses/>.
+// ================================================================
+
+#pragma once
+
+#include <cstddef>
+
+#include <angle.h>
+#include <Cartesian.h>
+#include <parallel.h>
+
+namespace Coords {
+
+  // ----- reductions -----
+
+  // A loop of += gives a different answer for every order the terms
+  // are added in, so the sum of a threaded loop depends on the
+  // threads. These split the array in fixed blocks of 4096 elements,
+  // sum each block pairwise, with four lanes of 16 terms at the
+  // leaves, and then sum the blocks' sums pairwise. The order depends
+  // only on the size, so the result is bitwise the same for any
+  // a_threads, and the rounding error grows with log(size), not size
+  // as for a running sum. The blocks are spread over the threads with
+  // parallelFor(), a_threads 0 is hardwareThreads().
+  //
+  // Arrays are either Cartesians or separate x, y, z arrays, as in
+  // ParticleSystem. some_weights, e.g. masses, may be 0 for all
+  // weights 1.
+
+  double    sum(const double* some_values, const size_t& a_size, const size_t& a_threads=0);
+
+  Cartesian sum(const Cartesian* some_vectors, const size_t& a_size, const size_t& a_threads=0);
+  Cartesian sum(const double* x, const double* y, const double* z, const size_t& a_size, const size_t& a_threads=0);
+
+  // sum of w v, e.g. momentum from masses and velocities
+  Cartesian weightedSum(const Cartesian* some_vectors, const double* some_weights,
+			const size_t& a_size, const size_t& a_threads=0);
+  Cartesian weightedSum(const double* x, const double* y, const double* z, const double* some_weights,
+			const size_t& a_size, const size_t& a_threads=0);
+
+  // sum of w v over the sum of w, e.g. the center of mass. Throws
+  // Error if the weights sum to zero.
+  Cartesian mean(const Cartesian* some_vectors, const double* some_weights,
+		 const size_t& a_size, const size_t& a_threads=0);
+  Cartesian mean(const double* x, const double* y, const double* z, const double* some_weights,
+		 const size_t& a_size, const size_t& a_threads=0);
+
+  // the smallest box holding the vectors, NaNs skipped. Exact, min
+  // and max do not round. Throws Error for a_size 0.
+  void bounds(const Cartesian* some_vectors, const size_t& a_size,
+	      Cartesian& a_lower, Cartesian& an_upper, const size_t& a_threads=0);
+  void bounds(const double* x, const double* y, const double* z, const size_t& a_size,
+	      Cartesian& a_lower, Cartesian& an_upper, const size_t& a_threads=0);
+
+  // the weighted covariance about the mean, sum of w (v - m)(v - m)^T
+  // over the sum of w, from a second pass over the differences so it
+  // does not cancel for vectors far from the origin. Throws as mean().
+  void covariance(const Cartesian* some_vectors, const double* some_weights, const size_t& a_size,
+		  double a_covariance[3][3], const size_t& a_threads=0);
+  void covariance(const double* x, const double* y, const double* z, const double* some_weights,
+		  const size_t& a_size, double a_covariance[3][3], const size_t& a_threads=0);
+
+} // end namespace Coords
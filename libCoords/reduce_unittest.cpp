@@ -0,0 +1,185 @@
+// ================================================================
+// Filename:    reduce_unittest.cpp
+// Description: This is the gtest unittest of the reproducible
+//              reductions.
+//
+// Author:      L.R. McFarland, lrm@starbug.com
+// Created:     2026 Oct 18
+// Language:    C++
+//
+// See also: http://code.google.com/p/googletest/wiki/Primer
+//
+//  Coordinates is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  Coordinates is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with Coordinates.  If not, see <http://www.gnu.org/licenses/>.
+// ================================================================
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <angle.h>
+#include <Cartesian.h>
+#include <reduce.h>
+
+
+namespace {
+
+  // ----------------------------
+  // ----- fixed reductions -----
+  // ----------------------------
+
+  TEST(FixedReduce, Small) {
+    const Coords::Cartesian some_vectors[] = {Coords::Cartesian(1, 2, 3), Coords::Cartesian(-1, 0, 5),
+					      Coords::Cartesian(4, -2, 1), Coords::Cartesian(0, 4, -1)};
+    const double some_weights[] = {1, 2, 3, 2};
+
+    EXPECT_EQ(Coords::Cartesian(4, 4, 8), Coords::sum(some_vectors, 4));
+    EXPECT_EQ(Coords::Cartesian(11, 4, 14), Coords::weightedSum(some_vectors, some_weights, 4));
+    EXPECT_EQ(Coords::Cartesian(1, 1, 2), Coords::mean(some_vectors, 0, 4));
+    EXPECT_EQ(Coords::Cartesian(11/8.0, 0.5, 14/8.0), Coords::mean(some_vectors, some_weights, 4));
+    EXPECT_EQ(8, Coords::sum(some_weights, 4));
+    EXPECT_EQ(Coords::Cartesian(0, 0, 0), Coords::sum(some_vectors, 0));
+
+    Coords::Cartesian lower, upper;
+    Coords::bounds(some_vectors, 4, lower, upper);
+    EXPECT_EQ(Coords::Cartesian(-1, -2, -1), lower);
+    EXPECT_EQ(Coords::Cartesian(4, 4, 5), upper);
+
+    // about the mean (1, 1, 2), the differences are (0, 1, 1),
+    // (-2, -1, 3), (3, -3, -1) and (-1, 3, -3)
+    double c[3][3];
+    Coords::covariance(some_vectors, 0, 4, c);
+    EXPECT_DOUBLE_EQ(14/4.0, c[0][0]);
+    EXPECT_DOUBLE_EQ(20/4.0, c[1][1]);
+    EXPECT_DOUBLE_EQ(20/4.0, c[2][2]);
+    EXPECT_DOUBLE_EQ(-10/4.0, c[0][1]);
+    EXPECT_DOUBLE_EQ(-10/4.0, c[1][0]);
+    EXPECT_DOUBLE_EQ(-6/4.0, c[0][2]);
+    EXPECT_DOUBLE_EQ(-8/4.0, c[1][2]);
+    EXPECT_EQ(c[1][2], c[2][1]);
+  }
+
+  TEST(FixedReduce, NaNs) {
+    const double nan(std::numeric_limits<double>::quiet_NaN());
+    const double x[] = {nan, 1, 2}, y[] = {3, nan, -1}, z[] = {0, 0, nan};
+    Coords::Cartesian lower, upper;
+    Coords::bounds(x, y, z, 3, lower, upper);
+    EXPECT_EQ(Coords::Cartesian(1, -1, 0), lower);
+    EXPECT_EQ(Coords::Cartesian(2, 3, 0), upper);
+    EXPECT_TRUE(std::isnan(Coords::sum(x, y, z, 3).x()));
+  }
+
+  TEST(FixedReduce, Errors) {
+    const Coords::Cartesian some_vectors[] = {Coords::Cartesian(1, 2, 3), Coords::Cartesian(-1, 0, 5)};
+    const double some_weights[] = {1, -1};
+    Coords::Cartesian lower, upper;
+    double c[3][3];
+    EXPECT_THROW(Coords::bounds(some_vectors, 0, lower, upper), Coords::Error);
+    EXPECT_THROW(Coords::mean(some_vectors, 0, 0), Coords::Error);
+    EXPECT_THROW(Coords::mean(some_vectors, some_weights, 2), Coords::Error);
+    EXPECT_THROW(Coords::covariance(some_vectors, some_weights, 2, c), Coords::Error);
+  }
+
+  // --------------------------
+  // ----- random vectors -----
+  // --------------------------
+
+  class RandomReduce : public ::testing::Test {
+  protected:
+
+    enum {s_size = 100003}; // not a whole number of blocks
+
+    virtual void SetUp() {
+      std::mt19937 generator(12345);
+      std::uniform_real_distribution<double> uniform(-1, 1);
+      std::exponential_distribution<double> spread(1);
+      for (size_t i = 0; i < s_size; ++i) {
+	// terms of very different sizes, so the order of the sum matters
+	const double scale(std::exp(10*uniform(generator)));
+	x.push_back(scale*uniform(generator));
+	y.push_back(scale*uniform(generator) + 1e6);
+	z.push_back(uniform(generator));
+	vectors.push_back(Coords::Cartesian(x.back(), y.back(), z.back()));
+	weights.push_back(spread(generator));
+      }
+    }
+
+    std::vector<double> x, y, z, weights;
+    std::vector<Coords::Cartesian> vectors;
+
+  };
+
+  TEST_F(RandomReduce, ThreadsMatchSerial) {
+    const Coords::Cartesian a_sum(Coords::sum(x.data(), y.data(), z.data(), s_size, 1));
+    const Coords::Cartesian a_weighted_sum(Coords::weightedSum(x.data(), y.data(), z.data(), weights.data(), s_size, 1));
+    const Coords::Cartesian a_mean(Coords::mean(x.data(), y.data(), z.data(), weights.data(), s_size, 1));
+    double a_covariance[3][3];
+    Coords::covariance(x.data(), y.data(), z.data(), weights.data(), s_size, a_covariance, 1);
+    Coords::Cartesian a_lower, an_upper;
+    Coords::bounds(x.data(), y.data(), z.data(), s_size, a_lower, an_upper, 1);
+
+    for (size_t threads : {2, 3, 4, 7, 0}) {
+      // the same order of additions, so bitwise equal in either layout
+      EXPECT_EQ(a_sum, Coords::sum(x.data(), y.data(), z.data(), s_size, threads)) << threads;
+      EXPECT_EQ(a_sum, Coords::sum(vectors.data(), s_size, threads)) << threads;
+      EXPECT_EQ(a_weighted_sum, Coords::weightedSum(vectors.data(), weights.data(), s_size, threads)) << threads;
+      EXPECT_EQ(a_mean, Coords::mean(vectors.data(), weights.data(), s_size, threads)) << threads;
+      double c[3][3];
+      Coords::covariance(vectors.data(), weights.data(), s_size, c, threads);
+      for (int i = 0; i < 3; ++i)
+	for (int j = 0; j < 3; ++j)
+	  EXPECT_EQ(a_covariance[i][j], c[i][j]) << threads;
+      Coords::Cartesian lower, upper;
+      Coords::bounds(vectors.data(), s_size, lower, upper, threads);
+      EXPECT_EQ(a_lower, lower);
+      EXPECT_EQ(an_upper, upper);
+    }
+  }
+
+  TEST_F(RandomReduce, Accuracy) {
+    // a compensated long double sum as the reference
+    long double reference(0), compensation(0), magnitude(0);
+    for (size_t i = 0; i < s_size; ++i) {
+      const long double t(x[i] - compensation);
+      const long double s(reference + t);
+      compensation = (s - reference) - t;
+      reference = s;
+      magnitude += std::fabs(x[i]);
+    }
+    EXPECT_LT(std::fabs(Coords::sum(x.data(), s_size) - double(reference)), 1e-15*double(magnitude));
+
+    // a running sum of 10^7 tenths is off by 1.6e-4
+    const std::vector<double> tenths(10000000, 0.1);
+    EXPECT_NEAR(1e6, Coords::sum(tenths.data(), tenths.size()), 1e-8);
+
+    // shifting the vectors does not change the covariance
+    std::vector<double> shifted(x);
+    for (size_t i = 0; i < s_size; ++i)
+      shifted[i] += 1e8;
+    double a[3][3], b[3][3];
+    Coords::covariance(x.data(), y.data(), z.data(), 0, s_size, a);
+    Coords::covariance(shifted.data(), y.data(), z.data(), 0, s_size, b);
+    for (int i = 0; i < 3; ++i)
+      for (int j = 0; j < 3; ++j)
+	EXPECT_NEAR(a[i][j], b[i][j], 1e-9*std::sqrt(a[i][i]*a[j][j])) << i << " " << j;
+  }
+
+} // end anonymous namespace
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -25,6 +25,7 @@
 #include <angle.h>
 #include <Cartesian.h>
 #include <spherical.h>
+#include <spherical_inl.h>
 
 // -----------------------
 // ----- class space -----
@@ -49,32 +50,6 @@ Coords::spherical::spherical(const Coords::Cartesian& a)
   theta(Coords::angle(Coords::angle::rad2deg(atan2(r_xy, a.z()))));
 }
 
-// ----- copy constructor -----
-Coords::spherical::spherical(const Coords::spherical& a) {
-  m_r     = a.r();
-  m_theta = a.theta();
-  m_phi   = a.phi();
-};
-
-// ----- copy assignment -----
-Coords::spherical& Coords::spherical::operator=(const Coords::spherical& rhs) {
-  if (this == &rhs) return *this;
-  m_r     = rhs.r();
-  m_theta = rhs.theta();
-  m_phi   = rhs.phi();
-  return *this;
-}
-
-// ----- bool operators -----
-
-bool Coords::spherical::operator== (const Coords::spherical& rhs) const {
-  return r() == rhs.r() && theta() == rhs.theta() && phi() == rhs.phi();
-}
-
-bool Coords::spherical::operator!= (const Coords::spherical& rhs) const {
-  return !operator==(rhs);
-}
-
 // ----- in-place operators -----
 
 Coords::spherical& Coords::spherical::operator+=(const Coords::spherical& rhs) {
@@ -98,19 +73,6 @@ Coords::spherical& Coords::spherical::operator-=(const Coords::spherical& rhs) {
 
 
 
-// scale
-Coords::spherical& Coords::spherical::operator*=(const double& rhs) {
-  m_r *= rhs;
-  return *this;
-}
-
-Coords::spherical& Coords::spherical::operator/=(const double& rhs) throw (DivideByZeroError) {
-  if (rhs == 0)
-    throw DivideByZeroError();
-  m_r /= rhs;
-  return *this;
-}
-
 // ---------------------
 // ----- operators -----
 // ---------------------
@@ -133,35 +95,50 @@ Coords::spherical Coords::operator-(const Coords::spherical& lhs,
   return diff;
 }
 
-Coords::spherical Coords::operator-(const Coords::spherical& rhs) {
-  return Coords::spherical(-rhs.r(),
-			   -rhs.theta(),
-			   -rhs.phi());
-}
-
-// scale
-Coords::spherical Coords::operator*(const Coords::spherical& lhs,
-				    const double& rhs) {
-  return Coords::spherical(lhs.r() * rhs, lhs.theta(), lhs.phi());
-}
-
-Coords::spherical Coords::operator*(const double& lhs,
-				    const Coords::spherical& rhs) {
-  return Coords::operator*(rhs, lhs);
-}
-
-Coords::spherical Coords::operator/(const Coords::spherical& lhs,
-				    const double& rhs)
-  throw (DivideByZeroError) {
-  if (rhs == 0)
-    throw DivideByZeroError();
-  return Coords::spherical(lhs.r() / rhs, lhs.theta(), lhs.phi());
-}
 
-Coords::spherical Coords::operator/(const double& lhs,
-				    const Coords::spherical& rhs)
-  throw (DivideByZeroError) {
-  if (rhs.r() == 0)
-    throw DivideByZeroError();
-  return Coords::spherical(lhs / rhs.r(), rhs.theta(), rhs.phi());
+// -----------------------------
+// ----- batch conversions -----
+// -----------------------------
+
+void Coords::spherical2Cartesian(const double* a_r_theta_phi, double* a_xyz, const size_t& a_size) {
+  for (size_t i = 0; i < 3*a_size; i += 3) {
+    const double r(a_r_theta_phi[i]);
+    const double theta(Coords::angle::deg2rad(a_r_theta_phi[i+1]));
+    const double phi(Coords::angle::deg2rad(a_r_theta_phi[i+2]));
+    const double r_xy(r * sin(theta)); // r projection in xy plane.
+    a_xyz[i]   = r_xy * cos(phi);
+    a_xyz[i+1] = r_xy * sin(phi);
+    a_xyz[i+2] = r * cos(theta);
+  }
+}
+
+void Coords::Cartesian2spherical(const double* a_xyz, double* a_r_theta_phi, const size_t& a_size) {
+  for (size_t i = 0; i < 3*a_size; i += 3) {
+    const double x(a_xyz[i]), y(a_xyz[i+1]), z(a_xyz[i+2]);
+    const double r_xy(sqrt(x*x + y*y));
+    a_r_theta_phi[i]   = sqrt(x*x + y*y + z*z);
+    a_r_theta_phi[i+1] = Coords::angle::rad2deg(atan2(r_xy, z));
+    a_r_theta_phi[i+2] = Coords::angle::rad2deg(atan2(y, x));
+  }
+}
+
+// ----- binary records -----
+
+void Coords::spherical2binary(const spherical* a_sphericals, char* a_buffer, const size_t& a_size) {
+  for (size_t i = 0; i < a_size; ++i) {
+    char* a_record(a_buffer + i*spherical_binary_size);
+    Coords::double2binary(a_sphericals[i].r(), a_record);
+    Coords::double2binary(a_sphericals[i].theta().value(), a_record + 8);
+    Coords::double2binary(a_sphericals[i].phi().value(), a_record + 16);
+  }
+}
+
+void Coords::binary2spherical(const char* a_buffer, spherical* a_sphericals, const size_t& a_size) {
+  for (size_t i = 0; i < a_size; ++i) {
+    const char* a_record(a_buffer + i*spherical_binary_size);
+    Coords::angle theta, phi; // value() is exact, the degrees ctor goes through seconds
+    theta.value(Coords::binary2double(a_record + 8));
+    phi.value(Coords::binary2double(a_record + 16));
+    a_sphericals[i] = Coords::spherical(Coords::binary2double(a_record), theta, phi);
+  }
 }
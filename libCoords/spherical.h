@@ -34,14 +34,17 @@ namespace Coords {
   class angle;
   class Cartesian;
 
+  // Thread safety: spherical is a value. Const methods may be called
+  // from any number of threads, writers need their own copy.
+
   class spherical {
   public:
 
     // ----- ctor and dtor -----
 
-    explicit spherical(const double& r = 0.0,
-		       const angle& theta = angle(0.0),
-		       const angle& phi = angle(0.0))
+    constexpr explicit spherical(const double& r = 0.0,
+				 const angle& theta = angle(0.0),
+				 const angle& phi = angle(0.0))
       : m_r(r), m_theta(theta), m_phi(phi) {}; // ctors, including default.
 
     explicit spherical(const std::string& r, // The ambiguity is in the box.
@@ -50,47 +53,52 @@ namespace Coords {
 
     explicit spherical(const Cartesian& a);
 
-    explicit spherical(const double& r,
-		       const Latitude& lat,
-		       const angle& phi = angle(0.0))
+    constexpr explicit spherical(const double& r,
+				 const Latitude& lat,
+				 const angle& phi = angle(0.0))
       : m_r(r), m_theta(90.0 - lat.value()), m_phi(phi) {};
 
-    explicit spherical(const double& r,
-		       const Declination& lat,
-		       const angle& phi = angle(0.0))
+    constexpr explicit spherical(const double& r,
+				 const Declination& lat,
+				 const angle& phi = angle(0.0))
       : m_r(r), m_theta(90.0 - lat.value()), m_phi(phi) {};
 
-    ~spherical() {};
-
-    spherical(const spherical& a);
-    spherical& operator=(const spherical& rhs);
+    // implicit copy, assignment and dtor keep spherical trivially
+    // copyable and a literal type.
 
     // ----- accessors -----
 
-    void          r(const double& rhs) {m_r = rhs;}
-    const double& r() const            {return m_r;}
-    double        getR() const         {return m_r;} // for boost python wrappers
+    void                    r(const double& rhs) {m_r = rhs;}
+    constexpr const double& r() const            {return m_r;}
+    constexpr double        getR() const         {return m_r;} // for boost python wrappers
 
-    void          theta(const angle& rhs)  {m_theta = rhs;}
-    const angle&  theta() const            {return m_theta;}
-    angle         getTheta() const         {return m_theta;} // for boost python wrappers
+    void                    theta(const angle& rhs)  {m_theta = rhs;}
+    constexpr const angle&  theta() const            {return m_theta;}
+    constexpr angle         getTheta() const         {return m_theta;} // for boost python wrappers
 
-    void          phi(const angle& rhs)  {m_phi = rhs;}
-    const angle&  phi() const            {return m_phi;}
-    angle         getPhi() const         {return m_phi;} // for boost python wrappers
+    void                    phi(const angle& rhs)  {m_phi = rhs;}
+    constexpr const angle&  phi() const            {return m_phi;}
+    constexpr angle         getPhi() const         {return m_phi;} // for boost python wrappers
 
     // ----- bool operators -----
 
-    bool operator==(const spherical& rhs) const;
-    bool operator!=(const spherical& rhs) const;
+    bool operator==(const spherical& rhs) const {
+      return m_r == rhs.r() && m_theta == rhs.theta() && m_phi == rhs.phi();
+    }
+    bool operator!=(const spherical& rhs) const {return !operator==(rhs);}
 
     // ----- in-place operators -----
 
     spherical& operator+=(const spherical& rhs);
     spherical& operator-=(const spherical& rhs);
 
-    spherical& operator*=(const double& rhs); // scale
-    spherical& operator/=(const double& rhs) throw (DivideByZeroError);
+    spherical& operator*=(const double& rhs) {m_r *= rhs; return *this;} // scale
+    spherical& operator/=(const double& rhs) throw (DivideByZeroError) {
+      if (rhs == 0)
+	throw DivideByZeroError();
+      m_r /= rhs;
+      return *this;
+    }
 
     // ----- other methods -----
 
@@ -121,6 +129,9 @@ namespace Coords {
 
   spherical operator+(const spherical& lhs, const spherical& rhs);
   spherical operator-(const spherical& lhs, const spherical& rhs);
+
+  COORDS_BEGIN_INLINE
+
   spherical operator-(const spherical& rhs); // unary minus
 
 
@@ -131,6 +142,32 @@ namespace Coords {
   spherical operator/(const spherical& lhs, const double& rhs) throw (DivideByZeroError); // scale
   spherical operator/(const double& lhs, const spherical& rhs) throw (DivideByZeroError); // scale
 
+  COORDS_END_INLINE
+
+  // -----------------------------
+  // ----- batch conversions -----
+  // -----------------------------
+
+  // Over a_size points packed x, y, z and r, theta, phi (theta and phi
+  // in degrees), i.e. C contiguous (a_size, 3) numpy arrays. Same
+  // conventions as the Cartesian(spherical) and spherical(Cartesian)
+  // constructors. The output may be the input array.
+
+  void spherical2Cartesian(const double* a_r_theta_phi, double* a_xyz, const size_t& a_size);
+  void Cartesian2spherical(const double* a_xyz, double* a_r_theta_phi, const size_t& a_size);
+
+  // --------------------------
+  // ----- binary records -----
+  // --------------------------
+
+  // r, theta, phi (degrees), 24 bytes little endian, like
+  // angle2binary(). a_buffer holds a_size records.
+
+  const size_t spherical_binary_size(24);
+
+  void spherical2binary(const spherical* a_sphericals, char* a_buffer, const size_t& a_size);
+  void binary2spherical(const char* a_buffer, spherical* a_sphericals, const size_t& a_size);
+
   // -------------------------------
   // ----- output operator<<() -----
   // -------------------------------
@@ -147,3 +184,7 @@ namespace Coords {
 
 
 } // end namespace Coords
+
+#if COORDS_INLINE
+#include <spherical_inl.h>
+#endif
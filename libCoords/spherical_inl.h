@@ -0,0 +1,72 @@
+// ================================================================
+// Filename:    spherical_inl.h
+//
+// Description: The spherical arithmetic operators that do not go through
+//              Cartesian. Included by spherical.cpp for libCoords
+//              and by spherical.h when built with -D COORDS_INLINE.
+//
+// Author:      L.R. McFarland
+// Created:     2026 Oct 18
+// Language:    C++
+//
+//  Coords is free software: you can redistribute it and/or modify it
+//  under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  Coords is distributed in the hope that it will be useful, but
+//  WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with Coords.  If not, see <http://www.gnu.org/licenses/>.
+// ================================================================
+
+#pragma once
+
+#include <angle.h>
+#include <spherical.h>
+#include <utils.h>
+
+// ---------------------
+// ----- operators -----
+// ---------------------
+
+COORDS_INLINE_SPEC
+Coords::spherical Coords::operator-(const Coords::spherical& rhs) {
+  return Coords::spherical(-rhs.r(),
+			   -rhs.theta(),
+			   -rhs.phi());
+}
+
+// scale
+COORDS_INLINE_SPEC
+Coords::spherical Coords::operator*(const Coords::spherical& lhs,
+				    const double& rhs) {
+  return Coords::spherical(lhs.r() * rhs, lhs.theta(), lhs.phi());
+}
+
+COORDS_INLINE_SPEC
+Coords::spherical Coords::operator*(const double& lhs,
+				    const Coords::spherical& rhs) {
+  return Coords::operator*(rhs, lhs);
+}
+
+COORDS_INLINE_SPEC
+Coords::spherical Coords::operator/(const Coords::spherical& lhs,
+				    const double& rhs)
+  throw (DivideByZeroError) {
+  if (rhs == 0)
+    throw DivideByZeroError();
+  return Coords::spherical(lhs.r() / rhs, lhs.theta(), lhs.phi());
+}
+
+COORDS_INLINE_SPEC
+Coords::spherical Coords::operator/(const double& lhs,
+				    const Coords::spherical& rhs)
+  throw (DivideByZeroError) {
+  if (rhs.r() == 0)
+    throw DivideByZeroError();
+  return Coords::spherical(lhs / rhs.r(), rhs.theta(), rhs.phi());
+}
@@ -30,6 +30,8 @@
 #include <chrono>
 #include <random>
 #include <sstream>
+#include <type_traits>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -88,6 +90,13 @@ namespace {
 		Coords::spherical(1.0, Coords::angle(2.0), Coords::angle(3.1)));
   }
 
+  TEST(FixedSpherical, Constexpr) {
+    static_assert(std::is_trivially_copyable<Coords::spherical>::value, "memcpy");
+    constexpr Coords::spherical a(1, Coords::angle(90), Coords::angle(45));
+    static_assert(a.r() == 1 && a.theta().value() == 90 && a.getPhi().value() == 45, "spherical");
+    EXPECT_EQ(Coords::spherical(1, Coords::angle(90), Coords::angle(45)), a);
+  }
+
   TEST(FixedSpherical, DefaultConstructor) {
     Coords::spherical a;
     EXPECT_DOUBLE_EQ(0, a.r());
@@ -581,6 +590,47 @@ namespace {
     }
   }
 
+  // ----- batch conversions -----
+
+  TEST(FixedSpherical, BatchConversions) {
+    std::vector<Coords::Cartesian> points = {Coords::Cartesian(1, 2, 3),
+					     Coords::Cartesian(-4, 0.5, -6),
+					     Coords::Cartesian(0, 0, -1),
+					     Coords::Cartesian(-1, -1, 0)};
+    std::vector<double> r_theta_phi(3*points.size());
+    std::vector<Coords::Cartesian> round_trip(points.size());
+
+    Coords::Cartesian2spherical(&points[0].x(), &r_theta_phi[0], points.size());
+    Coords::spherical2Cartesian(&r_theta_phi[0], const_cast<double*>(&round_trip[0].x()), points.size());
+
+    for (size_t i = 0; i < points.size(); ++i) {
+      Coords::spherical a(points[i]);
+      EXPECT_DOUBLE_EQ(a.r(), r_theta_phi[3*i]);
+      EXPECT_DOUBLE_EQ(a.theta().value(), r_theta_phi[3*i + 1]);
+      EXPECT_DOUBLE_EQ(a.phi().value(), r_theta_phi[3*i + 2]);
+
+      EXPECT_NEAR(points[i].x(), round_trip[i].x(), 1e-14);
+      EXPECT_NEAR(points[i].y(), round_trip[i].y(), 1e-14);
+      EXPECT_NEAR(points[i].z(), round_trip[i].z(), 1e-14);
+    }
+  }
+
+  TEST(FixedSpherical, BinaryRoundTrip) {
+    std::vector<Coords::spherical> points = {Coords::spherical(1, Coords::angle(0.1), Coords::angle(-0.2)),
+					     Coords::spherical(Coords::Cartesian(-4, 0.5, -6)),
+					     Coords::spherical(6371, Coords::Latitude(37, 27, 13), Coords::angle(-122, 10, 55))};
+    std::vector<char> buffer(points.size()*Coords::spherical_binary_size);
+    std::vector<Coords::spherical> round_trip(points.size());
+
+    Coords::spherical2binary(&points[0], &buffer[0], points.size());
+    Coords::binary2spherical(&buffer[0], &round_trip[0], points.size());
+
+    for (size_t i = 0; i < points.size(); ++i) {
+      EXPECT_EQ(points[i].r(), round_trip[i].r());
+      EXPECT_EQ(points[i].theta().value(), round_trip[i].theta().value());
+      EXPECT_EQ(points[i].phi().value(), round_trip[i].phi().value());
+    }
+  }
 
 
 
@@ -63,56 +63,25 @@ double Coords::degrees2seconds(const double& a_deg, const double& a_min, const d
   // be only once with the largest non-zero element.  All other
   // positions will ignore the sign. For example (0, -10, 30) ==
   // -10.5 minutes and (0, 10, -30) == 10.5 minutes.
+  return Coords::sexagesimal2seconds(a_deg, a_min, a_sec);
+}
 
-  double seconds(0);
-  double _min(a_min);
-  double _sec(a_sec);
-
-  if (a_deg > 0) {
-
-    if (a_min < 0)
-      _min *= -1;
-
-    if (a_sec < 0)
-      _sec *= -1;
-
-    seconds = 3600*a_deg + 60*_min + _sec; // a_deg > 0 && a_min > 0
-
-  } else if (a_deg == 0) {
-
-    if (a_min > 0) {
-
-      if (a_sec < 0)
-	_sec *= -1;
-
-      seconds = 60*_min + _sec; // a_deg == 0 && a_min > 0
-
-    } else if (a_min == 0) {
-
-      seconds = a_sec; // a_deg == 0 && a_min == 0
-
-    } else {
-
-      if (a_sec < 0)
-	_sec *= -1;
-
-      seconds = 60*_min - _sec; // a_deg == 0 && a_min < 0
-
-    }
-
-  } else {
-
-    if (a_min < 0)
-      _min *= -1;
-
-    if (a_sec < 0)
-      _sec *= -1;
-
-    seconds = 3600*a_deg - 60*_min - _sec; // a_deg < 0 && a_min < 0
-  }
-
-  return seconds;
+void Coords::degrees2seconds(const double* a_deg,
+			     const double* a_min,
+			     const double* a_sec,
+			     double* a_seconds,
+			     const size_t& a_size) {
+  for (size_t i = 0; i < a_size; ++i)
+    a_seconds[i] = Coords::sexagesimal2seconds(a_deg[i], a_min[i], a_sec[i]);
+}
 
+void Coords::sexagesimal2decimal(const double* a_deg,
+				 const double* a_min,
+				 const double* a_sec,
+				 double* a_decimal,
+				 const size_t& a_size) {
+  for (size_t i = 0; i < a_size; ++i)
+    a_decimal[i] = Coords::sexagesimal2seconds(a_deg[i], a_min[i], a_sec[i])/3600.0;
 }
 
 // -----------------------------
@@ -23,8 +23,28 @@
 
 #pragma once
 
+#include <cmath>
+#include <cstddef>
+#include <cstring>
 #include <sstream>
 #include <stdexcept>
+#include <stdint.h>
+
+// -D COORDS_INLINE defines the angle, Cartesian and spherical free
+// operators in the *_inl.h headers so callers can inline them. They
+// are then in the inline namespace Coords::inlined, a different
+// function from the one libCoords, built without it, keeps exporting
+// to callers built without it, so the two never break the one
+// definition rule. The member operators are inline in the classes.
+#if COORDS_INLINE
+#define COORDS_INLINE_SPEC inline
+#define COORDS_BEGIN_INLINE inline namespace inlined {
+#define COORDS_END_INLINE }
+#else
+#define COORDS_INLINE_SPEC
+#define COORDS_BEGIN_INLINE
+#define COORDS_END_INLINE
+#endif
 
 namespace Coords {
 
@@ -49,6 +69,123 @@ namespace Coords {
 
   double degrees2seconds(const double& a_deg, const double& a_min, const double& a_sec);
 
+  // constexpr degrees2seconds() for the angle constructor. The sign
+  // of the largest non-zero element applied to the sum of the
+  // magnitudes. Selects instead of nested ifs so the batch loops
+  // vectorize. All zeros returns a_sec to keep the sign of -0.0.
+
+  // fabs() is not constexpr with clang.
+  constexpr double absolute(const double& a) {return a < 0 ? -a : a;}
+
+  constexpr double signCarrier(const double& a_deg, const double& a_min, const double& a_sec) {
+    return a_deg != 0 ? a_deg : (a_min != 0 ? a_min : a_sec);
+  }
+
+  constexpr double applySign(const double& a_sign, const double& a_magnitude) {
+    return a_sign < 0 ? -a_magnitude : (a_sign > 0 ? a_magnitude : a_sign);
+  }
+
+  constexpr double sexagesimal2seconds(const double& a_deg, const double& a_min, const double& a_sec) {
+    return applySign(signCarrier(a_deg, a_min, a_sec),
+		     3600*absolute(a_deg) + 60*absolute(a_min) + absolute(a_sec));
+  }
+
+  // batch versions over columns of (deg, min, sec), e.g. from a
+  // catalog. Same sign convention as degrees2seconds().
+  void degrees2seconds(const double* a_deg,
+		       const double* a_min,
+		       const double* a_sec,
+		       double* a_seconds,
+		       const size_t& a_size);
+
+  // decimal degrees (or hours), i.e. degrees2seconds()/3600 as in the angle constructor.
+  void sexagesimal2decimal(const double* a_deg,
+			   const double* a_min,
+			   const double* a_sec,
+			   double* a_decimal,
+			   const size_t& a_size);
+
+  // floor() for batch loops. libm floor() is a call (or SSE4.1
+  // roundpd) which stops the loop from vectorizing. Adding and
+  // subtracting 2^52 rounds to an integer, exact for |a| < 2^52 and
+  // larger doubles are already integers. Needs IEEE rounding, i.e. no
+  // -ffast-math.
+  inline double branchlessFloor(const double& a) {
+    const double two52(4503599627370496.0);
+    const double shift(copysign(two52, a));
+    const double rounded(fabs(a) < two52 ? (a + shift) - shift : a);
+    return rounded > a ? rounded - 1.0 : rounded;
+  }
+
+  // ----- binary records -----
+
+  // Fields of the fixed layout records written by angle2binary(),
+  // Cartesian2binary() etc. for files and IPC. Little endian IEEE 754
+  // whatever the host, so a record from one machine reads on any
+  // other. On little endian hosts these compile to plain loads and
+  // stores.
+
+  inline void double2binary(const double& a, char* a_buffer) {
+    uint64_t bits;
+    memcpy(&bits, &a, sizeof(bits));
+    for (int i = 0; i < 8; ++i)
+      a_buffer[i] = static_cast<char>(bits >> 8*i);
+  }
+
+  inline double binary2double(const char* a_buffer) {
+    uint64_t bits(0);
+    for (int i = 0; i < 8; ++i)
+      bits |= static_cast<uint64_t>(static_cast<unsigned char>(a_buffer[i])) << 8*i;
+    double a;
+    memcpy(&a, &bits, sizeof(a));
+    return a;
+  }
+
+  inline void int2binary(const int32_t& a, char* a_buffer) {
+    const uint32_t bits(a);
+    for (int i = 0; i < 4; ++i)
+      a_buffer[i] = static_cast<char>(bits >> 8*i);
+  }
+
+  inline int32_t binary2int(const char* a_buffer) {
+    uint32_t bits(0);
+    for (int i = 0; i < 4; ++i)
+      bits |= static_cast<uint32_t>(static_cast<unsigned char>(a_buffer[i])) << 8*i;
+    return static_cast<int32_t>(bits);
+  }
+
+  inline void long2binary(const int64_t& a, char* a_buffer) {
+    const uint64_t bits(a);
+    for (int i = 0; i < 8; ++i)
+      a_buffer[i] = static_cast<char>(bits >> 8*i);
+  }
+
+  inline int64_t binary2long(const char* a_buffer) {
+    uint64_t bits(0);
+    for (int i = 0; i < 8; ++i)
+      bits |= static_cast<uint64_t>(static_cast<unsigned char>(a_buffer[i])) << 8*i;
+    return static_cast<int64_t>(bits);
+  }
+
+  // ----- Morton keys -----
+
+  // interleaves the low 21 bits of ix, iy and iz, x highest, so
+  // sorting by key walks the cells of a grid in z-order and nearby
+  // cells are mostly nearby in memory.
+  inline uint64_t spreadBits(uint64_t a) {
+    a &= 0x1fffff;
+    a = (a | a << 32) & 0x1f00000000ffffULL;
+    a = (a | a << 16) & 0x1f0000ff0000ffULL;
+    a = (a | a << 8)  & 0x100f00f00f00f00fULL;
+    a = (a | a << 4)  & 0x10c30c30c30c30c3ULL;
+    a = (a | a << 2)  & 0x1249249249249249ULL;
+    return a;
+  }
+
+  inline uint64_t mortonKey(const uint64_t& ix, const uint64_t& iy, const uint64_t& iz) {
+    return spreadBits(ix) << 2 | spreadBits(iy) << 1 | spreadBits(iz);
+  }
+
   // output operator<<
   void value2DMSString(const double& a_value, std::stringstream& a_string);
   void value2HMSString(const double& a_value, std::stringstream& a_string);